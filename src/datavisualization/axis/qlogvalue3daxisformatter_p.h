@@ -49,6 +49,7 @@ private:
     bool m_evenMaxSegment;
 
     friend class QLogValue3DAxisFormatter;
+    friend class AxisRenderCache;
 };
 
 QT_END_NAMESPACE
@@ -77,6 +77,7 @@ protected:
     bool m_cLocaleInUse;
 
     friend class QValue3DAxisFormatter;
+    friend class AxisRenderCache;
 };
 
 QT_END_NAMESPACE
@@ -0,0 +1,675 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include "qheightfieldsurfacedataproxy_p.h"
+#include "utils_p.h"
+
+#include <QtCore/QtEndian>
+#include <QtCore/qmath.h>
+
+QT_BEGIN_NAMESPACE
+
+// Default ranges correspond value axis defaults
+const float defaultMinValue = 0.0f;
+const float defaultMaxValue = 10.0f;
+
+// Minimum number of samples in a band of rows that is resolved in parallel
+const int resolveBandSampleCount = 16384;
+// Maximum number of samples resolved without a sample region, so that a very large height field
+// is not resolved into data at full resolution by default
+const qint64 defaultMaxSampleCount = 1024 * 1024;
+
+// Number of samples taken from length samples with the step, including the last one
+static inline int steppedSampleCount(int length, int step)
+{
+    return (length - 1 + step - 1) / step + 1;
+}
+
+/*!
+ * \class QHeightFieldSurfaceDataProxy
+ * \inmodule QtDataVisualization
+ * \brief Proxy class for Q3DSurface that reads heights from a raw height field file.
+ * \since 6.9
+ *
+ * QHeightFieldSurfaceDataProxy visualizes a regular grid of heights stored in a raw binary file,
+ * such as a digital elevation model. The samples are little endian 16-bit unsigned integers or
+ * 32-bit floating point values, stored in rows. Sample values are used as Y-values as is.
+ *
+ * The file is memory mapped instead of read into memory, and surface data items are only
+ * created for the samples in the sampleRegion, taking every sampleStep:th sample. Setting the
+ * region to the part of the height field that is visible within the axis ranges keeps the memory
+ * use of very large height fields proportional to the visible part only.
+ *
+ * Since height fields do not contain values for X or Z axes, those values need to be given
+ * separately using minXValue, maxXValue, minZValue, and maxZValue properties. They correspond to
+ * the whole height field. X-value corresponds to the columns and Z-value to the rows of the
+ * height field, with the first row in the file at minimum Z. Setting any of the properties
+ * triggers asynchronous re-resolving of the data.
+ *
+ * \sa QHeightMapSurfaceDataProxy, {Qt Data Visualization Data Handling}
+ */
+
+/*!
+ * \qmltype HeightFieldSurfaceDataProxy
+ * \inqmlmodule QtDataVisualization
+ * \since QtDataVisualization 6.9
+ * \ingroup datavisualization_qml
+ * \nativetype QHeightFieldSurfaceDataProxy
+ * \inherits SurfaceDataProxy
+ * \brief Proxy type for Surface3D that reads heights from a raw height field file.
+ *
+ * HeightFieldSurfaceDataProxy visualizes a regular grid of heights stored in a raw binary file,
+ * such as a digital elevation model. The file is memory mapped, and only the samples in the
+ * sampleRegion are resolved into the data.
+ *
+ * For more complete description, see QHeightFieldSurfaceDataProxy.
+ *
+ * \sa HeightMapSurfaceDataProxy, {Qt Data Visualization Data Handling}
+ */
+
+/*!
+ * \qmlproperty string HeightFieldSurfaceDataProxy::heightFieldFile
+ * \readonly
+ *
+ * The name of the mapped height field file. Empty if no file is mapped.
+ *
+ * \sa setHeightFieldFile()
+ */
+
+/*!
+ * \qmlproperty int HeightFieldSurfaceDataProxy::fieldWidth
+ * \readonly
+ *
+ * The number of columns in the height field.
+ */
+
+/*!
+ * \qmlproperty int HeightFieldSurfaceDataProxy::fieldHeight
+ * \readonly
+ *
+ * The number of rows in the height field.
+ */
+
+/*!
+ * \qmlproperty enumeration HeightFieldSurfaceDataProxy::sampleType
+ * \readonly
+ *
+ * The type of the samples in the height field file.
+ *
+ * \value HeightFieldSurfaceDataProxy.SampleTypeUInt16
+ *        Little endian 16-bit unsigned integers.
+ * \value HeightFieldSurfaceDataProxy.SampleTypeFloat32
+ *        Little endian 32-bit IEEE floating point values.
+ */
+
+/*!
+ * \qmlproperty int HeightFieldSurfaceDataProxy::dataOffset
+ * \readonly
+ *
+ * The offset of the first sample from the start of the file in bytes.
+ */
+
+/*!
+ * \qmlproperty int HeightFieldSurfaceDataProxy::rowStride
+ * \readonly
+ *
+ * The distance between the starts of consecutive rows in bytes.
+ */
+
+/*!
+ * \qmlproperty rect HeightFieldSurfaceDataProxy::sampleRegion
+ *
+ * The region of the height field samples that are resolved into the data, in rows and columns
+ * of the height field. A null rectangle means the whole height field, resolved with a step
+ * large enough to keep the data within 1024 x 1024 items.
+ */
+
+/*!
+ * \qmlproperty int HeightFieldSurfaceDataProxy::sampleStep
+ *
+ * The step between the resolved samples in rows and columns. Must be positive.
+ * Defaults to \c 1.
+ */
+
+/*!
+ * \qmlproperty real HeightFieldSurfaceDataProxy::minXValue
+ *
+ * The minimum X value for the first column of the height field. Defaults to \c{0.0}.
+ * Must be smaller than maxXValue.
+ */
+
+/*!
+ * \qmlproperty real HeightFieldSurfaceDataProxy::maxXValue
+ *
+ * The maximum X value for the last column of the height field. Defaults to \c{10.0}.
+ * Must be larger than minXValue.
+ */
+
+/*!
+ * \qmlproperty real HeightFieldSurfaceDataProxy::minZValue
+ *
+ * The minimum Z value for the first row of the height field. Defaults to \c{0.0}.
+ * Must be smaller than maxZValue.
+ */
+
+/*!
+ * \qmlproperty real HeightFieldSurfaceDataProxy::maxZValue
+ *
+ * The maximum Z value for the last row of the height field. Defaults to \c{10.0}.
+ * Must be larger than minZValue.
+ */
+
+/*!
+ * \qmlmethod bool HeightFieldSurfaceDataProxy::setHeightFieldFile(string filename, int width, int height, enumeration type, int offset, int stride)
+ *
+ * Maps the height field file \a filename of \a width columns and \a height rows of samples of
+ * the given \a type. The first sample is at \a offset bytes from the start of the file, and the
+ * rows are \a stride bytes apart, or tightly packed if \a stride is \c 0. Returns \c false and
+ * clears the data if the file cannot be mapped.
+ */
+
+/*!
+ * \qmlmethod void HeightFieldSurfaceDataProxy::clearHeightField()
+ *
+ * Unmaps the height field file and clears the data.
+ */
+
+/*!
+ * \qmlmethod real HeightFieldSurfaceDataProxy::heightAt(int row, int column)
+ *
+ * Returns the height of the sample at \a row and \a column of the height field.
+ */
+
+/*!
+ * \enum QHeightFieldSurfaceDataProxy::SampleType
+ *
+ * Type of the samples in a height field file.
+ *
+ * \value SampleTypeUInt16
+ *        Little endian 16-bit unsigned integers.
+ * \value SampleTypeFloat32
+ *        Little endian 32-bit IEEE floating point values.
+ */
+
+/*!
+ * Constructs QHeightFieldSurfaceDataProxy with the given \a parent.
+ */
+QHeightFieldSurfaceDataProxy::QHeightFieldSurfaceDataProxy(QObject *parent) :
+    QSurfaceDataProxy(new QHeightFieldSurfaceDataProxyPrivate(this), parent)
+{
+}
+
+/*!
+ * Destroys QHeightFieldSurfaceDataProxy.
+ */
+QHeightFieldSurfaceDataProxy::~QHeightFieldSurfaceDataProxy()
+{
+}
+
+/*!
+ * Maps the height field file \a filename for visualization. The height field has \a width columns
+ * and \a height rows of samples of the given \a type. The first sample is at \a offset bytes from
+ * the start of the file, and the rows are \a stride bytes apart. If \a stride is \c 0, the rows are
+ * tightly packed.
+ *
+ * Returns \c false and clears the data if the file cannot be mapped or is too small to contain
+ * the height field.
+ *
+ * \sa heightFieldFile, fieldWidth, fieldHeight, sampleType, dataOffset, rowStride
+ */
+bool QHeightFieldSurfaceDataProxy::setHeightFieldFile(const QString &filename, int width,
+                                                      int height, SampleType type,
+                                                      qint64 offset, qint64 stride)
+{
+    return dptr()->setHeightFieldFile(filename, width, height, type, offset, stride);
+}
+
+/*!
+ * Unmaps the height field file and clears the data.
+ */
+void QHeightFieldSurfaceDataProxy::clearHeightField()
+{
+    dptr()->clearHeightField();
+}
+
+/*!
+ * \property QHeightFieldSurfaceDataProxy::heightFieldFile
+ *
+ * \brief The name of the mapped height field file.
+ *
+ * Empty if no file is mapped.
+ */
+QString QHeightFieldSurfaceDataProxy::heightFieldFile() const
+{
+    return dptrc()->m_file.fileName();
+}
+
+/*!
+ * \property QHeightFieldSurfaceDataProxy::fieldWidth
+ *
+ * \brief The number of columns in the height field.
+ */
+int QHeightFieldSurfaceDataProxy::fieldWidth() const
+{
+    return dptrc()->m_fieldWidth;
+}
+
+/*!
+ * \property QHeightFieldSurfaceDataProxy::fieldHeight
+ *
+ * \brief The number of rows in the height field.
+ */
+int QHeightFieldSurfaceDataProxy::fieldHeight() const
+{
+    return dptrc()->m_fieldHeight;
+}
+
+/*!
+ * \property QHeightFieldSurfaceDataProxy::sampleType
+ *
+ * \brief The type of the samples in the height field file.
+ */
+QHeightFieldSurfaceDataProxy::SampleType QHeightFieldSurfaceDataProxy::sampleType() const
+{
+    return dptrc()->m_sampleType;
+}
+
+/*!
+ * \property QHeightFieldSurfaceDataProxy::dataOffset
+ *
+ * \brief The offset of the first sample from the start of the file in bytes.
+ */
+qint64 QHeightFieldSurfaceDataProxy::dataOffset() const
+{
+    return dptrc()->m_dataOffset;
+}
+
+/*!
+ * \property QHeightFieldSurfaceDataProxy::rowStride
+ *
+ * \brief The distance between the starts of consecutive rows in bytes.
+ */
+qint64 QHeightFieldSurfaceDataProxy::rowStride() const
+{
+    return dptrc()->m_rowStride;
+}
+
+/*!
+ * Returns the height of the sample at \a row and \a column of the height field, regardless of the
+ * sampleRegion. Returns \c 0 if the position is outside the height field.
+ */
+float QHeightFieldSurfaceDataProxy::heightAt(int row, int column) const
+{
+    const QHeightFieldSurfaceDataProxyPrivate *d = dptrc();
+    if (row < 0 || row >= d->m_fieldHeight || column < 0 || column >= d->m_fieldWidth)
+        return 0.0f;
+    return d->heightAt(row, column);
+}
+
+/*!
+ * \property QHeightFieldSurfaceDataProxy::sampleRegion
+ *
+ * \brief The region of the height field samples that are resolved into the data.
+ *
+ * The region is given in rows and columns of the height field, and it is clipped to the height
+ * field. A null rectangle means the whole height field. In that case a larger step than
+ * sampleStep is used if needed to keep the data within 1024 x 1024 items, so that very large
+ * height fields are not resolved at full resolution by default. Defaults to a null rectangle.
+ */
+void QHeightFieldSurfaceDataProxy::setSampleRegion(const QRect &region)
+{
+    dptr()->setSampleRegion(region);
+}
+
+QRect QHeightFieldSurfaceDataProxy::sampleRegion() const
+{
+    return dptrc()->m_sampleRegion;
+}
+
+/*!
+ * \property QHeightFieldSurfaceDataProxy::sampleStep
+ *
+ * \brief The step between the resolved samples in rows and columns.
+ *
+ * Every sampleStep:th sample of the sampleRegion is resolved into the data. The last row and
+ * column of the region are always included. Without a sampleRegion, a larger step may be used
+ * for the whole height field. Must be positive. Defaults to \c 1.
+ */
+void QHeightFieldSurfaceDataProxy::setSampleStep(int step)
+{
+    dptr()->setSampleStep(step);
+}
+
+int QHeightFieldSurfaceDataProxy::sampleStep() const
+{
+    return dptrc()->m_sampleStep;
+}
+
+/*!
+ * A convenience function for setting all minimum (\a minX and \a minZ) and maximum
+ * (\a maxX and \a maxZ) values at the same time. The minimum values must be smaller than the
+ * corresponding maximum value.
+ */
+void QHeightFieldSurfaceDataProxy::setValueRanges(float minX, float maxX, float minZ, float maxZ)
+{
+    dptr()->setValueRanges(minX, maxX, minZ, maxZ);
+}
+
+/*!
+ * \property QHeightFieldSurfaceDataProxy::minXValue
+ *
+ * \brief The minimum X value for the first column of the height field.
+ *
+ * Defaults to \c{0.0}. Must be smaller than maxXValue.
+ */
+void QHeightFieldSurfaceDataProxy::setMinXValue(float min)
+{
+    dptr()->setValueRanges(min, dptrc()->m_maxXValue, dptrc()->m_minZValue,
+                           dptrc()->m_maxZValue);
+}
+
+float QHeightFieldSurfaceDataProxy::minXValue() const
+{
+    return dptrc()->m_minXValue;
+}
+
+/*!
+ * \property QHeightFieldSurfaceDataProxy::maxXValue
+ *
+ * \brief The maximum X value for the last column of the height field.
+ *
+ * Defaults to \c{10.0}. Must be larger than minXValue.
+ */
+void QHeightFieldSurfaceDataProxy::setMaxXValue(float max)
+{
+    dptr()->setValueRanges(dptrc()->m_minXValue, max, dptrc()->m_minZValue,
+                           dptrc()->m_maxZValue);
+}
+
+float QHeightFieldSurfaceDataProxy::maxXValue() const
+{
+    return dptrc()->m_maxXValue;
+}
+
+/*!
+ * \property QHeightFieldSurfaceDataProxy::minZValue
+ *
+ * \brief The minimum Z value for the first row of the height field.
+ *
+ * Defaults to \c{0.0}. Must be smaller than maxZValue.
+ */
+void QHeightFieldSurfaceDataProxy::setMinZValue(float min)
+{
+    dptr()->setValueRanges(dptrc()->m_minXValue, dptrc()->m_maxXValue, min,
+                           dptrc()->m_maxZValue);
+}
+
+float QHeightFieldSurfaceDataProxy::minZValue() const
+{
+    return dptrc()->m_minZValue;
+}
+
+/*!
+ * \property QHeightFieldSurfaceDataProxy::maxZValue
+ *
+ * \brief The maximum Z value for the last row of the height field.
+ *
+ * Defaults to \c{10.0}. Must be larger than minZValue.
+ */
+void QHeightFieldSurfaceDataProxy::setMaxZValue(float max)
+{
+    dptr()->setValueRanges(dptrc()->m_minXValue, dptrc()->m_maxXValue, dptrc()->m_minZValue,
+                           max);
+}
+
+float QHeightFieldSurfaceDataProxy::maxZValue() const
+{
+    return dptrc()->m_maxZValue;
+}
+
+/*!
+ * \fn void QHeightFieldSurfaceDataProxy::heightFieldChanged()
+ *
+ * This signal is emitted when a height field file is mapped or the height field is cleared.
+ */
+
+/*!
+ * \internal
+ */
+QHeightFieldSurfaceDataProxyPrivate *QHeightFieldSurfaceDataProxy::dptr()
+{
+    return static_cast<QHeightFieldSurfaceDataProxyPrivate *>(d_ptr.data());
+}
+
+/*!
+ * \internal
+ */
+const QHeightFieldSurfaceDataProxyPrivate *QHeightFieldSurfaceDataProxy::dptrc() const
+{
+    return static_cast<const QHeightFieldSurfaceDataProxyPrivate *>(d_ptr.data());
+}
+
+//  QHeightFieldSurfaceDataProxyPrivate
+
+QHeightFieldSurfaceDataProxyPrivate::QHeightFieldSurfaceDataProxyPrivate(
+        QHeightFieldSurfaceDataProxy *q)
+    : QSurfaceDataProxyPrivate(q),
+      m_samples(nullptr),
+      m_fieldWidth(0),
+      m_fieldHeight(0),
+      m_sampleType(QHeightFieldSurfaceDataProxy::SampleTypeUInt16),
+      m_dataOffset(0),
+      m_rowStride(0),
+      m_sampleStep(1),
+      m_minXValue(defaultMinValue),
+      m_maxXValue(defaultMaxValue),
+      m_minZValue(defaultMinValue),
+      m_maxZValue(defaultMaxValue)
+{
+    m_resolveTimer.setSingleShot(true);
+    QObject::connect(&m_resolveTimer, &QTimer::timeout,
+                     this, &QHeightFieldSurfaceDataProxyPrivate::handlePendingResolve);
+}
+
+QHeightFieldSurfaceDataProxyPrivate::~QHeightFieldSurfaceDataProxyPrivate()
+{
+}
+
+QHeightFieldSurfaceDataProxy *QHeightFieldSurfaceDataProxyPrivate::qptr()
+{
+    return static_cast<QHeightFieldSurfaceDataProxy *>(q_ptr);
+}
+
+bool QHeightFieldSurfaceDataProxyPrivate::setHeightFieldFile(
+        const QString &filename, int width, int height,
+        QHeightFieldSurfaceDataProxy::SampleType type, qint64 offset, qint64 stride)
+{
+    const qint64 sampleSize = (type == QHeightFieldSurfaceDataProxy::SampleTypeFloat32) ? 4 : 2;
+    if (!stride)
+        stride = width * sampleSize;
+    if (width <= 0 || height <= 0 || offset < 0 || stride < width * sampleSize) {
+        qWarning("Invalid height field dimensions.");
+        clearHeightField();
+        return false;
+    }
+
+    clearHeightField();
+    m_file.setFileName(filename);
+    const qint64 mappedSize = stride * (height - 1) + width * sampleSize;
+    if (!m_file.open(QIODevice::ReadOnly) || m_file.size() < offset + mappedSize) {
+        qWarning("Failed to open height field file %s", qPrintable(filename));
+        m_file.close();
+        m_file.setFileName(QString());
+        scheduleResolve();
+        return false;
+    }
+    m_samples = m_file.map(offset, mappedSize);
+    if (!m_samples) {
+        qWarning("Failed to map height field file %s", qPrintable(filename));
+        m_file.close();
+        m_file.setFileName(QString());
+        scheduleResolve();
+        return false;
+    }
+
+    m_fieldWidth = width;
+    m_fieldHeight = height;
+    m_sampleType = type;
+    m_dataOffset = offset;
+    m_rowStride = stride;
+    emit qptr()->heightFieldChanged();
+    scheduleResolve();
+    return true;
+}
+
+void QHeightFieldSurfaceDataProxyPrivate::clearHeightField()
+{
+    if (!m_file.isOpen() && m_file.fileName().isEmpty())
+        return;
+
+    // Closing the file unmaps it
+    m_file.close();
+    m_file.setFileName(QString());
+    m_samples = nullptr;
+    m_fieldWidth = 0;
+    m_fieldHeight = 0;
+    m_dataOffset = 0;
+    m_rowStride = 0;
+    emit qptr()->heightFieldChanged();
+    scheduleResolve();
+}
+
+void QHeightFieldSurfaceDataProxyPrivate::setSampleRegion(const QRect &region)
+{
+    if (m_sampleRegion != region) {
+        m_sampleRegion = region;
+        emit qptr()->sampleRegionChanged(m_sampleRegion);
+        scheduleResolve();
+    }
+}
+
+void QHeightFieldSurfaceDataProxyPrivate::setSampleStep(int step)
+{
+    if (step <= 0) {
+        qWarning("Invalid sample step. The step must be positive.");
+        return;
+    }
+    if (m_sampleStep != step) {
+        m_sampleStep = step;
+        emit qptr()->sampleStepChanged(m_sampleStep);
+        scheduleResolve();
+    }
+}
+
+void QHeightFieldSurfaceDataProxyPrivate::setValueRanges(float minX, float maxX,
+                                                         float minZ, float maxZ)
+{
+    if (minX >= maxX || minZ >= maxZ) {
+        qWarning("Invalid value ranges. Minimum values must be smaller than maximum values.");
+        return;
+    }
+
+    const bool minXChanged = (m_minXValue != minX);
+    const bool maxXChanged = (m_maxXValue != maxX);
+    const bool minZChanged = (m_minZValue != minZ);
+    const bool maxZChanged = (m_maxZValue != maxZ);
+    m_minXValue = minX;
+    m_maxXValue = maxX;
+    m_minZValue = minZ;
+    m_maxZValue = maxZ;
+
+    if (minXChanged)
+        emit qptr()->minXValueChanged(m_minXValue);
+    if (minZChanged)
+        emit qptr()->minZValueChanged(m_minZValue);
+    if (maxXChanged)
+        emit qptr()->maxXValueChanged(m_maxXValue);
+    if (maxZChanged)
+        emit qptr()->maxZValueChanged(m_maxZValue);
+
+    if (minXChanged || minZChanged || maxXChanged || maxZChanged)
+        scheduleResolve();
+}
+
+float QHeightFieldSurfaceDataProxyPrivate::heightAt(int row, int column) const
+{
+    const uchar *sample = m_samples + row * m_rowStride;
+    if (m_sampleType == QHeightFieldSurfaceDataProxy::SampleTypeFloat32)
+        return qFromLittleEndian<float>(sample + column * 4);
+    return float(qFromLittleEndian<quint16>(sample + column * 2));
+}
+
+void QHeightFieldSurfaceDataProxyPrivate::scheduleResolve()
+{
+    // We do resolving asynchronously to make qml onArrayReset handlers actually get the reset
+    if (!m_resolveTimer.isActive())
+        m_resolveTimer.start(0);
+}
+
+QRect QHeightFieldSurfaceDataProxyPrivate::effectiveSampleRegion() const
+{
+    const QRect field(0, 0, m_fieldWidth, m_fieldHeight);
+    if (m_sampleRegion.isNull())
+        return field;
+    return m_sampleRegion.intersected(field);
+}
+
+int QHeightFieldSurfaceDataProxyPrivate::effectiveSampleStep(const QRect &region) const
+{
+    if (!m_sampleRegion.isNull())
+        return m_sampleStep;
+
+    // Whole field is sampled sparsely enough to stay within the default sample count
+    const qint64 sampleCount = qint64(region.width()) * qint64(region.height());
+    int step = qMax(m_sampleStep, int(qSqrt(double(sampleCount / defaultMaxSampleCount))));
+    while (qint64(steppedSampleCount(region.width(), step))
+           * qint64(steppedSampleCount(region.height(), step)) > defaultMaxSampleCount) {
+        step++;
+    }
+    return step;
+}
+
+void QHeightFieldSurfaceDataProxyPrivate::handlePendingResolve()
+{
+    const QRect region = effectiveSampleRegion();
+    if (!m_samples || region.isEmpty()) {
+        qptr()->resetArray(nullptr);
+        return;
+    }
+
+    // The last row and column of the region are included even if they are not on the step
+    const int step = effectiveSampleStep(region);
+    const int columns = steppedSampleCount(region.width(), step);
+    const int rows = steppedSampleCount(region.height(), step);
+    QSurfaceDataArray *dataArray = new QSurfaceDataArray;
+    dataArray->reserve(rows);
+    for (int i = 0; i < rows; i++)
+        dataArray->append(new QSurfaceDataRow(columns));
+
+    const float xMul = (m_maxXValue - m_minXValue) / float(qMax(1, m_fieldWidth - 1));
+    const float zMul = (m_maxZValue - m_minZValue) / float(qMax(1, m_fieldHeight - 1));
+    const int lastFieldRow = m_fieldHeight - 1;
+    const int lastFieldColumn = m_fieldWidth - 1;
+
+    // Items are only created for the region, so the samples outside it are never paged in
+    Utils::parallelFor(rows, qMax(1, resolveBandSampleCount / columns), [&](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            const int fieldRow = qMin(region.y() + i * step, region.bottom());
+            // Last row and column are explicitly set to max values, as relying
+            // on multiplier can cause rounding errors
+            const float zVal = (fieldRow == lastFieldRow) ? m_maxZValue
+                                                          : float(fieldRow) * zMul + m_minZValue;
+            QSurfaceDataRow &newRow = *dataArray->at(i);
+            for (int j = 0; j < columns; j++) {
+                const int fieldColumn = qMin(region.x() + j * step, region.right());
+                const float xVal = (fieldColumn == lastFieldColumn)
+                        ? m_maxXValue : float(fieldColumn) * xMul + m_minXValue;
+                newRow[j].setPosition(QVector3D(xVal, heightAt(fieldRow, fieldColumn), zVal));
+            }
+        }
+    });
+
+    qptr()->resetArray(dataArray);
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,87 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#ifndef QHEIGHTFIELDSURFACEDATAPROXY_H
+#define QHEIGHTFIELDSURFACEDATAPROXY_H
+
+#include <QtDataVisualization/qsurfacedataproxy.h>
+#include <QtCore/QRect>
+#include <QtCore/QString>
+
+QT_BEGIN_NAMESPACE
+
+class QHeightFieldSurfaceDataProxyPrivate;
+
+class Q_DATAVISUALIZATION_EXPORT QHeightFieldSurfaceDataProxy : public QSurfaceDataProxy
+{
+    Q_OBJECT
+
+    Q_PROPERTY(QString heightFieldFile READ heightFieldFile NOTIFY heightFieldChanged)
+    Q_PROPERTY(int fieldWidth READ fieldWidth NOTIFY heightFieldChanged)
+    Q_PROPERTY(int fieldHeight READ fieldHeight NOTIFY heightFieldChanged)
+    Q_PROPERTY(QHeightFieldSurfaceDataProxy::SampleType sampleType READ sampleType NOTIFY heightFieldChanged)
+    Q_PROPERTY(qint64 dataOffset READ dataOffset NOTIFY heightFieldChanged)
+    Q_PROPERTY(qint64 rowStride READ rowStride NOTIFY heightFieldChanged)
+    Q_PROPERTY(QRect sampleRegion READ sampleRegion WRITE setSampleRegion NOTIFY sampleRegionChanged)
+    Q_PROPERTY(int sampleStep READ sampleStep WRITE setSampleStep NOTIFY sampleStepChanged)
+    Q_PROPERTY(float minXValue READ minXValue WRITE setMinXValue NOTIFY minXValueChanged)
+    Q_PROPERTY(float maxXValue READ maxXValue WRITE setMaxXValue NOTIFY maxXValueChanged)
+    Q_PROPERTY(float minZValue READ minZValue WRITE setMinZValue NOTIFY minZValueChanged)
+    Q_PROPERTY(float maxZValue READ maxZValue WRITE setMaxZValue NOTIFY maxZValueChanged)
+
+public:
+    enum SampleType {
+        SampleTypeUInt16 = 0,
+        SampleTypeFloat32
+    };
+    Q_ENUM(SampleType)
+
+    explicit QHeightFieldSurfaceDataProxy(QObject *parent = nullptr);
+    virtual ~QHeightFieldSurfaceDataProxy();
+
+    Q_INVOKABLE bool setHeightFieldFile(const QString &filename, int width, int height,
+                                        SampleType type, qint64 offset = 0, qint64 stride = 0);
+    Q_INVOKABLE void clearHeightField();
+    QString heightFieldFile() const;
+    int fieldWidth() const;
+    int fieldHeight() const;
+    SampleType sampleType() const;
+    qint64 dataOffset() const;
+    qint64 rowStride() const;
+    Q_INVOKABLE float heightAt(int row, int column) const;
+
+    void setSampleRegion(const QRect &region);
+    QRect sampleRegion() const;
+    void setSampleStep(int step);
+    int sampleStep() const;
+
+    void setValueRanges(float minX, float maxX, float minZ, float maxZ);
+    void setMinXValue(float min);
+    float minXValue() const;
+    void setMaxXValue(float max);
+    float maxXValue() const;
+    void setMinZValue(float min);
+    float minZValue() const;
+    void setMaxZValue(float max);
+    float maxZValue() const;
+
+Q_SIGNALS:
+    void heightFieldChanged();
+    void sampleRegionChanged(const QRect &region);
+    void sampleStepChanged(int step);
+    void minXValueChanged(float value);
+    void maxXValueChanged(float value);
+    void minZValueChanged(float value);
+    void maxZValueChanged(float value);
+
+protected:
+    QHeightFieldSurfaceDataProxyPrivate *dptr();
+    const QHeightFieldSurfaceDataProxyPrivate *dptrc() const;
+
+private:
+    Q_DISABLE_COPY(QHeightFieldSurfaceDataProxy)
+};
+
+QT_END_NAMESPACE
+
+#endif
@@ -0,0 +1,71 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QtDataVisualization API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+
+#ifndef QHEIGHTFIELDSURFACEDATAPROXY_P_H
+#define QHEIGHTFIELDSURFACEDATAPROXY_P_H
+
+#include "qheightfieldsurfacedataproxy.h"
+#include "qsurfacedataproxy_p.h"
+#include <QtCore/QFile>
+#include <QtCore/QTimer>
+
+QT_BEGIN_NAMESPACE
+
+class QHeightFieldSurfaceDataProxyPrivate : public QSurfaceDataProxyPrivate
+{
+    Q_OBJECT
+
+public:
+    QHeightFieldSurfaceDataProxyPrivate(QHeightFieldSurfaceDataProxy *q);
+    virtual ~QHeightFieldSurfaceDataProxyPrivate();
+
+    bool setHeightFieldFile(const QString &filename, int width, int height,
+                            QHeightFieldSurfaceDataProxy::SampleType type, qint64 offset,
+                            qint64 stride);
+    void clearHeightField();
+    void setSampleRegion(const QRect &region);
+    void setSampleStep(int step);
+    void setValueRanges(float minX, float maxX, float minZ, float maxZ);
+
+    float heightAt(int row, int column) const;
+
+private:
+    QHeightFieldSurfaceDataProxy *qptr();
+    void scheduleResolve();
+    void handlePendingResolve();
+    QRect effectiveSampleRegion() const;
+    int effectiveSampleStep(const QRect &region) const;
+
+    // The file is mapped from the offset of the first sample onwards
+    QFile m_file;
+    const uchar *m_samples;
+    int m_fieldWidth;
+    int m_fieldHeight;
+    QHeightFieldSurfaceDataProxy::SampleType m_sampleType;
+    qint64 m_dataOffset;
+    qint64 m_rowStride;
+    QRect m_sampleRegion;
+    int m_sampleStep;
+    QTimer m_resolveTimer;
+
+    float m_minXValue;
+    float m_maxXValue;
+    float m_minZValue;
+    float m_maxZValue;
+
+    friend class QHeightFieldSurfaceDataProxy;
+};
+
+QT_END_NAMESPACE
+
+#endif
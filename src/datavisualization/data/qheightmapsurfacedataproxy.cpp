@@ -2,6 +2,9 @@
 // SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
 
 #include "qheightmapsurfacedataproxy_p.h"
+#include "utils_p.h"
+
+#include <QtCore/QSharedPointer>
 
 QT_BEGIN_NAMESPACE
 
@@ -9,6 +12,11 @@ QT_BEGIN_NAMESPACE
 const float defaultMinValue = 0.0f;
 const float defaultMaxValue = 10.0f;
 
+// Height maps with at least this many pixels are resolved on a worker thread
+const int backgroundResolvePixelCount = 512 * 512;
+// Minimum number of pixels in a band of rows that is resolved in parallel
+const int resolveBandPixelCount = 16384;
+
 /*!
  * \class QHeightMapSurfaceDataProxy
  * \inmodule QtDataVisualization
@@ -197,11 +205,19 @@ QHeightMapSurfaceDataProxy::~QHeightMapSurfaceDataProxy()
  * Not recommended formats: all mono formats (for example QImage::Format_Mono).
  *
  * The height map is resolved asynchronously. QSurfaceDataProxy::arrayReset() is emitted when the
- * data has been resolved.
+ * data has been resolved. Large height maps are resolved on a worker thread, and the current data
+ * is kept until the new data is ready. Setting a new height map while a resolve is in progress
+ * cancels it.
+ *
+ * The heights read from the pixels are retained, so changing the value ranges or autoScaleY
+ * afterwards only rescales the existing data without reading the image again.
  */
 void QHeightMapSurfaceDataProxy::setHeightMap(const QImage &image)
 {
     dptr()->m_heightMap = image;
+    dptr()->m_heightsDirty = true;
+    // Stop any resolve in progress right away, its result is not needed anymore
+    dptr()->m_resolveGeneration.fetchAndAddRelaxed(1);
 
     // We do resolving asynchronously to make qml onArrayReset handlers actually get the initial reset
     if (!dptr()->m_resolveTimer.isActive())
@@ -416,6 +432,9 @@ const QHeightMapSurfaceDataProxyPrivate *QHeightMapSurfaceDataProxy::dptrc() con
 
 QHeightMapSurfaceDataProxyPrivate::QHeightMapSurfaceDataProxyPrivate(QHeightMapSurfaceDataProxy *q)
     : QSurfaceDataProxyPrivate(q),
+      m_resolving(false),
+      m_heightScale(1.0f / UINT8_MAX),
+      m_heightsDirty(true),
       m_minXValue(defaultMinValue),
       m_maxXValue(defaultMaxValue),
       m_minZValue(defaultMinValue),
@@ -427,10 +446,14 @@ QHeightMapSurfaceDataProxyPrivate::QHeightMapSurfaceDataProxyPrivate(QHeightMapS
     m_resolveTimer.setSingleShot(true);
     QObject::connect(&m_resolveTimer, &QTimer::timeout,
                      this, &QHeightMapSurfaceDataProxyPrivate::handlePendingResolve);
+    m_resolvePool.setMaxThreadCount(1);
 }
 
 QHeightMapSurfaceDataProxyPrivate::~QHeightMapSurfaceDataProxyPrivate()
 {
+    // Cancel any running resolve. Results already posted are dropped with the posted events.
+    m_resolveGeneration.fetchAndAddRelaxed(1);
+    m_resolvePool.waitForDone();
 }
 
 QHeightMapSurfaceDataProxy *QHeightMapSurfaceDataProxyPrivate::qptr()
@@ -634,120 +657,208 @@ void QHeightMapSurfaceDataProxyPrivate::setAutoScaleY(bool enabled)
 
 void QHeightMapSurfaceDataProxyPrivate::handlePendingResolve()
 {
-    QImage heightImage = m_heightMap;
-    int bytesInChannel = 1;
-    float yMul = 1.0f / UINT8_MAX;
+    if (!m_heightsDirty) {
+        // Only the value ranges changed. A resolve in progress applies them when it finishes.
+        if (!m_resolving) {
+            QSurfaceDataArray *dataArray = m_dataArray;
+            if (dataArray->size() != m_heightsSize.height()
+                    || qptr()->columnCount() != m_heightsSize.width()) {
+                dataArray = createArray(m_heightsSize);
+            }
+            fillArray(*dataArray, m_heights, m_heightsSize, m_heightScale, currentParameters());
+            finishResolve(dataArray);
+        }
+        return;
+    }
 
-    bool is16bit = (heightImage.format() == QImage::Format_RGBX64
-                    || heightImage.format() == QImage::Format_RGBA64
-                    || heightImage.format() == QImage::Format_RGBA64_Premultiplied
-                    || heightImage.format() == QImage::Format_Grayscale16);
+    // Starting to resolve a new height map cancels the previous one
+    m_heightsDirty = false;
+    const int generation = m_resolveGeneration.loadRelaxed();
+    const QImage heightMap = m_heightMap;
+    const ResolveParameters parameters = currentParameters();
+
+    const qint64 pixelCount = qint64(heightMap.width()) * heightMap.height();
+    if (pixelCount < backgroundResolvePixelCount) {
+        m_resolving = false;
+        decodeHeights(heightMap, m_heights, m_heightScale, generation);
+        m_heightsSize = heightMap.size();
+        QSurfaceDataArray *dataArray = createArray(m_heightsSize);
+        fillArray(*dataArray, m_heights, m_heightsSize, m_heightScale, parameters);
+        finishResolve(dataArray);
+        return;
+    }
 
-    // Convert to RGB32 to be sure we're reading the right bytes
-    if (is16bit) {
-        if (heightImage.format() != QImage::Format_RGBX64)
-            heightImage = heightImage.convertToFormat(QImage::Format_RGBX64);
+    m_resolving = true;
+    m_resolvePool.start([this, heightMap, parameters, generation]() {
+        QList<float> heights;
+        float heightScale;
+        if (!decodeHeights(heightMap, heights, heightScale, generation))
+            return;
+        // Owned by the posted call, so that the array is freed also if the proxy is destroyed
+        // before the call is delivered
+        QSharedPointer<QSurfaceDataArray> result(createArray(heightMap.size()), deleteDataArray);
+        fillArray(*result, heights, heightMap.size(), heightScale, parameters);
+        QMetaObject::invokeMethod(this, [this, heights, heightScale, result, heightMap,
+                                         parameters, generation]() {
+            if (generation != m_resolveGeneration.loadRelaxed() || m_heightsDirty)
+                return;
+            m_resolving = false;
+            m_heights = heights;
+            m_heightsSize = heightMap.size();
+            m_heightScale = heightScale;
+            QSurfaceDataArray *dataArray = new QSurfaceDataArray;
+            dataArray->swap(*result);
+            // The value ranges may have changed after the resolve was started
+            const ResolveParameters current = currentParameters();
+            if (!(current == parameters))
+                fillArray(*dataArray, m_heights, m_heightsSize, m_heightScale, current);
+            finishResolve(dataArray);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void QHeightMapSurfaceDataProxyPrivate::finishResolve(QSurfaceDataArray *dataArray)
+{
+    qptr()->resetArray(dataArray);
+    emit qptr()->heightMapChanged(m_heightMap);
+}
 
-        bytesInChannel = 2;
-        yMul = 1.0f / UINT16_MAX;
-    } else if (heightImage.format() != QImage::Format_RGB32) {
+QHeightMapSurfaceDataProxyPrivate::ResolveParameters
+QHeightMapSurfaceDataProxyPrivate::currentParameters() const
+{
+    return {m_minXValue, m_maxXValue, m_minZValue, m_maxZValue, m_minYValue, m_maxYValue,
+            m_autoScaleY};
+}
+
+QSurfaceDataArray *QHeightMapSurfaceDataProxyPrivate::createArray(const QSize &size)
+{
+    QSurfaceDataArray *dataArray = new QSurfaceDataArray;
+    dataArray->reserve(size.height());
+    for (int i = 0; i < size.height(); i++)
+        dataArray->append(new QSurfaceDataRow(size.width()));
+    return dataArray;
+}
+
+void QHeightMapSurfaceDataProxyPrivate::deleteDataArray(QSurfaceDataArray *dataArray)
+{
+    for (QSurfaceDataRow *row : std::as_const(*dataArray))
+        delete row;
+    delete dataArray;
+}
+
+bool QHeightMapSurfaceDataProxyPrivate::decodeHeights(const QImage &heightMap,
+                                                      QList<float> &heights, float &heightScale,
+                                                      int generation) const
+{
+    QImage heightImage = heightMap;
+    heightScale = 1.0f / UINT8_MAX;
+
+    // Grayscale, RGB32 and RGBX64 images are read directly, others are converted to the RGB
+    // format of matching depth to be sure we're reading the right bytes
+    switch (heightImage.format()) {
+    case QImage::Format_Grayscale8:
+    case QImage::Format_RGB32:
+        break;
+    case QImage::Format_Grayscale16:
+    case QImage::Format_RGBX64:
+        heightScale = 1.0f / UINT16_MAX;
+        break;
+    case QImage::Format_RGBA64:
+    case QImage::Format_RGBA64_Premultiplied:
+        heightImage = heightImage.convertToFormat(QImage::Format_RGBX64);
+        heightScale = 1.0f / UINT16_MAX;
+        break;
+    default:
         heightImage = heightImage.convertToFormat(QImage::Format_RGB32);
+        break;
     }
 
-    uchar *bits = heightImage.bits();
-
-    int imageHeight = heightImage.height();
-    int imageWidth = heightImage.width();
-    int bitCount = imageWidth * 4 * (imageHeight - 1) * bytesInChannel;
-    int widthBits = imageWidth * 4 * bytesInChannel;
-    float height = 0;
-
-    // Do not recreate array if dimensions have not changed
-    QSurfaceDataArray *dataArray = m_dataArray;
-    if (imageWidth != qptr()->columnCount() || imageHeight != dataArray->size()) {
-        dataArray = new QSurfaceDataArray;
-        dataArray->reserve(imageHeight);
-        for (int i = 0; i < imageHeight; i++) {
-            QSurfaceDataRow *newProxyRow = new QSurfaceDataRow(imageWidth);
-            dataArray->append(newProxyRow);
+    const QImage::Format format = heightImage.format();
+    const int imageHeight = heightImage.height();
+    const int imageWidth = heightImage.width();
+    heights.resize(imageWidth * imageHeight);
+    float *heightData = heights.data();
+
+    Utils::parallelFor(imageHeight, qMax(1, resolveBandPixelCount / qMax(1, imageWidth)),
+                       [&](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            if (generation != m_resolveGeneration.loadRelaxed())
+                return;
+
+            // Images are stored top down, rows are ordered by ascending Z
+            const uchar *line = heightImage.constScanLine(imageHeight - 1 - i);
+            float *height = heightData + i * imageWidth;
+            // The pixel loops are kept free of branches so that they can be vectorized.
+            // RGB heights are averages of the color channels.
+            if (format == QImage::Format_Grayscale8) {
+                for (int j = 0; j < imageWidth; j++)
+                    height[j] = float(line[j]);
+            } else if (format == QImage::Format_Grayscale16) {
+                const quint16 *pixels = reinterpret_cast<const quint16 *>(line);
+                for (int j = 0; j < imageWidth; j++)
+                    height[j] = float(pixels[j]);
+            } else if (format == QImage::Format_RGBX64) {
+                const quint16 *pixels = reinterpret_cast<const quint16 *>(line);
+                for (int j = 0; j < imageWidth; j++) {
+                    const quint16 *pixel = pixels + 4 * j;
+                    height[j] = (float(pixel[0]) + float(pixel[1]) + float(pixel[2])) / 3.0f;
+                }
+            } else {
+                const QRgb *pixels = reinterpret_cast<const QRgb *>(line);
+                for (int j = 0; j < imageWidth; j++) {
+                    height[j] = (float(qRed(pixels[j])) + float(qGreen(pixels[j]))
+                                 + float(qBlue(pixels[j]))) / 3.0f;
+                }
+            }
         }
-    }
-    yMul *= m_maxYValue - m_minYValue;
-    float xMul = (m_maxXValue - m_minXValue) / float(imageWidth - 1);
-    float zMul = (m_maxZValue - m_minZValue) / float(imageHeight - 1);
+    });
+
+    return generation == m_resolveGeneration.loadRelaxed();
+}
+
+void QHeightMapSurfaceDataProxyPrivate::fillArray(QSurfaceDataArray &dataArray,
+                                                  const QList<float> &heights,
+                                                  const QSize &size, float heightScale,
+                                                  const ResolveParameters &parameters)
+{
+    const int imageHeight = size.height();
+    const int imageWidth = size.width();
+    const float yMul = heightScale * (parameters.maxYValue - parameters.minYValue);
+    const float xMul = (parameters.maxXValue - parameters.minXValue) / float(imageWidth - 1);
+    const float zMul = (parameters.maxZValue - parameters.minZValue) / float(imageHeight - 1);
 
     // Last row and column are explicitly set to max values, as relying
     // on multiplier can cause rounding errors, resulting in the value being
     // slightly over the specified maximum, which in turn can lead to it not
     // getting rendered.
-    int lastRow = imageHeight - 1;
-    int lastCol = imageWidth - 1;
-    if (heightImage.isGrayscale()) {
-        // Grayscale, it's enough to read Red byte
-        for (int i = 0; i < imageHeight; i++, bitCount -= widthBits) {
-            QSurfaceDataRow &newRow = *dataArray->at(i);
-            float zVal;
-            if (i == lastRow)
-                zVal = m_maxZValue;
-            else
-                zVal = (float(i) * zMul) + m_minZValue;
-            int j = 0;
-            float yVal = 0;
-            uchar *pixelptr;
-            for (; j < lastCol; j++) {
-                pixelptr  = (uchar *)(bits + bitCount + (j * 4 * bytesInChannel));
-                if (!m_autoScaleY)
-                    yVal = *pixelptr;
-                else
-                    yVal = float(*pixelptr) * yMul + m_minYValue;
-                newRow[j].setPosition(QVector3D((float(j) * xMul) + m_minXValue,
-                                                yVal,
-                                                zVal));
-            }
-            newRow[j].setPosition(QVector3D(m_maxXValue,
-                                            yVal,
-                                            zVal));
-        }
-    } else {
-        // Not grayscale, we'll need to calculate height from RGB
-        for (int i = 0; i < imageHeight; i++, bitCount -= widthBits) {
-            QSurfaceDataRow &newRow = *dataArray->at(i);
+    const int lastRow = imageHeight - 1;
+    const int lastCol = imageWidth - 1;
+    Utils::parallelFor(imageHeight, qMax(1, resolveBandPixelCount / qMax(1, imageWidth)),
+                       [&](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            const float *height = heights.constData() + i * imageWidth;
+            QSurfaceDataRow &newRow = *dataArray.at(i);
             float zVal;
             if (i == lastRow)
-                zVal = m_maxZValue;
+                zVal = parameters.maxZValue;
             else
-                zVal = (float(i) * zMul) + m_minZValue;
+                zVal = (float(i) * zMul) + parameters.minZValue;
             int j = 0;
             float yVal = 0;
             for (; j < lastCol; j++) {
-                int nextpixel = j * 4 * bytesInChannel;
-                uchar *pixelptr = (uchar *)(bits + bitCount + nextpixel);
-                if (is16bit) {
-                    height = float(*((ushort *)pixelptr))
-                        + float(*(((ushort *)pixelptr) + 1))
-                        + float(*(((ushort *)pixelptr) + 2));
-                } else {
-                    height = (float(*pixelptr)
-                            + float(*(pixelptr + 1))
-                            + float(*(pixelptr + 2)));
-                }
-                if (!m_autoScaleY)
-                    yVal = height / 3.0f;
+                if (!parameters.autoScaleY)
+                    yVal = height[j];
                 else
-                    yVal = (height / 3.0f * yMul) + m_minYValue;
-
-                newRow[j].setPosition(QVector3D((float(j) * xMul) + m_minXValue,
+                    yVal = height[j] * yMul + parameters.minYValue;
+                newRow[j].setPosition(QVector3D((float(j) * xMul) + parameters.minXValue,
                                                 yVal,
                                                 zVal));
             }
-            newRow[j].setPosition(QVector3D(m_maxXValue,
+            newRow[j].setPosition(QVector3D(parameters.maxXValue,
                                             yVal,
                                             zVal));
         }
-    }
-
-    qptr()->resetArray(dataArray);
-    emit qptr()->heightMapChanged(m_heightMap);
+    });
 }
 
 QT_END_NAMESPACE
@@ -16,6 +16,8 @@
 
 #include "qheightmapsurfacedataproxy.h"
 #include "qsurfacedataproxy_p.h"
+#include <QtCore/QAtomicInt>
+#include <QtCore/QThreadPool>
 #include <QtCore/QTimer>
 
 QT_BEGIN_NAMESPACE
@@ -37,12 +39,54 @@ public:
     void setMaxYValue(float max);
     void setAutoScaleY(bool enabled);
 private:
+    // Copy of the state the data depends on besides the heights, so that the data can be filled
+    // on a worker thread
+    struct ResolveParameters
+    {
+        float minXValue;
+        float maxXValue;
+        float minZValue;
+        float maxZValue;
+        float minYValue;
+        float maxYValue;
+        bool autoScaleY;
+
+        bool operator==(const ResolveParameters &other) const
+        {
+            return minXValue == other.minXValue && maxXValue == other.maxXValue
+                    && minZValue == other.minZValue && maxZValue == other.maxZValue
+                    && minYValue == other.minYValue && maxYValue == other.maxYValue
+                    && autoScaleY == other.autoScaleY;
+        }
+    };
+
     QHeightMapSurfaceDataProxy *qptr();
     void handlePendingResolve();
+    void finishResolve(QSurfaceDataArray *dataArray);
+    ResolveParameters currentParameters() const;
+    static QSurfaceDataArray *createArray(const QSize &size);
+    static void deleteDataArray(QSurfaceDataArray *dataArray);
+    // Thread safe. Returns false if a newer height map has been set meanwhile.
+    bool decodeHeights(const QImage &heightMap, QList<float> &heights, float &heightScale,
+                       int generation) const;
+    static void fillArray(QSurfaceDataArray &dataArray, const QList<float> &heights,
+                          const QSize &size, float heightScale,
+                          const ResolveParameters &parameters);
 
     QImage m_heightMap;
     QString m_heightMapFile;
     QTimer m_resolveTimer;
+    // Large height maps are resolved one at a time on a thread of their own
+    QThreadPool m_resolvePool;
+    // Bumped whenever the height map is set, so that resolves of older height maps are dropped
+    QAtomicInt m_resolveGeneration;
+    bool m_resolving;
+    // Heights read from the pixels of the height map, in pixel value units. Value range
+    // changes only refill the data from these.
+    QList<float> m_heights;
+    QSize m_heightsSize;
+    float m_heightScale;
+    bool m_heightsDirty;
 
     float m_minXValue;
     float m_maxXValue;
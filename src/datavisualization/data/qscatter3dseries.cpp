@@ -98,6 +98,65 @@ QT_BEGIN_NAMESPACE
  * The preset default is \c 0.0.
  */
 
+/*!
+ * \qmlproperty bool Scatter3DSeries::levelOfDetail
+ * \since 6.9
+ *
+ * Defines whether the series is drawn with screen-space level of detail.
+ * When enabled, items that are close to each other on screen are drawn as
+ * a single representative item, so that the number of drawn items depends on
+ * the projected size of the data rather than the total item count.
+ * The preset default is \c false.
+ *
+ * Level of detail has no effect on series using a mesh other than
+ * \l{Abstract3DSeries::Mesh}{Abstract3DSeries.MeshPoint} when the graph uses
+ * static optimization and instanced rendering is not supported.
+ *
+ * \sa levelOfDetailThreshold, levelOfDetailBudget
+ */
+
+/*!
+ * \qmlproperty real Scatter3DSeries::levelOfDetailThreshold
+ * \since 6.9
+ *
+ * The projected size in pixels under which a group of items is drawn as
+ * a single item when levelOfDetail is enabled. The value must be positive.
+ * The preset default is \c 1.0.
+ */
+
+/*!
+ * \qmlproperty int Scatter3DSeries::levelOfDetailBudget
+ * \since 6.9
+ *
+ * The maximum number of items drawn per frame when levelOfDetail is
+ * enabled. The groups of items with the largest projected size are refined
+ * first. Setting the budget to \c 0 removes the limit.
+ * The preset default is \c 0.
+ */
+
+/*!
+ * \qmlproperty bool Scatter3DSeries::densityRendering
+ * \since 6.9
+ *
+ * Defines whether the series is drawn as a density volume instead of items.
+ * When enabled, the items are counted into a grid of densityResolution cells
+ * along each axis, and each non-empty cell is drawn with a color taken from
+ * the base gradient of the series according to the number of items in it.
+ * Items of a series drawn as density cannot be selected by clicking.
+ * The preset default is \c false.
+ *
+ * \sa densityResolution
+ */
+
+/*!
+ * \qmlproperty int Scatter3DSeries::densityResolution
+ * \since 6.9
+ *
+ * The number of density cells along each axis when densityRendering is
+ * enabled. The value must be between \c 1 and \c 128.
+ * The preset default is \c 64.
+ */
+
 /*!
  * \qmlproperty int Scatter3DSeries::invalidSelectionIndex
  * A constant property providing an invalid index for selection. This index is
@@ -223,6 +282,150 @@ float QScatter3DSeries::itemSize() const
     return dptrc()->m_itemSize;
 }
 
+/*!
+ * \property QScatter3DSeries::levelOfDetail
+ * \since 6.9
+ *
+ * \brief Whether the series is drawn with screen-space level of detail.
+ *
+ * When enabled, the series items are grouped hierarchically by their position,
+ * and groups whose projected size is below levelOfDetailThreshold pixels are
+ * drawn as a single representative item. Groups are refined progressively as
+ * they grow on screen, for example when the camera is zoomed in.
+ *
+ * Level of detail has no effect on series using a mesh other than
+ * QAbstract3DSeries::MeshPoint when the graph uses
+ * QAbstract3DGraph::OptimizationStatic and instanced rendering is not
+ * supported.
+ *
+ * The preset default is \c false.
+ *
+ * \sa levelOfDetailThreshold, levelOfDetailBudget
+ */
+void QScatter3DSeries::setLevelOfDetail(bool enable)
+{
+    if (enable != dptrc()->m_levelOfDetail) {
+        dptr()->setLevelOfDetail(enable);
+        emit levelOfDetailChanged(enable);
+    }
+}
+
+bool QScatter3DSeries::isLevelOfDetail() const
+{
+    return dptrc()->m_levelOfDetail;
+}
+
+/*!
+ * \property QScatter3DSeries::levelOfDetailThreshold
+ * \since 6.9
+ *
+ * \brief The projected size in pixels under which a group of items is drawn
+ * as a single item.
+ *
+ * Only has effect when levelOfDetail is enabled. The value must be positive.
+ *
+ * The preset default is \c 1.0f.
+ */
+void QScatter3DSeries::setLevelOfDetailThreshold(float pixels)
+{
+    if (pixels <= 0.0f) {
+        qWarning("Invalid threshold. Level of detail threshold must be positive.");
+    } else if (pixels != dptrc()->m_levelOfDetailThreshold) {
+        dptr()->setLevelOfDetailThreshold(pixels);
+        emit levelOfDetailThresholdChanged(pixels);
+    }
+}
+
+float QScatter3DSeries::levelOfDetailThreshold() const
+{
+    return dptrc()->m_levelOfDetailThreshold;
+}
+
+/*!
+ * \property QScatter3DSeries::levelOfDetailBudget
+ * \since 6.9
+ *
+ * \brief The maximum number of items drawn per frame with level of detail.
+ *
+ * When the budget would be exceeded, the groups of items with the largest
+ * projected size are refined first. Setting the budget to \c 0 removes the
+ * limit. Only has effect when levelOfDetail is enabled.
+ *
+ * The preset default is \c 0.
+ */
+void QScatter3DSeries::setLevelOfDetailBudget(int itemCount)
+{
+    if (itemCount < 0) {
+        qWarning("Invalid budget. Level of detail budget cannot be negative.");
+    } else if (itemCount != dptrc()->m_levelOfDetailBudget) {
+        dptr()->setLevelOfDetailBudget(itemCount);
+        emit levelOfDetailBudgetChanged(itemCount);
+    }
+}
+
+int QScatter3DSeries::levelOfDetailBudget() const
+{
+    return dptrc()->m_levelOfDetailBudget;
+}
+
+/*!
+ * \property QScatter3DSeries::densityRendering
+ * \since 6.9
+ *
+ * \brief Whether the series is drawn as a density volume instead of items.
+ *
+ * When enabled, the items are counted into a grid of densityResolution cells
+ * along each axis, and each non-empty cell is drawn with a color taken from
+ * the base gradient of the series according to the number of items in it.
+ * The gradient is used regardless of colorStyle. This gives a readable view
+ * of very large data sets at a fraction of the cost of drawing every item.
+ *
+ * Items of a series drawn as density cannot be selected by clicking, and
+ * the series does not cast shadows.
+ *
+ * The preset default is \c false.
+ *
+ * \sa densityResolution
+ */
+void QScatter3DSeries::setDensityRendering(bool enable)
+{
+    if (enable != dptrc()->m_densityRendering) {
+        dptr()->setDensityRendering(enable);
+        emit densityRenderingChanged(enable);
+    }
+}
+
+bool QScatter3DSeries::isDensityRendering() const
+{
+    return dptrc()->m_densityRendering;
+}
+
+/*!
+ * \property QScatter3DSeries::densityResolution
+ * \since 6.9
+ *
+ * \brief The number of density cells along each axis.
+ *
+ * Only has effect when densityRendering is enabled. The value must be between
+ * \c 1 and \c 256.
+ *
+ * The preset default is \c 64.
+ */
+void QScatter3DSeries::setDensityResolution(int resolution)
+{
+    if (resolution < 1 || resolution > 128) {
+        qWarning("Invalid resolution. Density resolution must be between 1 and 128.");
+    } else if (resolution != dptrc()->m_densityResolution) {
+        dptr()->setDensityResolution(resolution);
+        emit densityResolutionChanged(resolution);
+    }
+}
+
+int QScatter3DSeries::densityResolution() const
+{
+    return dptrc()->m_densityResolution;
+}
+
 /*!
  * Returns an invalid index for selection. This index is set to the selectedItem
  * property to clear the selection from this series.
@@ -255,7 +458,12 @@ const QScatter3DSeriesPrivate *QScatter3DSeries::dptrc() const
 QScatter3DSeriesPrivate::QScatter3DSeriesPrivate(QScatter3DSeries *q)
     : QAbstract3DSeriesPrivate(q, QAbstract3DSeries::SeriesTypeScatter),
       m_selectedItem(Scatter3DController::invalidSelectionIndex()),
-      m_itemSize(0.0f)
+      m_itemSize(0.0f),
+      m_levelOfDetail(false),
+      m_levelOfDetailThreshold(1.0f),
+      m_levelOfDetailBudget(0),
+      m_densityRendering(false),
+      m_densityResolution(64)
 {
     m_itemLabelFormat = QStringLiteral("@xLabel, @yLabel, @zLabel");
     m_mesh = QAbstract3DSeries::MeshSphere;
@@ -324,7 +532,7 @@ void QScatter3DSeriesPrivate::createItemLabel()
     QValue3DAxis *axisX = static_cast<QValue3DAxis *>(m_controller->axisX());
     QValue3DAxis *axisY = static_cast<QValue3DAxis *>(m_controller->axisY());
     QValue3DAxis *axisZ = static_cast<QValue3DAxis *>(m_controller->axisZ());
-    QVector3D selectedPosition = qptr()->dataProxy()->itemAt(m_selectedItem)->position();
+    QVector3D selectedPosition = qptr()->dataProxy()->item(m_selectedItem).position();
 
     m_itemLabel = m_itemLabelFormat;
 
@@ -366,4 +574,42 @@ void QScatter3DSeriesPrivate::setItemSize(float size)
         m_controller->markSeriesVisualsDirty();
 }
 
+void QScatter3DSeriesPrivate::setLevelOfDetail(bool enable)
+{
+    m_levelOfDetail = enable;
+    if (m_controller)
+        m_controller->markSeriesVisualsDirty();
+}
+
+void QScatter3DSeriesPrivate::setLevelOfDetailThreshold(float pixels)
+{
+    m_levelOfDetailThreshold = pixels;
+    if (m_controller)
+        m_controller->markSeriesVisualsDirty();
+}
+
+void QScatter3DSeriesPrivate::setLevelOfDetailBudget(int itemCount)
+{
+    m_levelOfDetailBudget = itemCount;
+    if (m_controller)
+        m_controller->markSeriesVisualsDirty();
+}
+
+void QScatter3DSeriesPrivate::setDensityRendering(bool enable)
+{
+    m_densityRendering = enable;
+    if (m_controller) {
+        m_controller->markSeriesVisualsDirty();
+        // Item buffers are not kept up to date while drawing density
+        m_controller->markDataDirty();
+    }
+}
+
+void QScatter3DSeriesPrivate::setDensityResolution(int resolution)
+{
+    m_densityResolution = resolution;
+    if (m_controller)
+        m_controller->markSeriesVisualsDirty();
+}
+
 QT_END_NAMESPACE
@@ -17,6 +17,11 @@ class Q_DATAVISUALIZATION_EXPORT QScatter3DSeries : public QAbstract3DSeries
     Q_PROPERTY(QScatterDataProxy *dataProxy READ dataProxy WRITE setDataProxy NOTIFY dataProxyChanged)
     Q_PROPERTY(int selectedItem READ selectedItem WRITE setSelectedItem NOTIFY selectedItemChanged)
     Q_PROPERTY(float itemSize READ itemSize WRITE setItemSize NOTIFY itemSizeChanged)
+    Q_PROPERTY(bool levelOfDetail READ isLevelOfDetail WRITE setLevelOfDetail NOTIFY levelOfDetailChanged REVISION(6, 9))
+    Q_PROPERTY(float levelOfDetailThreshold READ levelOfDetailThreshold WRITE setLevelOfDetailThreshold NOTIFY levelOfDetailThresholdChanged REVISION(6, 9))
+    Q_PROPERTY(int levelOfDetailBudget READ levelOfDetailBudget WRITE setLevelOfDetailBudget NOTIFY levelOfDetailBudgetChanged REVISION(6, 9))
+    Q_PROPERTY(bool densityRendering READ isDensityRendering WRITE setDensityRendering NOTIFY densityRenderingChanged REVISION(6, 9))
+    Q_PROPERTY(int densityResolution READ densityResolution WRITE setDensityResolution NOTIFY densityResolutionChanged REVISION(6, 9))
 
 public:
     explicit QScatter3DSeries(QObject *parent = nullptr);
@@ -33,10 +38,27 @@ public:
     void setItemSize(float size);
     float itemSize() const;
 
+    void setLevelOfDetail(bool enable);
+    bool isLevelOfDetail() const;
+    void setLevelOfDetailThreshold(float pixels);
+    float levelOfDetailThreshold() const;
+    void setLevelOfDetailBudget(int itemCount);
+    int levelOfDetailBudget() const;
+
+    void setDensityRendering(bool enable);
+    bool isDensityRendering() const;
+    void setDensityResolution(int resolution);
+    int densityResolution() const;
+
 Q_SIGNALS:
     void dataProxyChanged(QScatterDataProxy *proxy);
     void selectedItemChanged(int index);
     void itemSizeChanged(float size);
+    Q_REVISION(6, 9) void levelOfDetailChanged(bool enabled);
+    Q_REVISION(6, 9) void levelOfDetailThresholdChanged(float pixels);
+    Q_REVISION(6, 9) void levelOfDetailBudgetChanged(int itemCount);
+    Q_REVISION(6, 9) void densityRenderingChanged(bool enabled);
+    Q_REVISION(6, 9) void densityResolutionChanged(int resolution);
 
 protected:
     explicit QScatter3DSeries(QScatter3DSeriesPrivate *d, QObject *parent = nullptr);
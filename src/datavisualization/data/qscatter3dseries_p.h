@@ -32,11 +32,21 @@ public:
 
     void setSelectedItem(int index);
     void setItemSize(float size);
+    void setLevelOfDetail(bool enable);
+    void setLevelOfDetailThreshold(float pixels);
+    void setLevelOfDetailBudget(int itemCount);
+    void setDensityRendering(bool enable);
+    void setDensityResolution(int resolution);
 
 private:
     QScatter3DSeries *qptr();
     int m_selectedItem;
     float m_itemSize;
+    bool m_levelOfDetail;
+    float m_levelOfDetailThreshold;
+    int m_levelOfDetailBudget;
+    bool m_densityRendering;
+    int m_densityResolution;
 
 private:
     friend class QScatter3DSeries;
@@ -5,8 +5,12 @@
 #include "qscatter3dseries_p.h"
 #include "qabstract3daxis_p.h"
 
+#include <algorithm>
+
 QT_BEGIN_NAMESPACE
 
+const int limitChunkSize = 1024;
+
 /*!
  * \class QScatterDataProxy
  * \inmodule QtDataVisualization
@@ -20,6 +24,18 @@ QT_BEGIN_NAMESPACE
  * QtDataVisualization::QScatterDataArray and QScatterDataItem objects passed to
  * it.
  *
+ * For large data sets, the proxy can also use externally owned arrays of
+ * coordinate values directly, without copying them into a QScatterDataArray.
+ * See resetArray(int, const float *, const float *, const float *, const QQuaternion *).
+ *
+ * For streaming data, the proxy can be used as a ring buffer of fixed capacity,
+ * where added items overwrite the oldest ones once the array is full.
+ * See ringCapacity.
+ *
+ * Items can also have individual colors and sizes, which are used instead of
+ * the series color and item size. This allows drawing differently colored or
+ * sized items as a single series. See setItemColors() and setItemSizes().
+ *
  * \sa {Qt Data Visualization Data Handling}
  */
 
@@ -57,12 +73,35 @@ QT_BEGIN_NAMESPACE
  * The series this proxy is attached to.
  */
 
+/*!
+ * \qmlproperty int ScatterDataProxy::ringCapacity
+ * \since 6.9
+ *
+ * The maximum number of items in ring buffer mode. Once the array holds this
+ * many items, added items overwrite the oldest items instead of growing the
+ * array. Defaults to \c 0, which disables the ring buffer mode.
+ *
+ * \sa ringHead
+ */
+
+/*!
+ * \qmlproperty int ScatterDataProxy::ringHead
+ * \since 6.9
+ * \readonly
+ *
+ * The index of the oldest item in ring buffer mode, which is the next item to
+ * be overwritten when items are added to a full array.
+ *
+ * \sa ringCapacity
+ */
+
 /*!
  * Constructs QScatterDataProxy with the given \a parent.
  */
 QScatterDataProxy::QScatterDataProxy(QObject *parent) :
     QAbstractDataProxy(new QScatterDataProxyPrivate(this), parent)
 {
+    dptr()->connectLimitTracking();
 }
 
 /*!
@@ -71,6 +110,7 @@ QScatterDataProxy::QScatterDataProxy(QObject *parent) :
 QScatterDataProxy::QScatterDataProxy(QScatterDataProxyPrivate *d, QObject *parent) :
     QAbstractDataProxy(d, parent)
 {
+    dptr()->connectLimitTracking();
 }
 
 /*!
@@ -99,13 +139,60 @@ QScatter3DSeries *QScatterDataProxy::series() const
  */
 void QScatterDataProxy::resetArray(QScatterDataArray *newArray)
 {
-    if (dptr()->m_dataArray != newArray)
+    if (dptr()->m_dataArray != newArray || hasExternalArray())
         dptr()->resetArray(newArray);
+    else
+        dptr()->setRingHead(0);
 
     emit arrayReset();
     emit itemCountChanged(itemCount());
 }
 
+/*!
+ * \since 6.9
+ *
+ * Makes the proxy use externally owned arrays of coordinate values instead of
+ * its own data array. Item \c i is positioned at \a xValues[i], \a yValues[i],
+ * and \a zValues[i], and rotated by \a rotations[i], if \a rotations is not
+ * null. Each array must contain at least \a itemCount values. The current
+ * data array is cleared.
+ *
+ * The values are not copied. The caller keeps the ownership of the arrays and
+ * must keep them valid and unchanged until the proxy is reset again or
+ * destroyed. To update the graph after changing values in the arrays, emit
+ * itemsChanged() for the changed items or arrayReset() if most of them changed.
+ *
+ * While the external arrays are in use, there are no QScatterDataItem objects
+ * to point to, so array() and itemAt() return null. Use item() to read items
+ * by value instead. Functions that modify items,
+ * such as setItem() or addItems(), first copy the external values into the
+ * proxy's own data array, after which the external arrays are no longer used.
+ *
+ * If \a itemCount is zero or any of the coordinate arrays is null, the proxy
+ * is reset to an empty data array.
+ *
+ * \sa hasExternalArray()
+ */
+void QScatterDataProxy::resetArray(int itemCount, const float *xValues, const float *yValues,
+                                   const float *zValues, const QQuaternion *rotations)
+{
+    dptr()->resetArray(itemCount, xValues, yValues, zValues, rotations);
+
+    emit arrayReset();
+    emit itemCountChanged(this->itemCount());
+}
+
+/*!
+ * \since 6.9
+ *
+ * Returns \c true if the proxy uses externally owned coordinate arrays set with
+ * resetArray(int, const float *, const float *, const float *, const QQuaternion *).
+ */
+bool QScatterDataProxy::hasExternalArray() const
+{
+    return dptrc()->hasExternalArray();
+}
+
 /*!
  * Replaces the item at the position \a index with the item \a item.
  */
@@ -126,12 +213,18 @@ void QScatterDataProxy::setItems(int index, const QScatterDataArray &items)
 }
 
 /*!
- * Adds the item \a item to the end of the array.
+ * Adds the item \a item to the end of the array. In ring buffer mode, the item
+ * replaces the oldest item if the array is full.
  *
  * Returns the index of the added item.
+ *
+ * \sa ringCapacity
  */
 int QScatterDataProxy::addItem(const QScatterDataItem &item)
 {
+    if (ringCapacity())
+        return dptr()->addRingItems(&item, 1);
+
     int addIndex = dptr()->addItem(item);
     emit itemsAdded(addIndex, 1);
     emit itemCountChanged(itemCount());
@@ -139,12 +232,19 @@ int QScatterDataProxy::addItem(const QScatterDataItem &item)
 }
 
 /*!
- * Adds the items specified by \a items to the end of the array.
+ * Adds the items specified by \a items to the end of the array. In ring buffer
+ * mode, the items that do not fit replace the oldest items, starting at
+ * ringHead.
  *
  * Returns the index of the first added item.
+ *
+ * \sa ringCapacity
  */
 int QScatterDataProxy::addItems(const QScatterDataArray &items)
 {
+    if (ringCapacity())
+        return dptr()->addRingItems(items.constData(), items.size());
+
     int addIndex = dptr()->addItems(items);
     emit itemsAdded(addIndex, items.size());
     emit itemCountChanged(itemCount());
@@ -180,7 +280,7 @@ void QScatterDataProxy::insertItems(int index, const QScatterDataArray &items)
  */
 void QScatterDataProxy::removeItems(int index, int removeCount)
 {
-    if (index >= dptr()->m_dataArray->size())
+    if (index >= itemCount())
         return;
 
     dptr()->removeItems(index, removeCount);
@@ -188,6 +288,185 @@ void QScatterDataProxy::removeItems(int index, int removeCount)
     emit itemCountChanged(itemCount());
 }
 
+/*!
+ * \property QScatterDataProxy::ringCapacity
+ * \since 6.9
+ *
+ * \brief The maximum number of items in ring buffer mode.
+ *
+ * Once the array holds this many items, addItem() and addItems() overwrite
+ * the oldest items, starting at ringHead, instead of growing the array. The
+ * overwritten items are reported with the itemsChanged() signal, so the graph
+ * only updates the changed items instead of reloading the whole series.
+ *
+ * Setting the capacity reorders the array from the oldest item to the newest
+ * and removes the oldest items that do not fit. Inserting, removing, or
+ * resetting items resets ringHead to zero, but does not limit the item count.
+ *
+ * Defaults to \c 0, which disables the ring buffer mode.
+ *
+ * \sa ringHead
+ */
+void QScatterDataProxy::setRingCapacity(int capacity)
+{
+    if (capacity < 0) {
+        qWarning("Invalid capacity. Ring buffer capacity cannot be negative.");
+        return;
+    }
+    if (capacity != ringCapacity()) {
+        dptr()->setRingCapacity(capacity);
+        emit ringCapacityChanged(capacity);
+    }
+}
+
+int QScatterDataProxy::ringCapacity() const
+{
+    return dptrc()->m_ringCapacity;
+}
+
+/*!
+ * \property QScatterDataProxy::ringHead
+ * \since 6.9
+ *
+ * \brief The index of the oldest item in ring buffer mode.
+ *
+ * This is the next item to be overwritten when items are added to a full
+ * array. The items from the head to the end of the array, followed by the
+ * items from the start of the array to the head, are in the order they were
+ * added.
+ *
+ * \sa ringCapacity
+ */
+int QScatterDataProxy::ringHead() const
+{
+    return dptrc()->m_ringHead;
+}
+
+/*!
+ * \since 6.9
+ *
+ * Sets the colors of the items to \a colors. The color at index \c i is used
+ * for the item at the same index instead of the base color of the series.
+ * Items beyond the end of the list and items with a fully transparent color
+ * use the series color. An empty list removes the item colors.
+ *
+ * Item colors are used when the color style of the series is
+ * Q3DTheme::ColorStyleUniform. Gradient color styles ignore them.
+ *
+ * Inserting and removing items keeps the colors aligned with the items. In
+ * ring buffer mode, items that overwrite the oldest items use the series color
+ * until their color is set. Resetting the array does not change the colors.
+ *
+ * \sa itemColors(), setItemColor(), setItemSizes()
+ */
+void QScatterDataProxy::setItemColors(const QList<QRgb> &colors)
+{
+    // Items covered by either the old or the new colors change
+    const int changedCount = qMin(itemCount(),
+                                  int(qMax(colors.size(), dptrc()->m_itemColors.size())));
+    dptr()->setItemColors(colors);
+    if (changedCount)
+        emit itemsChanged(0, changedCount);
+}
+
+/*!
+ * \since 6.9
+ *
+ * Returns the colors of the items.
+ *
+ * \sa setItemColors()
+ */
+QList<QRgb> QScatterDataProxy::itemColors() const
+{
+    return dptrc()->m_itemColors;
+}
+
+/*!
+ * \since 6.9
+ *
+ * Sets the color of the item at the position \a index to \a color. A fully
+ * transparent color makes the item use the series color.
+ *
+ * \sa setItemColors()
+ */
+void QScatterDataProxy::setItemColor(int index, QRgb color)
+{
+    if (index < 0 || index >= itemCount()) {
+        qWarning("Invalid index. Item color index is out of range.");
+        return;
+    }
+    dptr()->setItemColor(index, color);
+    emit itemsChanged(index, 1);
+}
+
+/*!
+ * \since 6.9
+ *
+ * Sets the sizes of the items to \a sizes. The size at index \c i is used for
+ * the item at the same index instead of QScatter3DSeries::itemSize. Items
+ * beyond the end of the list and items with zero size use the item size of the
+ * series. An empty list removes the item sizes.
+ *
+ * The sizes use the same scale as QScatter3DSeries::itemSize and must be
+ * between \c 0.0f and \c 1.0f. If any of them is not, the sizes are not
+ * changed.
+ *
+ * Inserting and removing items keeps the sizes aligned with the items. In ring
+ * buffer mode, items that overwrite the oldest items use the series item size
+ * until their size is set. Resetting the array does not change the sizes.
+ *
+ * \sa itemSizes(), setItemSize(), setItemColors()
+ */
+void QScatterDataProxy::setItemSizes(const QList<float> &sizes)
+{
+    for (float size : sizes) {
+        if (size < 0.0f || size > 1.0f) {
+            qWarning("Invalid size. Valid range for item size is 0.0f...1.0f");
+            return;
+        }
+    }
+    const int changedCount = qMin(itemCount(),
+                                  int(qMax(sizes.size(), dptrc()->m_itemSizes.size())));
+    dptr()->setItemSizes(sizes);
+    if (changedCount)
+        emit itemsChanged(0, changedCount);
+}
+
+/*!
+ * \since 6.9
+ *
+ * Returns the sizes of the items.
+ *
+ * \sa setItemSizes()
+ */
+QList<float> QScatterDataProxy::itemSizes() const
+{
+    return dptrc()->m_itemSizes;
+}
+
+/*!
+ * \since 6.9
+ *
+ * Sets the size of the item at the position \a index to \a size. The size
+ * must be between \c 0.0f and \c 1.0f. Zero size makes the item use the item
+ * size of the series.
+ *
+ * \sa setItemSizes()
+ */
+void QScatterDataProxy::setItemSize(int index, float size)
+{
+    if (index < 0 || index >= itemCount()) {
+        qWarning("Invalid index. Item size index is out of range.");
+        return;
+    }
+    if (size < 0.0f || size > 1.0f) {
+        qWarning("Invalid size. Valid range for item size is 0.0f...1.0f");
+        return;
+    }
+    dptr()->setItemSize(index, size);
+    emit itemsChanged(index, 1);
+}
+
 /*!
  * \property QScatterDataProxy::itemCount
  *
@@ -195,26 +474,51 @@ void QScatterDataProxy::removeItems(int index, int removeCount)
  */
 int QScatterDataProxy::itemCount() const
 {
-    return dptrc()->m_dataArray->size();
+    return dptrc()->itemCount();
 }
 
 /*!
- * Returns the pointer to the data array.
+ * Returns the pointer to the data array. Returns null if the proxy uses
+ * external coordinate arrays.
+ *
+ * \sa hasExternalArray()
  */
 const QScatterDataArray *QScatterDataProxy::array() const
 {
+    if (hasExternalArray()) {
+        qWarning("Data array is not available while the proxy uses external arrays.");
+        return nullptr;
+    }
     return dptrc()->m_dataArray;
 }
 
 /*!
  * Returns the pointer to the item at the index \a index. It is guaranteed to be
- * valid only until the next call that modifies data.
+ * valid only until the next call that modifies data. Returns null if the proxy
+ * uses external coordinate arrays.
+ *
+ * \sa item(), hasExternalArray()
  */
 const QScatterDataItem *QScatterDataProxy::itemAt(int index) const
 {
+    if (hasExternalArray()) {
+        qWarning("Item pointers are not available while the proxy uses external arrays.");
+        return nullptr;
+    }
     return &dptrc()->m_dataArray->at(index);
 }
 
+/*!
+ * \since 6.9
+ *
+ * Returns a copy of the item at the index \a index. Unlike itemAt(), this also
+ * works when the proxy uses external coordinate arrays.
+ */
+QScatterDataItem QScatterDataProxy::item(int index) const
+{
+    return dptrc()->item(index);
+}
+
 /*!
  * \internal
  */
@@ -280,7 +584,14 @@ const QScatterDataProxyPrivate *QScatterDataProxy::dptrc() const
 
 QScatterDataProxyPrivate::QScatterDataProxyPrivate(QScatterDataProxy *q)
     : QAbstractDataProxyPrivate(q, QAbstractDataProxy::DataTypeScatter),
-      m_dataArray(new QScatterDataArray)
+      m_dataArray(new QScatterDataArray),
+      m_externalCount(0),
+      m_externalX(0),
+      m_externalY(0),
+      m_externalZ(0),
+      m_externalRotations(0),
+      m_ringCapacity(0),
+      m_ringHead(0)
 {
 }
 
@@ -292,6 +603,9 @@ QScatterDataProxyPrivate::~QScatterDataProxyPrivate()
 
 void QScatterDataProxyPrivate::resetArray(QScatterDataArray *newArray)
 {
+    clearExternalArray();
+    setRingHead(0);
+
     if (!newArray)
         newArray = new QScatterDataArray;
 
@@ -302,14 +616,53 @@ void QScatterDataProxyPrivate::resetArray(QScatterDataArray *newArray)
     }
 }
 
+void QScatterDataProxyPrivate::resetArray(int itemCount, const float *xValues,
+                                          const float *yValues, const float *zValues,
+                                          const QQuaternion *rotations)
+{
+    resetArray(nullptr);
+
+    if (itemCount <= 0 || !xValues || !yValues || !zValues)
+        return;
+
+    m_externalCount = itemCount;
+    m_externalX = xValues;
+    m_externalY = yValues;
+    m_externalZ = zValues;
+    m_externalRotations = rotations;
+}
+
+void QScatterDataProxyPrivate::clearExternalArray()
+{
+    m_externalCount = 0;
+    m_externalX = 0;
+    m_externalY = 0;
+    m_externalZ = 0;
+    m_externalRotations = 0;
+}
+
+// Copies the external values to the data array, so that they can be modified
+void QScatterDataProxyPrivate::detachExternalArray()
+{
+    if (!m_externalX)
+        return;
+
+    QScatterDataArray *newArray = new QScatterDataArray(m_externalCount);
+    for (int i = 0; i < m_externalCount; i++)
+        (*newArray)[i] = item(i);
+    resetArray(newArray);
+}
+
 void QScatterDataProxyPrivate::setItem(int index, const QScatterDataItem &item)
 {
+    detachExternalArray();
     Q_ASSERT(index >= 0 && index < m_dataArray->size());
     (*m_dataArray)[index] = item;
 }
 
 void QScatterDataProxyPrivate::setItems(int index, const QScatterDataArray &items)
 {
+    detachExternalArray();
     Q_ASSERT(index >= 0 && (index + items.size()) <= m_dataArray->size());
     for (int i = 0; i < items.size(); i++)
         (*m_dataArray)[index++] = items[i];
@@ -317,6 +670,7 @@ void QScatterDataProxyPrivate::setItems(int index, const QScatterDataArray &item
 
 int QScatterDataProxyPrivate::addItem(const QScatterDataItem &item)
 {
+    detachExternalArray();
     int currentSize = m_dataArray->size();
     m_dataArray->append(item);
     return currentSize;
@@ -324,6 +678,7 @@ int QScatterDataProxyPrivate::addItem(const QScatterDataItem &item)
 
 int QScatterDataProxyPrivate::addItems(const QScatterDataArray &items)
 {
+    detachExternalArray();
     int currentSize = m_dataArray->size();
     (*m_dataArray) += items;
     return currentSize;
@@ -331,78 +686,227 @@ int QScatterDataProxyPrivate::addItems(const QScatterDataArray &items)
 
 void QScatterDataProxyPrivate::insertItem(int index, const QScatterDataItem &item)
 {
+    detachExternalArray();
     Q_ASSERT(index >= 0 && index <= m_dataArray->size());
     m_dataArray->insert(index, item);
+    insertItemStyles(index, 1);
+    setRingHead(0);
 }
 
 void QScatterDataProxyPrivate::insertItems(int index, const QScatterDataArray &items)
 {
+    detachExternalArray();
     Q_ASSERT(index >= 0 && index <= m_dataArray->size());
     for (int i = 0; i < items.size(); i++)
         m_dataArray->insert(index++, items.at(i));
+    insertItemStyles(index - items.size(), items.size());
+    setRingHead(0);
 }
 
 void QScatterDataProxyPrivate::removeItems(int index, int removeCount)
 {
+    detachExternalArray();
     Q_ASSERT(index >= 0);
     int maxRemoveCount = m_dataArray->size() - index;
     removeCount = qMin(removeCount, maxRemoveCount);
     m_dataArray->remove(index, removeCount);
+    removeItemStyles(index, removeCount);
+    setRingHead(0);
+}
+
+// Appends the items until the capacity is reached and then overwrites the oldest items,
+// reporting the overwritten items as changed. Returns the index of the first written item.
+int QScatterDataProxyPrivate::addRingItems(const QScatterDataItem *items, int count)
+{
+    QScatterDataProxy *q = qptr();
+    detachExternalArray();
+
+    int firstIndex = m_dataArray->size();
+    const int appendCount = qMin(count, m_ringCapacity - int(m_dataArray->size()));
+    if (appendCount > 0) {
+        m_dataArray->append(items, appendCount);
+        emit q->itemsAdded(firstIndex, appendCount);
+        emit q->itemCountChanged(m_dataArray->size());
+        items += appendCount;
+        count -= appendCount;
+        if (count <= 0)
+            return firstIndex;
+    } else if (count <= 0) {
+        return firstIndex;
+    }
+
+    // Items that would be overwritten by the same call are skipped
+    int head = m_ringHead;
+    if (count > m_ringCapacity) {
+        const int skipCount = count - m_ringCapacity;
+        items += skipCount;
+        count = m_ringCapacity;
+        head = (head + skipCount) % m_ringCapacity;
+    }
+    if (appendCount <= 0)
+        firstIndex = head;
+
+    // Overwritten items form at most two ranges, as the write wraps around at most once
+    while (count > 0) {
+        const int writeCount = qMin(count, m_ringCapacity - head);
+        std::copy(items, items + writeCount, m_dataArray->begin() + head);
+        resetItemStyles(head, writeCount);
+        emit q->itemsChanged(head, writeCount);
+        items += writeCount;
+        count -= writeCount;
+        head = (head + writeCount) % m_ringCapacity;
+    }
+    setRingHead(head);
+
+    return firstIndex;
+}
+
+void QScatterDataProxyPrivate::setRingCapacity(int capacity)
+{
+    QScatterDataProxy *q = qptr();
+
+    // Order the items from the oldest to the newest, so that the head can start from zero
+    if (m_ringHead) {
+        std::rotate(m_dataArray->begin(), m_dataArray->begin() + m_ringHead,
+                    m_dataArray->end());
+        if (!m_itemColors.isEmpty()) {
+            m_itemColors.resize(m_dataArray->size(), 0);
+            std::rotate(m_itemColors.begin(), m_itemColors.begin() + m_ringHead,
+                        m_itemColors.end());
+        }
+        if (!m_itemSizes.isEmpty()) {
+            m_itemSizes.resize(m_dataArray->size(), 0.0f);
+            std::rotate(m_itemSizes.begin(), m_itemSizes.begin() + m_ringHead,
+                        m_itemSizes.end());
+        }
+        setRingHead(0);
+        emit q->arrayReset();
+    }
+
+    m_ringCapacity = capacity;
+    const int excessCount = q->itemCount() - capacity;
+    if (capacity && excessCount > 0)
+        q->removeItems(0, excessCount);
+}
+
+void QScatterDataProxyPrivate::setRingHead(int head)
+{
+    if (head != m_ringHead) {
+        m_ringHead = head;
+        emit qptr()->ringHeadChanged(head);
+    }
+}
+
+void QScatterDataProxyPrivate::setItemColors(const QList<QRgb> &colors)
+{
+    m_itemColors = colors;
+}
+
+void QScatterDataProxyPrivate::setItemColor(int index, QRgb color)
+{
+    if (index >= m_itemColors.size())
+        m_itemColors.resize(itemCount(), 0);
+    m_itemColors[index] = color;
+}
+
+void QScatterDataProxyPrivate::setItemSizes(const QList<float> &sizes)
+{
+    m_itemSizes = sizes;
+}
+
+void QScatterDataProxyPrivate::setItemSize(int index, float size)
+{
+    if (index >= m_itemSizes.size())
+        m_itemSizes.resize(itemCount(), 0.0f);
+    m_itemSizes[index] = size;
+}
+
+float QScatterDataProxyPrivate::maxItemSize() const
+{
+    float maxSize = 0.0f;
+    for (float size : std::as_const(m_itemSizes))
+        maxSize = qMax(maxSize, size);
+    return maxSize;
+}
+
+// Item colors and sizes only need to follow the items they cover
+void QScatterDataProxyPrivate::insertItemStyles(int index, int count)
+{
+    if (index < m_itemColors.size())
+        m_itemColors.insert(index, count, 0);
+    if (index < m_itemSizes.size())
+        m_itemSizes.insert(index, count, 0.0f);
+}
+
+void QScatterDataProxyPrivate::removeItemStyles(int index, int count)
+{
+    if (index < m_itemColors.size())
+        m_itemColors.remove(index, qMin(count, int(m_itemColors.size()) - index));
+    if (index < m_itemSizes.size())
+        m_itemSizes.remove(index, qMin(count, int(m_itemSizes.size()) - index));
+}
+
+void QScatterDataProxyPrivate::resetItemStyles(int index, int count)
+{
+    const int colorEnd = qMin(index + count, int(m_itemColors.size()));
+    if (index < colorEnd)
+        std::fill(m_itemColors.begin() + index, m_itemColors.begin() + colorEnd, 0);
+    const int sizeEnd = qMin(index + count, int(m_itemSizes.size()));
+    if (index < sizeEnd)
+        std::fill(m_itemSizes.begin() + index, m_itemSizes.begin() + sizeEnd, 0.0f);
 }
 
 void QScatterDataProxyPrivate::limitValues(QVector3D &minValues, QVector3D &maxValues,
                                            QAbstract3DAxis *axisX, QAbstract3DAxis *axisY,
                                            QAbstract3DAxis *axisZ) const
 {
-    if (m_dataArray->isEmpty())
+    const int dataSize = itemCount();
+    if (!dataSize)
         return;
 
-    const QVector3D &firstPos = m_dataArray->at(0).position();
-
-    float minX = firstPos.x();
-    float maxX = minX;
-    float minY = firstPos.y();
-    float maxY = minY;
-    float minZ = firstPos.z();
-    float maxZ = minZ;
-
-    if (m_dataArray->size() > 1) {
-        for (int i = 1; i < m_dataArray->size(); i++) {
-            const QVector3D &pos = m_dataArray->at(i).position();
-
-            float value = pos.x();
-            if (qIsNaN(value) || qIsInf(value))
-                continue;
-            if (isValidValue(minX, value, axisX))
-                minX = value;
-            if (maxX < value)
-                maxX = value;
-
-            value = pos.y();
-            if (qIsNaN(value) || qIsInf(value))
-                continue;
-            if (isValidValue(minY, value, axisY))
-                minY = value;
-            if (maxY < value)
-                maxY = value;
-
-            value = pos.z();
-            if (qIsNaN(value) || qIsInf(value))
-                continue;
-            if (isValidValue(minZ, value, axisZ))
-                minZ = value;
-            if (maxZ < value)
-                maxZ = value;
+    const int chunkCount = (dataSize + limitChunkSize - 1) / limitChunkSize;
+    m_limitChunks.resize(chunkCount);
+
+    // Only rescan the chunks that have changed since the previous call
+    ValueLimits limits[3];
+    for (int chunk = 0; chunk < chunkCount; chunk++) {
+        LimitChunk &limitChunk = m_limitChunks[chunk];
+        if (limitChunk.dirty) {
+            for (int axis = 0; axis < 3; axis++)
+                limitChunk.limits[axis].clear();
+            const int end = qMin(dataSize, (chunk + 1) * limitChunkSize);
+            for (int i = chunk * limitChunkSize; i < end; i++) {
+                // Invalid value on an axis excludes the item from the following axes, too
+                const QVector3D pos = position(i);
+                if (!limitChunk.limits[0].add(pos.x()))
+                    continue;
+                if (!limitChunk.limits[1].add(pos.y()))
+                    continue;
+                limitChunk.limits[2].add(pos.z());
+            }
+            limitChunk.dirty = false;
         }
+        for (int axis = 0; axis < 3; axis++)
+            limits[axis].add(limitChunk.limits[axis]);
     }
 
-    minValues.setX(minX);
-    minValues.setY(minY);
-    minValues.setZ(minZ);
-
-    maxValues.setX(maxX);
-    maxValues.setY(maxY);
-    maxValues.setZ(maxZ);
+    // The first item initializes the limits regardless of its validity
+    const QVector3D firstPos = position(0);
+    QAbstract3DAxis *axes[3] = { axisX, axisY, axisZ };
+    for (int axis = 0; axis < 3; axis++) {
+        float minValue = firstPos[axis];
+        float maxValue = firstPos[axis];
+        float validMin;
+        if (limits[axis].minimum(axes[axis]->d_ptr->allowZero(),
+                                 axes[axis]->d_ptr->allowNegatives(), validMin)
+                && isValidValue(minValue, validMin, axes[axis])) {
+            minValue = validMin;
+        }
+        if (limits[axis].hasValues() && maxValue < limits[axis].maximum())
+            maxValue = limits[axis].maximum();
+        minValues[axis] = minValue;
+        maxValues[axis] = maxValue;
+    }
 }
 
 bool QScatterDataProxyPrivate::isValidValue(float axisValue, float value,
@@ -425,4 +929,43 @@ QScatterDataProxy *QScatterDataProxyPrivate::qptr()
     return static_cast<QScatterDataProxy *>(q_ptr);
 }
 
+void QScatterDataProxyPrivate::connectLimitTracking()
+{
+    // Array can also be modified directly, so track changes through the signals
+    QScatterDataProxy *proxy = qptr();
+    QObject::connect(proxy, &QScatterDataProxy::arrayReset,
+                     this, &QScatterDataProxyPrivate::handleArrayReset);
+    QObject::connect(proxy, &QScatterDataProxy::itemsChanged,
+                     this, &QScatterDataProxyPrivate::handleItemsChanged);
+    QObject::connect(proxy, &QScatterDataProxy::itemsAdded,
+                     this, &QScatterDataProxyPrivate::handleItemCountChanged);
+    QObject::connect(proxy, &QScatterDataProxy::itemsInserted,
+                     this, &QScatterDataProxyPrivate::handleItemCountChanged);
+    QObject::connect(proxy, &QScatterDataProxy::itemsRemoved,
+                     this, &QScatterDataProxyPrivate::handleItemCountChanged);
+}
+
+void QScatterDataProxyPrivate::handleArrayReset()
+{
+    m_limitChunks.clear();
+}
+
+void QScatterDataProxyPrivate::handleItemsChanged(int startIndex, int count)
+{
+    const int lastChunk = qMin(m_limitChunks.size() - 1,
+                               (startIndex + count - 1) / limitChunkSize);
+    for (int chunk = startIndex / limitChunkSize; chunk <= lastChunk; chunk++)
+        m_limitChunks[chunk].dirty = true;
+}
+
+void QScatterDataProxyPrivate::handleItemCountChanged(int startIndex, int count)
+{
+    Q_UNUSED(count);
+
+    // Items after the start index have moved, so all chunks from there on need a rescan
+    const int firstChunk = startIndex / limitChunkSize;
+    if (firstChunk < m_limitChunks.size())
+        m_limitChunks.resize(firstChunk);
+}
+
 QT_END_NAMESPACE
@@ -6,6 +6,7 @@
 
 #include <QtDataVisualization/qabstractdataproxy.h>
 #include <QtDataVisualization/qscatterdataitem.h>
+#include <QtGui/qrgb.h>
 
 Q_MOC_INCLUDE(<QtDataVisualization/qscatter3dseries.h>)
 
@@ -22,6 +23,8 @@ class Q_DATAVISUALIZATION_EXPORT QScatterDataProxy : public QAbstractDataProxy
 
     Q_PROPERTY(int itemCount READ itemCount NOTIFY itemCountChanged)
     Q_PROPERTY(QScatter3DSeries *series READ series NOTIFY seriesChanged)
+    Q_PROPERTY(int ringCapacity READ ringCapacity WRITE setRingCapacity NOTIFY ringCapacityChanged REVISION(6, 9))
+    Q_PROPERTY(int ringHead READ ringHead NOTIFY ringHeadChanged REVISION(6, 9))
 
 public:
     explicit QScatterDataProxy(QObject *parent = nullptr);
@@ -31,8 +34,12 @@ public:
     int itemCount() const;
     const QScatterDataArray *array() const;
     const QScatterDataItem *itemAt(int index) const;
+    QScatterDataItem item(int index) const;
 
     void resetArray(QScatterDataArray *newArray);
+    void resetArray(int itemCount, const float *xValues, const float *yValues,
+                    const float *zValues, const QQuaternion *rotations = nullptr);
+    bool hasExternalArray() const;
 
     void setItem(int index, const QScatterDataItem &item);
     void setItems(int index, const QScatterDataArray &items);
@@ -45,6 +52,17 @@ public:
 
     void removeItems(int index, int removeCount);
 
+    void setRingCapacity(int capacity);
+    int ringCapacity() const;
+    int ringHead() const;
+
+    void setItemColors(const QList<QRgb> &colors);
+    QList<QRgb> itemColors() const;
+    void setItemColor(int index, QRgb color);
+    void setItemSizes(const QList<float> &sizes);
+    QList<float> itemSizes() const;
+    void setItemSize(int index, float size);
+
 Q_SIGNALS:
     void arrayReset();
     void itemsAdded(int startIndex, int count);
@@ -54,6 +72,8 @@ Q_SIGNALS:
 
     void itemCountChanged(int count);
     void seriesChanged(QScatter3DSeries *series);
+    Q_REVISION(6, 9) void ringCapacityChanged(int capacity);
+    Q_REVISION(6, 9) void ringHeadChanged(int head);
 
 protected:
     explicit QScatterDataProxy(QScatterDataProxyPrivate *d, QObject *parent = nullptr);
@@ -64,6 +84,7 @@ private:
     Q_DISABLE_COPY(QScatterDataProxy)
 
     friend class Scatter3DController;
+    friend class Scatter3DRenderer;
 };
 
 QT_END_NAMESPACE
@@ -17,6 +17,7 @@
 #include "qscatterdataproxy.h"
 #include "qabstractdataproxy_p.h"
 #include "qscatterdataitem.h"
+#include "valuelimits_p.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -30,6 +31,8 @@ public:
     virtual ~QScatterDataProxyPrivate();
 
     void resetArray(QScatterDataArray *newArray);
+    void resetArray(int itemCount, const float *xValues, const float *yValues,
+                    const float *zValues, const QQuaternion *rotations);
     void setItem(int index, const QScatterDataItem &item);
     void setItems(int index, const QScatterDataArray &items);
     int addItem(const QScatterDataItem &item);
@@ -37,16 +40,93 @@ public:
     void insertItem(int index, const QScatterDataItem &item);
     void insertItems(int index, const QScatterDataArray &items);
     void removeItems(int index, int removeCount);
+    int addRingItems(const QScatterDataItem *items, int count);
+    void setRingCapacity(int capacity);
+    void setRingHead(int head);
+    void setItemColors(const QList<QRgb> &colors);
+    void setItemColor(int index, QRgb color);
+    void setItemSizes(const QList<float> &sizes);
+    void setItemSize(int index, float size);
+    float maxItemSize() const;
     void limitValues(QVector3D &minValues, QVector3D &maxValues, QAbstract3DAxis *axisX,
                      QAbstract3DAxis *axisY, QAbstract3DAxis *axisZ) const;
     bool isValidValue(float axisValue, float value, QAbstract3DAxis *axis) const;
 
     void setSeries(QAbstract3DSeries *series) override;
+
+    inline bool hasExternalArray() const { return m_externalX; }
+    inline int itemCount() const
+    {
+        return m_externalX ? m_externalCount : int(m_dataArray->size());
+    }
+    inline QVector3D position(int index) const
+    {
+        if (m_externalX)
+            return QVector3D(m_externalX[index], m_externalY[index], m_externalZ[index]);
+        return m_dataArray->at(index).position();
+    }
+    inline QScatterDataItem item(int index) const
+    {
+        if (m_externalX) {
+            return QScatterDataItem(position(index), m_externalRotations
+                                    ? m_externalRotations[index] : QQuaternion());
+        }
+        return m_dataArray->at(index);
+    }
+    inline bool hasItemColors() const { return !m_itemColors.isEmpty(); }
+    inline bool hasItemSizes() const { return !m_itemSizes.isEmpty(); }
+    inline QRgb itemColor(int index) const
+    {
+        return index < m_itemColors.size() ? m_itemColors.at(index) : 0;
+    }
+    inline float itemSize(int index) const
+    {
+        return index < m_itemSizes.size() ? m_itemSizes.at(index) : 0.0f;
+    }
+
+public Q_SLOTS:
+    void handleArrayReset();
+    void handleItemsChanged(int startIndex, int count);
+    void handleItemCountChanged(int startIndex, int count);
+
 private:
+    // Value limits of a fixed size chunk of the data array
+    struct LimitChunk
+    {
+        LimitChunk() : dirty(true) {}
+        ValueLimits limits[3];
+        bool dirty;
+    };
+
     QScatterDataProxy *qptr();
+    void connectLimitTracking();
+    void clearExternalArray();
+    void detachExternalArray();
+    void insertItemStyles(int index, int count);
+    void removeItemStyles(int index, int count);
+    void resetItemStyles(int index, int count);
     QScatterDataArray *m_dataArray;
 
+    // Externally owned values, used instead of m_dataArray when m_externalX is set
+    int m_externalCount;
+    const float *m_externalX;
+    const float *m_externalY;
+    const float *m_externalZ;
+    const QQuaternion *m_externalRotations;
+
+    // Maximum item count in ring buffer mode, or zero if the mode is not in use.
+    // The head is the index of the oldest item, which the next added item overwrites.
+    int m_ringCapacity;
+    int m_ringHead;
+
+    // Optional per-item colors and sizes, indexed like the items. Items beyond the end of
+    // the lists, items with zero alpha color, and items with zero size use the series values.
+    QList<QRgb> m_itemColors;
+    QList<float> m_itemSizes;
+    mutable QList<LimitChunk> m_limitChunks;
+
     friend class QScatterDataProxy;
+    friend class Scatter3DRenderer;
 };
 
 QT_END_NAMESPACE
@@ -146,6 +146,30 @@ QT_BEGIN_NAMESPACE
  * The color used to draw the gridlines of the surface wireframe.
  */
 
+/*!
+ * \qmlproperty bool Surface3DSeries::levelOfDetail
+ * \since 6.9
+ *
+ * Defines whether the surface is drawn with level of detail. When enabled,
+ * the surface is split into tiles, and each tile is drawn with fewer vertices
+ * the smaller the resulting height error is on screen. Selection and slicing
+ * still use the full resolution data.
+ * The preset default is \c false.
+ *
+ * Level of detail has no effect when flatShadingEnabled is \c true.
+ *
+ * \sa levelOfDetailThreshold
+ */
+
+/*!
+ * \qmlproperty real Surface3DSeries::levelOfDetailThreshold
+ * \since 6.9
+ *
+ * The largest height error in pixels that is allowed when a tile is drawn
+ * with fewer vertices. The value must be positive.
+ * The preset default is \c 1.0.
+ */
+
 /*!
  * \enum QSurface3DSeries::DrawFlag
  *
@@ -396,6 +420,65 @@ QColor QSurface3DSeries::wireframeColor() const
 {
     return dptrc()->m_wireframeColor;
 }
+
+/*!
+ * \property QSurface3DSeries::levelOfDetail
+ * \since 6.9
+ *
+ * \brief Whether the surface is drawn with level of detail.
+ *
+ * When enabled, the surface is split into tiles, and each tile is drawn with
+ * a vertex step of its own. The step of each tile is chosen every frame so that
+ * the height error caused by the skipped vertices stays below
+ * levelOfDetailThreshold pixels on screen. Edges between tiles drawn with
+ * different steps are stitched, so the surface has no cracks. Selection and
+ * slicing still use the full resolution data.
+ *
+ * Level of detail has no effect when flatShadingEnabled is \c true.
+ *
+ * The preset default is \c false.
+ *
+ * \sa levelOfDetailThreshold
+ */
+void QSurface3DSeries::setLevelOfDetail(bool enable)
+{
+    if (enable != dptrc()->m_levelOfDetail) {
+        dptr()->setLevelOfDetail(enable);
+        emit levelOfDetailChanged(enable);
+    }
+}
+
+bool QSurface3DSeries::isLevelOfDetail() const
+{
+    return dptrc()->m_levelOfDetail;
+}
+
+/*!
+ * \property QSurface3DSeries::levelOfDetailThreshold
+ * \since 6.9
+ *
+ * \brief The largest allowed height error in pixels when drawing tiles with
+ * fewer vertices.
+ *
+ * Only has effect when levelOfDetail is enabled. The value must be positive.
+ *
+ * The preset default is \c 1.0f.
+ */
+void QSurface3DSeries::setLevelOfDetailThreshold(float pixels)
+{
+    if (pixels <= 0.0f) {
+        qWarning("Invalid threshold. Level of detail threshold must be positive.");
+    } else if (pixels != dptrc()->m_levelOfDetailThreshold) {
+        dptr()->setLevelOfDetailThreshold(pixels);
+        emit levelOfDetailThresholdChanged(pixels);
+    }
+}
+
+float QSurface3DSeries::levelOfDetailThreshold() const
+{
+    return dptrc()->m_levelOfDetailThreshold;
+}
+
 /*!
  * \internal
  */
@@ -419,7 +502,9 @@ QSurface3DSeriesPrivate::QSurface3DSeriesPrivate(QSurface3DSeries *q)
       m_selectedPoint(Surface3DController::invalidSelectionPosition()),
       m_flatShadingEnabled(true),
       m_drawMode(QSurface3DSeries::DrawSurfaceAndWireframe),
-      m_wireframeColor(Qt::black)
+      m_wireframeColor(Qt::black),
+      m_levelOfDetail(false),
+      m_levelOfDetailThreshold(1.0f)
 {
     m_itemLabelFormat = QStringLiteral("@xLabel, @yLabel, @zLabel");
     m_mesh = QAbstract3DSeries::MeshSphere;
@@ -559,4 +644,18 @@ void QSurface3DSeriesPrivate::setWireframeColor(const QColor &color)
         m_controller->markSeriesVisualsDirty();
 }
 
+void QSurface3DSeriesPrivate::setLevelOfDetail(bool enable)
+{
+    m_levelOfDetail = enable;
+    if (m_controller)
+        m_controller->markSeriesVisualsDirty();
+}
+
+void QSurface3DSeriesPrivate::setLevelOfDetailThreshold(float pixels)
+{
+    m_levelOfDetailThreshold = pixels;
+    if (m_controller)
+        m_controller->markSeriesVisualsDirty();
+}
+
 QT_END_NAMESPACE
@@ -23,6 +23,8 @@ class Q_DATAVISUALIZATION_EXPORT QSurface3DSeries : public QAbstract3DSeries
     Q_PROPERTY(QImage texture READ texture WRITE setTexture NOTIFY textureChanged)
     Q_PROPERTY(QString textureFile READ textureFile WRITE setTextureFile NOTIFY textureFileChanged)
     Q_PROPERTY(QColor wireframeColor READ wireframeColor WRITE setWireframeColor NOTIFY wireframeColorChanged REVISION(6, 3))
+    Q_PROPERTY(bool levelOfDetail READ isLevelOfDetail WRITE setLevelOfDetail NOTIFY levelOfDetailChanged REVISION(6, 9))
+    Q_PROPERTY(float levelOfDetailThreshold READ levelOfDetailThreshold WRITE setLevelOfDetailThreshold NOTIFY levelOfDetailThresholdChanged REVISION(6, 9))
 
 public:
     enum DrawFlag {
@@ -60,6 +62,11 @@ public:
     void setWireframeColor(const QColor &color);
     QColor wireframeColor() const;
 
+    void setLevelOfDetail(bool enable);
+    bool isLevelOfDetail() const;
+    void setLevelOfDetailThreshold(float pixels);
+    float levelOfDetailThreshold() const;
+
 Q_SIGNALS:
     void dataProxyChanged(QSurfaceDataProxy *proxy);
     void selectedPointChanged(const QPoint &position);
@@ -69,6 +76,8 @@ Q_SIGNALS:
     void textureChanged(const QImage &image);
     void textureFileChanged(const QString &filename);
     Q_REVISION(6, 3) void wireframeColorChanged(const QColor &color);
+    Q_REVISION(6, 9) void levelOfDetailChanged(bool enabled);
+    Q_REVISION(6, 9) void levelOfDetailThresholdChanged(float pixels);
 
 protected:
     explicit QSurface3DSeries(QSurface3DSeriesPrivate *d, QObject *parent = nullptr);
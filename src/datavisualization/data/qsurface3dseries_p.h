@@ -35,6 +35,8 @@ public:
     void setDrawMode(QSurface3DSeries::DrawFlags mode);
     void setTexture(const QImage &texture);
     void setWireframeColor(const QColor &color);
+    void setLevelOfDetail(bool enable);
+    void setLevelOfDetailThreshold(float pixels);
 
 private:
     QSurface3DSeries *qptr();
@@ -45,6 +47,8 @@ private:
     QImage m_texture;
     QString m_textureFile;
     QColor m_wireframeColor;
+    bool m_levelOfDetail;
+    float m_levelOfDetailThreshold;
 
 private:
     friend class QSurface3DSeries;
@@ -104,6 +104,7 @@ QT_BEGIN_NAMESPACE
 QSurfaceDataProxy::QSurfaceDataProxy(QObject *parent) :
     QAbstractDataProxy(new QSurfaceDataProxyPrivate(this), parent)
 {
+    dptr()->connectLimitTracking();
 }
 
 /*!
@@ -112,6 +113,7 @@ QSurfaceDataProxy::QSurfaceDataProxy(QObject *parent) :
 QSurfaceDataProxy::QSurfaceDataProxy(QSurfaceDataProxyPrivate *d, QObject *parent) :
     QAbstractDataProxy(d, parent)
 {
+    dptr()->connectLimitTracking();
 }
 
 /*!
@@ -519,23 +521,34 @@ void QSurfaceDataProxyPrivate::limitValues(QVector3D &minValues, QVector3D &maxV
         max = m_dataArray->at(0)->at(0).y();
     }
 
+    // Only rescan the rows that have changed since the previous call
+    if (m_rowLimits.size() != rows) {
+        m_rowLimits.clear();
+        m_rowLimits.resize(rows);
+    }
+    ValueLimits limits;
     for (int i = 0; i < rows; i++) {
-        QSurfaceDataRow *row = m_dataArray->at(i);
-        if (row) {
-            for (int j = 0; j < columns; j++) {
-                float itemValue = m_dataArray->at(i)->at(j).y();
-                if (qIsNaN(itemValue) || qIsInf(itemValue))
-                    continue;
-                if ((min > itemValue || (qIsNaN(min) || qIsInf(min)))
-                        && isValidValue(itemValue, axisY)) {
-                    min = itemValue;
-                }
-                if (max < itemValue  || (qIsNaN(max) || qIsInf(max)))
-                    max = itemValue;
+        RowLimits &rowLimits = m_rowLimits[i];
+        if (rowLimits.dirty) {
+            rowLimits.limits.clear();
+            QSurfaceDataRow *row = m_dataArray->at(i);
+            if (row) {
+                for (int j = 0; j < columns; j++)
+                    rowLimits.limits.add(row->at(j).y());
             }
+            rowLimits.dirty = false;
         }
+        limits.add(rowLimits.limits);
     }
 
+    float validMin;
+    if (limits.minimum(axisY->d_ptr->allowZero(), axisY->d_ptr->allowNegatives(), validMin)
+            && (min > validMin || (qIsNaN(min) || qIsInf(min)))) {
+        min = validMin;
+    }
+    if (limits.hasValues() && (max < limits.maximum() || (qIsNaN(max) || qIsInf(max))))
+        max = limits.maximum();
+
     minValues.setY(min);
     maxValues.setY(max);
 
@@ -617,6 +630,58 @@ bool QSurfaceDataProxyPrivate::isValidValue(float value, QAbstract3DAxis *axis)
             || (value < 0.0f && axis->d_ptr->allowNegatives()));
 }
 
+void QSurfaceDataProxyPrivate::connectLimitTracking()
+{
+    // Array can also be modified directly, so track changes through the signals
+    QSurfaceDataProxy *proxy = qptr();
+    QObject::connect(proxy, &QSurfaceDataProxy::arrayReset,
+                     this, &QSurfaceDataProxyPrivate::handleArrayReset);
+    QObject::connect(proxy, &QSurfaceDataProxy::rowsChanged,
+                     this, &QSurfaceDataProxyPrivate::handleRowsChanged);
+    QObject::connect(proxy, &QSurfaceDataProxy::rowsAdded,
+                     this, &QSurfaceDataProxyPrivate::handleRowsInserted);
+    QObject::connect(proxy, &QSurfaceDataProxy::rowsInserted,
+                     this, &QSurfaceDataProxyPrivate::handleRowsInserted);
+    QObject::connect(proxy, &QSurfaceDataProxy::rowsRemoved,
+                     this, &QSurfaceDataProxyPrivate::handleRowsRemoved);
+    QObject::connect(proxy, &QSurfaceDataProxy::itemChanged,
+                     this, &QSurfaceDataProxyPrivate::handleItemChanged);
+}
+
+void QSurfaceDataProxyPrivate::handleArrayReset()
+{
+    m_rowLimits.clear();
+}
+
+void QSurfaceDataProxyPrivate::handleRowsChanged(int startIndex, int count)
+{
+    const int endIndex = qMin(m_rowLimits.size(), startIndex + count);
+    for (int i = startIndex; i < endIndex; i++)
+        m_rowLimits[i].dirty = true;
+}
+
+void QSurfaceDataProxyPrivate::handleRowsInserted(int startIndex, int count)
+{
+    if (startIndex <= m_rowLimits.size())
+        m_rowLimits.insert(startIndex, count, RowLimits());
+    else
+        m_rowLimits.clear();
+}
+
+void QSurfaceDataProxyPrivate::handleRowsRemoved(int startIndex, int count)
+{
+    if (startIndex < m_rowLimits.size())
+        m_rowLimits.remove(startIndex, qMin(count, m_rowLimits.size() - startIndex));
+}
+
+void QSurfaceDataProxyPrivate::handleItemChanged(int rowIndex, int columnIndex)
+{
+    Q_UNUSED(columnIndex);
+
+    if (rowIndex < m_rowLimits.size())
+        m_rowLimits[rowIndex].dirty = true;
+}
+
 void QSurfaceDataProxyPrivate::clearRow(int rowIndex)
 {
     if (m_dataArray->at(rowIndex)) {
@@ -16,6 +16,7 @@
 
 #include "qsurfacedataproxy.h"
 #include "qabstractdataproxy_p.h"
+#include "valuelimits_p.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -43,13 +44,31 @@ public:
 
     void setSeries(QAbstract3DSeries *series) override;
 
+public Q_SLOTS:
+    void handleArrayReset();
+    void handleRowsChanged(int startIndex, int count);
+    void handleRowsInserted(int startIndex, int count);
+    void handleRowsRemoved(int startIndex, int count);
+    void handleItemChanged(int rowIndex, int columnIndex);
+
 protected:
     QSurfaceDataArray *m_dataArray;
 
 private:
+    // Y value limits of a single row
+    struct RowLimits
+    {
+        RowLimits() : dirty(true) {}
+        ValueLimits limits;
+        bool dirty;
+    };
+
     QSurfaceDataProxy *qptr();
     void clearRow(int rowIndex);
     void clearArray();
+    void connectLimitTracking();
+
+    mutable QList<RowLimits> m_rowLimits;
 
     friend class QSurfaceDataProxy;
 };
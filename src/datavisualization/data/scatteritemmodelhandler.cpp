@@ -199,8 +199,10 @@ void ScatterItemModelHandler::resolveModel()
     int runningCount = 0;
 
     // If dimensions have changed, recreate the array
-    if (m_proxyArray != m_proxy->array() || totalCount != m_proxyArray->size())
+    if (m_proxy->hasExternalArray() || m_proxyArray != m_proxy->array()
+            || totalCount != m_proxyArray->size()) {
         m_proxyArray = new QScatterDataArray(totalCount);
+    }
 
     // Parse data into newProxyArray
     for (int i = 0; i < rowCount; i++) {
@@ -7,7 +7,9 @@ QT_BEGIN_NAMESPACE
 
 ScatterRenderItem::ScatterRenderItem()
     : AbstractRenderItem(),
-      m_visible(false)
+      m_visible(false),
+      m_color(0),
+      m_size(0.0f)
 {
 }
 
@@ -16,6 +18,8 @@ ScatterRenderItem::ScatterRenderItem(const ScatterRenderItem &other)
 {
     m_position = other.m_position;
     m_visible = other.m_visible;
+    m_color = other.m_color;
+    m_size = other.m_size;
 }
 
 ScatterRenderItem::~ScatterRenderItem()
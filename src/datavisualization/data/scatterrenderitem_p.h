@@ -15,6 +15,7 @@
 #define SCATTERRENDERITEM_P_H
 
 #include "abstractrenderitem_p.h"
+#include <QtGui/qrgb.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -36,9 +37,17 @@ public:
     inline bool isVisible() const { return m_visible; }
     inline void setVisible(bool visible) { m_visible = visible; }
 
+    // Zero alpha color or zero size means the series value is used
+    inline QRgb color() const { return m_color; }
+    inline void setColor(QRgb color) { m_color = color; }
+    inline float size() const { return m_size; }
+    inline void setSize(float size) { m_size = size; }
+
 protected:
     QVector3D m_position;
     bool m_visible;
+    QRgb m_color;
+    float m_size;
 };
 typedef QList<ScatterRenderItem> ScatterRenderItemArray;
 
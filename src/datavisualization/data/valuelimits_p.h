@@ -0,0 +1,107 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QtDataVisualization API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+
+#ifndef VALUELIMITS_P_H
+#define VALUELIMITS_P_H
+
+#include "datavisualizationglobal_p.h"
+
+QT_BEGIN_NAMESPACE
+
+// Summary of a set of finite values. Summaries of partial data can be combined, and the
+// minimum accepted by an axis can be resolved from the summary without rescanning the data.
+class ValueLimits
+{
+public:
+    ValueLimits()
+        : m_min(0.0f),
+          m_max(0.0f),
+          m_minPositive(0.0f),
+          m_hasValues(false),
+          m_hasPositive(false),
+          m_hasZero(false)
+    {
+    }
+
+    inline void clear() { *this = ValueLimits(); }
+
+    inline bool add(float value)
+    {
+        if (qIsNaN(value) || qIsInf(value))
+            return false;
+        if (!m_hasValues) {
+            m_min = value;
+            m_max = value;
+            m_hasValues = true;
+        } else if (value < m_min) {
+            m_min = value;
+        } else if (value > m_max) {
+            m_max = value;
+        }
+        if (value > 0.0f) {
+            if (!m_hasPositive || value < m_minPositive)
+                m_minPositive = value;
+            m_hasPositive = true;
+        } else if (value == 0.0f) {
+            m_hasZero = true;
+        }
+        return true;
+    }
+
+    inline void add(const ValueLimits &other)
+    {
+        if (!other.m_hasValues)
+            return;
+        if (!m_hasValues) {
+            *this = other;
+            return;
+        }
+        m_min = qMin(m_min, other.m_min);
+        m_max = qMax(m_max, other.m_max);
+        if (other.m_hasPositive) {
+            if (!m_hasPositive || other.m_minPositive < m_minPositive)
+                m_minPositive = other.m_minPositive;
+            m_hasPositive = true;
+        }
+        m_hasZero = m_hasZero || other.m_hasZero;
+    }
+
+    inline bool hasValues() const { return m_hasValues; }
+    inline float maximum() const { return m_max; }
+
+    // Returns false if there are no values the axis accepts
+    inline bool minimum(bool allowZero, bool allowNegatives, float &value) const
+    {
+        if (allowNegatives && m_hasValues && m_min < 0.0f)
+            value = m_min;
+        else if (allowZero && m_hasZero)
+            value = 0.0f;
+        else if (m_hasPositive)
+            value = m_minPositive;
+        else
+            return false;
+        return true;
+    }
+
+private:
+    float m_min;
+    float m_max;
+    float m_minPositive;
+    bool m_hasValues;
+    bool m_hasPositive;
+    bool m_hasZero;
+};
+
+QT_END_NAMESPACE
+
+#endif
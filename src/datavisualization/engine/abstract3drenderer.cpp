@@ -13,6 +13,7 @@
 #include "qcustom3dlabel_p.h"
 #include "qcustom3dvolume_p.h"
 #include "scatter3drenderer_p.h"
+#include "frustum_p.h"
 
 #include <QtCore/qmath.h>
 #include <QtGui/QOffscreenSurface>
@@ -101,6 +102,9 @@ Abstract3DRenderer::Abstract3DRenderer(Abstract3DController *controller)
       m_isOpenGLES(true)
 
 {
+    for (int &count : m_culledItemCounts)
+        count = 0;
+
     initializeOpenGLFunctions();
     m_isOpenGLES = Utils::isOpenGLES();
 #if !QT_CONFIG(opengles2)
@@ -220,6 +224,9 @@ void Abstract3DRenderer::initializeOpenGL()
 
 void Abstract3DRenderer::render(const GLuint defaultFboHandle)
 {
+    for (int &count : m_culledItemCounts)
+        count = 0;
+
     if (defaultFboHandle) {
         glDepthMask(true);
         glEnable(GL_DEPTH_TEST);
@@ -593,8 +600,7 @@ void Abstract3DRenderer::updateAxisRange(QAbstract3DAxis::AxisOrientation orient
     cache.setMin(min);
     cache.setMax(max);
 
-    foreach (SeriesRenderCache *cache, m_renderCacheList)
-        cache->setDataDirty(true);
+    handleAxisMappingChanged();
 }
 
 void Abstract3DRenderer::updateAxisSegmentCount(QAbstract3DAxis::AxisOrientation orientation,
@@ -621,8 +627,7 @@ void Abstract3DRenderer::updateAxisReversed(QAbstract3DAxis::AxisOrientation ori
                                             bool enable)
 {
     axisCacheForOrientation(orientation).setReversed(enable);
-    foreach (SeriesRenderCache *cache, m_renderCacheList)
-        cache->setDataDirty(true);
+    handleAxisMappingChanged();
 }
 
 void Abstract3DRenderer::updateAxisFormatter(QAbstract3DAxis::AxisOrientation orientation,
@@ -637,6 +642,12 @@ void Abstract3DRenderer::updateAxisFormatter(QAbstract3DAxis::AxisOrientation or
     formatter->d_ptr->populateCopy(*(cache.formatter()));
     cache.markPositionsDirty();
 
+    handleAxisMappingChanged();
+}
+
+// Called when the mapping of data values to positions changes on any axis
+void Abstract3DRenderer::handleAxisMappingChanged()
+{
     foreach (SeriesRenderCache *cache, m_renderCacheList)
         cache->setDataDirty(true);
 }
@@ -1443,6 +1454,9 @@ void Abstract3DRenderer::drawCustomItems(RenderingState state,
         shader->setUniformValue(shader->view(), viewMatrix);
     }
 
+    const Frustum frustum(RenderingDepth == state ? depthProjectionViewMatrix
+                                                  : projectionViewMatrix);
+
     // Draw custom items - first regular and then volumes
     bool volumeDetected = false;
     int loopCount = 0;
@@ -1476,6 +1490,17 @@ void Abstract3DRenderer::drawCustomItems(RenderingState state,
                 continue;
             }
 
+            // Skip items outside the view frustum, using a bounding sphere around the mesh
+            const QVector3D &scaling = item->scaling();
+            const float radius = item->mesh()->radius()
+                    * qMax(qAbs(scaling.x()), qMax(qAbs(scaling.y()), qAbs(scaling.z())));
+            QVector3D center = item->translation();
+            center.setY(reflection * center.y());
+            if (!frustum.intersectsSphere(center, radius)) {
+                m_culledItemCounts[state]++;
+                continue;
+            }
+
             QMatrix4x4 modelMatrix;
             QMatrix4x4 itModelMatrix;
             QMatrix4x4 MVPMatrix;
@@ -1975,6 +2000,30 @@ float Abstract3DRenderer::calculatePolarBackgroundMargin()
     return maxNeededMargin;
 }
 
+// Calculates the picking ray through the input position in world coordinates. The position is
+// mapped the same way as the selection buffer is read, and is returned in normalized device
+// coordinates if ndcPosition is given. Returns false if the ray cannot be calculated.
+bool Abstract3DRenderer::inputPositionRay(const QMatrix4x4 &projectionViewMatrix,
+                                          QVector3D &origin, QVector3D &direction,
+                                          QPointF *ndcPosition) const
+{
+    const float width = float(m_primarySubViewport.width());
+    const float height = float(m_primarySubViewport.height());
+    bool invertible = false;
+    const QMatrix4x4 inverseMatrix = projectionViewMatrix.inverted(&invertible);
+    if (!invertible || width <= 0.0f || height <= 0.0f)
+        return false;
+
+    const float ndcX = (2.0f * m_inputPosition.x() + 1.0f) / width - 1.0f;
+    const float ndcY = (2.0f * (m_viewport.height() - m_inputPosition.y()) + 1.0f) / height
+            - 1.0f;
+    origin = inverseMatrix.map(QVector3D(ndcX, ndcY, -1.0f));
+    direction = (inverseMatrix.map(QVector3D(ndcX, ndcY, 1.0f)) - origin).normalized();
+    if (ndcPosition)
+        *ndcPosition = QPointF(ndcX, ndcY);
+    return true;
+}
+
 void Abstract3DRenderer::updateCameraViewport()
 {
     QVector3D adjustedTarget = m_cachedScene->activeCamera()->target();
@@ -46,13 +46,13 @@ protected:
         SelectOnSlice
     };
 
+public:
     enum RenderingState {
         RenderingNormal = 0,
         RenderingSelection,
         RenderingDepth
     };
 
-public:
     virtual ~Abstract3DRenderer();
 
     virtual void updateData() = 0;
@@ -146,6 +146,15 @@ public:
     inline void clearGraphPositionQueryResolved() { m_graphPositionQueryResolved = false; }
     inline QVector3D queriedGraphPosition() const { return m_queriedGraphPosition; }
     inline QPoint cachedGraphPositionQuery() const { return m_cachedScene->graphPositionQuery(); }
+    inline SeriesRenderCache *renderCache(QAbstract3DSeries *series) const
+    {
+        return m_renderCacheList.value(series);
+    }
+    inline const AxisRenderCache &axisCacheX() const { return m_axisCacheX; }
+    inline const AxisRenderCache &axisCacheY() const { return m_axisCacheY; }
+    inline const AxisRenderCache &axisCacheZ() const { return m_axisCacheZ; }
+    // Items skipped by frustum culling in the given rendering state on the latest frame
+    inline int culledItemCount(RenderingState state) const { return m_culledItemCounts[state]; }
 
     LabelItem &selectionLabelItem();
     void setSelectionLabel(const QString &label);
@@ -173,6 +182,7 @@ protected:
     void reInitShaders();
     virtual void handleShadowQualityChange();
     virtual void handleResize();
+    virtual void handleAxisMappingChanged();
 
     AxisRenderCache &axisCacheForOrientation(QAbstract3DAxis::AxisOrientation orientation);
 
@@ -218,6 +228,8 @@ protected:
                               const QMatrix4x4 &projectionViewMatrix);
     void queriedGraphPosition(const QMatrix4x4 &projectionViewMatrix, const QVector3D &scaling,
                               GLuint defaultFboHandle);
+    bool inputPositionRay(const QMatrix4x4 &projectionViewMatrix, QVector3D &origin,
+                          QVector3D &direction, QPointF *ndcPosition = nullptr) const;
 
     bool m_hasNegativeValues;
     Q3DTheme *m_cachedTheme;
@@ -308,6 +320,8 @@ protected:
     bool m_reflectionEnabled;
     qreal m_reflectivity;
 
+    int m_culledItemCounts[RenderingDepth + 1];
+
     QLocale m_locale;
 #if !QT_CONFIG(opengles2)
     QOpenGLFunctions_2_1 *m_funcs_2_1;
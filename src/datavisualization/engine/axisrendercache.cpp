@@ -4,6 +4,8 @@
 #undef QT_NO_FOREACH // this file contains unported legacy Q_FOREACH uses
 
 #include "axisrendercache_p.h"
+#include "qvalue3daxisformatter_p.h"
+#include "qlogvalue3daxisformatter_p.h"
 
 #include <QtGui/QFontMetrics>
 
@@ -144,6 +146,60 @@ void AxisRenderCache::updateAllPositions()
     }
 }
 
+// Returns false if the formatter is not the default value axis formatter
+bool AxisRenderCache::linearMapping(LinearAxisMapping &mapping) const
+{
+    if (!m_formatter || m_formatter->metaObject() != &QValue3DAxisFormatter::staticMetaObject)
+        return false;
+
+    mapping.min = m_formatter->d_ptr->m_min;
+    mapping.rangeNormalizer = m_formatter->d_ptr->m_rangeNormalizer;
+    mapping.scale = m_scale;
+    mapping.translate = m_translate;
+    mapping.reversed = m_reversed;
+    return true;
+}
+
+// Built-in formatters can be used for positions from multiple threads at the same time.
+// Custom formatters are not required to support that.
+bool AxisRenderCache::hasBuiltInFormatter() const
+{
+    return m_formatter
+            && (m_formatter->metaObject() == &QValue3DAxisFormatter::staticMetaObject
+                || m_formatter->metaObject() == &QLogValue3DAxisFormatter::staticMetaObject);
+}
+
+// Gives the parameters for mapping values to positions in a shader as
+// (f(value) - offset) / normalizer * scale + translate, where f is the natural logarithm for
+// logarithmic axes and identity otherwise. Axis reversal is included in the scale and translate.
+// Returns false if the formatter is not a built-in one, as custom mappings are not known.
+bool AxisRenderCache::shaderMapping(bool &logarithmic, float &offset, float &normalizer,
+                                    float &scale, float &translate) const
+{
+    if (!hasBuiltInFormatter())
+        return false;
+
+    logarithmic = (m_formatter->metaObject() == &QLogValue3DAxisFormatter::staticMetaObject);
+    if (logarithmic) {
+        const QLogValue3DAxisFormatterPrivate *logPrivate =
+                static_cast<const QLogValue3DAxisFormatterPrivate *>(m_formatter->d_ptr.data());
+        offset = float(logPrivate->m_logMin);
+        normalizer = float(logPrivate->m_logRangeNormalizer);
+    } else {
+        offset = m_formatter->d_ptr->m_min;
+        normalizer = m_formatter->d_ptr->m_rangeNormalizer;
+    }
+
+    if (m_reversed) {
+        scale = -m_scale;
+        translate = m_scale + m_translate;
+    } else {
+        scale = m_scale;
+        translate = m_translate;
+    }
+    return true;
+}
+
 void AxisRenderCache::updateTextures()
 {
     m_font = m_drawer->font();
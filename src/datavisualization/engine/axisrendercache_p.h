@@ -20,7 +20,27 @@
 
 QT_BEGIN_NAMESPACE
 
-class AxisRenderCache : public QObject
+// Value to position mapping of an axis with the default value axis formatter. Gives the same
+// results as AxisRenderCache::positionAt() without calling the formatter.
+struct LinearAxisMapping
+{
+    float min;
+    float rangeNormalizer;
+    float scale;
+    float translate;
+    bool reversed;
+
+    inline float positionAt(float value) const
+    {
+        const float position = (value - min) / rangeNormalizer;
+        if (reversed)
+            return (1.0f - position) * scale + translate;
+        else
+            return position * scale + translate;
+    }
+};
+
+class Q_AUTOTEST_EXPORT AxisRenderCache : public QObject
 {
     Q_OBJECT
 public:
@@ -78,13 +98,17 @@ public:
     inline float translate() { return m_translate; }
     inline void setScale(float scale) { m_scale = scale; m_positionsDirty = true; }
     inline float scale() { return m_scale; }
-    inline float positionAt(float value)
+    inline float positionAt(float value) const
     {
         if (m_reversed)
             return (1.0f - m_formatter->positionAt(value)) * m_scale + m_translate;
         else
             return m_formatter->positionAt(value) * m_scale + m_translate;
     }
+    bool linearMapping(LinearAxisMapping &mapping) const;
+    bool hasBuiltInFormatter() const;
+    bool shaderMapping(bool &logarithmic, float &offset, float &normalizer, float &scale,
+                       float &translate) const;
     inline float labelAutoRotation() const { return m_labelAutoRotation; }
     inline void setLabelAutoRotation(float angle) { m_labelAutoRotation = angle; }
     inline bool isTitleVisible() const { return m_titleVisible; }
@@ -164,28 +164,13 @@ void Bars3DController::handleRowsAdded(int startIndex, int count)
 void Bars3DController::handleRowsChanged(int startIndex, int count)
 {
     QBar3DSeries *series = static_cast<QBarDataProxy *>(sender())->series();
-    int oldChangeCount = m_changedRows.size();
-    if (!oldChangeCount)
-        m_changedRows.reserve(count);
-
-    for (int i = 0; i < count; i++) {
-        bool newItem = true;
-        int candidate = startIndex + i;
-        for (int j = 0; j < oldChangeCount; j++) {
-            const ChangeRow &oldChangeItem = m_changedRows.at(j);
-            if (oldChangeItem.row == candidate && series == oldChangeItem.series) {
-                newItem = false;
-                break;
-            }
-        }
-        if (newItem) {
-            ChangeRow newChangeItem = {series, candidate};
-            m_changedRows.append(newChangeItem);
-            if (series == m_selectedBarSeries && m_selectedBar.x() == candidate)
-                series->d_ptr->markItemLabelDirty();
-        }
-    }
+
     if (count) {
+        m_changedRows[series].insert(startIndex, count);
+        if (series == m_selectedBarSeries && m_selectedBar.x() >= startIndex
+                && m_selectedBar.x() < startIndex + count) {
+            series->d_ptr->markItemLabelDirty();
+        }
         m_changeTracker.rowsChanged = true;
 
         if (series->isVisible())
@@ -254,18 +239,8 @@ void Bars3DController::handleItemChanged(int rowIndex, int columnIndex)
 {
     QBar3DSeries *series = static_cast<QBarDataProxy *>(sender())->series();
 
-    bool newItem = true;
     QPoint candidate(rowIndex, columnIndex);
-    foreach (ChangeItem item, m_changedItems) {
-        if (item.point == candidate && item.series == series) {
-            newItem = false;
-            break;
-        }
-    }
-
-    if (newItem) {
-        ChangeItem newItem = {series, candidate};
-        m_changedItems.append(newItem);
+    if (m_changedItems[series].insert(IndexRangeSet::pointIndex(candidate))) {
         m_changeTracker.itemChanged = true;
 
         if (series == m_selectedBarSeries && m_selectedBar == candidate)
@@ -16,6 +16,7 @@
 
 #include <private/datavisualizationglobal_p.h>
 #include <private/abstract3dcontroller_p.h>
+#include <private/indexrangeset_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -48,19 +49,14 @@ class Q_DATAVISUALIZATION_EXPORT Bars3DController : public Abstract3DController
     Q_OBJECT
 
 public:
-    struct ChangeItem {
-        QBar3DSeries *series;
-        QPoint point;
-    };
-    struct ChangeRow {
-        QBar3DSeries *series;
-        int row;
-    };
+    // Changed items are stored as point indexes, see IndexRangeSet::pointIndex()
+    typedef QHash<QBar3DSeries *, IndexRangeSet> ChangedItems;
+    typedef QHash<QBar3DSeries *, IndexRangeSet> ChangedRows;
 
 private:
     Bars3DChangeBitField m_changeTracker;
-    QList<ChangeItem> m_changedItems;
-    QList<ChangeRow> m_changedRows;
+    ChangedItems m_changedItems;
+    ChangedRows m_changedRows;
 
     // Interaction
     QPoint m_selectedBar;     // Points to row & column in data window.
@@ -9,6 +9,7 @@
 #include "texturehelper_p.h"
 #include "utils_p.h"
 #include "barseriesrendercache_p.h"
+#include "frustum_p.h"
 
 #include <QtCore/qmath.h>
 
@@ -230,6 +231,7 @@ void Bars3DRenderer::updateData()
                     updateRenderRow(dataRow, renderRow);
                     dataRowIndex++;
                 }
+                cache->chunkBounds().invalidateAll();
                 cache->setDataDirty(false);
             }
         }
@@ -335,71 +337,85 @@ SeriesRenderCache *Bars3DRenderer::createNewCache(QAbstract3DSeries *series)
     return new BarSeriesRenderCache(series, this);
 }
 
-void Bars3DRenderer::updateRows(const QList<Bars3DController::ChangeRow> &rows)
+void Bars3DRenderer::updateRows(const Bars3DController::ChangedRows &rows)
 {
     int minRow = m_axisCacheZ.min();
     int maxRow = m_axisCacheZ.max();
-    BarSeriesRenderCache *cache = 0;
-    const QBar3DSeries *prevSeries = 0;
-    const QBarDataArray *dataArray = 0;
 
-    foreach (Bars3DController::ChangeRow item, rows) {
-        const int row = item.row;
-        if (row < minRow || row > maxRow)
+    for (auto it = rows.cbegin(); it != rows.cend(); ++it) {
+        QBar3DSeries *series = it.key();
+        BarSeriesRenderCache *cache =
+                static_cast<BarSeriesRenderCache *>(m_renderCacheList.value(series));
+        if (!cache)
             continue;
-        QBar3DSeries *currentSeries = item.series;
-        if (currentSeries != prevSeries) {
-            cache = static_cast<BarSeriesRenderCache *>(m_renderCacheList.value(currentSeries));
-            prevSeries = currentSeries;
-            dataArray = item.series->dataProxy()->array();
-            // Invisible series render caches are not updated, but instead just marked dirty, so that
-            // they can be completely recalculated when they are turned visible.
-            if (!cache->isVisible() && !cache->dataDirty())
+        // Invisible series render caches are not updated, but instead just marked dirty, so that
+        // they can be completely recalculated when they are turned visible.
+        if (!cache->isVisible()) {
+            if (!cache->dataDirty())
                 cache->setDataDirty(true);
+            continue;
         }
-        if (cache->isVisible()) {
-            updateRenderRow(dataArray->at(row), cache->renderArray()[row - minRow]);
-            if (m_cachedIsSlicingActivated
-                    && cache == m_selectedSeriesCache
-                    && m_selectedBarPos.x() == row) {
-                m_selectionDirty = true; // Need to update slice view
+
+        const QBarDataArray *dataArray = series->dataProxy()->array();
+        const QList<IndexRangeSet::Range> ranges = it.value().ranges();
+        foreach (const IndexRangeSet::Range &range, ranges) {
+            const int startRow = int(qMax(qint64(minRow), range.start));
+            const int endRow = int(qMin(qint64(maxRow), range.start + range.count - 1));
+            for (int row = startRow; row <= endRow; row++) {
+                BarRenderItemRow &renderRow = cache->renderArray()[row - minRow];
+                updateRenderRow(dataArray->at(row), renderRow);
+                for (int bar = 0; bar < renderRow.size(); bar++)
+                    cache->chunkBounds().invalidate((row - minRow) * renderRow.size() + bar);
+                if (m_cachedIsSlicingActivated
+                        && cache == m_selectedSeriesCache
+                        && m_selectedBarPos.x() == row) {
+                    m_selectionDirty = true; // Need to update slice view
+                }
             }
         }
     }
 }
 
-void Bars3DRenderer::updateItems(const QList<Bars3DController::ChangeItem> &items)
+void Bars3DRenderer::updateItems(const Bars3DController::ChangedItems &items)
 {
     int minRow = m_axisCacheZ.min();
     int maxRow = m_axisCacheZ.max();
     int minCol = m_axisCacheX.min();
     int maxCol = m_axisCacheX.max();
-    BarSeriesRenderCache *cache = 0;
-    const QBar3DSeries *prevSeries = 0;
-    const QBarDataArray *dataArray = 0;
-
-    foreach (Bars3DController::ChangeItem item, items) {
-        const int row = item.point.x();
-        const int col = item.point.y();
-        if (row < minRow || row > maxRow || col < minCol || col > maxCol)
+
+    for (auto it = items.cbegin(); it != items.cend(); ++it) {
+        QBar3DSeries *series = it.key();
+        BarSeriesRenderCache *cache =
+                static_cast<BarSeriesRenderCache *>(m_renderCacheList.value(series));
+        if (!cache)
             continue;
-        QBar3DSeries *currentSeries = item.series;
-        if (currentSeries != prevSeries) {
-            cache = static_cast<BarSeriesRenderCache *>(m_renderCacheList.value(currentSeries));
-            prevSeries = currentSeries;
-            dataArray = item.series->dataProxy()->array();
-            // Invisible series render caches are not updated, but instead just marked dirty, so that
-            // they can be completely recalculated when they are turned visible.
-            if (!cache->isVisible() && !cache->dataDirty())
+        // Invisible series render caches are not updated, but instead just marked dirty, so that
+        // they can be completely recalculated when they are turned visible.
+        if (!cache->isVisible()) {
+            if (!cache->dataDirty())
                 cache->setDataDirty(true);
+            continue;
         }
-        if (cache->isVisible()) {
-            updateRenderItem(dataArray->at(row)->at(col),
-                             cache->renderArray()[row - minRow][col - minCol]);
-            if (m_cachedIsSlicingActivated
-                    && cache == m_selectedSeriesCache
-                    && m_selectedBarPos == QPoint(row, col)) {
-                m_selectionDirty = true; // Need to update slice view
+
+        const QBarDataArray *dataArray = series->dataProxy()->array();
+        const QList<IndexRangeSet::Range> ranges = it.value().ranges();
+        foreach (const IndexRangeSet::Range &range, ranges) {
+            // Ranges never span multiple rows
+            const QPoint first = IndexRangeSet::indexPoint(range.start);
+            const int row = first.x();
+            if (row < minRow || row > maxRow)
+                continue;
+            const int startCol = qMax(minCol, first.y());
+            const int endCol = qMin(maxCol, int(first.y() + range.count - 1));
+            for (int col = startCol; col <= endCol; col++) {
+                BarRenderItemRow &renderRow = cache->renderArray()[row - minRow];
+                updateRenderItem(dataArray->at(row)->at(col), renderRow[col - minCol]);
+                cache->chunkBounds().invalidate((row - minRow) * renderRow.size() + col - minCol);
+                if (m_cachedIsSlicingActivated
+                        && cache == m_selectedSeriesCache
+                        && m_selectedBarPos == QPoint(row, col)) {
+                    m_selectionDirty = true; // Need to update slice view
+                }
             }
         }
     }
@@ -1060,11 +1076,14 @@ void Bars3DRenderer::drawScene(GLuint defaultFboHandle)
                 ObjectHelper *barObj = cache->object();
                 QQuaternion seriesRotation(cache->meshRotation());
                 const BarRenderItemArray &renderArray = cache->renderArray();
+                if (!cullBars(cache, depthProjectionViewMatrix, seriesPos, 1.0f, RenderingDepth))
+                    continue;
+                const ChunkBounds &bounds = cache->chunkBounds();
                 for (int row = startRow; row != stopRow; row += stepRow) {
                     const BarRenderItemRow &renderRow = renderArray.at(row);
                     for (int bar = startBar; bar != stopBar; bar += stepBar) {
                         const BarRenderItem &item = renderRow.at(bar);
-                        if (!item.value())
+                        if (!item.value() || bounds.isItemCulled(row * renderRow.size() + bar))
                             continue;
                         GLfloat shadowOffset = 0.0f;
                         // Set front face culling for negative valued bars and back face culling
@@ -1184,11 +1203,14 @@ void Bars3DRenderer::drawScene(GLuint defaultFboHandle)
                 ObjectHelper *barObj = cache->object();
                 QQuaternion seriesRotation(cache->meshRotation());
                 const BarRenderItemArray &renderArray = cache->renderArray();
+                if (!cullBars(cache, projectionViewMatrix, seriesPos, 1.0f, RenderingSelection))
+                    continue;
+                const ChunkBounds &bounds = cache->chunkBounds();
                 for (int row = startRow; row != stopRow; row += stepRow) {
                     const BarRenderItemRow &renderRow = renderArray.at(row);
                     for (int bar = startBar; bar != stopBar; bar += stepBar) {
                         const BarRenderItem &item = renderRow.at(bar);
-                        if (!item.value())
+                        if (!item.value() || bounds.isItemCulled(row * renderRow.size() + bar))
                             continue;
 
                         if (item.height() < 0)
@@ -1476,6 +1498,10 @@ bool Bars3DRenderer::drawBars(BarRenderItem **selectedBar,
             }
 
             previousColorStyle = colorStyle;
+
+            // Culled bars still need their selection state updated
+            cullBars(cache, projectionViewMatrix, seriesPos, reflection, RenderingNormal);
+            const ChunkBounds &bounds = cache->chunkBounds();
             for (int row = startRow; row != stopRow; row += stepRow) {
                 BarRenderItemRow &renderRow = renderArray[row];
                 for (int bar = startBar; bar != stopBar; bar += stepBar) {
@@ -1619,7 +1645,7 @@ bool Bars3DRenderer::drawBars(BarRenderItem **selectedBar,
                         }
                     }
 
-                    if (item.height() == 0) {
+                    if (item.height() == 0 || bounds.isItemCulled(row * renderRow.size() + bar)) {
                         continue;
                     } else if ((m_reflectionEnabled
                                 && (reflection == 1.0f
@@ -1681,6 +1707,37 @@ bool Bars3DRenderer::drawBars(BarRenderItem **selectedBar,
     return barSelectionFound;
 }
 
+// Culls the bars of the series against the frustum of the given matrix. Returns false if no bars
+// are left to draw.
+bool Bars3DRenderer::cullBars(BarSeriesRenderCache *cache, const QMatrix4x4 &projectionViewMatrix,
+                              float seriesPos, float reflection, RenderingState state)
+{
+    ChunkBounds &bounds = cache->chunkBounds();
+    cache->updateChunkBounds();
+
+    // Bar rotations are around the y-axis only, but series rotation can be arbitrary
+    if (!cache->meshRotation().isIdentity()) {
+        bounds.resetCulling();
+        return true;
+    }
+
+    // Bounds are in column, height and row coordinates
+    const float columnScale = m_cachedBarSpacing.width() / m_scaleFactor;
+    const float rowScale = m_cachedBarSpacing.height() / m_scaleFactor;
+    QMatrix4x4 itemToWorld;
+    itemToWorld.translate((seriesPos * m_cachedBarSpacing.width() - m_rowWidth) / m_scaleFactor,
+                          0.0f,
+                          (m_columnDepth - 0.5f * m_cachedBarSpacing.height()) / m_scaleFactor);
+    itemToWorld.scale(columnScale, reflection, -rowScale);
+
+    const float radius = cache->object()->radius()
+            * qMax(m_scaleX * m_seriesScaleX, m_scaleZ * m_seriesScaleZ);
+    const int culledCount = bounds.cull(Frustum(projectionViewMatrix * itemToWorld),
+                                        QVector3D(radius / columnScale, 0.0f, radius / rowScale));
+    m_culledItemCounts[state] += culledCount;
+    return !bounds.isAllCulled();
+}
+
 void Bars3DRenderer::drawBackground(GLfloat backgroundRotation,
                                     const QMatrix4x4 &depthProjectionViewMatrix,
                                     const QMatrix4x4 &projectionViewMatrix,
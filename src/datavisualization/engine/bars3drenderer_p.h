@@ -97,8 +97,8 @@ public:
     void updateData() override;
     void updateSeries(const QList<QAbstract3DSeries *> &seriesList) override;
     SeriesRenderCache *createNewCache(QAbstract3DSeries *series) override;
-    void updateRows(const QList<Bars3DController::ChangeRow> &rows);
-    void updateItems(const QList<Bars3DController::ChangeItem> &items);
+    void updateRows(const Bars3DController::ChangedRows &rows);
+    void updateItems(const Bars3DController::ChangedItems &items);
     void updateScene(Q3DScene *scene) override;
     void render(GLuint defaultFboHandle = 0) override;
 
@@ -143,6 +143,8 @@ private:
     void drawLabels(bool drawSelection, const Q3DCamera *activeCamera,
                     const QMatrix4x4 &viewMatrix, const QMatrix4x4 &projectionMatrix);
 
+    bool cullBars(BarSeriesRenderCache *cache, const QMatrix4x4 &projectionViewMatrix,
+                  float seriesPos, float reflection, RenderingState state);
     bool drawBars(BarRenderItem **selectedBar, const QMatrix4x4 &depthProjectionViewMatrix,
                   const QMatrix4x4 &projectionViewMatrix, const QMatrix4x4 &viewMatrix,
                   GLint startRow, GLint stopRow, GLint stepRow,
@@ -20,8 +20,48 @@ void BarSeriesRenderCache::cleanup(TextureHelper *texHelper)
 {
     m_renderArray.clear();
     m_sliceArray.clear();
+    m_chunkBounds.resize(0);
 
     SeriesRenderCache::cleanup(texHelper);
 }
 
+// Recomputes the bounds of the chunks that have changed items. Items are indexed row by row,
+// and bounds are in column index, height and row index coordinates.
+void BarSeriesRenderCache::updateChunkBounds()
+{
+    const int rowCount = m_renderArray.size();
+    const int columnCount = rowCount ? m_renderArray.at(0).size() : 0;
+    const int itemCount = rowCount * columnCount;
+    m_chunkBounds.resize(itemCount);
+    const QList<int> dirtyChunks = m_chunkBounds.takeDirtyChunks();
+    for (int chunk : dirtyChunks) {
+        const int first = chunk * ChunkBounds::chunkSize;
+        const int end = qMin(first + ChunkBounds::chunkSize, itemCount);
+        QVector3D minimum;
+        QVector3D maximum;
+        int visibleCount = 0;
+        for (int i = first; i < end; i++) {
+            const int row = i / columnCount;
+            const int bar = i % columnCount;
+            const BarRenderItem &item = m_renderArray.at(row).at(bar);
+            if (item.height() == 0.0f)
+                continue;
+            // Bar meshes span from zero to twice the height
+            const float bottom = qMin(0.0f, 2.0f * item.height());
+            const float top = qMax(0.0f, 2.0f * item.height());
+            if (!visibleCount) {
+                minimum = QVector3D(bar, bottom, row);
+                maximum = QVector3D(bar, top, row);
+            } else {
+                minimum = QVector3D(qMin(minimum.x(), float(bar)), qMin(minimum.y(), bottom),
+                                    qMin(minimum.z(), float(row)));
+                maximum = QVector3D(qMax(maximum.x(), float(bar)), qMax(maximum.y(), top),
+                                    qMax(maximum.z(), float(row)));
+            }
+            visibleCount++;
+        }
+        m_chunkBounds.setChunkBounds(chunk, minimum, maximum, visibleCount);
+    }
+}
+
 QT_END_NAMESPACE
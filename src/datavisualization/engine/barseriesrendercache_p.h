@@ -18,6 +18,7 @@
 #include "seriesrendercache_p.h"
 #include "qbar3dseries_p.h"
 #include "barrenderitem_p.h"
+#include "chunkbounds_p.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -34,11 +35,14 @@ public:
     inline QList<BarRenderSliceItem> &sliceArray() { return m_sliceArray; }
     inline void setVisualIndex(int index) { m_visualIndex = index; }
     inline int visualIndex() {return m_visualIndex; }
+    inline ChunkBounds &chunkBounds() { return m_chunkBounds; }
+    void updateChunkBounds();
 
 protected:
     BarRenderItemArray m_renderArray;
     QList<BarRenderSliceItem> m_sliceArray;
     int m_visualIndex; // order of the series is relevant
+    ChunkBounds m_chunkBounds; // Used for frustum culling, in column, height and row coordinates
 };
 
 QT_END_NAMESPACE
@@ -8,10 +8,16 @@
 #include "texturehelper_p.h"
 #include "abstract3drenderer_p.h"
 #include "scatterpointbufferhelper_p.h"
+#include "scatterinstancebufferhelper_p.h"
+#include "scatterobjectbufferhelper_p.h"
+#include "scatterdensitybufferhelper_p.h"
 
 #include <QtGui/QMatrix4x4>
+#include <QtGui/QOpenGLExtraFunctions>
 #include <QtCore/qmath.h>
 
+#include <cstddef>
+
 // Resources need to be explicitly initialized when building as static library
 class StaticLibInitializer
 {
@@ -106,9 +112,12 @@ void Drawer::drawObject(ShaderHelper *shader, AbstractObjectHelper *object, GLui
 #endif
 
     // 1st attribute buffer : vertices
-    glEnableVertexAttribArray(shader->posAtt());
-    glBindBuffer(GL_ARRAY_BUFFER, object->vertexBuf());
-    glVertexAttribPointer(shader->posAtt(), 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
+    // Height mapped surfaces generate the vertices from the UVs
+    if (shader->posAtt() >= 0) {
+        glEnableVertexAttribArray(shader->posAtt());
+        glBindBuffer(GL_ARRAY_BUFFER, object->vertexBuf());
+        glVertexAttribPointer(shader->posAtt(), 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
+    }
 
     // 2nd attribute buffer : normals
     if (shader->normalAtt() >= 0) {
@@ -138,7 +147,8 @@ void Drawer::drawObject(ShaderHelper *shader, AbstractObjectHelper *object, GLui
         glDisableVertexAttribArray(shader->uvAtt());
     if (shader->normalAtt() >= 0)
         glDisableVertexAttribArray(shader->normalAtt());
-    glDisableVertexAttribArray(shader->posAtt());
+    if (shader->posAtt() >= 0)
+        glDisableVertexAttribArray(shader->posAtt());
 
     // Release textures
 #if !QT_CONFIG(opengles2)
@@ -169,17 +179,258 @@ void Drawer::drawSelectionObject(ShaderHelper *shader, AbstractObjectHelper *obj
     glDisableVertexAttribArray(shader->posAtt());
 }
 
-void Drawer::drawSurfaceGrid(ShaderHelper *shader, SurfaceObject *object)
+void Drawer::drawInstancedObject(ShaderHelper *shader, AbstractObjectHelper *object,
+                                 ScatterInstanceBufferHelper *instances, GLuint textureId,
+                                 GLuint depthTextureId)
 {
-    // Get grid line color
-    QVector4D lineColor = Utils::vectorFromColor(object->wireframeColor());
-    shader->setUniformValue(shader->color(), lineColor);
+    QOpenGLExtraFunctions *extraFuncs = QOpenGLContext::currentContext()->extraFunctions();
+
+    if (textureId) {
+        // Activate texture
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, textureId);
+        shader->setUniformValue(shader->texture(), 0);
+    }
+
+    if (depthTextureId) {
+        // Activate depth texture
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, depthTextureId);
+        shader->setUniformValue(shader->shadow(), 1);
+    }
+
+    // 1st attribute buffer : vertices
+    glEnableVertexAttribArray(shader->posAtt());
+    glBindBuffer(GL_ARRAY_BUFFER, object->vertexBuf());
+    glVertexAttribPointer(shader->posAtt(), 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
+
+    // 2nd attribute buffer : normals
+    if (shader->normalAtt() >= 0) {
+        glEnableVertexAttribArray(shader->normalAtt());
+        glBindBuffer(GL_ARRAY_BUFFER, object->normalBuf());
+        glVertexAttribPointer(shader->normalAtt(), 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
+    }
+
+    // 3rd attribute buffer : instance positions, advanced once per instance
+    glEnableVertexAttribArray(shader->instancePosAtt());
+    glBindBuffer(GL_ARRAY_BUFFER, instances->positionBuf());
+    glVertexAttribPointer(shader->instancePosAtt(), 4, GL_FLOAT, GL_FALSE, 0, (void*)0);
+    extraFuncs->glVertexAttribDivisor(shader->instancePosAtt(), 1);
+
+    // 4th attribute buffer : instance rotations, advanced once per instance
+    const bool hasRotation = shader->instanceRotAtt() >= 0;
+    if (hasRotation) {
+        glEnableVertexAttribArray(shader->instanceRotAtt());
+        glBindBuffer(GL_ARRAY_BUFFER, instances->rotationBuf());
+        glVertexAttribPointer(shader->instanceRotAtt(), 4, GL_FLOAT, GL_FALSE, 0, (void*)0);
+        extraFuncs->glVertexAttribDivisor(shader->instanceRotAtt(), 1);
+    }
+
+    // 5th attribute buffer : item colors and sizes, advanced once per instance
+    const GLuint styleBuffer = instances->styleBuf();
+    enableItemStyles(shader, styleBuffer, 0, true);
+
+    // Index buffer
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, object->elementBuf());
+
+    if (instances->hasDrawRanges()) {
+        // Draw each range of instances by offsetting the instance attributes to its start
+        const int instanceCount = int(instances->instanceCount());
+        for (const QPair<int, int> &range : instances->drawRanges()) {
+            if (range.first >= instanceCount)
+                break;
+            void *offset = (void *)(range.first * sizeof(QVector4D));
+            glBindBuffer(GL_ARRAY_BUFFER, instances->positionBuf());
+            glVertexAttribPointer(shader->instancePosAtt(), 4, GL_FLOAT, GL_FALSE, 0, offset);
+            if (hasRotation) {
+                glBindBuffer(GL_ARRAY_BUFFER, instances->rotationBuf());
+                glVertexAttribPointer(shader->instanceRotAtt(), 4, GL_FLOAT, GL_FALSE, 0,
+                                      offset);
+            }
+            enableItemStyles(shader, styleBuffer, range.first, true);
+            extraFuncs->glDrawElementsInstanced(GL_TRIANGLES, object->indexCount(),
+                                                GL_UNSIGNED_INT, (void*)0,
+                                                qMin(range.second, instanceCount - range.first));
+        }
+    } else {
+        // Draw the triangles of all instances
+        extraFuncs->glDrawElementsInstanced(GL_TRIANGLES, object->indexCount(), GL_UNSIGNED_INT,
+                                            (void*)0, instances->instanceCount());
+    }
+
+    // Free buffers
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    disableItemStyles(shader, styleBuffer, true);
+    if (hasRotation) {
+        extraFuncs->glVertexAttribDivisor(shader->instanceRotAtt(), 0);
+        glDisableVertexAttribArray(shader->instanceRotAtt());
+    }
+    extraFuncs->glVertexAttribDivisor(shader->instancePosAtt(), 0);
+    glDisableVertexAttribArray(shader->instancePosAtt());
+    if (shader->normalAtt() >= 0)
+        glDisableVertexAttribArray(shader->normalAtt());
+    glDisableVertexAttribArray(shader->posAtt());
+
+    // Release textures
+    if (depthTextureId) {
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+    if (textureId) {
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+}
+
+// Draws a static scatter mesh with the instanced shaders, with the instance attributes repeated
+// for each vertex
+void Drawer::drawStaticObject(ShaderHelper *shader, ScatterObjectBufferHelper *object,
+                              GLuint textureId, GLuint depthTextureId)
+{
+    if (textureId) {
+        // Activate texture
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, textureId);
+        shader->setUniformValue(shader->texture(), 0);
+    }
+
+    if (depthTextureId) {
+        // Activate depth texture
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, depthTextureId);
+        shader->setUniformValue(shader->shadow(), 1);
+    }
+
+    // 1st attribute buffer : vertices
+    glEnableVertexAttribArray(shader->posAtt());
+    glBindBuffer(GL_ARRAY_BUFFER, object->vertexBuf());
+    glVertexAttribPointer(shader->posAtt(), 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
+
+    // 2nd attribute buffer : normals
+    if (shader->normalAtt() >= 0) {
+        glEnableVertexAttribArray(shader->normalAtt());
+        glBindBuffer(GL_ARRAY_BUFFER, object->normalBuf());
+        glVertexAttribPointer(shader->normalAtt(), 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
+    }
+
+    // 3rd attribute buffer : item positions
+    glEnableVertexAttribArray(shader->instancePosAtt());
+    glBindBuffer(GL_ARRAY_BUFFER, object->positionBuf());
+    glVertexAttribPointer(shader->instancePosAtt(), 4, GL_FLOAT, GL_FALSE, 0, (void*)0);
+
+    // 4th attribute buffer : item rotations
+    const bool hasRotation = shader->instanceRotAtt() >= 0;
+    if (hasRotation) {
+        glEnableVertexAttribArray(shader->instanceRotAtt());
+        glBindBuffer(GL_ARRAY_BUFFER, object->rotationBuf());
+        glVertexAttribPointer(shader->instanceRotAtt(), 4, GL_FLOAT, GL_FALSE, 0, (void*)0);
+    }
+
+    // Series color and size
+    enableItemStyles(shader, 0, 0, false);
+
+    // Index buffer
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, object->elementBuf());
+
+    // Draw the triangles
+    glDrawElements(GL_TRIANGLES, object->indexCount(), GL_UNSIGNED_INT, (void*)0);
+
+    // Free buffers
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    if (hasRotation)
+        glDisableVertexAttribArray(shader->instanceRotAtt());
+    glDisableVertexAttribArray(shader->instancePosAtt());
+    if (shader->normalAtt() >= 0)
+        glDisableVertexAttribArray(shader->normalAtt());
+    glDisableVertexAttribArray(shader->posAtt());
+
+    // Release textures
+    if (depthTextureId) {
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+    if (textureId) {
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+}
+
+void Drawer::drawImpostor(ShaderHelper *shader, AbstractObjectHelper *object,
+                          const QVector4D &instancePosition, const QVector4D &instanceRotation,
+                          GLuint textureId, GLuint depthTextureId)
+{
+    if (textureId) {
+        // Activate texture
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, textureId);
+        shader->setUniformValue(shader->texture(), 0);
+    }
+
+    if (depthTextureId) {
+        // Activate depth texture
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, depthTextureId);
+        shader->setUniformValue(shader->shadow(), 1);
+    }
 
     // 1st attribute buffer : vertices
     glEnableVertexAttribArray(shader->posAtt());
     glBindBuffer(GL_ARRAY_BUFFER, object->vertexBuf());
     glVertexAttribPointer(shader->posAtt(), 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
 
+    // Instance attributes of a single item are constant vertex attributes
+    glVertexAttrib4f(shader->instancePosAtt(), instancePosition.x(), instancePosition.y(),
+                     instancePosition.z(), instancePosition.w());
+    if (shader->instanceRotAtt() >= 0) {
+        glVertexAttrib4f(shader->instanceRotAtt(), instanceRotation.x(), instanceRotation.y(),
+                         instanceRotation.z(), instanceRotation.w());
+    }
+    enableItemStyles(shader, 0, 0, false);
+
+    // Index buffer
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, object->elementBuf());
+
+    // Draw the triangles
+    glDrawElements(GL_TRIANGLES, object->indexCount(), GL_UNSIGNED_INT, (void*)0);
+
+    // Free buffers
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    glDisableVertexAttribArray(shader->posAtt());
+
+    // Release textures
+    if (depthTextureId) {
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+    if (textureId) {
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+}
+
+void Drawer::drawSurfaceGrid(ShaderHelper *shader, SurfaceObject *object)
+{
+    // Get grid line color
+    QVector4D lineColor = Utils::vectorFromColor(object->wireframeColor());
+    shader->setUniformValue(shader->color(), lineColor);
+
+    // 1st attribute buffer : vertices, or UVs for height mapped surfaces
+    if (shader->posAtt() >= 0) {
+        glEnableVertexAttribArray(shader->posAtt());
+        glBindBuffer(GL_ARRAY_BUFFER, object->vertexBuf());
+        glVertexAttribPointer(shader->posAtt(), 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
+    } else {
+        glEnableVertexAttribArray(shader->uvAtt());
+        glBindBuffer(GL_ARRAY_BUFFER, object->uvBuf());
+        glVertexAttribPointer(shader->uvAtt(), 2, GL_FLOAT, GL_FALSE, 0, (void*)0);
+    }
+
     // Index buffer
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, object->gridElementBuf());
 
@@ -190,7 +441,10 @@ void Drawer::drawSurfaceGrid(ShaderHelper *shader, SurfaceObject *object)
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
-    glDisableVertexAttribArray(shader->posAtt());
+    if (shader->posAtt() >= 0)
+        glDisableVertexAttribArray(shader->posAtt());
+    else
+        glDisableVertexAttribArray(shader->uvAtt());
 }
 
 void Drawer::drawPoint(ShaderHelper *shader)
@@ -239,13 +493,34 @@ void Drawer::drawPoints(ShaderHelper *shader, ScatterPointBufferHelper *object,
         glVertexAttribPointer(shader->uvAtt(), 2, GL_FLOAT, GL_FALSE, 0, (void*)0);
     }
 
+    // 3rd attribute buffer : item colors and sizes
+    const GLuint styleBuffer = object->styleBuf();
+    enableItemStyles(shader, styleBuffer, 0, false);
+
     // Draw the points
-    glDrawArrays(GL_POINTS, 0, object->indexCount());
+    if (object->hasSubset()) {
+        if (object->subsetCount()) {
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, object->elementBuf());
+            glDrawElements(GL_POINTS, object->subsetCount(), GL_UNSIGNED_INT, (void*)0);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        }
+    } else if (object->hasDrawRanges()) {
+        const int pointCount = int(object->indexCount());
+        for (const QPair<int, int> &range : object->drawRanges()) {
+            if (range.first < pointCount) {
+                glDrawArrays(GL_POINTS, range.first,
+                             qMin(range.second, pointCount - range.first));
+            }
+        }
+    } else {
+        glDrawArrays(GL_POINTS, 0, object->indexCount());
+    }
 
     // Free buffers
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 
     glDisableVertexAttribArray(shader->posAtt());
+    disableItemStyles(shader, styleBuffer, false);
 
     if (textureId) {
         glDisableVertexAttribArray(shader->uvAtt());
@@ -254,6 +529,85 @@ void Drawer::drawPoints(ShaderHelper *shader, ScatterPointBufferHelper *object,
     }
 }
 
+void Drawer::drawDensity(ShaderHelper *shader, ScatterDensityBufferHelper *object,
+                         GLuint textureId)
+{
+    // Activate gradient texture
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, textureId);
+    shader->setUniformValue(shader->texture(), 0);
+
+    // 1st attribute buffer : cell centers and densities
+    glEnableVertexAttribArray(shader->posAtt());
+    glBindBuffer(GL_ARRAY_BUFFER, object->vertexBuf());
+    glVertexAttribPointer(shader->posAtt(), 4, GL_FLOAT, GL_FALSE, 0, (void*)0);
+
+    // Draw the cells
+    glDrawArrays(GL_POINTS, 0, object->indexCount());
+
+    // Free buffers
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glDisableVertexAttribArray(shader->posAtt());
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+// Binds item colors and sizes starting from the given item, or sets them to zero for the
+// series values if there is no style buffer
+void Drawer::enableItemStyles(ShaderHelper *shader, GLuint styleBuffer, int first, bool instanced)
+{
+    const GLint colorAtt = shader->itemColorAtt();
+    const GLint sizeAtt = shader->itemSizeAtt();
+    if (!styleBuffer) {
+        if (colorAtt >= 0)
+            glVertexAttrib4f(colorAtt, 0.0f, 0.0f, 0.0f, 0.0f);
+        if (sizeAtt >= 0)
+            glVertexAttrib1f(sizeAtt, 0.0f);
+        return;
+    }
+
+    QOpenGLExtraFunctions *extraFuncs = QOpenGLContext::currentContext()->extraFunctions();
+    const GLsizei stride = sizeof(ScatterItemStyle);
+    const size_t offset = size_t(first) * stride;
+    glBindBuffer(GL_ARRAY_BUFFER, styleBuffer);
+    if (colorAtt >= 0) {
+        glEnableVertexAttribArray(colorAtt);
+        glVertexAttribPointer(colorAtt, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride,
+                              (void *)(offset + offsetof(ScatterItemStyle, color)));
+        if (instanced)
+            extraFuncs->glVertexAttribDivisor(colorAtt, 1);
+    }
+    if (sizeAtt >= 0) {
+        glEnableVertexAttribArray(sizeAtt);
+        glVertexAttribPointer(sizeAtt, 1, GL_FLOAT, GL_FALSE, stride,
+                              (void *)(offset + offsetof(ScatterItemStyle, size)));
+        if (instanced)
+            extraFuncs->glVertexAttribDivisor(sizeAtt, 1);
+    }
+}
+
+void Drawer::disableItemStyles(ShaderHelper *shader, GLuint styleBuffer, bool instanced)
+{
+    if (!styleBuffer)
+        return;
+
+    QOpenGLExtraFunctions *extraFuncs = QOpenGLContext::currentContext()->extraFunctions();
+    const GLint colorAtt = shader->itemColorAtt();
+    const GLint sizeAtt = shader->itemSizeAtt();
+    if (colorAtt >= 0) {
+        if (instanced)
+            extraFuncs->glVertexAttribDivisor(colorAtt, 0);
+        glDisableVertexAttribArray(colorAtt);
+    }
+    if (sizeAtt >= 0) {
+        if (instanced)
+            extraFuncs->glVertexAttribDivisor(sizeAtt, 0);
+        glDisableVertexAttribArray(sizeAtt);
+    }
+}
+
 void Drawer::drawLine(ShaderHelper *shader)
 {
     // Draw a single line
@@ -31,6 +31,9 @@ class TextureHelper;
 class Q3DCamera;
 class Abstract3DRenderer;
 class ScatterPointBufferHelper;
+class ScatterInstanceBufferHelper;
+class ScatterObjectBufferHelper;
+class ScatterDensityBufferHelper;
 
 class Drawer : public QObject, public QOpenGLFunctions
 {
@@ -63,9 +66,18 @@ public:
     void drawObject(ShaderHelper *shader, AbstractObjectHelper *object, GLuint textureId = 0,
                     GLuint depthTextureId = 0, GLuint textureId3D = 0);
     void drawSelectionObject(ShaderHelper *shader, AbstractObjectHelper *object);
+    void drawInstancedObject(ShaderHelper *shader, AbstractObjectHelper *object,
+                             ScatterInstanceBufferHelper *instances, GLuint textureId = 0,
+                             GLuint depthTextureId = 0);
+    void drawStaticObject(ShaderHelper *shader, ScatterObjectBufferHelper *object,
+                          GLuint textureId = 0, GLuint depthTextureId = 0);
+    void drawImpostor(ShaderHelper *shader, AbstractObjectHelper *object,
+                      const QVector4D &instancePosition, const QVector4D &instanceRotation,
+                      GLuint textureId = 0, GLuint depthTextureId = 0);
     void drawSurfaceGrid(ShaderHelper *shader, SurfaceObject *object);
     void drawPoint(ShaderHelper *shader);
     void drawPoints(ShaderHelper *shader, ScatterPointBufferHelper *object, GLuint textureId);
+    void drawDensity(ShaderHelper *shader, ScatterDensityBufferHelper *object, GLuint textureId);
     void drawLine(ShaderHelper *shader);
     void drawLabel(const AbstractRenderItem &item, const LabelItem &labelItem,
                    const QMatrix4x4 &viewmatrix, const QMatrix4x4 &projectionmatrix,
@@ -83,6 +95,9 @@ Q_SIGNALS:
     void drawerChanged();
 
 private:
+    void enableItemStyles(ShaderHelper *shader, GLuint styleBuffer, int first, bool instanced);
+    void disableItemStyles(ShaderHelper *shader, GLuint styleBuffer, bool instanced);
+
     Q3DTheme *m_theme;
     TextureHelper *m_textureHelper;
     GLuint m_pointbuffer;
@@ -140,6 +140,17 @@ QT_BEGIN_NAMESPACE
            Provides the full feature set at a reasonable performance.
     \value OptimizationStatic
            Optimizes the rendering of static data sets at the expense of some features.
+    \value OptimizationAxisMapping
+           Maps data values to graph positions in the vertex shader, so that axis range
+           changes do not require the item buffers to be recalculated or uploaded again.
+           Applies only to scatter series drawn with instancing, and only if the axes use
+           the built-in formatters. Frustum culling and level of detail are not used for
+           these series. This value was introduced in Qt 6.9.
+    \value OptimizationSphereImpostors
+           Draws the items of sphere mesh series as camera facing quads, and ray traces
+           the sphere surfaces in the fragment shader instead of drawing the sphere mesh
+           for each item. The spheres are always smooth. Applies only to scatter series
+           drawn with instancing on desktop OpenGL. This value was introduced in Qt 6.9.
 */
 
 /*!
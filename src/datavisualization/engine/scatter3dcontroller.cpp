@@ -13,6 +13,9 @@
 QT_BEGIN_NAMESPACE
 
 static const int insertRemoveRecordReserveSize = 31;
+// Each splice moves the items after it, so series edited more often than this between renders
+// are reloaded instead.
+static const int maxItemSpliceCount = 16;
 
 Scatter3DController::Scatter3DController(QRect boundRect, Q3DScene *scene)
     : Abstract3DController(boundRect, scene),
@@ -57,6 +60,13 @@ void Scatter3DController::synchDataToRenderer()
     if (!isInitialized())
         return;
 
+    // Render arrays are spliced without a data update, unless some series could not be spliced
+    if (m_insertedAndRemovedItems.size()) {
+        if (m_renderer->updateInsertedAndRemovedItems(m_insertedAndRemovedItems))
+            m_isDataDirty = true;
+        m_insertedAndRemovedItems.clear();
+    }
+
     Abstract3DController::synchDataToRenderer();
 
     // Notify changes to renderer
@@ -89,6 +99,8 @@ void Scatter3DController::removeSeries(QAbstract3DSeries *series)
 
     Abstract3DController::removeSeries(series);
 
+    clearItemSplices(series);
+
     if (m_selectedItemSeries == series)
         setSelectedItem(invalidSelectionIndex(), 0);
 
@@ -121,6 +133,7 @@ void Scatter3DController::handleArrayReset()
         adjustAxisRanges();
         m_isDataDirty = true;
     }
+    clearItemSplices(series);
     if (!m_changedSeriesList.contains(series))
         m_changedSeriesList.append(series);
     setSelectedItem(m_selectedItem, m_selectedItemSeries);
@@ -130,44 +143,26 @@ void Scatter3DController::handleArrayReset()
 
 void Scatter3DController::handleItemsAdded(int startIndex, int count)
 {
-    Q_UNUSED(startIndex);
-    Q_UNUSED(count);
     QScatter3DSeries *series = static_cast<QScatterDataProxy *>(sender())->series();
-    if (series->isVisible()) {
+    // Axis ranges only invalidate the item positions if they actually change
+    if (series->isVisible())
         adjustAxisRanges();
+    // Series that are not spliced are reloaded
+    if (!recordItemSplice(true, startIndex, count, series) && series->isVisible())
         m_isDataDirty = true;
-    }
-    if (!m_changedSeriesList.contains(series))
-        m_changedSeriesList.append(series);
     emitNeedRender();
 }
 
 void Scatter3DController::handleItemsChanged(int startIndex, int count)
 {
     QScatter3DSeries *series = static_cast<QScatterDataProxy *>(sender())->series();
-    int oldChangeCount = m_changedItems.size();
-    if (!oldChangeCount)
-        m_changedItems.reserve(count);
-
-    for (int i = 0; i < count; i++) {
-        bool newItem = true;
-        int candidate = startIndex + i;
-        for (int j = 0; j < oldChangeCount; j++) {
-            const ChangeItem &oldChangeItem = m_changedItems.at(j);
-            if (oldChangeItem.index == candidate && series == oldChangeItem.series) {
-                newItem = false;
-                break;
-            }
-        }
-        if (newItem) {
-            ChangeItem newChangeItem = {series, candidate};
-            m_changedItems.append(newChangeItem);
-            if (series == m_selectedItemSeries && m_selectedItem == candidate)
-                series->d_ptr->markItemLabelDirty();
-        }
-    }
 
     if (count) {
+        m_changedItems[series].insert(startIndex, count);
+        if (series == m_selectedItemSeries && m_selectedItem >= startIndex
+                && m_selectedItem < startIndex + count) {
+            series->d_ptr->markItemLabelDirty();
+        }
         m_changeTracker.itemChanged = true;
         if (series->isVisible())
             adjustAxisRanges();
@@ -177,8 +172,6 @@ void Scatter3DController::handleItemsChanged(int startIndex, int count)
 
 void Scatter3DController::handleItemsRemoved(int startIndex, int count)
 {
-    Q_UNUSED(startIndex);
-    Q_UNUSED(count);
     QScatter3DSeries *series = static_cast<QScatterDataProxy *>(sender())->series();
     if (series == m_selectedItemSeries) {
         // If items removed from selected series before the selection, adjust the selection
@@ -193,12 +186,10 @@ void Scatter3DController::handleItemsRemoved(int startIndex, int count)
         }
     }
 
-    if (series->isVisible()) {
+    if (series->isVisible())
         adjustAxisRanges();
+    if (!recordItemSplice(false, startIndex, count, series) && series->isVisible())
         m_isDataDirty = true;
-    }
-    if (!m_changedSeriesList.contains(series))
-        m_changedSeriesList.append(series);
 
     if (m_recordInsertsAndRemoves) {
         InsertRemoveRecord record(false, startIndex, count, series);
@@ -210,8 +201,6 @@ void Scatter3DController::handleItemsRemoved(int startIndex, int count)
 
 void Scatter3DController::handleItemsInserted(int startIndex, int count)
 {
-    Q_UNUSED(startIndex);
-    Q_UNUSED(count);
     QScatter3DSeries *series = static_cast<QScatterDataProxy *>(sender())->series();
     if (series == m_selectedItemSeries) {
         // If items inserted to selected series before the selection, adjust the selection
@@ -222,12 +211,10 @@ void Scatter3DController::handleItemsInserted(int startIndex, int count)
         }
     }
 
-    if (series->isVisible()) {
+    if (series->isVisible())
         adjustAxisRanges();
+    if (!recordItemSplice(true, startIndex, count, series) && series->isVisible())
         m_isDataDirty = true;
-    }
-    if (!m_changedSeriesList.contains(series))
-        m_changedSeriesList.append(series);
 
     if (m_recordInsertsAndRemoves) {
         InsertRemoveRecord record(true, startIndex, count, series);
@@ -251,6 +238,45 @@ void Scatter3DController::startRecordingRemovesAndInserts()
     }
 }
 
+// Records inserted or removed items to be spliced into the render items of the series, instead
+// of reloading all of them. Returns false if the series is reloaded instead.
+bool Scatter3DController::recordItemSplice(bool isInsert, int startIndex, int count,
+                                           QScatter3DSeries *series)
+{
+    // Pending item changes refer to the indexes after all edits
+    auto changed = m_changedItems.find(series);
+    if (changed != m_changedItems.end()) {
+        if (isInsert)
+            changed->adjustForInsert(startIndex, count);
+        else
+            changed->adjustForRemove(startIndex, count);
+    }
+
+    if (m_changedSeriesList.contains(series))
+        return false;
+
+    int spliceCount = 0;
+    for (const InsertRemoveRecord &record : std::as_const(m_insertedAndRemovedItems)) {
+        if (record.m_series == series)
+            spliceCount++;
+    }
+    if (spliceCount < maxItemSpliceCount) {
+        m_insertedAndRemovedItems.append(InsertRemoveRecord(isInsert, startIndex, count, series));
+        return true;
+    }
+    clearItemSplices(series);
+    m_changedSeriesList.append(series);
+    return false;
+}
+
+// Drops the recorded splices of a series that is reloaded or removed
+void Scatter3DController::clearItemSplices(QAbstract3DSeries *series)
+{
+    m_insertedAndRemovedItems.removeIf([series](const InsertRemoveRecord &record) {
+        return record.m_series == series;
+    });
+}
+
 void Scatter3DController::handleAxisAutoAdjustRangeChangedInOrientation(
         QAbstract3DAxis::AxisOrientation orientation, bool autoAdjust)
 {
@@ -16,6 +16,7 @@
 
 #include <private/datavisualizationglobal_p.h>
 #include <private/abstract3dcontroller_p.h>
+#include <private/indexrangeset_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -39,19 +40,7 @@ class Q_DATAVISUALIZATION_EXPORT Scatter3DController : public Abstract3DControll
     Q_OBJECT
 
 public:
-    struct ChangeItem {
-        QScatter3DSeries *series;
-        int index;
-    };
-private:
-    Scatter3DChangeBitField m_changeTracker;
-    QList<ChangeItem> m_changedItems;
-
-    // Rendering
-    Scatter3DRenderer *m_renderer;
-    int m_selectedItem;
-    QScatter3DSeries *m_selectedItemSeries; // Points to the series for which the bar is selected
-                                            // in single series selection cases.
+    typedef QHash<QScatter3DSeries *, IndexRangeSet> ChangedItems;
 
     struct InsertRemoveRecord {
         bool m_isInsert;
@@ -74,8 +63,19 @@ private:
         {}
     };
 
+private:
+    Scatter3DChangeBitField m_changeTracker;
+    ChangedItems m_changedItems;
+
+    // Rendering
+    Scatter3DRenderer *m_renderer;
+    int m_selectedItem;
+    QScatter3DSeries *m_selectedItemSeries; // Points to the series for which the bar is selected
+                                            // in single series selection cases.
+
     QList<InsertRemoveRecord> m_insertRemoveRecords;
     bool m_recordInsertsAndRemoves;
+    QList<InsertRemoveRecord> m_insertedAndRemovedItems; // Spliced into the render items
 
 public:
     explicit Scatter3DController(QRect rect, Q3DScene *scene = 0);
@@ -118,6 +118,8 @@ protected:
     void startRecordingRemovesAndInserts() override;
 
 private:
+    bool recordItemSplice(bool isInsert, int startIndex, int count, QScatter3DSeries *series);
+    void clearItemSplices(QAbstract3DSeries *series);
 
     Q_DISABLE_COPY(Scatter3DController)
 };
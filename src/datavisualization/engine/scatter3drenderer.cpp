@@ -11,9 +11,16 @@
 #include "scatterseriesrendercache_p.h"
 #include "scatterobjectbufferhelper_p.h"
 #include "scatterpointbufferhelper_p.h"
+#include "scatterinstancebufferhelper_p.h"
+#include "scatterdensitybufferhelper_p.h"
+#include "frustum_p.h"
+#include "qscatterdataproxy_p.h"
 
 #include <QtCore/qmath.h>
 
+#include <algorithm>
+#include <limits>
+
 // You can verify that depth buffer drawing works correctly by uncommenting this.
 // You should see the scene from  where the light is
 //#define SHOW_DEPTH_TEXTURE_SCENE
@@ -22,7 +29,7 @@ QT_BEGIN_NAMESPACE
 
 const GLfloat defaultMinSize = 0.01f;
 const GLfloat defaultMaxSize = 0.1f;
-const GLfloat itemScaler = 3.0f;
+const int renderItemChunkSize = 16384;
 
 Scatter3DRenderer::Scatter3DRenderer(Scatter3DController *controller)
     : Abstract3DRenderer(controller),
@@ -37,6 +44,14 @@ Scatter3DRenderer::Scatter3DRenderer(Scatter3DController *controller)
       m_selectionShader(0),
       m_backgroundShader(0),
       m_staticGradientPointShader(0),
+      m_dotInstancedShader(0),
+      m_dotGradientInstancedShader(0),
+      m_depthInstancedShader(0),
+      m_impostorShader(0),
+      m_impostorGradientShader(0),
+      m_depthImpostorShader(0),
+      m_itemStylePointShader(0),
+      m_densityShader(0),
       m_bgrTexture(0),
       m_selectionTexture(0),
       m_depthFrameBuffer(0),
@@ -56,7 +71,10 @@ Scatter3DRenderer::Scatter3DRenderer(Scatter3DController *controller)
       m_havePointSeries(false),
       m_haveMeshSeries(false),
       m_haveUniformColorMeshSeries(false),
-      m_haveGradientMeshSeries(false)
+      m_haveGradientMeshSeries(false),
+      m_instancingSupported(false),
+      m_pickedSeriesCache(0),
+      m_pickedIndex(Scatter3DController::invalidSelectionIndex())
 {
     initializeOpenGL();
 }
@@ -72,6 +90,14 @@ Scatter3DRenderer::~Scatter3DRenderer()
     delete m_selectionShader;
     delete m_backgroundShader;
     delete m_staticGradientPointShader;
+    delete m_dotInstancedShader;
+    delete m_dotGradientInstancedShader;
+    delete m_depthInstancedShader;
+    delete m_impostorShader;
+    delete m_impostorGradientShader;
+    delete m_depthImpostorShader;
+    delete m_itemStylePointShader;
+    delete m_densityShader;
 }
 
 void Scatter3DRenderer::contextCleanup()
@@ -87,6 +113,9 @@ void Scatter3DRenderer::contextCleanup()
 
 void Scatter3DRenderer::initializeOpenGL()
 {
+    // Mesh series are drawn with instanced draw calls when the context supports it
+    m_instancingSupported = ScatterInstanceBufferHelper::isSupported();
+
     Abstract3DRenderer::initializeOpenGL();
 
     // Initialize shaders
@@ -101,6 +130,12 @@ void Scatter3DRenderer::initializeOpenGL()
     // Init selection shader
     initSelectionShader();
 
+    // Static points with item colors or sizes
+    initItemStylePointShader();
+
+    // Series drawn as density
+    initDensityShader();
+
     // Set view port
     glViewport(m_primarySubViewport.x(),
                m_primarySubViewport.y(),
@@ -161,86 +196,140 @@ void Scatter3DRenderer::getVisibleItemBounds(QVector3D &minBounds, QVector3D &ma
 void Scatter3DRenderer::updateData()
 {
     calculateSceneScalingFactors();
-    int totalDataSize = 0;
+    const bool optimizationStatic =
+            m_cachedOptimizationHint.testFlag(QAbstract3DGraph::OptimizationStatic);
 
     foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
         ScatterSeriesRenderCache *cache = static_cast<ScatterSeriesRenderCache *>(baseCache);
         if (cache->isVisible()) {
             const QScatter3DSeries *currentSeries = cache->series();
             ScatterRenderItemArray &renderArray = cache->renderArray();
-            QScatterDataProxy *dataProxy = currentSeries->dataProxy();
-            const QScatterDataArray &dataArray = *dataProxy->array();
-            int dataSize = dataArray.size();
-            totalDataSize += dataSize;
+            const QScatterDataProxyPrivate *dataProxy = currentSeries->dataProxy()->dptrc();
+            int dataSize = dataProxy->itemCount();
             if (cache->dataDirty()) {
                 if (dataSize != renderArray.size())
                     renderArray.resize(dataSize);
 
-                for (int i = 0; i < dataSize; i++)
-                    updateRenderItem(dataArray.at(i), renderArray[i]);
+                updateRenderItems(dataProxy, renderArray);
+                cache->setTranslationsDirty(false);
+                updateItemStyleFlags(cache, dataProxy);
+                cache->setMaxItemStyleSize(dataProxy->maxItemSize());
 
-                if (m_cachedOptimizationHint.testFlag(QAbstract3DGraph::OptimizationStatic))
+                if (optimizationStatic
+                        || (m_instancingSupported && cache->mesh() != QAbstract3DSeries::MeshPoint)) {
                     cache->setStaticBufferDirty(true);
+                }
+                cache->bvh().invalidate();
+                cache->octree().invalidate();
+                cache->chunkBounds().invalidateAll();
+                cache->setDensityDirty(true);
 
                 cache->setDataDirty(false);
             }
         }
     }
 
+    calculateDotSizeScale();
+
+    if (optimizationStatic || m_instancingSupported) {
+        foreach (SeriesRenderCache *baseCache, m_renderCacheList)
+            updateItemBuffers(static_cast<ScatterSeriesRenderCache *>(baseCache));
+    }
+
+    updateSelectedItem(m_selectedItemIndex,
+                       m_selectedSeriesCache ? m_selectedSeriesCache->series() : 0);
+}
+
+// Default item size depends on the total number of visible items
+void Scatter3DRenderer::calculateDotSizeScale()
+{
+    int totalDataSize = 0;
+    foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
+        if (baseCache->isVisible()) {
+            totalDataSize += static_cast<ScatterSeriesRenderCache *>(baseCache)
+                    ->series()->dataProxy()->itemCount();
+        }
+    }
+
     if (totalDataSize) {
         m_dotSizeScale = GLfloat(qBound(defaultMinSize,
                                         2.0f / float(qSqrt(qreal(totalDataSize))),
                                         defaultMaxSize));
     }
+}
 
-    if (m_cachedOptimizationHint.testFlag(QAbstract3DGraph::OptimizationStatic)) {
-        foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
-            ScatterSeriesRenderCache *cache = static_cast<ScatterSeriesRenderCache *>(baseCache);
-            if (cache->isVisible()) {
-                ScatterRenderItemArray &renderArray = cache->renderArray();
-                const int renderArraySize = renderArray.size();
-
-                if (cache->mesh() == QAbstract3DSeries::MeshPoint) {
-                    ScatterPointBufferHelper *points = cache->bufferPoints();
-                    if (!points) {
-                        points = new ScatterPointBufferHelper();
-                        cache->setBufferPoints(points);
-                    }
-                    points->setScaleY(m_scaleY);
-                    points->load(cache);
-                } else {
-                    ScatterObjectBufferHelper *object = cache->bufferObject();
-                    if (!object) {
-                        object = new ScatterObjectBufferHelper();
-                        cache->setBufferObject(object);
-                    }
-                    if (renderArraySize != cache->oldArraySize()
-                            || cache->object()->objectFile() != cache->oldMeshFileName()
-                            || cache->staticBufferDirty()) {
-                        object->setScaleY(m_scaleY);
-                        object->fullLoad(cache, m_dotSizeScale);
-                        cache->setOldArraySize(renderArraySize);
-                        cache->setOldMeshFileName(cache->object()->objectFile());
-                    } else {
-                        object->update(cache, m_dotSizeScale);
-                    }
-                }
-
-                cache->setStaticBufferDirty(false);
+// Reloads the point, instance or static object buffers of the series that need it
+void Scatter3DRenderer::updateItemBuffers(ScatterSeriesRenderCache *cache)
+{
+    const bool optimizationStatic =
+            m_cachedOptimizationHint.testFlag(QAbstract3DGraph::OptimizationStatic);
+    const bool drawingPoints = (cache->mesh() == QAbstract3DSeries::MeshPoint);
+    // Item buffers of series drawn as density are reloaded when turned back to items
+    if (cache->isVisible() && !cache->densityRendering()
+            && (optimizationStatic || !drawingPoints)) {
+        ScatterRenderItemArray &renderArray = cache->renderArray();
+        const int renderArraySize = renderArray.size();
+
+        if (drawingPoints) {
+            ScatterPointBufferHelper *points = cache->bufferPoints();
+            if (!points) {
+                points = new ScatterPointBufferHelper();
+                cache->setBufferPoints(points);
+            }
+            points->setScaleY(m_scaleY);
+            points->load(cache);
+            cache->setItemStylesChanged(false);
+        } else if (m_instancingSupported) {
+            // Instance buffers only hold a few attributes per item, so reloading
+            // them is cheap compared to expanding the mesh for each item.
+            ScatterInstanceBufferHelper *instances = cache->bufferInstances();
+            if (!instances) {
+                instances = new ScatterInstanceBufferHelper();
+                cache->setBufferInstances(instances);
+                cache->setStaticBufferDirty(true);
+            }
+            const bool rawPositions = isAxisMappedInShader(cache);
+            if (instances->rawPositions() != rawPositions) {
+                instances->setRawPositions(rawPositions);
+                cache->setStaticBufferDirty(true);
+            }
+            if (cache->staticBufferDirty() || cache->itemStylesChanged()) {
+                instances->setScaleY(m_scaleY);
+                instances->fullLoad(cache);
+                cache->setItemStylesChanged(false);
+            }
+        } else {
+            ScatterObjectBufferHelper *object = cache->bufferObject();
+            if (!object) {
+                object = new ScatterObjectBufferHelper();
+                cache->setBufferObject(object);
+            }
+            // Item size is a shader uniform, so only changed data needs to be uploaded
+            object->setScaleY(m_scaleY);
+            if (renderArraySize != cache->oldArraySize()
+                    || cache->object()->objectFile() != cache->oldMeshFileName()) {
+                object->fullLoad(cache);
+                cache->setOldArraySize(renderArraySize);
+                cache->setOldMeshFileName(cache->object()->objectFile());
+            } else if (cache->staticBufferDirty()) {
+                object->update(cache);
             }
         }
-    }
 
-    updateSelectedItem(m_selectedItemIndex,
-                       m_selectedSeriesCache ? m_selectedSeriesCache->series() : 0);
+        cache->setStaticBufferDirty(false);
+    }
 }
 
 void Scatter3DRenderer::updateSeries(const QList<QAbstract3DSeries *> &seriesList)
 {
     int seriesCount = seriesList.size();
 
-    // Check OptimizationStatic specific issues before populate marks changeTracker done
-    if (m_cachedOptimizationHint.testFlag(QAbstract3DGraph::OptimizationStatic)) {
+    const bool optimizationStatic =
+            m_cachedOptimizationHint.testFlag(QAbstract3DGraph::OptimizationStatic);
+
+    // Check OptimizationStatic and instancing specific issues before populate marks
+    // changeTracker done
+    if (optimizationStatic || m_instancingSupported) {
         for (int i = 0; i < seriesCount; i++) {
             QScatter3DSeries *scatterSeries = static_cast<QScatter3DSeries *>(seriesList[i]);
             if (scatterSeries->isVisible()) {
@@ -250,7 +339,8 @@ void Scatter3DRenderer::updateSeries(const QList<QAbstract3DSeries *> &seriesLis
                 if (cache) {
                     if (changeTracker.baseGradientChanged || changeTracker.colorStyleChanged)
                         cache->setStaticObjectUVDirty(true);
-                    if (cache->itemSize() != scatterSeries->itemSize())
+                    // Item size is a shader uniform for instanced and static mesh drawing
+                    if (changeTracker.meshRotationChanged)
                         cache->setStaticBufferDirty(true);
                 }
             }
@@ -278,6 +368,32 @@ void Scatter3DRenderer::updateSeries(const QList<QAbstract3DSeries *> &seriesLis
                 maxItemSize = itemSize;
             if (cache->itemSize() != itemSize)
                 cache->setItemSize(itemSize);
+            if (cache->levelOfDetail() != scatterSeries->isLevelOfDetail()) {
+                cache->setLevelOfDetail(scatterSeries->isLevelOfDetail());
+                if (!cache->levelOfDetail()) {
+                    // Return to drawing all items
+                    cache->octree().invalidate();
+                    cache->lodIndices().clear();
+                    if (cache->bufferPoints())
+                        cache->bufferPoints()->clearSubset();
+                    if (cache->bufferInstances())
+                        cache->bufferInstances()->clearSubset();
+                }
+            }
+            cache->setLevelOfDetailThreshold(scatterSeries->levelOfDetailThreshold());
+            cache->setLevelOfDetailBudget(scatterSeries->levelOfDetailBudget());
+            if (cache->densityRendering() != scatterSeries->isDensityRendering()) {
+                cache->setDensityRendering(scatterSeries->isDensityRendering());
+                cache->setDensityDirty(true);
+                cache->updateIndices().clear();
+                // Item buffers are not updated while drawing density, so reload them fully
+                cache->setStaticBufferDirty(true);
+                cache->setOldArraySize(0);
+            }
+            if (cache->densityResolution() != scatterSeries->densityResolution()) {
+                cache->setDensityResolution(scatterSeries->densityResolution());
+                cache->setDensityDirty(true);
+            }
             if (noSelection
                     && scatterSeries->selectedItem() != QScatter3DSeries::invalidSelectionIndex()) {
                 if (m_selectionLabel != cache->itemLabel())
@@ -285,6 +401,11 @@ void Scatter3DRenderer::updateSeries(const QList<QAbstract3DSeries *> &seriesLis
                 noSelection = false;
             }
 
+            if (cache->densityRendering()) {
+                cache->setStaticObjectUVDirty(false);
+                continue;
+            }
+
             if (cache->mesh() == QAbstract3DSeries::MeshPoint) {
                 m_havePointSeries = true;
             } else {
@@ -295,20 +416,41 @@ void Scatter3DRenderer::updateSeries(const QList<QAbstract3DSeries *> &seriesLis
                     m_haveGradientMeshSeries = true;
             }
 
+            const bool instanced = m_instancingSupported
+                    && cache->mesh() != QAbstract3DSeries::MeshPoint;
+            if (instanced && !cache->bufferInstances()) {
+                // Mesh was changed from points, or series was just made visible
+                cache->setBufferInstances(new ScatterInstanceBufferHelper());
+                cache->setStaticBufferDirty(true);
+            }
+
             if (cache->staticBufferDirty()) {
-                if (cache->mesh() != QAbstract3DSeries::MeshPoint) {
+                if (instanced) {
+                    ScatterInstanceBufferHelper *instances = cache->bufferInstances();
+                    instances->setScaleY(m_scaleY);
+                    instances->fullLoad(cache);
+                } else if (cache->mesh() != QAbstract3DSeries::MeshPoint && cache->bufferObject()) {
                     ScatterObjectBufferHelper *object = cache->bufferObject();
-                    object->update(cache, m_dotSizeScale);
+                    object->update(cache);
                 }
                 cache->setStaticBufferDirty(false);
             }
             if (cache->staticObjectUVDirty()) {
                 if (cache->mesh() == QAbstract3DSeries::MeshPoint) {
-                    ScatterPointBufferHelper *object = cache->bufferPoints();
-                    object->updateUVs(cache);
+                    if (optimizationStatic) {
+                        ScatterPointBufferHelper *object = cache->bufferPoints();
+                        object->updateUVs(cache);
+                    }
+                } else if (instanced) {
+                    // Gradient coordinate is stored in the instance position buffer
+                    ScatterInstanceBufferHelper *instances = cache->bufferInstances();
+                    instances->setScaleY(m_scaleY);
+                    instances->fullLoad(cache);
                 } else {
+                    // Static meshes store the gradient coordinate the same way
                     ScatterObjectBufferHelper *object = cache->bufferObject();
-                    object->updateUVs(cache);
+                    object->setScaleY(m_scaleY);
+                    object->update(cache);
                 }
                 cache->setStaticObjectUVDirty(false);
             }
@@ -329,68 +471,215 @@ SeriesRenderCache *Scatter3DRenderer::createNewCache(QAbstract3DSeries *series)
     return new ScatterSeriesRenderCache(series, this);
 }
 
-void Scatter3DRenderer::updateItems(const QList<Scatter3DController::ChangeItem> &items)
+void Scatter3DRenderer::updateItems(const Scatter3DController::ChangedItems &items)
 {
-    ScatterSeriesRenderCache *cache = 0;
-    const QScatter3DSeries *prevSeries = 0;
-    const QScatterDataArray *dataArray = 0;
     const bool optimizationStatic = m_cachedOptimizationHint.testFlag(
                 QAbstract3DGraph::OptimizationStatic);
 
-    foreach (Scatter3DController::ChangeItem item, items) {
-        QScatter3DSeries *currentSeries = item.series;
-        if (currentSeries != prevSeries) {
-            cache = static_cast<ScatterSeriesRenderCache *>(m_renderCacheList.value(currentSeries));
-            prevSeries = currentSeries;
-            dataArray = item.series->dataProxy()->array();
-            // Invisible series render caches are not updated, but instead just marked dirty, so that
-            // they can be completely recalculated when they are turned visible.
-            if (!cache->isVisible() && !cache->dataDirty())
+    for (auto it = items.cbegin(); it != items.cend(); ++it) {
+        QScatter3DSeries *series = it.key();
+        ScatterSeriesRenderCache *cache =
+                static_cast<ScatterSeriesRenderCache *>(m_renderCacheList.value(series));
+        if (!cache)
+            continue;
+        // Invisible series render caches are not updated, but instead just marked dirty, so that
+        // they can be completely recalculated when they are turned visible.
+        if (!cache->isVisible()) {
+            if (!cache->dataDirty())
                 cache->setDataDirty(true);
+            continue;
         }
-        if (cache->isVisible()) {
-            const int index = item.index;
-            if (index >= cache->renderArray().size())
-                continue; // Items removed from array for same render
-            bool oldVisibility = false;
-            ScatterRenderItem &item = cache->renderArray()[index];
-            if (optimizationStatic)
-                oldVisibility = item.isVisible();
-            updateRenderItem(dataArray->at(index), item);
-            if (optimizationStatic) {
-                if (!cache->visibilityChanged() && oldVisibility != item.isVisible())
-                    cache->setVisibilityChanged(true);
-                cache->updateIndices().append(index);
+
+        const QScatterDataProxyPrivate *dataProxy = series->dataProxy()->dptrc();
+        ScatterRenderItemArray &renderArray = cache->renderArray();
+        const int renderArraySize = renderArray.size();
+        // Density is rebinned only for the changed items when it is next drawn
+        const bool trackChanges = cache->densityRendering() || optimizationStatic
+                || (m_instancingSupported && cache->mesh() != QAbstract3DSeries::MeshPoint);
+        const QList<IndexRangeSet::Range> ranges = it.value().ranges();
+        updateItemStyleFlags(cache, dataProxy);
+        float maxItemStyleSize = cache->maxItemStyleSize();
+        foreach (const IndexRangeSet::Range &range, ranges) {
+            // Items may have been removed from array for same render
+            const int end = int(qMin(qint64(renderArraySize), range.start + range.count));
+            for (int index = int(range.start); index < end; index++) {
+                ScatterRenderItem &item = renderArray[index];
+                updateRenderItem(dataProxy->item(index), item);
+                item.setColor(dataProxy->itemColor(index));
+                item.setSize(dataProxy->itemSize(index));
+                maxItemStyleSize = qMax(maxItemStyleSize, item.size());
+                cache->bvh().invalidateItem(index);
+                cache->chunkBounds().invalidate(index);
+                if (trackChanges)
+                    cache->updateIndices().append(index);
             }
         }
+        // Shrinking sizes keep the old maximum until the next full data update
+        cache->setMaxItemStyleSize(maxItemStyleSize);
+        // Level of detail representatives may change, so the octree is simply rebuilt
+        if (cache->levelOfDetail())
+            cache->octree().invalidate();
     }
-    if (optimizationStatic) {
+    if (optimizationStatic || m_instancingSupported) {
         foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
             ScatterSeriesRenderCache *cache = static_cast<ScatterSeriesRenderCache *>(baseCache);
-            if (cache->isVisible() && cache->updateIndices().size()) {
-                if (cache->mesh() == QAbstract3DSeries::MeshPoint) {
-                    cache->bufferPoints()->update(cache);
-                    if (cache->colorStyle() == Q3DTheme::ColorStyleRangeGradient)
-                        cache->bufferPoints()->updateUVs(cache);
-                } else {
-                    if (cache->visibilityChanged()) {
-                        // If any change changes item visibility, full load is needed to
-                        // resize the buffers.
+            // Density is rebinned from the update indices when drawn
+            if (cache->isVisible() && !cache->densityRendering()
+                    && cache->updateIndices().size()) {
+                // Buffer helpers coalesce sorted indices into contiguous uploads
+                QList<int> &updateIndices = cache->updateIndices();
+                std::sort(updateIndices.begin(), updateIndices.end());
+                updateIndices.erase(std::unique(updateIndices.begin(), updateIndices.end()),
+                                    updateIndices.end());
+                if (m_instancingSupported && cache->mesh() != QAbstract3DSeries::MeshPoint
+                        && cache->bufferInstances()) {
+                    ScatterInstanceBufferHelper *instances = cache->bufferInstances();
+                    instances->setScaleY(m_scaleY);
+                    // Item style buffers are only allocated if the items have colors or sizes
+                    if (cache->itemStylesChanged())
                         cache->updateIndices().clear();
-                        cache->bufferObject()->fullLoad(cache, m_dotSizeScale);
+                    instances->update(cache);
+                } else if (cache->mesh() == QAbstract3DSeries::MeshPoint) {
+                    if (cache->itemStylesChanged()) {
+                        cache->bufferPoints()->load(cache);
                     } else {
-                        cache->bufferObject()->update(cache, m_dotSizeScale);
+                        cache->bufferPoints()->update(cache);
                         if (cache->colorStyle() == Q3DTheme::ColorStyleRangeGradient)
-                            cache->bufferObject()->updateUVs(cache);
+                            cache->bufferPoints()->updateUVs(cache);
                     }
+                } else {
+                    // Buffers hold hidden items too, so visibility changes are updated in place
+                    cache->bufferObject()->setScaleY(m_scaleY);
+                    cache->bufferObject()->update(cache);
                 }
                 cache->updateIndices().clear();
             }
-            cache->setVisibilityChanged(false);
+            cache->setItemStylesChanged(false);
         }
     }
 }
 
+// Inserts and removes render items, so that the existing items do not need to be recalculated.
+// Records are applied in the order of the edits, after which the inserted items are read from
+// the data. Returns true if some series could not be spliced and need a full data update.
+bool Scatter3DRenderer::updateInsertedAndRemovedItems(
+        const QList<Scatter3DController::InsertRemoveRecord> &records)
+{
+    // Inserted items and the first moved item of each spliced series
+    QHash<ScatterSeriesRenderCache *, IndexRangeSet> insertedItems;
+    QHash<ScatterSeriesRenderCache *, int> firstMovedItems;
+    bool reloadNeeded = false;
+
+    for (const Scatter3DController::InsertRemoveRecord &record : records) {
+        ScatterSeriesRenderCache *cache =
+                static_cast<ScatterSeriesRenderCache *>(m_renderCacheList.value(record.m_series));
+        if (!cache)
+            continue;
+        // Series waiting for a full update read all items from the data anyway
+        if (cache->dataDirty()) {
+            reloadNeeded = true;
+            continue;
+        }
+        ScatterRenderItemArray &renderArray = cache->renderArray();
+        if (!cache->isVisible() || record.m_startIndex > renderArray.size()
+                || (!record.m_isInsert
+                    && record.m_startIndex + record.m_count > renderArray.size())) {
+            cache->setDataDirty(true);
+            reloadNeeded = true;
+            continue;
+        }
+
+        IndexRangeSet &inserted = insertedItems[cache];
+        ScatterDensityBufferHelper *density =
+                cache->densityRendering() ? cache->bufferDensity() : nullptr;
+        if (record.m_isInsert) {
+            renderArray.insert(record.m_startIndex, record.m_count, ScatterRenderItem());
+            inserted.adjustForInsert(record.m_startIndex, record.m_count);
+            inserted.insert(record.m_startIndex, record.m_count);
+            if (density)
+                density->insertItems(record.m_startIndex, record.m_count);
+        } else {
+            renderArray.remove(record.m_startIndex, record.m_count);
+            inserted.adjustForRemove(record.m_startIndex, record.m_count);
+            if (density)
+                density->removeItems(record.m_startIndex, record.m_count);
+        }
+        auto firstMoved = firstMovedItems.find(cache);
+        if (firstMoved == firstMovedItems.end())
+            firstMovedItems.insert(cache, record.m_startIndex);
+        else
+            *firstMoved = qMin(*firstMoved, record.m_startIndex);
+    }
+
+    const bool optimizationStatic =
+            m_cachedOptimizationHint.testFlag(QAbstract3DGraph::OptimizationStatic);
+
+    for (auto it = firstMovedItems.cbegin(); it != firstMovedItems.cend(); ++it) {
+        ScatterSeriesRenderCache *cache = it.key();
+        const int firstMovedIndex = it.value();
+        const QScatterDataProxyPrivate *dataProxy = cache->series()->dataProxy()->dptrc();
+        ScatterRenderItemArray &renderArray = cache->renderArray();
+        const int renderArraySize = renderArray.size();
+        if (cache->dataDirty() || renderArraySize != dataProxy->itemCount()) {
+            cache->setDataDirty(true);
+            reloadNeeded = true;
+            continue;
+        }
+
+        updateItemStyleFlags(cache, dataProxy);
+        float maxItemStyleSize = cache->maxItemStyleSize();
+        const QList<IndexRangeSet::Range> ranges = insertedItems.value(cache).ranges();
+        for (const IndexRangeSet::Range &range : ranges) {
+            const int end = int(range.start + range.count);
+            for (int index = int(range.start); index < end; index++) {
+                ScatterRenderItem &item = renderArray[index];
+                updateRenderItem(dataProxy->item(index), item);
+                item.setColor(dataProxy->itemColor(index));
+                item.setSize(dataProxy->itemSize(index));
+                maxItemStyleSize = qMax(maxItemStyleSize, item.size());
+                // Density of the inserted items is binned when next drawn
+                if (cache->densityRendering())
+                    cache->updateIndices().append(index);
+            }
+        }
+        cache->setMaxItemStyleSize(maxItemStyleSize);
+
+        // Hierarchies refer to items by index, so they are rebuilt when next needed
+        cache->bvh().invalidate();
+        cache->octree().invalidate();
+        cache->chunkBounds().resize(renderArraySize, firstMovedIndex);
+
+        // Item buffers of series drawn as density are reloaded when turned back to items
+        const bool splicedMesh =
+                !cache->densityRendering() && cache->mesh() != QAbstract3DSeries::MeshPoint;
+        if (m_instancingSupported && splicedMesh) {
+            // Changed item styles reload the whole buffer below
+            ScatterInstanceBufferHelper *instances = cache->bufferInstances();
+            if (instances && !cache->itemStylesChanged()) {
+                instances->setScaleY(m_scaleY);
+                instances->splice(cache, firstMovedIndex);
+            }
+        } else if (optimizationStatic && splicedMesh) {
+            ScatterObjectBufferHelper *object = cache->bufferObject();
+            if (object && cache->object()->objectFile() == cache->oldMeshFileName()) {
+                object->setScaleY(m_scaleY);
+                object->splice(cache, firstMovedIndex);
+                cache->setOldArraySize(renderArraySize);
+            }
+        }
+        // Point buffers and buffers that could not be spliced are reloaded
+        if (optimizationStatic || m_instancingSupported)
+            updateItemBuffers(cache);
+    }
+
+    if (!reloadNeeded && !firstMovedItems.isEmpty()) {
+        calculateDotSizeScale();
+        updateSelectedItem(m_selectedItemIndex,
+                           m_selectedSeriesCache ? m_selectedSeriesCache->series() : 0);
+    }
+    return reloadNeeded;
+}
+
 void Scatter3DRenderer::updateScene(Q3DScene *scene)
 {
     scene->activeCamera()->d_ptr->setMinYRotation(-90.0f);
@@ -495,6 +784,8 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
     QMatrix4x4 viewMatrix = activeCamera->d_ptr->viewMatrix();
     QMatrix4x4 projectionViewMatrix = projectionMatrix * viewMatrix;
 
+    updateLevelOfDetail(projectionMatrix, projectionViewMatrix);
+
     // Calculate label flipping
     if (viewMatrix.row(0).x() > 0)
         m_zFlipped = false;
@@ -570,6 +861,9 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
                 if (baseCache->isVisible()) {
                     ScatterSeriesRenderCache *cache =
                             static_cast<ScatterSeriesRenderCache *>(baseCache);
+                    // Density cells do not cast shadows
+                    if (cache->densityRendering())
+                        continue;
                     ObjectHelper *dotObj = cache->object();
                     QQuaternion seriesRotation(cache->meshRotation());
                     const ScatterRenderItemArray &renderArray = cache->renderArray();
@@ -584,19 +878,74 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
                     }
                     QVector3D modelScaler(itemSize, itemSize, itemSize);
 
-                    if (!optimizationDefault
-                            && ((drawingPoints && cache->bufferPoints()->indexCount() == 0)
-                                || (!drawingPoints && cache->bufferObject()->indexCount() == 0))) {
+                    if (!cullItems(cache, depthProjectionViewMatrix, itemSize, RenderingDepth))
+                        continue;
+
+                    if (m_instancingSupported && !drawingPoints) {
+                        ScatterInstanceBufferHelper *instances = cache->bufferInstances();
+                        if (instances && instances->indexCount() && isDrawnAsImpostors(cache)) {
+                            // Impostor quads face the light, so front face culling would
+                            // remove them
+                            glDisable(GL_CULL_FACE);
+                            m_depthImpostorShader->bind();
+                            m_depthImpostorShader->setUniformValue(
+                                        m_depthImpostorShader->MVP(), depthProjectionViewMatrix);
+                            m_depthImpostorShader->setUniformValue(
+                                        m_depthImpostorShader->view(), depthViewMatrix);
+                            m_depthImpostorShader->setUniformValue(
+                                        m_depthImpostorShader->instanceScale(), itemSize);
+                            setAxisMappingUniforms(m_depthImpostorShader, cache);
+                            m_drawer->drawInstancedObject(m_depthImpostorShader, m_labelObj,
+                                                          instances);
+                            glEnable(GL_CULL_FACE);
+                            m_depthShader->bind();
+                        } else if (instances && instances->indexCount()) {
+                            m_depthInstancedShader->bind();
+                            m_depthInstancedShader->setUniformValue(
+                                        m_depthInstancedShader->MVP(), depthProjectionViewMatrix);
+                            m_depthInstancedShader->setUniformValue(
+                                        m_depthInstancedShader->instanceScale(), itemSize);
+                            setAxisMappingUniforms(m_depthInstancedShader, cache);
+                            m_drawer->drawInstancedObject(m_depthInstancedShader, dotObj,
+                                                          instances);
+                            m_depthShader->bind();
+                        }
                         continue;
                     }
 
+                    if (!optimizationDefault && !drawingPoints) {
+                        // Static meshes are placed and scaled by the instanced shader
+                        ScatterObjectBufferHelper *object = cache->bufferObject();
+                        if (object->indexCount()) {
+                            m_depthInstancedShader->bind();
+                            m_depthInstancedShader->setUniformValue(
+                                        m_depthInstancedShader->MVP(), depthProjectionViewMatrix);
+                            m_depthInstancedShader->setUniformValue(
+                                        m_depthInstancedShader->instanceScale(), itemSize);
+                            setAxisMappingUniforms(m_depthInstancedShader, cache);
+                            m_drawer->drawStaticObject(m_depthInstancedShader, object);
+                            m_depthShader->bind();
+                        }
+                        continue;
+                    }
+
+                    if (!optimizationDefault && cache->bufferPoints()->indexCount() == 0)
+                        continue;
+
+                    const bool drawingLod = optimizationDefault && cache->levelOfDetail();
                     int loopCount = 1;
-                    if (optimizationDefault)
+                    if (drawingLod)
+                        loopCount = cache->lodIndices().size();
+                    else if (optimizationDefault)
                         loopCount = renderArraySize;
                     for (int dot = 0; dot < loopCount; dot++) {
-                        const ScatterRenderItem &item = renderArray.at(dot);
-                        if (!item.isVisible() && optimizationDefault)
+                        const int index = drawingLod ? cache->lodIndices().at(dot) : dot;
+                        const ScatterRenderItem &item = renderArray.at(index);
+                        if (optimizationDefault
+                                && (!item.isVisible()
+                                    || cache->chunkBounds().isItemCulled(index))) {
                             continue;
+                        }
 
                         QMatrix4x4 modelMatrix;
                         QMatrix4x4 MVPMatrix;
@@ -606,7 +955,15 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
                             if (!drawingPoints) {
                                 if (!seriesRotation.isIdentity() || !item.rotation().isIdentity())
                                     modelMatrix.rotate(seriesRotation * item.rotation());
-                                modelMatrix.scale(modelScaler);
+                                if (item.size() > 0.0f)
+                                    modelMatrix.scale(item.size() / itemScaler);
+                                else
+                                    modelMatrix.scale(modelScaler);
+                            } else if (cache->hasItemSizes()) {
+                                const float dotSize = item.size() > 0.0f
+                                        ? item.size() / itemScaler : itemSize;
+                                m_funcs_2_1->glPointSize(dotSize * 100.0f
+                                                         * m_shadowQualityMultiplier);
                             }
                         }
 
@@ -620,46 +977,24 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
                             else
                                 m_drawer->drawPoints(m_depthShader, cache->bufferPoints(), 0);
                         } else {
-                            if (optimizationDefault) {
-                                // 1st attribute buffer : vertices
-                                glEnableVertexAttribArray(m_depthShader->posAtt());
-                                glBindBuffer(GL_ARRAY_BUFFER, dotObj->vertexBuf());
-                                glVertexAttribPointer(m_depthShader->posAtt(), 3, GL_FLOAT, GL_FALSE, 0,
-                                                      (void *)0);
-
-                                // Index buffer
-                                glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, dotObj->elementBuf());
-
-                                // Draw the triangles
-                                glDrawElements(GL_TRIANGLES, dotObj->indexCount(),
-                                               GL_UNSIGNED_INT, (void *)0);
-
-                                // Free buffers
-                                glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-                                glBindBuffer(GL_ARRAY_BUFFER, 0);
+                            // 1st attribute buffer : vertices
+                            glEnableVertexAttribArray(m_depthShader->posAtt());
+                            glBindBuffer(GL_ARRAY_BUFFER, dotObj->vertexBuf());
+                            glVertexAttribPointer(m_depthShader->posAtt(), 3, GL_FLOAT, GL_FALSE, 0,
+                                                  (void *)0);
 
-                                glDisableVertexAttribArray(m_depthShader->posAtt());
-                            } else {
-                                ScatterObjectBufferHelper *object = cache->bufferObject();
-                                // 1st attribute buffer : vertices
-                                glEnableVertexAttribArray(m_depthShader->posAtt());
-                                glBindBuffer(GL_ARRAY_BUFFER, object->vertexBuf());
-                                glVertexAttribPointer(m_depthShader->posAtt(), 3, GL_FLOAT, GL_FALSE, 0,
-                                                      (void *)0);
-
-                                // Index buffer
-                                glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, object->elementBuf());
+                            // Index buffer
+                            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, dotObj->elementBuf());
 
-                                // Draw the triangles
-                                glDrawElements(GL_TRIANGLES, object->indexCount(),
-                                               GL_UNSIGNED_INT, (void *)0);
+                            // Draw the triangles
+                            glDrawElements(GL_TRIANGLES, dotObj->indexCount(),
+                                           GL_UNSIGNED_INT, (void *)0);
 
-                                // Free buffers
-                                glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-                                glBindBuffer(GL_ARRAY_BUFFER, 0);
+                            // Free buffers
+                            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+                            glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-                                glDisableVertexAttribArray(m_depthShader->posAtt());
-                            }
+                            glDisableVertexAttribArray(m_depthShader->posAtt());
                         }
                     }
                 }
@@ -713,68 +1048,52 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); // Needed for clearing the frame buffer
         glDisable(GL_DITHER); // disable dithering, it may affect colors if enabled
 
-        bool previousDrawingPoints = false;
-        int totalIndex = 0;
-        foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
-            if (baseCache->isVisible()) {
-                ScatterSeriesRenderCache *cache =
-                        static_cast<ScatterSeriesRenderCache *>(baseCache);
-                ObjectHelper *dotObj = cache->object();
-                QQuaternion seriesRotation(cache->meshRotation());
-                const ScatterRenderItemArray &renderArray = cache->renderArray();
-                const int renderArraySize = renderArray.size();
-                bool drawingPoints = (cache->mesh() == QAbstract3DSeries::MeshPoint);
-                float itemSize = cache->itemSize() / itemScaler;
-                if (itemSize == 0.0f)
-                    itemSize = m_dotSizeScale;
+        // Resolve the item under cursor on CPU and draw only that item to the selection buffer,
+        // so that it gets correctly occluded by custom items.
+        pickItem(projectionMatrix, projectionViewMatrix, activeCamera);
+        if (m_pickedSeriesCache) {
+            ScatterSeriesRenderCache *cache = m_pickedSeriesCache;
+            const ScatterRenderItem &item = cache->renderArray().at(m_pickedIndex);
+            bool drawingPoints = (cache->mesh() == QAbstract3DSeries::MeshPoint);
+            float itemSize = cache->itemSize() / itemScaler;
+            if (itemSize == 0.0f)
+                itemSize = m_dotSizeScale;
+            // Same size as the item is drawn and picked with
+            if (item.size() > 0.0f)
+                itemSize = item.size() / itemScaler;
 #if !QT_CONFIG(opengles2)
-                if (drawingPoints && !m_isOpenGLES)
-                    m_funcs_2_1->glPointSize(itemSize * activeCamera->zoomLevel());
+            if (drawingPoints && !m_isOpenGLES)
+                m_funcs_2_1->glPointSize(itemSize * activeCamera->zoomLevel());
 #endif
-                QVector3D modelScaler(itemSize, itemSize, itemSize);
-
-                // Rebind selection shader if it has changed
-                if (!totalIndex || drawingPoints != previousDrawingPoints) {
-                    previousDrawingPoints = drawingPoints;
-                    if (drawingPoints)
-                        selectionShader = pointSelectionShader;
-                    else
-                        selectionShader = m_selectionShader;
-
-                    selectionShader->bind();
-                }
-                cache->setSelectionIndexOffset(totalIndex);
-                for (int dot = 0; dot < renderArraySize; dot++) {
-                    const ScatterRenderItem &item = renderArray.at(dot);
-                    if (!item.isVisible()) {
-                        totalIndex++;
-                        continue;
-                    }
+            if (drawingPoints)
+                selectionShader = pointSelectionShader;
+            else
+                selectionShader = m_selectionShader;
+            selectionShader->bind();
 
-                    QMatrix4x4 modelMatrix;
-                    QMatrix4x4 MVPMatrix;
+            QMatrix4x4 modelMatrix;
+            QMatrix4x4 MVPMatrix;
 
-                    modelMatrix.translate(item.translation());
-                    if (!drawingPoints) {
-                        if (!seriesRotation.isIdentity() || !item.rotation().isIdentity())
-                            modelMatrix.rotate(seriesRotation * item.rotation());
-                        modelMatrix.scale(modelScaler);
-                    }
+            modelMatrix.translate(item.translation());
+            if (!drawingPoints) {
+                QQuaternion seriesRotation(cache->meshRotation());
+                if (!seriesRotation.isIdentity() || !item.rotation().isIdentity())
+                    modelMatrix.rotate(seriesRotation * item.rotation());
+                modelMatrix.scale(QVector3D(itemSize, itemSize, itemSize));
+            }
 
-                    MVPMatrix = projectionViewMatrix * modelMatrix;
+            MVPMatrix = projectionViewMatrix * modelMatrix;
 
-                    QVector4D dotColor = indexToSelectionColor(totalIndex++);
-                    dotColor /= 255.0f;
+            QVector4D dotColor = indexToSelectionColor(0);
+            dotColor /= 255.0f;
 
-                    selectionShader->setUniformValue(selectionShader->MVP(), MVPMatrix);
-                    selectionShader->setUniformValue(selectionShader->color(), dotColor);
+            selectionShader->setUniformValue(selectionShader->MVP(), MVPMatrix);
+            selectionShader->setUniformValue(selectionShader->color(), dotColor);
 
-                    if (drawingPoints)
-                        m_drawer->drawPoint(selectionShader);
-                    else
-                        m_drawer->drawSelectionObject(selectionShader, dotObj);
-                }
-            }
+            if (drawingPoints)
+                m_drawer->drawPoint(selectionShader);
+            else
+                m_drawer->drawSelectionObject(selectionShader, cache->object());
         }
 
         Abstract3DRenderer::drawCustomItems(RenderingSelection, m_selectionShader,
@@ -845,6 +1164,9 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
         if (baseCache->isVisible()) {
             ScatterSeriesRenderCache *cache =
                     static_cast<ScatterSeriesRenderCache *>(baseCache);
+            // Density is drawn after the opaque parts of the graph
+            if (cache->densityRendering())
+                continue;
             ObjectHelper *dotObj = cache->object();
             QQuaternion seriesRotation(cache->meshRotation());
             ScatterRenderItemArray &renderArray = cache->renderArray();
@@ -864,13 +1186,25 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
             if (drawingPoints && !m_isOpenGLES)
                 m_funcs_2_1->glPointSize(itemSize * activeCamera->zoomLevel());
 #endif
-            QVector3D modelScaler(itemSize, itemSize, itemSize);
             int gradientImageHeight = cache->gradientImage().height();
             int maxGradientPositition = gradientImageHeight - 1;
-
-            if (!optimizationDefault
-                    && ((drawingPoints && cache->bufferPoints()->indexCount() == 0)
-                        || (!drawingPoints && cache->bufferObject()->indexCount() == 0))) {
+            const bool drawingInstanced = m_instancingSupported && !drawingPoints;
+            // Static meshes without instancing support use the instanced shaders, too
+            const bool drawingStaticMesh = !optimizationDefault && !drawingInstanced
+                    && !drawingPoints;
+            const bool drawingImpostors = drawingInstanced && isDrawnAsImpostors(cache);
+            // Impostors are drawn as quads, the sphere is ray traced in the fragment shader
+            ObjectHelper *instancedObj = drawingImpostors ? m_labelObj : dotObj;
+            // Instanced and static drawing handle level of detail in the buffers
+            const bool drawingLod = optimizationDefault && !drawingInstanced
+                    && cache->levelOfDetail();
+
+            if (drawingInstanced) {
+                if (!cache->bufferInstances() || cache->bufferInstances()->indexCount() == 0)
+                    continue;
+            } else if (!optimizationDefault
+                       && ((drawingPoints && cache->bufferPoints()->indexCount() == 0)
+                           || (!drawingPoints && cache->bufferObject()->indexCount() == 0))) {
                 continue;
             }
 
@@ -887,6 +1221,9 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
                             dotShader = m_staticGradientPointShader;
                         else
                             dotShader = m_labelShader;
+                    } else if (!optimizationDefault && cache->hasItemStyles()) {
+                        // Point sizes come from the vertex shader
+                        dotShader = m_itemStylePointShader;
                     } else {
                         dotShader = pointSelectionShader;
                     }
@@ -914,23 +1251,109 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
             if (!drawingPoints)
                 previousMeshColorStyle = colorStyle;
 
+            const bool drawingStyledPoints = (dotShader == m_itemStylePointShader);
+            if (drawingStyledPoints) {
+                dotShader->setUniformValue(dotShader->instanceScale(), itemSize);
+                dotShader->setUniformValue(dotShader->pointScale(), activeCamera->zoomLevel());
+#if !QT_CONFIG(opengles2)
+                if (!m_isOpenGLES)
+                    glEnable(GL_VERTEX_PROGRAM_POINT_SIZE);
+#endif
+            }
+
             if (useColor) {
                 baseColor = cache->baseColor();
                 dotColor = baseColor;
             }
+            const bool itemsInFrustum =
+                    cullItems(cache, projectionViewMatrix, itemSize, RenderingNormal);
             int loopCount = 1;
-            if (optimizationDefault)
+            if (!itemsInFrustum)
+                loopCount = 0;
+            else if (drawingLod)
+                loopCount = cache->lodIndices().size();
+            else if (optimizationDefault)
                 loopCount = renderArraySize;
 
+            if ((drawingInstanced || drawingStaticMesh) && itemsInFrustum) {
+                // All items of the series are drawn with a single draw call, selected item
+                // is drawn on top of it separately.
+                ShaderHelper *instancedShader;
+                if (drawingImpostors) {
+                    instancedShader = colorStyleIsUniform
+                            ? m_impostorShader : m_impostorGradientShader;
+                } else {
+                    instancedShader = colorStyleIsUniform
+                            ? m_dotInstancedShader : m_dotGradientInstancedShader;
+                }
+                instancedShader->bind();
+                instancedShader->setUniformValue(instancedShader->lightP(), lightPos);
+                instancedShader->setUniformValue(instancedShader->view(), viewMatrix);
+                instancedShader->setUniformValue(instancedShader->ambientS(),
+                                                 m_cachedTheme->ambientLightStrength());
+                instancedShader->setUniformValue(instancedShader->lightColor(), lightColor);
+                instancedShader->setUniformValue(instancedShader->instanceScale(), itemSize);
+                setAxisMappingUniforms(instancedShader, cache);
+#ifdef SHOW_DEPTH_TEXTURE_SCENE
+                instancedShader->setUniformValue(instancedShader->MVP(),
+                                                 depthProjectionViewMatrix);
+#else
+                instancedShader->setUniformValue(instancedShader->MVP(), projectionViewMatrix);
+#endif
+                if (colorStyleIsUniform) {
+                    instancedShader->setUniformValue(instancedShader->color(), baseColor);
+                    gradientTexture = 0;
+                } else {
+                    instancedShader->setUniformValue(
+                                instancedShader->gradientHeight(),
+                                colorStyle == Q3DTheme::ColorStyleObjectGradient ? 0.5f : 0.0f);
+                    gradientTexture = cache->baseGradientTexture();
+                }
+                if (m_cachedShadowQuality > QAbstract3DGraph::ShadowQualityNone && !m_isOpenGLES) {
+                    instancedShader->setUniformValue(instancedShader->shadowQ(),
+                                                     m_shadowQualityToShader);
+                    instancedShader->setUniformValue(instancedShader->depth(),
+                                                     depthProjectionViewMatrix);
+                    instancedShader->setUniformValue(instancedShader->lightS(),
+                                                     m_cachedTheme->lightStrength() / 10.0f);
+                    if (drawingStaticMesh) {
+                        m_drawer->drawStaticObject(instancedShader, cache->bufferObject(),
+                                                   gradientTexture, m_depthTexture);
+                    } else {
+                        m_drawer->drawInstancedObject(instancedShader, instancedObj,
+                                                      cache->bufferInstances(), gradientTexture,
+                                                      m_depthTexture);
+                    }
+                } else {
+                    instancedShader->setUniformValue(instancedShader->lightS(),
+                                                     m_cachedTheme->lightStrength());
+                    if (drawingStaticMesh) {
+                        m_drawer->drawStaticObject(instancedShader, cache->bufferObject(),
+                                                   gradientTexture);
+                    } else {
+                        m_drawer->drawInstancedObject(instancedShader, instancedObj,
+                                                      cache->bufferInstances(), gradientTexture);
+                    }
+                }
+                dotShader->bind();
+                loopCount = 0;
+            }
+
             for (int i = 0; i < loopCount; i++) {
-                ScatterRenderItem &item = renderArray[i];
-                if (!item.isVisible() && optimizationDefault)
+                const int index = drawingLod ? cache->lodIndices().at(i) : i;
+                ScatterRenderItem &item = renderArray[index];
+                if (optimizationDefault
+                        && (!item.isVisible() || cache->chunkBounds().isItemCulled(index))) {
                     continue;
+                }
 
                 QMatrix4x4 modelMatrix;
                 QMatrix4x4 MVPMatrix;
                 QMatrix4x4 itModelMatrix;
 
+                // Items drawn one by one use their own size and color, if they have them
+                const float dotSize = (optimizationDefault && item.size() > 0.0f)
+                        ? item.size() / itemScaler : itemSize;
                 if (optimizationDefault) {
                     modelMatrix.translate(item.translation());
                     if (!drawingPoints) {
@@ -939,9 +1362,13 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
                             modelMatrix.rotate(totalRotation);
                             itModelMatrix.rotate(totalRotation);
                         }
-                        modelMatrix.scale(modelScaler);
-                        itModelMatrix.scale(modelScaler);
+                        modelMatrix.scale(dotSize);
+                        itModelMatrix.scale(dotSize);
                     }
+#if !QT_CONFIG(opengles2)
+                    if (drawingPoints && cache->hasItemSizes() && !m_isOpenGLES)
+                        m_funcs_2_1->glPointSize(dotSize * activeCamera->zoomLevel());
+#endif
                 }
 #ifdef SHOW_DEPTH_TEXTURE_SCENE
                 MVPMatrix = depthProjectionViewMatrix * modelMatrix;
@@ -957,6 +1384,8 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
                         position = qMin(maxGradientPositition, position); // clamp to edge
                         dotColor = Utils::vectorFromColor(
                                     cache->gradientImage().pixel(0, position));
+                    } else if (optimizationDefault && qAlpha(item.color())) {
+                        dotColor = Utils::vectorFromColor(QColor::fromRgba(item.color()));
                     } else {
                         dotColor = baseColor;
                     }
@@ -968,7 +1397,8 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
                     gradientTexture = cache->baseGradientTexture();
 
                 GLfloat lightStrength = m_cachedTheme->lightStrength();
-                if (optimizationDefault && selectedSeries && (m_selectedItemIndex == i)) {
+                if (optimizationDefault && !drawingLod && selectedSeries
+                        && (m_selectedItemIndex == index)) {
                     if (useColor)
                         dotColor = cache->singleHighlightColor();
                     else
@@ -979,7 +1409,7 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
                     dotSelectionFound = true;
                     // Save selected item size (adjusted with font size) for selection label
                     // positioning
-                    selectedItemSize = itemSize + m_drawer->scaledFontSize() - 0.05f;
+                    selectedItemSize = dotSize + m_drawer->scaledFontSize() - 0.05f;
                 }
 
                 if (!drawingPoints) {
@@ -1006,13 +1436,7 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
                         dotShader->setUniformValue(dotShader->lightS(), lightStrength / 10.0f);
 
                         // Draw the object
-                        if (optimizationDefault) {
-                            m_drawer->drawObject(dotShader, dotObj, gradientTexture,
-                                                 m_depthTexture);
-                        } else {
-                            m_drawer->drawObject(dotShader, cache->bufferObject(), gradientTexture,
-                                                 m_depthTexture);
-                        }
+                        m_drawer->drawObject(dotShader, dotObj, gradientTexture, m_depthTexture);
                     } else {
                         // Draw the object
                         if (optimizationDefault)
@@ -1025,10 +1449,7 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
                         // Set shadowless shader bindings
                         dotShader->setUniformValue(dotShader->lightS(), lightStrength);
                         // Draw the object
-                        if (optimizationDefault)
-                            m_drawer->drawObject(dotShader, dotObj, gradientTexture);
-                        else
-                            m_drawer->drawObject(dotShader, cache->bufferObject(), gradientTexture);
+                        m_drawer->drawObject(dotShader, dotObj, gradientTexture);
                     } else {
                         // Draw the object
                         if (optimizationDefault)
@@ -1038,16 +1459,94 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
                     }
                 }
             }
+#if !QT_CONFIG(opengles2)
+            if (drawingStyledPoints && !m_isOpenGLES)
+                glDisable(GL_VERTEX_PROGRAM_POINT_SIZE);
+#endif
 
 
-            // Draw the selected item on static optimization
-            if (!optimizationDefault && selectedSeries
+            // Draw the selected item on static optimization, instanced drawing and level of detail
+            if ((!optimizationDefault || drawingInstanced || drawingLod) && selectedSeries
                     && m_selectedItemIndex != Scatter3DController::invalidSelectionIndex()) {
                 ScatterRenderItem &item = renderArray[m_selectedItemIndex];
-                if (item.isVisible()) {
+                const float selectedDotSize = item.size() > 0.0f
+                        ? item.size() / itemScaler : itemSize;
+                if (item.isVisible() && drawingImpostors) {
+                    // Highlight is an identical impostor drawn over the instance
+                    ShaderHelper *impostorShader = colorStyleIsUniform
+                            ? m_impostorShader : m_impostorGradientShader;
+                    impostorShader->bind();
+                    impostorShader->setUniformValue(impostorShader->lightP(), lightPos);
+                    impostorShader->setUniformValue(impostorShader->view(), viewMatrix);
+                    impostorShader->setUniformValue(impostorShader->ambientS(),
+                                                    m_cachedTheme->ambientLightStrength());
+                    impostorShader->setUniformValue(impostorShader->lightColor(), lightColor);
+                    impostorShader->setUniformValue(impostorShader->instanceScale(),
+                                                    selectedDotSize);
+                    setAxisMappingUniforms(impostorShader, cache);
+#ifdef SHOW_DEPTH_TEXTURE_SCENE
+                    impostorShader->setUniformValue(impostorShader->MVP(),
+                                                    depthProjectionViewMatrix);
+#else
+                    impostorShader->setUniformValue(impostorShader->MVP(), projectionViewMatrix);
+#endif
+
+                    QVector4D instancePosition(item.translation(), 0.0f);
+                    if (cache->bufferInstances()->rawPositions())
+                        instancePosition = QVector4D(item.position(), 0.0f);
+                    if (colorStyleIsUniform) {
+                        impostorShader->setUniformValue(impostorShader->color(),
+                                                        cache->singleHighlightColor());
+                        gradientTexture = 0;
+                    } else {
+                        impostorShader->setUniformValue(
+                                    impostorShader->gradientHeight(),
+                                    colorStyle == Q3DTheme::ColorStyleObjectGradient ? 0.5f : 0.0f);
+                        if (colorStyle == Q3DTheme::ColorStyleRangeGradient
+                                && !cache->bufferInstances()->rawPositions()) {
+                            instancePosition.setW((item.translation().y() + m_scaleY)
+                                                  * rangeGradientYScaler);
+                        }
+                        gradientTexture = cache->singleHighlightGradientTexture();
+                    }
+                    const QVector4D instanceRotation =
+                            (seriesRotation * item.rotation()).toVector4D();
+
+                    // Highlight has the same depth as the instance below it
+                    glDepthFunc(GL_LEQUAL);
+                    GLfloat lightStrength = m_cachedTheme->highlightLightStrength();
+                    if (m_cachedShadowQuality > QAbstract3DGraph::ShadowQualityNone) {
+                        impostorShader->setUniformValue(impostorShader->shadowQ(),
+                                                        m_shadowQualityToShader);
+                        impostorShader->setUniformValue(impostorShader->depth(),
+                                                        depthProjectionViewMatrix);
+                        impostorShader->setUniformValue(impostorShader->lightS(),
+                                                        lightStrength / 10.0f);
+                        m_drawer->drawImpostor(impostorShader, m_labelObj, instancePosition,
+                                               instanceRotation, gradientTexture,
+                                               m_depthTexture);
+                    } else {
+                        impostorShader->setUniformValue(impostorShader->lightS(), lightStrength);
+                        m_drawer->drawImpostor(impostorShader, m_labelObj, instancePosition,
+                                               instanceRotation, gradientTexture);
+                    }
+                    glDepthFunc(GL_LESS);
+
+                    // Save the reference to the item to be used in label drawing
+                    selectedItem = &item;
+                    dotSelectionFound = true;
+                    // Save selected item size (adjusted with font size) for selection label
+                    // positioning
+                    selectedItemSize = selectedDotSize + m_drawer->scaledFontSize() - 0.05f;
+                } else if (item.isVisible()) {
                     ShaderHelper *selectionShader;
                     if (drawingPoints) {
                         selectionShader = pointSelectionShader;
+                    } else if (optimizationDefault) {
+                        if (colorStyleIsUniform)
+                            selectionShader = m_dotShader;
+                        else
+                            selectionShader = m_dotGradientShader;
                     } else {
                         if (colorStyleIsUniform)
                             selectionShader = m_staticSelectedItemShader;
@@ -1068,8 +1567,8 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
                             modelMatrix.rotate(totalRotation);
                             itModelMatrix.rotate(totalRotation);
                         }
-                        modelMatrix.scale(modelScaler);
-                        itModelMatrix.scale(modelScaler);
+                        modelMatrix.scale(selectedDotSize);
+                        itModelMatrix.scale(selectedDotSize);
 
                         selectionShader->setUniformValue(selectionShader->lightP(),
                                                          lightPos);
@@ -1098,7 +1597,11 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
                     dotSelectionFound = true;
                     // Save selected item size (adjusted with font size) for selection label
                     // positioning
-                    selectedItemSize = itemSize + m_drawer->scaledFontSize() - 0.05f;
+                    selectedItemSize = selectedDotSize + m_drawer->scaledFontSize() - 0.05f;
+#if !QT_CONFIG(opengles2)
+                    if (drawingPoints && cache->hasItemSizes() && !m_isOpenGLES)
+                        m_funcs_2_1->glPointSize(selectedDotSize * activeCamera->zoomLevel());
+#endif
 
                     if (!drawingPoints) {
                         // Set shader bindings
@@ -1586,6 +2089,8 @@ void Scatter3DRenderer::drawScene(const GLuint defaultFboHandle)
                                         projectionViewMatrix, depthProjectionViewMatrix,
                                         m_depthTexture, m_shadowQualityToShader);
 
+    drawDensity(projectionMatrix, projectionViewMatrix);
+
     drawLabels(false, activeCamera, viewMatrix, projectionMatrix);
 
     // Handle selection clearing and selection label drawing
@@ -2138,10 +2643,16 @@ void Scatter3DRenderer::updateSelectedItem(int index, QScatter3DSeries *series)
     }
 
     if (m_selectedSeriesCache) {
-        const ScatterRenderItemArray &renderArray = m_selectedSeriesCache->renderArray();
+        ScatterRenderItemArray &renderArray = m_selectedSeriesCache->renderArray();
         if (index < renderArray.size() && index >= 0) {
             m_selectedItemIndex = index;
 
+            // Only the selected item is needed on CPU after axis changes
+            if (m_selectedSeriesCache->translationsDirty()) {
+                updateRenderItem(series->dataProxy()->dptrc()->item(index),
+                                 renderArray[index]);
+            }
+
             if (m_cachedOptimizationHint.testFlag(QAbstract3DGraph::OptimizationStatic)
                     && m_selectedSeriesCache->mesh() == QAbstract3DSeries::MeshPoint) {
                 m_selectedSeriesCache->bufferPoints()->pushPoint(m_selectedItemIndex);
@@ -2302,6 +2813,8 @@ void Scatter3DRenderer::initShaders(const QString &vertexShader, const QString &
     delete m_dotShader;
     m_dotShader = new ShaderHelper(this, vertexShader, fragmentShader);
     m_dotShader->initialize();
+
+    initInstancedShaders();
 }
 
 void Scatter3DRenderer::initGradientShaders(const QString &vertexShader,
@@ -2356,9 +2869,77 @@ void Scatter3DRenderer::initDepthShader()
         m_depthShader = new ShaderHelper(this, QStringLiteral(":/shaders/vertexDepth"),
                                          QStringLiteral(":/shaders/fragmentDepth"));
         m_depthShader->initialize();
+
+        // Static meshes use the instanced shader even without instancing support
+        delete m_depthInstancedShader;
+        m_depthInstancedShader = new ShaderHelper(this,
+                                                  QStringLiteral(":/shaders/vertexDepthInstanced"),
+                                                  QStringLiteral(":/shaders/fragmentDepth"));
+        m_depthInstancedShader->initialize();
+
+        if (m_instancingSupported) {
+            delete m_depthImpostorShader;
+            m_depthImpostorShader = new ShaderHelper(this,
+                                                     QStringLiteral(":/shaders/vertexImpostorInstanced"),
+                                                     QStringLiteral(":/shaders/fragmentImpostorDepth"));
+            m_depthImpostorShader->initialize();
+        }
     }
 }
 
+void Scatter3DRenderer::initInstancedShaders()
+{
+    delete m_dotInstancedShader;
+    m_dotInstancedShader = 0;
+    delete m_dotGradientInstancedShader;
+    m_dotGradientInstancedShader = 0;
+    delete m_impostorShader;
+    m_impostorShader = 0;
+    delete m_impostorGradientShader;
+    m_impostorGradientShader = 0;
+
+    // Mesh shaders are also used for static meshes, with per-vertex instance attributes, when
+    // instancing is not supported
+    QString vertexShader;
+    QString fragmentShader;
+    QString gradientFragmentShader;
+    if (m_isOpenGLES) {
+        vertexShader = QStringLiteral(":/shaders/vertexInstanced");
+        fragmentShader = QStringLiteral(":/shaders/fragmentItemColorES2");
+        gradientFragmentShader = QStringLiteral(":/shaders/fragmentTextureES2");
+    } else if (m_cachedShadowQuality > QAbstract3DGraph::ShadowQualityNone) {
+        vertexShader = QStringLiteral(":/shaders/vertexShadowInstanced");
+        fragmentShader = QStringLiteral(":/shaders/fragmentItemColorShadow");
+        gradientFragmentShader = QStringLiteral(":/shaders/fragmentShadow");
+    } else {
+        vertexShader = QStringLiteral(":/shaders/vertexInstanced");
+        fragmentShader = QStringLiteral(":/shaders/fragmentItemColor");
+        gradientFragmentShader = QStringLiteral(":/shaders/fragmentTexture");
+    }
+
+    m_dotInstancedShader = new ShaderHelper(this, vertexShader, fragmentShader);
+    m_dotInstancedShader->initialize();
+    m_dotGradientInstancedShader = new ShaderHelper(this, vertexShader, gradientFragmentShader);
+    m_dotGradientInstancedShader->initialize();
+
+    // Impostors write fragment depth, which OpenGL ES 2.0 does not support
+    if (m_isOpenGLES || !m_instancingSupported)
+        return;
+
+    if (m_cachedShadowQuality > QAbstract3DGraph::ShadowQualityNone) {
+        fragmentShader = QStringLiteral(":/shaders/fragmentImpostorShadowNoTex");
+        gradientFragmentShader = QStringLiteral(":/shaders/fragmentImpostorShadow");
+    } else {
+        fragmentShader = QStringLiteral(":/shaders/fragmentImpostor");
+        gradientFragmentShader = QStringLiteral(":/shaders/fragmentImpostorTexture");
+    }
+    vertexShader = QStringLiteral(":/shaders/vertexImpostorInstanced");
+    m_impostorShader = new ShaderHelper(this, vertexShader, fragmentShader);
+    m_impostorShader->initialize();
+    m_impostorGradientShader = new ShaderHelper(this, vertexShader, gradientFragmentShader);
+    m_impostorGradientShader->initialize();
+}
+
 void Scatter3DRenderer::updateDepthBuffer()
 {
     if (!m_isOpenGLES) {
@@ -2388,6 +2969,23 @@ void Scatter3DRenderer::initPointShader()
     }
 }
 
+void Scatter3DRenderer::initItemStylePointShader()
+{
+    delete m_itemStylePointShader;
+    m_itemStylePointShader = new ShaderHelper(this,
+                                              QStringLiteral(":/shaders/vertexPointItemStyle"),
+                                              QStringLiteral(":/shaders/fragmentPointItemStyle"));
+    m_itemStylePointShader->initialize();
+}
+
+void Scatter3DRenderer::initDensityShader()
+{
+    delete m_densityShader;
+    m_densityShader = new ShaderHelper(this, QStringLiteral(":/shaders/vertexDensity"),
+                                       QStringLiteral(":/shaders/fragmentDensity"));
+    m_densityShader->initialize();
+}
+
 void Scatter3DRenderer::initBackgroundShaders(const QString &vertexShader,
                                               const QString &fragmentShader)
 {
@@ -2436,25 +3034,12 @@ void Scatter3DRenderer::selectionColorToSeriesAndIndex(const QVector4D &color,
                     + (int(color.y()) << 8)
                     + (int(color.z()) << 16);
             m_clickedType = QAbstract3DGraph::ElementCustomItem;
-        } else {
-            int totalIndex = int(color.x())
-                    + (int(color.y()) << 8)
-                    + (int(color.z()) << 16);
-            // Find the series and adjust the index accordingly
-            foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
-                if (baseCache->isVisible()) {
-                    ScatterSeriesRenderCache *cache =
-                            static_cast<ScatterSeriesRenderCache *>(baseCache);
-                    int offset = cache->selectionIndexOffset();
-                    if (totalIndex >= offset
-                            && totalIndex < (offset + cache->renderArray().size())) {
-                        index = totalIndex - offset;
-                        series = cache->series();
-                        m_clickedType = QAbstract3DGraph::ElementSeries;
-                        return;
-                    }
-                }
-            }
+        } else if (m_pickedSeriesCache) {
+            // Only the item picked on CPU is drawn to the selection buffer
+            index = m_pickedIndex;
+            series = m_pickedSeriesCache->series();
+            m_clickedType = QAbstract3DGraph::ElementSeries;
+            return;
         }
     }
 
@@ -2463,22 +3048,435 @@ void Scatter3DRenderer::selectionColorToSeriesAndIndex(const QVector4D &color,
     series = 0;
 }
 
+void Scatter3DRenderer::pickItem(const QMatrix4x4 &projectionMatrix,
+                                 const QMatrix4x4 &projectionViewMatrix,
+                                 const Q3DCamera *activeCamera)
+{
+    m_pickedSeriesCache = 0;
+    m_pickedIndex = Scatter3DController::invalidSelectionIndex();
+
+    QVector3D rayOrigin;
+    QVector3D rayDirection;
+    QPointF ndcPosition;
+    if (!inputPositionRay(projectionViewMatrix, rayOrigin, rayDirection, &ndcPosition))
+        return;
+    const float width = float(m_primarySubViewport.width());
+    const float height = float(m_primarySubViewport.height());
+
+    // Points have constant size in pixels, so their size in world coordinates depends on
+    // the distance. Use the farthest corner of the graph for a conservative estimate.
+    const float pixelToWorld = 2.0f / (height * projectionMatrix(1, 1));
+    float maxW = 0.0f;
+    for (int i = 0; i < 8; i++) {
+        const QVector4D corner((i & 1) ? m_scaleX : -m_scaleX,
+                               (i & 2) ? m_scaleY : -m_scaleY,
+                               (i & 4) ? m_scaleZ : -m_scaleZ, 1.0f);
+        maxW = qMax(maxW, (projectionViewMatrix * corner).w());
+    }
+
+    float nearestDistance = std::numeric_limits<float>::max();
+    QList<int> candidates;
+    foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
+        ScatterSeriesRenderCache *cache = static_cast<ScatterSeriesRenderCache *>(baseCache);
+        // Items drawn as density are not individually visible
+        if (!cache->isVisible() || cache->densityRendering())
+            continue;
+        const ScatterRenderItemArray &renderArray = cache->renderArray();
+        const bool drawingPoints = (cache->mesh() == QAbstract3DSeries::MeshPoint);
+        float itemSize = cache->itemSize() / itemScaler;
+        if (itemSize == 0.0f)
+            itemSize = m_dotSizeScale;
+        // Candidates are searched with the largest item size, and then tested with their own
+        const float maxItemSize = qMax(itemSize, cache->maxItemStyleSize() / itemScaler);
+        const float maxPointRadius = maxItemSize * activeCamera->zoomLevel() * 0.5f;
+        // Meshes are scaled by the item size, the same way as when culling them
+        const float meshRadius = (!drawingPoints && cache->object())
+                ? cache->object()->radius() : 1.0f;
+        const float radius = drawingPoints ? maxPointRadius * pixelToWorld * maxW
+                                           : maxItemSize * meshRadius;
+
+        updateTranslations(cache);
+        cache->bvh().update(renderArray);
+        candidates.clear();
+        cache->bvh().intersect(renderArray, rayOrigin, rayDirection, radius, candidates);
+
+        foreach (int index, candidates) {
+            const ScatterRenderItem &item = renderArray.at(index);
+            const float itemScale = item.size() > 0.0f ? item.size() / itemScaler : itemSize;
+            const QVector3D &position = item.translation();
+            const QVector3D toItem = position - rayOrigin;
+            const float rayDistance = QVector3D::dotProduct(toItem, rayDirection);
+            float distance;
+            if (drawingPoints) {
+                const QVector4D clipPosition = projectionViewMatrix * QVector4D(position, 1.0f);
+                if (clipPosition.w() <= 0.0f)
+                    continue;
+                const float dx = (clipPosition.x() / clipPosition.w() - float(ndcPosition.x()))
+                        * width * 0.5f;
+                const float dy = (clipPosition.y() / clipPosition.w() - float(ndcPosition.y()))
+                        * height * 0.5f;
+                const float pointRadius = itemScale * activeCamera->zoomLevel() * 0.5f;
+                if (dx * dx + dy * dy > pointRadius * pointRadius)
+                    continue;
+                distance = rayDistance;
+            } else {
+                // Distance to the bounding sphere surface of the item
+                const float itemRadius = itemScale * meshRadius;
+                const float offsetSquared = itemRadius * itemRadius - toItem.lengthSquared()
+                        + rayDistance * rayDistance;
+                if (offsetSquared < 0.0f && cache->hasItemSizes())
+                    continue;
+                distance = rayDistance - qSqrt(qMax(0.0f, offsetSquared));
+            }
+            // Items behind the camera cannot be picked
+            if (distance < 0.0f)
+                continue;
+            if (distance < nearestDistance) {
+                nearestDistance = distance;
+                m_pickedSeriesCache = cache;
+                m_pickedIndex = index;
+            }
+        }
+    }
+}
+
+// Culls the items of the series against the frustum of the given matrix. Items drawn one by one
+// and instanced or static points drawn without a subset are culled by chunk, other drawing only
+// as a whole. Returns false if no items are left to draw.
+bool Scatter3DRenderer::cullItems(ScatterSeriesRenderCache *cache,
+                                  const QMatrix4x4 &projectionViewMatrix, float itemSize,
+                                  RenderingState state)
+{
+    const bool optimizationDefault =
+            !m_cachedOptimizationHint.testFlag(QAbstract3DGraph::OptimizationStatic);
+    const bool drawingPoints = (cache->mesh() == QAbstract3DSeries::MeshPoint);
+    const bool drawingInstanced = m_instancingSupported && !drawingPoints;
+    ScatterInstanceBufferHelper *instances = cache->bufferInstances();
+    ScatterPointBufferHelper *points = cache->bufferPoints();
+
+    // Meshes are scaled by the item size, points are approximated with it
+    float radius = qMax(itemSize, cache->maxItemStyleSize() / itemScaler);
+    if (!drawingPoints && cache->object())
+        radius *= cache->object()->radius();
+
+    if (instances)
+        instances->clearDrawRanges();
+    if (points)
+        points->clearDrawRanges();
+
+    ChunkBounds &bounds = cache->chunkBounds();
+    if (drawingInstanced && instances && instances->rawPositions()) {
+        // Translations are not kept up to date when axes are mapped in the shader
+        bounds.resetCulling();
+        return true;
+    }
+
+    cache->updateChunkBounds();
+    const int culledCount = bounds.cull(Frustum(projectionViewMatrix),
+                                        QVector3D(radius, radius, radius));
+    const bool allCulled = bounds.isAllCulled();
+
+    QList<QPair<int, int>> ranges;
+    if (drawingInstanced && instances && !instances->hasSubset()) {
+        bounds.visibleRanges(ranges);
+        instances->setDrawRanges(ranges);
+    } else if (!optimizationDefault && drawingPoints && points && !points->hasSubset()) {
+        bounds.visibleRanges(ranges);
+        points->setDrawRanges(ranges);
+    } else if ((drawingInstanced || !optimizationDefault) && !allCulled) {
+        // Series is drawn as a whole
+        bounds.resetCulling();
+        return true;
+    }
+
+    m_culledItemCounts[state] += culledCount;
+    return !allCulled;
+}
+
+// Draws the series drawn as density after the opaque parts of the scene. Cells are blended
+// additively without writing depth, so that they need no sorting.
+void Scatter3DRenderer::drawDensity(const QMatrix4x4 &projectionMatrix,
+                                    const QMatrix4x4 &projectionViewMatrix)
+{
+    // Projected size in pixels of unit length at unit distance from the camera
+    const float pixelScale = projectionMatrix(1, 1) * m_primarySubViewport.height() / 2.0f;
+    const QVector3D sceneScale(m_scaleX, m_scaleY, m_scaleZ);
+    bool stateSet = false;
+
+    foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
+        ScatterSeriesRenderCache *cache = static_cast<ScatterSeriesRenderCache *>(baseCache);
+        if (!cache->isVisible() || !cache->densityRendering())
+            continue;
+
+        ScatterDensityBufferHelper *density = cache->bufferDensity();
+        if (!density) {
+            density = new ScatterDensityBufferHelper();
+            cache->setBufferDensity(density);
+            cache->setDensityDirty(true);
+        }
+        if (cache->translationsDirty()) {
+            updateTranslations(cache);
+            cache->setDensityDirty(true);
+        }
+        // Axis changes move all items, other changes only rebin the changed items
+        if (cache->densityDirty() || density->resolution() != cache->densityResolution()
+                || density->sceneScale() != sceneScale) {
+            density->load(cache, sceneScale, cache->densityResolution());
+            cache->setDensityDirty(false);
+        } else {
+            density->update(cache);
+        }
+        cache->updateIndices().clear();
+        if (!density->indexCount())
+            continue;
+
+        if (!stateSet) {
+            m_densityShader->bind();
+            m_densityShader->setUniformValue(m_densityShader->MVP(), projectionViewMatrix);
+            glEnable(GL_BLEND);
+            glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+            glDepthMask(GL_FALSE);
+#if !QT_CONFIG(opengles2)
+            if (!m_isOpenGLES)
+                glEnable(GL_VERTEX_PROGRAM_POINT_SIZE);
+#endif
+            stateSet = true;
+        }
+        // Cells overlap, so opacity is reduced on finer grids to keep the brightness similar
+        m_densityShader->setUniformValue(m_densityShader->pointScale(),
+                                         density->cellSize() * pixelScale);
+        m_densityShader->setUniformValue(m_densityShader->alphaMultiplier(),
+                                         qMin(1.0f, 16.0f / float(density->resolution())));
+        m_drawer->drawDensity(m_densityShader, density, cache->baseGradientTexture());
+    }
+
+    if (stateSet) {
+#if !QT_CONFIG(opengles2)
+        if (!m_isOpenGLES)
+            glDisable(GL_VERTEX_PROGRAM_POINT_SIZE);
+#endif
+        glDepthMask(GL_TRUE);
+        glDisable(GL_BLEND);
+    }
+}
+
+void Scatter3DRenderer::updateLevelOfDetail(const QMatrix4x4 &projectionMatrix,
+                                            const QMatrix4x4 &projectionViewMatrix)
+{
+    const bool optimizationStatic =
+            m_cachedOptimizationHint.testFlag(QAbstract3DGraph::OptimizationStatic);
+    // Projected size in pixels of unit length at unit distance from the camera
+    const float pixelScale = projectionMatrix(1, 1) * m_primarySubViewport.height() / 2.0f;
+
+    foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
+        ScatterSeriesRenderCache *cache = static_cast<ScatterSeriesRenderCache *>(baseCache);
+        if (!cache->isVisible() || !cache->levelOfDetail() || cache->densityRendering())
+            continue;
+
+        const bool drawingPoints = (cache->mesh() == QAbstract3DSeries::MeshPoint);
+        // Static mesh buffers are drawn with a single draw call, so items cannot be skipped
+        if (optimizationStatic && !drawingPoints && !m_instancingSupported)
+            continue;
+        // Octree is built from translations, which are not kept up to date in raw buffers
+        ScatterInstanceBufferHelper *rawInstances = cache->bufferInstances();
+        if (!drawingPoints && rawInstances && rawInstances->rawPositions()) {
+            rawInstances->clearSubset();
+            continue;
+        }
+
+        cache->octree().update(cache->renderArray());
+        const bool changed = cache->octree().selectItems(projectionViewMatrix, pixelScale,
+                                                          cache->levelOfDetailThreshold(),
+                                                          cache->levelOfDetailBudget(),
+                                                          cache->lodIndices());
+        if (drawingPoints) {
+            ScatterPointBufferHelper *points = cache->bufferPoints();
+            if (optimizationStatic && points && (changed || !points->hasSubset()))
+                points->setSubset(cache->lodIndices());
+        } else if (m_instancingSupported) {
+            ScatterInstanceBufferHelper *instances = cache->bufferInstances();
+            if (instances && (changed || !instances->hasSubset()))
+                instances->setSubset(cache, cache->lodIndices());
+        }
+    }
+}
+
+bool Scatter3DRenderer::isAxisMappedInShader(ScatterSeriesRenderCache *cache) const
+{
+    return m_cachedOptimizationHint.testFlag(QAbstract3DGraph::OptimizationAxisMapping)
+            && m_instancingSupported && cache->mesh() != QAbstract3DSeries::MeshPoint
+            && m_axisCacheX.hasBuiltInFormatter() && m_axisCacheY.hasBuiltInFormatter()
+            && m_axisCacheZ.hasBuiltInFormatter();
+}
+
+// Sphere impostors replace the instanced sphere mesh with a ray traced quad per item
+bool Scatter3DRenderer::isDrawnAsImpostors(ScatterSeriesRenderCache *cache) const
+{
+    return m_cachedOptimizationHint.testFlag(QAbstract3DGraph::OptimizationSphereImpostors)
+            && m_instancingSupported && !m_isOpenGLES
+            && cache->mesh() == QAbstract3DSeries::MeshSphere;
+}
+
+// Sets the uniforms of instanced shaders that map data values to translations
+void Scatter3DRenderer::setAxisMappingUniforms(ShaderHelper *shader,
+                                               ScatterSeriesRenderCache *cache)
+{
+    if (!cache->bufferInstances() || !cache->bufferInstances()->rawPositions()) {
+        shader->setUniformValue(shader->axisMapping(), zeroVector);
+        return;
+    }
+
+    QVector3D logarithmic;
+    QVector3D offset;
+    QVector3D normalizer;
+    QVector3D scale;
+    QVector3D translate;
+    const AxisRenderCache *axisCaches[3] = { &m_axisCacheX, &m_axisCacheY, &m_axisCacheZ };
+    for (int axis = 0; axis < 3; axis++) {
+        bool axisLogarithmic = false;
+        float axisOffset = 0.0f;
+        float axisNormalizer = 1.0f;
+        float axisScale = 1.0f;
+        float axisTranslate = 0.0f;
+        axisCaches[axis]->shaderMapping(axisLogarithmic, axisOffset, axisNormalizer, axisScale,
+                                        axisTranslate);
+        logarithmic[axis] = axisLogarithmic ? 1.0f : 0.0f;
+        offset[axis] = axisOffset;
+        normalizer[axis] = axisNormalizer;
+        scale[axis] = axisScale;
+        translate[axis] = axisTranslate;
+    }
+
+    const bool rangeGradient = (cache->colorStyle() == Q3DTheme::ColorStyleRangeGradient);
+    shader->setUniformValue(shader->axisMin(), QVector3D(m_axisCacheX.min(), m_axisCacheY.min(),
+                                                         m_axisCacheZ.min()));
+    shader->setUniformValue(shader->axisMax(), QVector3D(m_axisCacheX.max(), m_axisCacheY.max(),
+                                                         m_axisCacheZ.max()));
+    shader->setUniformValue(shader->axisLog(), logarithmic);
+    shader->setUniformValue(shader->axisOffset(), offset);
+    shader->setUniformValue(shader->axisNormalizer(), normalizer);
+    shader->setUniformValue(shader->axisScale(), scale);
+    shader->setUniformValue(shader->axisTranslate(), translate);
+    shader->setUniformValue(shader->axisMapping(),
+                            QVector3D(1.0f, m_polarGraph ? m_polarRadius : 0.0f,
+                                      rangeGradient ? m_scaleY : 0.0f));
+}
+
+// Updates the render items of a series mapped in the shader after axis changes. Only needed
+// when the translations are used on CPU, such as for picking.
+void Scatter3DRenderer::updateTranslations(ScatterSeriesRenderCache *cache)
+{
+    if (!cache->translationsDirty())
+        return;
+
+    updateRenderItems(cache->series()->dataProxy()->dptrc(), cache->renderArray());
+    cache->bvh().invalidate();
+    cache->octree().invalidate();
+    cache->chunkBounds().invalidateAll();
+    cache->setTranslationsDirty(false);
+}
+
+void Scatter3DRenderer::handleAxisMappingChanged()
+{
+    // Buffers of series mapped in the shader hold data values, so they stay valid
+    foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
+        ScatterSeriesRenderCache *cache = static_cast<ScatterSeriesRenderCache *>(baseCache);
+        ScatterInstanceBufferHelper *instances = cache->bufferInstances();
+        if (cache->isVisible() && instances && instances->rawPositions()
+                && isAxisMappedInShader(cache)) {
+            cache->setTranslationsDirty(true);
+        } else {
+            cache->setDataDirty(true);
+        }
+    }
+}
+
+// Updates the whole render array from the data. Large arrays are split into chunks that are
+// updated in parallel, if the axis formatters allow it.
+void Scatter3DRenderer::updateRenderItems(const QScatterDataProxyPrivate *dataProxy,
+                                          ScatterRenderItemArray &renderArray)
+{
+    const int dataSize = renderArray.size();
+    ScatterRenderItem *renderItems = renderArray.data();
+    const QScatterDataArray &dataArray = *dataProxy->m_dataArray;
+    const bool externalArray = dataProxy->hasExternalArray();
+
+    // Default formatters are mapped without calling them, which gives identical results
+    LinearAxisMapping mappingX;
+    LinearAxisMapping mappingY;
+    LinearAxisMapping mappingZ;
+    const bool linearAxes = !m_polarGraph && m_axisCacheX.linearMapping(mappingX)
+            && m_axisCacheY.linearMapping(mappingY) && m_axisCacheZ.linearMapping(mappingZ);
+
+    auto updateRange = [&](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            ScatterRenderItem &renderItem = renderItems[i];
+            const bool visible = externalArray
+                    ? updateRenderItemPosition(dataProxy->item(i), renderItem)
+                    : updateRenderItemPosition(dataArray.at(i), renderItem);
+            renderItem.setColor(dataProxy->itemColor(i));
+            renderItem.setSize(dataProxy->itemSize(i));
+            if (!visible)
+                continue;
+            if (linearAxes) {
+                const QVector3D &pos = renderItem.position();
+                renderItem.setTranslation(QVector3D(mappingX.positionAt(pos.x()),
+                                                    mappingY.positionAt(pos.y()),
+                                                    mappingZ.positionAt(pos.z())));
+            } else {
+                calculateTranslation(renderItem);
+            }
+        }
+    };
+
+    const bool parallel = dataSize > renderItemChunkSize
+            && (linearAxes || (m_axisCacheX.hasBuiltInFormatter()
+                               && m_axisCacheY.hasBuiltInFormatter()
+                               && m_axisCacheZ.hasBuiltInFormatter()));
+    if (parallel)
+        Utils::parallelFor(dataSize, renderItemChunkSize, updateRange);
+    else
+        updateRange(0, dataSize);
+}
+
+// Notes the proxy starting or stopping to use item colors or sizes, which changes the buffers
+void Scatter3DRenderer::updateItemStyleFlags(ScatterSeriesRenderCache *cache,
+                                             const QScatterDataProxyPrivate *dataProxy)
+{
+    if (cache->hasItemColors() != dataProxy->hasItemColors()
+            || cache->hasItemSizes() != dataProxy->hasItemSizes()) {
+        cache->setItemColors(dataProxy->hasItemColors());
+        cache->setItemSizes(dataProxy->hasItemSizes());
+        cache->setItemStylesChanged(true);
+    }
+}
+
 void Scatter3DRenderer::updateRenderItem(const QScatterDataItem &dataItem,
                                          ScatterRenderItem &renderItem)
 {
+    if (updateRenderItemPosition(dataItem, renderItem))
+        calculateTranslation(renderItem);
+}
+
+// Returns true if the item is visible, in which case the translation needs to be calculated
+bool Scatter3DRenderer::updateRenderItemPosition(const QScatterDataItem &dataItem,
+                                                 ScatterRenderItem &renderItem)
+{
+    // Position and rotation of hidden items are needed for raw instance buffers
     QVector3D dotPos = dataItem.position();
+    renderItem.setPosition(dotPos);
+    if (!dataItem.rotation().isIdentity())
+        renderItem.setRotation(dataItem.rotation().normalized());
+    else
+        renderItem.setRotation(identityQuaternion);
     if ((dotPos.x() >= m_axisCacheX.min() && dotPos.x() <= m_axisCacheX.max() )
             && (dotPos.y() >= m_axisCacheY.min() && dotPos.y() <= m_axisCacheY.max())
             && (dotPos.z() >= m_axisCacheZ.min() && dotPos.z() <= m_axisCacheZ.max())) {
-        renderItem.setPosition(dotPos);
         renderItem.setVisible(true);
-        if (!dataItem.rotation().isIdentity())
-            renderItem.setRotation(dataItem.rotation().normalized());
-        else
-            renderItem.setRotation(identityQuaternion);
-        calculateTranslation(renderItem);
+        return true;
     } else {
         renderItem.setVisible(false);
+        return false;
     }
 }
 
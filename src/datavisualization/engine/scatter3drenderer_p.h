@@ -27,6 +27,7 @@ class ShaderHelper;
 class Q3DScene;
 class ScatterSeriesRenderCache;
 class QScatterDataItem;
+class QScatterDataProxyPrivate;
 
 class Q_DATAVISUALIZATION_EXPORT Scatter3DRenderer : public Abstract3DRenderer
 {
@@ -45,6 +46,14 @@ private:
     ShaderHelper *m_selectionShader;
     ShaderHelper *m_backgroundShader;
     ShaderHelper *m_staticGradientPointShader;
+    ShaderHelper *m_dotInstancedShader;
+    ShaderHelper *m_dotGradientInstancedShader;
+    ShaderHelper *m_depthInstancedShader;
+    ShaderHelper *m_impostorShader;
+    ShaderHelper *m_impostorGradientShader;
+    ShaderHelper *m_depthImpostorShader;
+    ShaderHelper *m_itemStylePointShader;
+    ShaderHelper *m_densityShader;
     GLuint m_bgrTexture;
     GLuint m_selectionTexture;
     GLuint m_depthFrameBuffer;
@@ -66,6 +75,9 @@ private:
     bool m_haveMeshSeries;
     bool m_haveUniformColorMeshSeries;
     bool m_haveGradientMeshSeries;
+    bool m_instancingSupported;
+    ScatterSeriesRenderCache *m_pickedSeriesCache;
+    int m_pickedIndex;
 
 public:
     explicit Scatter3DRenderer(Scatter3DController *controller);
@@ -74,7 +86,9 @@ public:
     void updateData() override;
     void updateSeries(const QList<QAbstract3DSeries *> &seriesList) override;
     SeriesRenderCache *createNewCache(QAbstract3DSeries *series) override;
-    void updateItems(const QList<Scatter3DController::ChangeItem> &items);
+    void updateItems(const Scatter3DController::ChangedItems &items);
+    bool updateInsertedAndRemovedItems(
+            const QList<Scatter3DController::InsertRemoveRecord> &records);
     void updateScene(Q3DScene *scene) override;
     void updateAxisLabels(QAbstract3DAxis::AxisOrientation orientation,
                           const QStringList &labels) override;
@@ -87,6 +101,7 @@ public:
 
     inline int clickedIndex() const { return m_clickedIndex; }
     void resetClickedStatus();
+    bool isDrawnAsImpostors(ScatterSeriesRenderCache *cache) const;
 
     void render(GLuint defaultFboHandle) override;
 
@@ -98,6 +113,7 @@ protected:
     void initializeOpenGL() override;
     void fixCameraTarget(QVector3D &target) override;
     void getVisibleItemBounds(QVector3D &minBounds, QVector3D &maxBounds) override;
+    void handleAxisMappingChanged() override;
 
 private:
     void initShaders(const QString &vertexShader, const QString &fragmentShader) override;
@@ -120,14 +136,36 @@ private:
     void initStaticPointShaders(const QString &vertexShader, const QString &fragmentShader);
     void initSelectionBuffer() override;
     void initDepthShader();
+    void initInstancedShaders();
     void updateDepthBuffer() override;
     void initPointShader();
+    void initItemStylePointShader();
+    void initDensityShader();
     void calculateTranslation(ScatterRenderItem &item);
     void calculateSceneScalingFactors();
-
+    void calculateDotSizeScale();
+    void updateItemBuffers(ScatterSeriesRenderCache *cache);
+
+    void pickItem(const QMatrix4x4 &projectionMatrix, const QMatrix4x4 &projectionViewMatrix,
+                  const Q3DCamera *activeCamera);
+    bool cullItems(ScatterSeriesRenderCache *cache, const QMatrix4x4 &projectionViewMatrix,
+                   float itemSize, RenderingState state);
+    void updateLevelOfDetail(const QMatrix4x4 &projectionMatrix,
+                             const QMatrix4x4 &projectionViewMatrix);
+    void drawDensity(const QMatrix4x4 &projectionMatrix,
+                     const QMatrix4x4 &projectionViewMatrix);
+    bool isAxisMappedInShader(ScatterSeriesRenderCache *cache) const;
+    void setAxisMappingUniforms(ShaderHelper *shader, ScatterSeriesRenderCache *cache);
+    void updateTranslations(ScatterSeriesRenderCache *cache);
     void selectionColorToSeriesAndIndex(const QVector4D &color, int &index,
                                         QAbstract3DSeries *&series);
+    void updateRenderItems(const QScatterDataProxyPrivate *dataProxy,
+                           ScatterRenderItemArray &renderArray);
+    void updateItemStyleFlags(ScatterSeriesRenderCache *cache,
+                              const QScatterDataProxyPrivate *dataProxy);
     inline void updateRenderItem(const QScatterDataItem &dataItem, ScatterRenderItem &renderItem);
+    inline bool updateRenderItemPosition(const QScatterDataItem &dataItem,
+                                         ScatterRenderItem &renderItem);
 
     Q_DISABLE_COPY(Scatter3DRenderer)
 };
@@ -4,6 +4,8 @@
 #include "scatterseriesrendercache_p.h"
 #include "scatterobjectbufferhelper_p.h"
 #include "scatterpointbufferhelper_p.h"
+#include "scatterinstancebufferhelper_p.h"
+#include "scatterdensitybufferhelper_p.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -11,13 +13,24 @@ ScatterSeriesRenderCache::ScatterSeriesRenderCache(QAbstract3DSeries *series,
                                                    Abstract3DRenderer *renderer)
     : SeriesRenderCache(series, renderer),
       m_itemSize(0.0f),
-      m_selectionIndexOffset(0),
+      m_levelOfDetail(false),
+      m_levelOfDetailThreshold(1.0f),
+      m_levelOfDetailBudget(0),
+      m_densityRendering(false),
+      m_densityResolution(64),
+      m_densityDirty(false),
       m_staticBufferDirty(false),
       m_oldRenderArraySize(0),
       m_oldMeshFileName(QString()),
       m_scatterBufferObj(0),
       m_scatterBufferPoints(0),
-      m_visibilityChanged(false)
+      m_scatterBufferInstances(0),
+      m_scatterBufferDensity(0),
+      m_translationsDirty(false),
+      m_itemColors(false),
+      m_itemSizes(false),
+      m_maxItemStyleSize(0.0f),
+      m_itemStylesChanged(false)
 {
 }
 
@@ -25,13 +38,63 @@ ScatterSeriesRenderCache::~ScatterSeriesRenderCache()
 {
     delete m_scatterBufferObj;
     delete m_scatterBufferPoints;
+    delete m_scatterBufferInstances;
+    delete m_scatterBufferDensity;
 }
 
 void ScatterSeriesRenderCache::cleanup(TextureHelper *texHelper)
 {
     m_renderArray.clear();
+    m_bvh.invalidate();
+    m_octree.invalidate();
+    m_lodIndices.clear();
+    m_chunkBounds.resize(0);
 
     SeriesRenderCache::cleanup(texHelper);
 }
 
+// Recomputes the bounds of the chunks that have changed items
+void ScatterSeriesRenderCache::updateChunkBounds()
+{
+    const int renderArraySize = m_renderArray.size();
+    m_chunkBounds.resize(renderArraySize);
+    const QList<int> dirtyChunks = m_chunkBounds.takeDirtyChunks();
+    for (int chunk : dirtyChunks) {
+        const int first = chunk * ChunkBounds::chunkSize;
+        const int end = qMin(first + ChunkBounds::chunkSize, renderArraySize);
+        QVector3D minimum;
+        QVector3D maximum;
+        int visibleCount = 0;
+        for (int i = first; i < end; i++) {
+            const ScatterRenderItem &item = m_renderArray.at(i);
+            if (!item.isVisible())
+                continue;
+            const QVector3D &translation = item.translation();
+            if (!visibleCount) {
+                minimum = translation;
+                maximum = translation;
+            } else {
+                for (int axis = 0; axis < 3; axis++) {
+                    minimum[axis] = qMin(minimum[axis], translation[axis]);
+                    maximum[axis] = qMax(maximum[axis], translation[axis]);
+                }
+            }
+            visibleCount++;
+        }
+        m_chunkBounds.setChunkBounds(chunk, minimum, maximum, visibleCount);
+    }
+}
+
+ScatterItemStyle ScatterSeriesRenderCache::itemStyle(const ScatterRenderItem &item)
+{
+    const QRgb color = item.color();
+    ScatterItemStyle style;
+    style.color[0] = GLubyte(qRed(color));
+    style.color[1] = GLubyte(qGreen(color));
+    style.color[2] = GLubyte(qBlue(color));
+    style.color[3] = GLubyte(qAlpha(color));
+    style.size = item.size() / itemScaler;
+    return style;
+}
+
 QT_END_NAMESPACE
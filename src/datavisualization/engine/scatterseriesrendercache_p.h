@@ -18,11 +18,27 @@
 #include "seriesrendercache_p.h"
 #include "qscatter3dseries_p.h"
 #include "scatterrenderitem_p.h"
+#include "scatteritembvh_p.h"
+#include "scatteritemoctree_p.h"
+#include "chunkbounds_p.h"
 
 QT_BEGIN_NAMESPACE
 
 class ScatterObjectBufferHelper;
 class ScatterPointBufferHelper;
+class ScatterInstanceBufferHelper;
+class ScatterDensityBufferHelper;
+
+// Ratio of series and item sizes to item sizes in scene units
+static const GLfloat itemScaler = 3.0f;
+
+// Item color as normalized RGBA bytes and item size in scene units, as stored in vertex
+// attribute buffers. Zeros stand for the series values.
+struct ScatterItemStyle
+{
+    GLubyte color[4];
+    GLfloat size;
+};
 
 class ScatterSeriesRenderCache : public SeriesRenderCache
 {
@@ -36,8 +52,18 @@ public:
     inline QScatter3DSeries *series() const { return static_cast<QScatter3DSeries *>(m_series); }
     inline void setItemSize(float size) { m_itemSize = size; }
     inline float itemSize() const { return m_itemSize; }
-    inline void setSelectionIndexOffset(int offset) { m_selectionIndexOffset = offset; }
-    inline int selectionIndexOffset() const { return m_selectionIndexOffset; }
+    inline void setLevelOfDetail(bool enable) { m_levelOfDetail = enable; }
+    inline bool levelOfDetail() const { return m_levelOfDetail; }
+    inline void setLevelOfDetailThreshold(float pixels) { m_levelOfDetailThreshold = pixels; }
+    inline float levelOfDetailThreshold() const { return m_levelOfDetailThreshold; }
+    inline void setLevelOfDetailBudget(int itemCount) { m_levelOfDetailBudget = itemCount; }
+    inline int levelOfDetailBudget() const { return m_levelOfDetailBudget; }
+    inline void setDensityRendering(bool enable) { m_densityRendering = enable; }
+    inline bool densityRendering() const { return m_densityRendering; }
+    inline void setDensityResolution(int resolution) { m_densityResolution = resolution; }
+    inline int densityResolution() const { return m_densityResolution; }
+    inline void setDensityDirty(bool dirty) { m_densityDirty = dirty; }
+    inline bool densityDirty() const { return m_densityDirty; }
     inline void setStaticBufferDirty(bool state) { m_staticBufferDirty = state; }
     inline bool staticBufferDirty() const { return m_staticBufferDirty; }
     inline int oldArraySize() const { return m_oldRenderArraySize; }
@@ -48,23 +74,56 @@ public:
     inline ScatterObjectBufferHelper *bufferObject() const { return m_scatterBufferObj; }
     inline void setBufferPoints(ScatterPointBufferHelper *object) { m_scatterBufferPoints = object; }
     inline ScatterPointBufferHelper *bufferPoints() const { return m_scatterBufferPoints; }
+    inline void setBufferInstances(ScatterInstanceBufferHelper *object) { m_scatterBufferInstances = object; }
+    inline ScatterInstanceBufferHelper *bufferInstances() const { return m_scatterBufferInstances; }
+    inline void setBufferDensity(ScatterDensityBufferHelper *object) { m_scatterBufferDensity = object; }
+    inline ScatterDensityBufferHelper *bufferDensity() const { return m_scatterBufferDensity; }
     inline QList<int> &updateIndices() { return m_updateIndices; }
-    inline QList<int> &bufferIndices() { return m_bufferIndices; }
-    inline void setVisibilityChanged(bool changed) { m_visibilityChanged = changed; }
-    inline bool visibilityChanged() const { return m_visibilityChanged; }
+    inline void setTranslationsDirty(bool dirty) { m_translationsDirty = dirty; }
+    inline bool translationsDirty() const { return m_translationsDirty; }
+    inline void setItemColors(bool enable) { m_itemColors = enable; }
+    inline bool hasItemColors() const { return m_itemColors; }
+    inline void setItemSizes(bool enable) { m_itemSizes = enable; }
+    inline bool hasItemSizes() const { return m_itemSizes; }
+    inline bool hasItemStyles() const { return m_itemColors || m_itemSizes; }
+    inline void setMaxItemStyleSize(float size) { m_maxItemStyleSize = size; }
+    inline float maxItemStyleSize() const { return m_maxItemStyleSize; }
+    inline void setItemStylesChanged(bool changed) { m_itemStylesChanged = changed; }
+    inline bool itemStylesChanged() const { return m_itemStylesChanged; }
+    inline ScatterItemBvh &bvh() { return m_bvh; }
+    inline ScatterItemOctree &octree() { return m_octree; }
+    inline QList<int> &lodIndices() { return m_lodIndices; }
+    inline ChunkBounds &chunkBounds() { return m_chunkBounds; }
+    void updateChunkBounds();
+
+    static ScatterItemStyle itemStyle(const ScatterRenderItem &item);
 
 protected:
     ScatterRenderItemArray m_renderArray;
     float m_itemSize;
-    int m_selectionIndexOffset; // Temporarily cached value for selection color calculations
+    bool m_levelOfDetail;
+    float m_levelOfDetailThreshold;
+    int m_levelOfDetailBudget;
+    bool m_densityRendering;
+    int m_densityResolution;
+    bool m_densityDirty; // Items or scene scale have changed since density was binned
     bool m_staticBufferDirty;
     int m_oldRenderArraySize; // Used to detect if full buffer change needed
     QString m_oldMeshFileName; // Used to detect if full buffer change needed
     ScatterObjectBufferHelper *m_scatterBufferObj;
     ScatterPointBufferHelper *m_scatterBufferPoints;
+    ScatterInstanceBufferHelper *m_scatterBufferInstances;
+    ScatterDensityBufferHelper *m_scatterBufferDensity;
     QList<int> m_updateIndices; // Used as temporary cache during item updates
-    QList<int> m_bufferIndices; // Cache for mapping renderarray to mesh buffer
-    bool m_visibilityChanged; // Used to detect if full buffer change needed
+    bool m_translationsDirty; // Axes have changed since render items were updated
+    bool m_itemColors; // Proxy has per-item colors
+    bool m_itemSizes; // Proxy has per-item sizes
+    float m_maxItemStyleSize; // Largest per-item size, used for culling and picking margins
+    bool m_itemStylesChanged; // Used to detect if full buffer change needed
+    ScatterItemBvh m_bvh; // Used for picking items
+    ScatterItemOctree m_octree; // Used for level of detail
+    QList<int> m_lodIndices; // Items drawn with level of detail
+    ChunkBounds m_chunkBounds; // Used for frustum culling
 };
 
 QT_END_NAMESPACE
@@ -0,0 +1,9 @@
+uniform sampler2D textureSampler;
+uniform highp float alphaMultiplier;
+
+varying highp float density;
+
+void main() {
+    highp vec3 color = texture2D(textureSampler, vec2(0.0, density)).xyz;
+    gl_FragColor = vec4(color, density * alphaMultiplier);
+}
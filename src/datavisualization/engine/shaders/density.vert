@@ -0,0 +1,13 @@
+uniform highp mat4 MVP;
+uniform highp float pointScale;
+
+attribute highp vec4 vertexPosition_mdl;
+
+varying highp float density;
+
+void main() {
+    // Cell center in xyz, normalized density in w. Cells are sized by their projected extent.
+    gl_Position = MVP * vec4(vertexPosition_mdl.xyz, 1.0);
+    gl_PointSize = pointScale / gl_Position.w;
+    density = vertexPosition_mdl.w;
+}
@@ -0,0 +1,51 @@
+uniform highp mat4 MVP;
+uniform highp float instanceScale;
+uniform highp vec3 axisMin;
+uniform highp vec3 axisMax;
+uniform highp vec3 axisLog;
+uniform highp vec3 axisOffset;
+uniform highp vec3 axisNormalizer;
+uniform highp vec3 axisScale;
+uniform highp vec3 axisTranslate;
+uniform highp vec3 axisMapping; // Enabled, polar radius, range gradient y scale
+
+attribute highp vec3 vertexPosition_mdl;
+attribute highp vec4 instancePosition;
+attribute highp vec4 instanceRotation;
+attribute highp float itemSize;
+
+highp vec3 rotate(highp vec4 q, highp vec3 v) {
+    return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v);
+}
+
+// Instance positions are data values instead of translations when axis mapping is enabled
+highp vec3 mapPosition(highp vec3 value) {
+    highp vec3 position = (mix(value, log(max(value, vec3(1.0e-30))), axisLog) - axisOffset)
+            / axisNormalizer;
+    if (axisMapping.y > 0.0) {
+        highp float angle = position.x * 6.28318530718;
+        return vec3(position.z * sin(angle) * axisMapping.y,
+                    position.y * axisScale.y + axisTranslate.y,
+                    -position.z * cos(angle) * axisMapping.y);
+    }
+    return position * axisScale + axisTranslate;
+}
+
+bool outsideAxisRanges(highp vec3 value) {
+    return any(lessThan(value, axisMin)) || any(greaterThan(value, axisMax));
+}
+
+void main() {
+    highp vec3 translation = instancePosition.xyz;
+    if (axisMapping.x > 0.0)
+        translation = mapPosition(instancePosition.xyz);
+    // Zero size stands for the series item size
+    highp float scale = itemSize > 0.0 ? itemSize : instanceScale;
+    highp vec3 vertexPosition_wrld = rotate(instanceRotation, vertexPosition_mdl * scale)
+            + translation;
+    gl_Position = MVP * vec4(vertexPosition_wrld, 1.0);
+    // Hidden items and items outside the axis ranges are moved beyond the far plane.
+    // Hidden items have a negative gradient coordinate unless axes are mapped.
+    if (axisMapping.x > 0.0 ? outsideAxisRanges(instancePosition.xyz) : instancePosition.w < 0.0)
+        gl_Position = vec4(0.0, 0.0, 2.0, 1.0);
+}
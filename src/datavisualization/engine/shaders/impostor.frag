@@ -0,0 +1,60 @@
+#version 120
+
+varying highp vec3 center_wrld;
+varying highp vec3 rayOrigin_wrld;
+varying highp vec3 rayDirection_wrld;
+varying highp vec4 rotation_mdl;
+varying highp float gradientY;
+varying highp vec4 itemColor_frag;
+varying highp float radius;
+
+uniform highp mat4 MVP;
+uniform highp mat4 V;
+uniform highp vec3 lightPosition_wrld;
+uniform highp float lightStrength;
+uniform highp float ambientStrength;
+uniform highp vec4 lightColor;
+
+void main() {
+    // Intersect the view ray with the sphere, fragments missing it are outside the silhouette
+    highp vec3 direction = normalize(rayDirection_wrld);
+    highp vec3 offset = rayOrigin_wrld - center_wrld;
+    highp float b = dot(offset, direction);
+    // Distance from the ray to the center is computed directly to avoid cancellation
+    highp vec3 perpendicular = offset - b * direction;
+    highp float discriminant = radius * radius - dot(perpendicular, perpendicular);
+    if (discriminant < 0.0)
+        discard;
+
+    highp vec3 position_wrld = rayOrigin_wrld + direction * (-b - sqrt(discriminant));
+    highp vec4 position_clip = MVP * vec4(position_wrld, 1.0);
+    gl_FragDepth = 0.5 * (gl_DepthRange.diff * position_clip.z / position_clip.w
+                          + gl_DepthRange.near + gl_DepthRange.far);
+
+    highp vec3 normal_wrld = (position_wrld - center_wrld) / radius;
+    highp vec3 normal_cmr = vec4(V * vec4(normal_wrld, 0.0)).xyz;
+    highp vec3 eyeDirection_cmr = vec3(0.0, 0.0, 0.0) - vec4(V * vec4(position_wrld, 1.0)).xyz;
+    highp vec3 lightDirection_cmr = vec4(V * vec4(lightPosition_wrld, 1.0)).xyz
+            + eyeDirection_cmr;
+
+    highp vec3 materialDiffuseColor = itemColor_frag.rgb;
+    highp vec3 materialAmbientColor = lightColor.rgb * ambientStrength * materialDiffuseColor;
+    highp vec3 materialSpecularColor = lightColor.rgb;
+
+    highp float distance = length(lightPosition_wrld - position_wrld);
+
+    highp vec3 n = normalize(normal_cmr);
+    highp vec3 l = normalize(lightDirection_cmr);
+    highp float cosTheta = clamp(dot(n, l), 0.0, 1.0);
+
+    highp vec3 E = normalize(eyeDirection_cmr);
+    highp vec3 R = reflect(-l, n);
+    highp float cosAlpha = clamp(dot(E, R), 0.0, 1.0);
+
+    gl_FragColor.rgb =
+        materialAmbientColor +
+        materialDiffuseColor * lightStrength * pow(cosTheta, 2) / distance +
+        materialSpecularColor * lightStrength * pow(cosAlpha, 5) / distance;
+    gl_FragColor.a = itemColor_frag.a;
+    gl_FragColor = clamp(gl_FragColor, 0.0, 1.0);
+}
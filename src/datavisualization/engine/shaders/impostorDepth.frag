@@ -0,0 +1,24 @@
+#version 120
+
+uniform highp mat4 MVP;
+
+varying highp vec3 center_wrld;
+varying highp vec3 rayOrigin_wrld;
+varying highp vec3 rayDirection_wrld;
+varying highp float radius;
+
+void main() {
+    highp vec3 direction = normalize(rayDirection_wrld);
+    highp vec3 offset = rayOrigin_wrld - center_wrld;
+    highp float b = dot(offset, direction);
+    // Distance from the ray to the center is computed directly to avoid cancellation
+    highp vec3 perpendicular = offset - b * direction;
+    highp float discriminant = radius * radius - dot(perpendicular, perpendicular);
+    if (discriminant < 0.0)
+        discard;
+
+    highp vec3 position_wrld = rayOrigin_wrld + direction * (-b - sqrt(discriminant));
+    highp vec4 position_clip = MVP * vec4(position_wrld, 1.0);
+    gl_FragDepth = 0.5 * (gl_DepthRange.diff * position_clip.z / position_clip.w
+                          + gl_DepthRange.near + gl_DepthRange.far);
+}
@@ -0,0 +1,99 @@
+attribute highp vec3 vertexPosition_mdl;
+attribute highp vec4 instancePosition;
+attribute highp vec4 instanceRotation;
+attribute highp vec4 itemColor;
+attribute highp float itemSize;
+
+uniform highp mat4 MVP;
+uniform highp mat4 V;
+uniform highp float instanceScale;
+uniform highp vec4 color_mdl;
+uniform highp vec3 axisMin;
+uniform highp vec3 axisMax;
+uniform highp vec3 axisLog;
+uniform highp vec3 axisOffset;
+uniform highp vec3 axisNormalizer;
+uniform highp vec3 axisScale;
+uniform highp vec3 axisTranslate;
+uniform highp vec3 axisMapping; // Enabled, polar radius, range gradient y scale
+
+varying highp vec3 center_wrld;
+varying highp vec3 rayOrigin_wrld;
+varying highp vec3 rayDirection_wrld;
+varying highp vec4 rotation_mdl;
+varying highp float gradientY;
+varying highp vec4 itemColor_frag;
+varying highp float radius;
+
+// Instance positions are data values instead of translations when axis mapping is enabled
+highp vec3 mapPosition(highp vec3 value) {
+    highp vec3 position = (mix(value, log(max(value, vec3(1.0e-30))), axisLog) - axisOffset)
+            / axisNormalizer;
+    if (axisMapping.y > 0.0) {
+        highp float angle = position.x * 6.28318530718;
+        return vec3(position.z * sin(angle) * axisMapping.y,
+                    position.y * axisScale.y + axisTranslate.y,
+                    -position.z * cos(angle) * axisMapping.y);
+    }
+    return position * axisScale + axisTranslate;
+}
+
+bool outsideAxisRanges(highp vec3 value) {
+    return any(lessThan(value, axisMin)) || any(greaterThan(value, axisMax));
+}
+
+// Draws the sphere as a quad covering its silhouette, the sphere surface is ray traced
+// in the fragment shader.
+void main() {
+    highp vec3 translation = instancePosition.xyz;
+    gradientY = instancePosition.w;
+    if (axisMapping.x > 0.0) {
+        translation = mapPosition(instancePosition.xyz);
+        if (axisMapping.z > 0.0)
+            gradientY = ((translation.y + axisMapping.z) * 0.5) / axisMapping.z;
+    }
+
+    // Zero alpha color and zero size stand for the series values
+    itemColor_frag = itemColor.a > 0.0 ? itemColor : color_mdl;
+    radius = itemSize > 0.0 ? itemSize : instanceScale;
+
+    // Camera axes and position in world space, from the rigid view matrix
+    highp vec3 cameraRight = vec3(V[0][0], V[1][0], V[2][0]);
+    highp vec3 cameraUp = vec3(V[0][1], V[1][1], V[2][1]);
+    highp vec3 cameraBack = vec3(V[0][2], V[1][2], V[2][2]);
+    highp vec3 eye_wrld = -vec3(dot(V[0].xyz, V[3].xyz), dot(V[1].xyz, V[3].xyz),
+                                dot(V[2].xyz, V[3].xyz));
+
+    // Bottom row of an orthographic projection is (0, 0, 0, 1)
+    bool orthographic = MVP[0][3] == 0.0 && MVP[1][3] == 0.0 && MVP[2][3] == 0.0;
+    highp vec3 right = cameraRight;
+    highp vec3 up = cameraUp;
+    highp float halfSize = radius;
+    if (!orthographic) {
+        // Face the eye and cover the cone of rays touching the sphere
+        highp vec3 toEye = eye_wrld - translation;
+        highp float distance = length(toEye);
+        toEye /= distance;
+        right = normalize(cross(cameraUp, toEye));
+        up = cross(toEye, right);
+        halfSize = radius * distance / sqrt(max(distance * distance - radius * radius, 1.0e-6));
+    }
+    highp vec3 vertexPosition_wrld = translation
+            + (right * vertexPosition_mdl.x + up * vertexPosition_mdl.y) * halfSize;
+
+    if (orthographic) {
+        rayOrigin_wrld = vertexPosition_wrld;
+        rayDirection_wrld = -cameraBack;
+    } else {
+        rayOrigin_wrld = eye_wrld;
+        rayDirection_wrld = vertexPosition_wrld - eye_wrld;
+    }
+    center_wrld = translation;
+    rotation_mdl = instanceRotation;
+
+    gl_Position = MVP * vec4(vertexPosition_wrld, 1.0);
+    // Hidden items and items outside the axis ranges are moved beyond the far plane.
+    // Hidden items have a negative gradient coordinate unless axes are mapped.
+    if (axisMapping.x > 0.0 ? outsideAxisRanges(instancePosition.xyz) : instancePosition.w < 0.0)
+        gl_Position = vec4(0.0, 0.0, 2.0, 1.0);
+}
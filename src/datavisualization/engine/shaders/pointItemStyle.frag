@@ -0,0 +1,5 @@
+varying highp vec4 itemColor_frag;
+
+void main() {
+    gl_FragColor = itemColor_frag;
+}
@@ -0,0 +1,17 @@
+uniform highp mat4 MVP;
+uniform highp vec4 color_mdl;
+uniform highp float instanceScale;
+uniform highp float pointScale;
+
+attribute highp vec3 vertexPosition_mdl;
+attribute highp vec4 itemColor;
+attribute highp float itemSize;
+
+varying highp vec4 itemColor_frag;
+
+void main() {
+    // Zero alpha color and zero size stand for the series values
+    gl_PointSize = (itemSize > 0.0 ? itemSize : instanceScale) * pointScale;
+    gl_Position = MVP * vec4(vertexPosition_mdl, 1.0);
+    itemColor_frag = itemColor.a > 0.0 ? itemColor : color_mdl;
+}
@@ -0,0 +1,87 @@
+#version 120
+
+uniform highp mat4 MVP;
+uniform highp mat4 V;
+uniform highp mat4 depthMVP;
+uniform highp vec3 lightPosition_wrld;
+uniform highp float instanceScale;
+uniform highp vec4 color_mdl;
+uniform highp vec3 axisMin;
+uniform highp vec3 axisMax;
+uniform highp vec3 axisLog;
+uniform highp vec3 axisOffset;
+uniform highp vec3 axisNormalizer;
+uniform highp vec3 axisScale;
+uniform highp vec3 axisTranslate;
+uniform highp vec3 axisMapping; // Enabled, polar radius, range gradient y scale
+uniform highp float gradHeight;
+
+attribute highp vec3 vertexPosition_mdl;
+attribute highp vec3 vertexNormal_mdl;
+attribute highp vec4 instancePosition;
+attribute highp vec4 instanceRotation;
+attribute highp vec4 itemColor;
+attribute highp float itemSize;
+
+varying highp vec2 UV;
+varying highp vec3 position_wrld;
+varying highp vec3 normal_cmr;
+varying highp vec3 eyeDirection_cmr;
+varying highp vec3 lightDirection_cmr;
+varying highp vec4 shadowCoord;
+varying highp vec2 coords_mdl;
+varying highp vec4 itemColor_frag;
+
+const highp mat4 bias = mat4(0.5, 0.0, 0.0, 0.0,
+                             0.0, 0.5, 0.0, 0.0,
+                             0.0, 0.0, 0.5, 0.0,
+                             0.5, 0.5, 0.5, 1.0);
+
+highp vec3 rotate(highp vec4 q, highp vec3 v) {
+    return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v);
+}
+
+// Instance positions are data values instead of translations when axis mapping is enabled
+highp vec3 mapPosition(highp vec3 value) {
+    highp vec3 position = (mix(value, log(max(value, vec3(1.0e-30))), axisLog) - axisOffset)
+            / axisNormalizer;
+    if (axisMapping.y > 0.0) {
+        highp float angle = position.x * 6.28318530718;
+        return vec3(position.z * sin(angle) * axisMapping.y,
+                    position.y * axisScale.y + axisTranslate.y,
+                    -position.z * cos(angle) * axisMapping.y);
+    }
+    return position * axisScale + axisTranslate;
+}
+
+bool outsideAxisRanges(highp vec3 value) {
+    return any(lessThan(value, axisMin)) || any(greaterThan(value, axisMax));
+}
+
+void main() {
+    highp vec3 translation = instancePosition.xyz;
+    highp float gradientY = instancePosition.w;
+    if (axisMapping.x > 0.0) {
+        translation = mapPosition(instancePosition.xyz);
+        if (axisMapping.z > 0.0)
+            gradientY = ((translation.y + axisMapping.z) * 0.5) / axisMapping.z;
+    }
+    // Zero size stands for the series item size
+    highp float scale = itemSize > 0.0 ? itemSize : instanceScale;
+    highp vec3 vertexPosition_wrld = rotate(instanceRotation, vertexPosition_mdl * scale)
+            + translation;
+    gl_Position = MVP * vec4(vertexPosition_wrld, 1.0);
+    itemColor_frag = itemColor.a > 0.0 ? itemColor : color_mdl;
+    // Hidden items and items outside the axis ranges are moved beyond the far plane.
+    // Hidden items have a negative gradient coordinate unless axes are mapped.
+    if (axisMapping.x > 0.0 ? outsideAxisRanges(instancePosition.xyz) : instancePosition.w < 0.0)
+        gl_Position = vec4(0.0, 0.0, 2.0, 1.0);
+    coords_mdl = vertexPosition_mdl.xy;
+    shadowCoord = bias * depthMVP * vec4(vertexPosition_wrld, 1.0);
+    position_wrld = vertexPosition_wrld;
+    vec3 vertexPosition_cmr = vec4(V * vec4(vertexPosition_wrld, 1.0)).xyz;
+    eyeDirection_cmr = vec3(0.0, 0.0, 0.0) - vertexPosition_cmr;
+    lightDirection_cmr = vec4(V * vec4(lightPosition_wrld, 0.0)).xyz;
+    normal_cmr = vec4(V * vec4(rotate(instanceRotation, vertexNormal_mdl), 0.0)).xyz;
+    UV = vec2(0.0, gradientY + ((vertexPosition_mdl.y + 1.0) * gradHeight));
+}
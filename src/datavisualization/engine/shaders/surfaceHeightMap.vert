@@ -0,0 +1,49 @@
+attribute highp vec2 vertexUV;
+
+uniform highp mat4 MVP;
+uniform highp mat4 V;
+uniform highp mat4 M;
+uniform highp mat4 itM;
+uniform highp vec3 lightPosition_wrld;
+uniform sampler2D heightSampler;
+uniform highp vec4 heightMapGrid;
+uniform highp vec2 heightMapSize;
+
+varying highp vec3 lightPosition_wrld_frag;
+varying highp vec3 position_wrld;
+varying highp vec3 normal_cmr;
+varying highp vec3 eyeDirection_cmr;
+varying highp vec3 lightDirection_cmr;
+varying highp vec2 coords_mdl;
+varying highp vec2 UV;
+
+highp float heightAt(highp vec2 cell) {
+    return texture2DLod(heightSampler, (cell + 0.5) / heightMapSize, 0.0).r;
+}
+
+void main() {
+    highp vec2 cell = floor(vertexUV * (heightMapSize - 1.0) + 0.5);
+    highp vec2 spacing = heightMapGrid.zw / (heightMapSize - 1.0);
+    highp vec3 vertexPosition_mdl = vec3(heightMapGrid.x + cell.x * spacing.x,
+                                         heightAt(cell),
+                                         heightMapGrid.y + cell.y * spacing.y);
+
+    highp vec2 low = max(cell - 1.0, 0.0);
+    highp vec2 high = min(cell + 1.0, heightMapSize - 1.0);
+    highp float slopeX = (heightAt(vec2(high.x, cell.y)) - heightAt(vec2(low.x, cell.y)))
+            / ((high.x - low.x) * spacing.x);
+    highp float slopeZ = (heightAt(vec2(cell.x, high.y)) - heightAt(vec2(cell.x, low.y)))
+            / ((high.y - low.y) * spacing.y);
+    highp vec3 vertexNormal_mdl = vec3(-slopeX, 1.0, -slopeZ);
+
+    gl_Position = MVP * vec4(vertexPosition_mdl, 1.0);
+    coords_mdl = vertexPosition_mdl.xy;
+    position_wrld = vec4(M * vec4(vertexPosition_mdl, 1.0)).xyz;
+    vec3 vertexPosition_cmr = vec4(V * M * vec4(vertexPosition_mdl, 1.0)).xyz;
+    eyeDirection_cmr = vec3(0.0, 0.0, 0.0) - vertexPosition_cmr;
+    vec3 lightPosition_cmr = vec4(V * vec4(lightPosition_wrld, 1.0)).xyz;
+    lightDirection_cmr = lightPosition_cmr + eyeDirection_cmr;
+    normal_cmr = vec4(V * itM * vec4(vertexNormal_mdl, 0.0)).xyz;
+    lightPosition_wrld_frag = lightPosition_wrld;
+    UV = vertexUV;
+}
@@ -332,29 +332,13 @@ void Surface3DController::handleFlatShadingSupportedChange(bool supported)
 void Surface3DController::handleRowsChanged(int startIndex, int count)
 {
     QSurface3DSeries *series = static_cast<QSurfaceDataProxy *>(QObject::sender())->series();
-    int oldChangeCount = m_changedRows.size();
-    if (!oldChangeCount)
-        m_changedRows.reserve(count);
-
-    int selectedRow = m_selectedPoint.x();
-    for (int i = 0; i < count; i++) {
-        bool newItem = true;
-        int candidate = startIndex + i;
-        for (int j = 0; j < oldChangeCount; j++) {
-            const ChangeRow &oldChangeItem = m_changedRows.at(j);
-            if (oldChangeItem.row == candidate && series == oldChangeItem.series) {
-                newItem = false;
-                break;
-            }
-        }
-        if (newItem) {
-            ChangeRow newChangeItem = {series, candidate};
-            m_changedRows.append(newChangeItem);
-            if (series == m_selectedSeries && selectedRow == candidate)
-                series->d_ptr->markItemLabelDirty();
-        }
-    }
     if (count) {
+        m_changedRows[series].insert(startIndex, count);
+        int selectedRow = m_selectedPoint.x();
+        if (series == m_selectedSeries && selectedRow >= startIndex
+                && selectedRow < startIndex + count) {
+            series->d_ptr->markItemLabelDirty();
+        }
         m_changeTracker.rowsChanged = true;
 
         if (series->isVisible())
@@ -368,17 +352,8 @@ void Surface3DController::handleItemChanged(int rowIndex, int columnIndex)
     QSurfaceDataProxy *sender = static_cast<QSurfaceDataProxy *>(QObject::sender());
     QSurface3DSeries *series = sender->series();
 
-    bool newItem = true;
     QPoint candidate(rowIndex, columnIndex);
-    foreach (ChangeItem item, m_changedItems) {
-        if (item.point == candidate && item.series == series) {
-            newItem = false;
-            break;
-        }
-    }
-    if (newItem) {
-        ChangeItem newItem = {series, candidate};
-        m_changedItems.append(newItem);
+    if (m_changedItems[series].insert(IndexRangeSet::pointIndex(candidate))) {
         m_changeTracker.itemChanged = true;
 
         if (series == m_selectedSeries && m_selectedPoint == candidate)
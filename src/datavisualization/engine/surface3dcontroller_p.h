@@ -15,6 +15,7 @@
 #define SURFACE3DCONTROLLER_P_H
 
 #include <private/abstract3dcontroller_p.h>
+#include <private/indexrangeset_p.h>
 #include <private/datavisualizationglobal_p.h>
 
 QT_BEGIN_NAMESPACE
@@ -44,14 +45,9 @@ class Q_DATAVISUALIZATION_EXPORT Surface3DController : public Abstract3DControll
     Q_OBJECT
 
 public:
-    struct ChangeItem {
-        QSurface3DSeries *series;
-        QPoint point;
-    };
-    struct ChangeRow {
-        QSurface3DSeries *series;
-        int row;
-    };
+    // Changed items are stored as point indexes, see IndexRangeSet::pointIndex()
+    typedef QHash<QSurface3DSeries *, IndexRangeSet> ChangedItems;
+    typedef QHash<QSurface3DSeries *, IndexRangeSet> ChangedRows;
 
 private:
     Surface3DChangeBitField m_changeTracker;
@@ -60,8 +56,8 @@ private:
     QSurface3DSeries *m_selectedSeries; // Points to the series for which the point is selected in
                                         // single series selection cases.
     bool m_flatShadingSupported;
-    QList<ChangeItem> m_changedItems;
-    QList<ChangeRow> m_changedRows;
+    ChangedItems m_changedItems;
+    ChangedRows m_changedRows;
     bool m_flipHorizontalGrid;
     QList<QSurface3DSeries *> m_changedTextures;
 
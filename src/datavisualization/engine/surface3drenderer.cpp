@@ -11,7 +11,7 @@
 
 #include <QtCore/qmath.h>
 
-static const int ID_TO_RGBA_MASK = 0xff;
+#include <limits>
 
 QT_BEGIN_NAMESPACE
 
@@ -22,6 +22,8 @@ const GLfloat sliceUnits = 2.5f;
 const uint greenMultiplier = 256;
 const uint blueMultiplier = 65536;
 const uint alphaMultiplier = 16777216;
+// Only the picked surface is drawn to the selection buffer, with this ID
+const uint surfaceSelectionId = 1;
 
 Surface3DRenderer::Surface3DRenderer(Surface3DController *controller)
     : Abstract3DRenderer(controller),
@@ -36,6 +38,9 @@ Surface3DRenderer::Surface3DRenderer(Surface3DController *controller)
       m_surfaceSliceFlatShader(0),
       m_surfaceSliceSmoothShader(0),
       m_selectionShader(0),
+      m_surfaceHeightMapShader(0),
+      m_surfaceHeightMapGridShader(0),
+      m_heightMapDepthShader(0),
       m_heightNormalizer(0.0f),
       m_scaleX(0.0f),
       m_scaleY(0.0f),
@@ -46,12 +51,14 @@ Surface3DRenderer::Surface3DRenderer(Surface3DController *controller)
       m_selectionResultTexture(0),
       m_shadowQualityToShader(33.3f),
       m_flatSupported(true),
+      m_heightMapSupported(false),
       m_selectionActive(false),
       m_shadowQualityMultiplier(3),
       m_selectedPoint(Surface3DController::invalidSelectionPosition()),
       m_selectedSeries(0),
       m_clickedPosition(Surface3DController::invalidSelectionPosition()),
-      m_selectionTexturesDirty(false),
+      m_pickedSeriesCache(0),
+      m_pickedPoint(Surface3DController::invalidSelectionPosition()),
       m_noShadowTexture(0)
 {
     // Check if flat feature is supported
@@ -82,6 +89,9 @@ Surface3DRenderer::~Surface3DRenderer()
     delete m_surfaceGridShader;
     delete m_surfaceSliceFlatShader;
     delete m_surfaceSliceSmoothShader;
+    delete m_surfaceHeightMapShader;
+    delete m_surfaceHeightMapGridShader;
+    delete m_heightMapDepthShader;
 }
 
 void Surface3DRenderer::contextCleanup()
@@ -99,6 +109,9 @@ void Surface3DRenderer::contextCleanup()
 
 void Surface3DRenderer::initializeOpenGL()
 {
+    // Smooth regular grids are displaced from a height texture when the context supports it
+    m_heightMapSupported = !m_isOpenGLES && SurfaceObject::isHeightMapSupported();
+
     Abstract3DRenderer::initializeOpenGL();
 
     // Initialize shaders
@@ -191,9 +204,6 @@ void Surface3DRenderer::updateData()
 
             bool dimensionsChanged = false;
             if (cache->sampleSpace() != sampleSpace) {
-                if (sampleSpace.width() >= 2)
-                    m_selectionTexturesDirty = true;
-
                 dimensionsChanged = true;
                 cache->setSampleSpace(sampleSpace);
 
@@ -225,9 +235,6 @@ void Surface3DRenderer::updateData()
         }
     }
 
-    if (m_selectionTexturesDirty && m_cachedSelectionMode > QAbstract3DGraph::SelectionNone)
-        updateSelectionTextures();
-
     updateSelectedPoint(m_selectedPoint, m_selectedSeries);
 }
 
@@ -305,8 +312,14 @@ void Surface3DRenderer::updateSurfaceTextures(QList<QSurface3DSeries *> seriesLi
 
                 if (cache->isFlatShadingEnabled())
                     cache->surfaceObject()->coarseUVs(array, cache->dataArray());
+                else if (cache->surfaceObject()->isHeightMapped())
+                    updateObjects(cache, false); // Textured surfaces need the full vertices
                 else
                     cache->surfaceObject()->smoothUVs(array, cache->dataArray());
+            } else if (m_heightMapSupported && !cache->isFlatShadingEnabled()
+                       && cache->sampleSpace().width()) {
+                // Surface can be height mapped again
+                updateObjects(cache, false);
             }
         }
     }
@@ -314,49 +327,50 @@ void Surface3DRenderer::updateSurfaceTextures(QList<QSurface3DSeries *> seriesLi
 
 SeriesRenderCache *Surface3DRenderer::createNewCache(QAbstract3DSeries *series)
 {
-    m_selectionTexturesDirty = true;
     return new SurfaceSeriesRenderCache(series, this);
 }
 
-void Surface3DRenderer::cleanCache(SeriesRenderCache *cache)
+void Surface3DRenderer::updateRows(const Surface3DController::ChangedRows &rows)
 {
-    Abstract3DRenderer::cleanCache(cache);
-    m_selectionTexturesDirty = true;
-}
-
-void Surface3DRenderer::updateRows(const QList<Surface3DController::ChangeRow> &rows)
-{
-    foreach (Surface3DController::ChangeRow item, rows) {
+    for (auto it = rows.cbegin(); it != rows.cend(); ++it) {
+        QSurface3DSeries *series = it.key();
         SurfaceSeriesRenderCache *cache =
-                static_cast<SurfaceSeriesRenderCache *>(m_renderCacheList.value(item.series));
+                static_cast<SurfaceSeriesRenderCache *>(m_renderCacheList.value(series));
+        if (!cache)
+            continue;
+        QSurfaceDataProxy *dataProxy = series->dataProxy();
+        if (!dataProxy)
+            continue;
+
         QSurfaceDataArray &dstArray = cache->dataArray();
         const QRect &sampleSpace = cache->sampleSpace();
+        const QSurfaceDataArray *srcArray = dataProxy->array();
 
-        const QSurfaceDataArray *srcArray = 0;
-        QSurfaceDataProxy *dataProxy = item.series->dataProxy();
-        if (dataProxy)
-            srcArray = dataProxy->array();
-
-        if (cache && srcArray->size() >= 2 && srcArray->at(0)->size() >= 2 &&
+        if (srcArray->size() >= 2 && srcArray->at(0)->size() >= 2 &&
                 sampleSpace.width() >= 2 && sampleSpace.height() >= 2) {
             bool updateBuffers = false;
-            int sampleSpaceTop = sampleSpace.y() + sampleSpace.height();
-            int row = item.row;
-            if (row >= sampleSpace.y() && row <= sampleSpaceTop) {
-                updateBuffers = true;
-                for (int j = 0; j < sampleSpace.width(); j++) {
-                    (*(dstArray.at(row - sampleSpace.y())))[j] =
-                            srcArray->at(row)->at(j + sampleSpace.x());
-                }
+            const int sampleSpaceTop = sampleSpace.y() + sampleSpace.height();
+            const QList<IndexRangeSet::Range> ranges = it.value().ranges();
+            foreach (const IndexRangeSet::Range &range, ranges) {
+                const int startRow = int(qMax(qint64(sampleSpace.y()), range.start));
+                const int endRow = int(qMin(qint64(sampleSpaceTop), range.start + range.count));
+                for (int row = startRow; row < endRow; row++) {
+                    updateBuffers = true;
+                    for (int j = 0; j < sampleSpace.width(); j++) {
+                        (*(dstArray.at(row - sampleSpace.y())))[j] =
+                                srcArray->at(row)->at(j + sampleSpace.x());
+                    }
 
-                if (cache->isFlatShadingEnabled()) {
-                    cache->surfaceObject()->updateCoarseRow(dstArray, row - sampleSpace.y(),
-                                                            m_polarGraph);
-                } else {
-                    cache->surfaceObject()->updateSmoothRow(dstArray, row - sampleSpace.y(),
-                                                            m_polarGraph);
+                    if (cache->isFlatShadingEnabled()) {
+                        cache->surfaceObject()->updateCoarseRow(dstArray, row - sampleSpace.y(),
+                                                                m_polarGraph);
+                    } else {
+                        cache->surfaceObject()->updateSmoothRow(dstArray, row - sampleSpace.y(),
+                                                                m_polarGraph);
+                    }
                 }
             }
+            // Upload once per series instead of once per changed row
             if (updateBuffers)
                 cache->surfaceObject()->uploadBuffers();
         }
@@ -365,43 +379,52 @@ void Surface3DRenderer::updateRows(const QList<Surface3DController::ChangeRow> &
     updateSelectedPoint(m_selectedPoint, m_selectedSeries);
 }
 
-void Surface3DRenderer::updateItems(const QList<Surface3DController::ChangeItem> &points)
+void Surface3DRenderer::updateItems(const Surface3DController::ChangedItems &points)
 {
-    foreach (Surface3DController::ChangeItem item, points) {
+    for (auto it = points.cbegin(); it != points.cend(); ++it) {
+        QSurface3DSeries *series = it.key();
         SurfaceSeriesRenderCache *cache =
-                static_cast<SurfaceSeriesRenderCache *>(m_renderCacheList.value(item.series));
+                static_cast<SurfaceSeriesRenderCache *>(m_renderCacheList.value(series));
+        if (!cache)
+            continue;
+        QSurfaceDataProxy *dataProxy = series->dataProxy();
+        if (!dataProxy)
+            continue;
+
         QSurfaceDataArray &dstArray = cache->dataArray();
         const QRect &sampleSpace = cache->sampleSpace();
+        const QSurfaceDataArray *srcArray = dataProxy->array();
 
-        const QSurfaceDataArray *srcArray = 0;
-        QSurfaceDataProxy *dataProxy = item.series->dataProxy();
-        if (dataProxy)
-            srcArray = dataProxy->array();
-
-        if (cache && srcArray->size() >= 2 && srcArray->at(0)->size() >= 2 &&
+        if (srcArray->size() >= 2 && srcArray->at(0)->size() >= 2 &&
                 sampleSpace.width() >= 2 && sampleSpace.height() >= 2) {
-            int sampleSpaceTop = sampleSpace.y() + sampleSpace.height();
-            int sampleSpaceRight = sampleSpace.x() + sampleSpace.width();
+            const int sampleSpaceTop = sampleSpace.y() + sampleSpace.height();
+            const int sampleSpaceRight = sampleSpace.x() + sampleSpace.width();
             bool updateBuffers = false;
-            // Note: Point is (row, column), samplespace is (columns x rows)
-            QPoint point = item.point;
-
-            if (point.x() <= sampleSpaceTop && point.x() >= sampleSpace.y() &&
-                    point.y() <= sampleSpaceRight && point.y() >= sampleSpace.x()) {
-                updateBuffers = true;
-                int x = point.y() - sampleSpace.x();
-                int y = point.x() - sampleSpace.y();
-                (*(dstArray.at(y)))[x] = srcArray->at(point.x())->at(point.y());
+            const QList<IndexRangeSet::Range> ranges = it.value().ranges();
+            foreach (const IndexRangeSet::Range &range, ranges) {
+                // Note: Point is (row, column), samplespace is (columns x rows).
+                // Ranges never span multiple rows.
+                const QPoint first = IndexRangeSet::indexPoint(range.start);
+                const int row = first.x();
+                if (row < sampleSpace.y() || row >= sampleSpaceTop)
+                    continue;
+                const int startCol = qMax(sampleSpace.x(), first.y());
+                const int endCol = qMin(sampleSpaceRight, int(first.y() + range.count));
+                const int y = row - sampleSpace.y();
+                for (int col = startCol; col < endCol; col++) {
+                    updateBuffers = true;
+                    int x = col - sampleSpace.x();
+                    (*(dstArray.at(y)))[x] = srcArray->at(row)->at(col);
 
-                if (cache->isFlatShadingEnabled())
-                    cache->surfaceObject()->updateCoarseItem(dstArray, y, x, m_polarGraph);
-                else
-                    cache->surfaceObject()->updateSmoothItem(dstArray, y, x, m_polarGraph);
+                    if (cache->isFlatShadingEnabled())
+                        cache->surfaceObject()->updateCoarseItem(dstArray, y, x, m_polarGraph);
+                    else
+                        cache->surfaceObject()->updateSmoothItem(dstArray, y, x, m_polarGraph);
+                }
             }
             if (updateBuffers)
                 cache->surfaceObject()->uploadBuffers();
         }
-
     }
 
     updateSelectedPoint(m_selectedPoint, m_selectedSeries);
@@ -1117,6 +1140,16 @@ void Surface3DRenderer::drawScene(GLuint defaultFboHandle)
 
     QMatrix4x4 projectionViewMatrix = projectionMatrix * viewMatrix;
 
+    // Select the tile levels of smooth surfaces using level of detail
+    const float pixelScale = projectionMatrix(1, 1) * m_primarySubViewport.height() / 2.0f;
+    for (SeriesRenderCache *baseCache : std::as_const(m_renderCacheList)) {
+        SurfaceSeriesRenderCache *cache = static_cast<SurfaceSeriesRenderCache *>(baseCache);
+        if (cache->levelOfDetail() && !cache->isFlatShadingEnabled() && cache->renderable()) {
+            cache->surfaceObject()->updateLevelOfDetail(projectionViewMatrix, pixelScale,
+                                                        cache->levelOfDetailThreshold());
+        }
+    }
+
     // Calculate flipping indicators
     if (viewMatrix.row(0).x() > 0)
         m_zFlipped = false;
@@ -1198,6 +1231,18 @@ void Surface3DRenderer::drawScene(GLuint defaultFboHandle)
             SurfaceObject *object = cache->surfaceObject();
             if (object->indexCount() && cache->surfaceVisible() && cache->isVisible()
                     && cache->sampleSpace().width() >= 2 && cache->sampleSpace().height() >= 2) {
+                if (object->isHeightMapped()) {
+                    glDisableVertexAttribArray(m_depthShader->posAtt());
+                    m_heightMapDepthShader->bind();
+                    m_heightMapDepthShader->setUniformValue(m_heightMapDepthShader->MVP(),
+                                                            depthProjectionViewMatrix);
+                    setHeightMapUniforms(m_heightMapDepthShader, object);
+                    object->activateSurfaceTexture(false);
+                    m_drawer->drawObject(m_heightMapDepthShader, object);
+                    m_depthShader->bind();
+                    continue;
+                }
+
                 // No translation nor scaling for surfaces, therefore no modelMatrix
                 // Use directly projectionViewMatrix
                 m_depthShader->setUniformValue(m_depthShader->MVP(), depthProjectionViewMatrix);
@@ -1257,7 +1302,6 @@ void Surface3DRenderer::drawScene(GLuint defaultFboHandle)
             && m_selectionState == SelectOnScene
             && m_cachedSelectionMode > QAbstract3DGraph::SelectionNone
             && m_selectionResultTexture) {
-        m_selectionShader->bind();
         glBindFramebuffer(GL_FRAMEBUFFER, m_selectionFrameBuffer);
         glViewport(0,
                    0,
@@ -1271,16 +1315,25 @@ void Surface3DRenderer::drawScene(GLuint defaultFboHandle)
 
         glDisable(GL_CULL_FACE);
 
-        foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
-            SurfaceSeriesRenderCache *cache = static_cast<SurfaceSeriesRenderCache *>(baseCache);
-            if (cache->surfaceObject()->indexCount() && cache->renderable()) {
-                m_selectionShader->setUniformValue(m_selectionShader->MVP(), projectionViewMatrix);
-
-                cache->surfaceObject()->activateSurfaceTexture(false);
-
-                m_drawer->drawObject(m_selectionShader, cache->surfaceObject(),
-                                     cache->selectionTexture());
-            }
+        // Resolve the point under cursor on CPU and draw only the surface it is on to the
+        // selection buffer, so that it gets correctly occluded by custom items.
+        pickSurfacePoint(projectionViewMatrix);
+        if (m_pickedSeriesCache) {
+            SurfaceObject *object = m_pickedSeriesCache->surfaceObject();
+            ShaderHelper *shader = m_surfaceGridShader;
+            if (object->isHeightMapped())
+                shader = m_surfaceHeightMapGridShader;
+            shader->bind();
+            if (shader == m_surfaceHeightMapGridShader)
+                setHeightMapUniforms(shader, object);
+            shader->setUniformValue(shader->MVP(), projectionViewMatrix);
+            shader->setUniformValue(shader->color(),
+                                    QVector4D(float(surfaceSelectionId), 0.0f, 0.0f, 0.0f)
+                                    / 255.0f);
+
+            object->activateSurfaceTexture(false);
+
+            m_drawer->drawObject(shader, object);
         }
         m_surfaceGridShader->bind();
         Abstract3DRenderer::drawCustomItems(RenderingSelection, m_surfaceGridShader,
@@ -1383,8 +1436,12 @@ void Surface3DRenderer::drawScene(GLuint defaultFboHandle)
                         shader = m_surfaceSmoothShader;
                         if (cache->surfaceTexture())
                             shader = m_surfaceTexturedSmoothShader;
+                        else if (cache->surfaceObject()->isHeightMapped())
+                            shader = m_surfaceHeightMapShader;
                     }
                     shader->bind();
+                    if (shader == m_surfaceHeightMapShader)
+                        setHeightMapUniforms(shader, cache->surfaceObject());
 
                     // Set shader bindings
                     shader->setUniformValue(shader->lightP(), lightPos);
@@ -1463,7 +1520,19 @@ void Surface3DRenderer::drawScene(GLuint defaultFboHandle)
                 if (cache->surfaceObject()->indexCount() && cache->surfaceGridVisible()
                         && cache->isVisible() && sampleSpace.width() >= 2
                         && sampleSpace.height() >= 2) {
-                    m_drawer->drawSurfaceGrid(m_surfaceGridShader, cache->surfaceObject());
+                    if (cache->surfaceObject()->isHeightMapped()) {
+                        m_surfaceHeightMapGridShader->bind();
+                        m_surfaceHeightMapGridShader->setUniformValue(
+                                    m_surfaceHeightMapGridShader->MVP(), cache->MVPMatrix());
+                        setHeightMapUniforms(m_surfaceHeightMapGridShader,
+                                             cache->surfaceObject());
+                        cache->surfaceObject()->activateSurfaceTexture(false);
+                        m_drawer->drawSurfaceGrid(m_surfaceHeightMapGridShader,
+                                                  cache->surfaceObject());
+                        m_surfaceGridShader->bind();
+                    } else {
+                        m_drawer->drawSurfaceGrid(m_surfaceGridShader, cache->surfaceObject());
+                    }
                 }
             }
         }
@@ -2419,80 +2488,6 @@ void Surface3DRenderer::drawLabels(bool drawSelection, const Q3DCamera *activeCa
         glDisable(GL_BLEND);
 }
 
-void Surface3DRenderer::updateSelectionMode(QAbstract3DGraph::SelectionFlags mode)
-{
-    Abstract3DRenderer::updateSelectionMode(mode);
-
-    if (m_cachedSelectionMode > QAbstract3DGraph::SelectionNone)
-        updateSelectionTextures();
-}
-
-void Surface3DRenderer::updateSelectionTextures()
-{
-    uint lastSelectionId = 1;
-
-    foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
-        SurfaceSeriesRenderCache *cache =
-                static_cast<SurfaceSeriesRenderCache *>(baseCache);
-        GLuint texture = cache->selectionTexture();
-        m_textureHelper->deleteTexture(&texture);
-        createSelectionTexture(cache, lastSelectionId);
-    }
-    m_selectionTexturesDirty = false;
-}
-
-void Surface3DRenderer::createSelectionTexture(SurfaceSeriesRenderCache *cache,
-                                               uint &lastSelectionId)
-{
-    // Create the selection ID image. Each grid corner gets 1 pixel area of
-    // ID color so that each vertex (data point) has 2x2 pixel area of ID color,
-    // except the vertices on the edges.
-    const QRect &sampleSpace = cache->sampleSpace();
-    int idImageWidth = (sampleSpace.width() - 1) * 2;
-    int idImageHeight = (sampleSpace.height() - 1) * 2;
-
-    if (idImageHeight <= 0 || idImageWidth <= 0) {
-        cache->setSelectionIdRange(~0U, ~0U);
-        cache->setSelectionTexture(0);
-        return;
-    }
-
-    int stride = idImageWidth * 4 * sizeof(uchar); // 4 = number of color components (rgba)
-
-    uint idStart = lastSelectionId;
-    uchar *bits = new uchar[idImageWidth * idImageHeight * 4 * sizeof(uchar)];
-    for (int i = 0; i < idImageHeight; i += 2) {
-        for (int j = 0; j < idImageWidth; j += 2) {
-            int p = (i * idImageWidth + j) * 4;
-            uchar r, g, b, a;
-            idToRGBA(lastSelectionId, &r, &g, &b, &a);
-            fillIdCorner(&bits[p], r, g, b, a);
-
-            idToRGBA(lastSelectionId + 1, &r, &g, &b, &a);
-            fillIdCorner(&bits[p + 4], r, g, b, a);
-
-            idToRGBA(lastSelectionId + sampleSpace.width(), &r, &g, &b, &a);
-            fillIdCorner(&bits[p + stride], r, g, b, a);
-
-            idToRGBA(lastSelectionId + sampleSpace.width() + 1, &r, &g, &b, &a);
-            fillIdCorner(&bits[p + stride + 4], r, g, b, a);
-
-            lastSelectionId++;
-        }
-        lastSelectionId++;
-    }
-    lastSelectionId += sampleSpace.width();
-    cache->setSelectionIdRange(idStart, lastSelectionId - 1);
-
-    // Move the ID image (bits) to the texture
-    QImage image = QImage(bits, idImageWidth, idImageHeight, QImage::Format_RGB32);
-    GLuint selectionTexture = m_textureHelper->create2DTexture(image, false, false, false);
-    cache->setSelectionTexture(selectionTexture);
-
-    // Release the temp bits allocation
-    delete[] bits;
-}
-
 void Surface3DRenderer::initSelectionBuffer()
 {
     // Create the result selection texture and buffers
@@ -2503,22 +2498,6 @@ void Surface3DRenderer::initSelectionBuffer()
                                                                        m_selectionDepthBuffer);
 }
 
-void Surface3DRenderer::fillIdCorner(uchar *p, uchar r, uchar g, uchar b, uchar a)
-{
-    p[0] = r;
-    p[1] = g;
-    p[2] = b;
-    p[3] = a;
-}
-
-void Surface3DRenderer::idToRGBA(uint id, uchar *r, uchar *g, uchar *b, uchar *a)
-{
-    *r = id & ID_TO_RGBA_MASK;
-    *g = (id >> 8) & ID_TO_RGBA_MASK;
-    *b = (id >> 16) & ID_TO_RGBA_MASK;
-    *a = (id >> 24) & ID_TO_RGBA_MASK;
-}
-
 void Surface3DRenderer::calculateSceneScalingFactors()
 {
     // Margin for background (the default 0.10 makes it 10% larger to avoid
@@ -2608,6 +2587,9 @@ void Surface3DRenderer::updateObjects(SurfaceSeriesRenderCache *cache, bool dime
         if (cache->surfaceTexture())
             cache->surfaceObject()->coarseUVs(array, dataArray);
     } else {
+        cache->surfaceObject()->setLevelOfDetail(cache->levelOfDetail());
+        cache->surfaceObject()->setHeightMapAllowed(m_heightMapSupported
+                                                    && !cache->surfaceTexture());
         cache->surfaceObject()->setUpSmoothData(dataArray, sampleSpace, dimensionChanged,
                                                 m_polarGraph);
         if (cache->surfaceTexture())
@@ -2615,6 +2597,17 @@ void Surface3DRenderer::updateObjects(SurfaceSeriesRenderCache *cache, bool dime
     }
 }
 
+void Surface3DRenderer::setHeightMapUniforms(ShaderHelper *shader, SurfaceObject *object)
+{
+    // Texture units 0 to 2 are used by the drawer
+    glActiveTexture(GL_TEXTURE3);
+    glBindTexture(GL_TEXTURE_2D, object->heightMapTexture());
+    shader->setUniformValue(shader->heightMap(), 3);
+    glActiveTexture(GL_TEXTURE0);
+    shader->setUniformValue(shader->heightMapGrid(), object->heightMapGrid());
+    shader->setUniformValue(shader->heightMapSize(), object->heightMapSize());
+}
+
 void Surface3DRenderer::updateSelectedPoint(const QPoint &position, QSurface3DSeries *series)
 {
     m_selectedPoint = position;
@@ -2766,28 +2759,44 @@ QPoint Surface3DRenderer::selectionIdToSurfacePoint(uint id)
         return Surface3DController::invalidSelectionPosition();
     }
 
-    // Not a label selection
-    SurfaceSeriesRenderCache *selectedCache = 0;
-    foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
-        SurfaceSeriesRenderCache *cache = static_cast<SurfaceSeriesRenderCache *>(baseCache);
-        if (cache->isWithinIdRange(id)) {
-            selectedCache = cache;
-            break;
-        }
-    }
-    if (!selectedCache) {
+    // Not a label selection, only the point picked on CPU can be a match
+    if (id != surfaceSelectionId || !m_pickedSeriesCache) {
         m_clickedSeries = 0;
         return Surface3DController::invalidSelectionPosition();
     }
 
-    uint idInSeries = id - selectedCache->selectionIdStart() + 1;
-    const QRect &sampleSpace = selectedCache->sampleSpace();
-    int column = ((idInSeries - 1) % sampleSpace.width()) + sampleSpace.x();
-    int row = ((idInSeries - 1) / sampleSpace.width()) +  sampleSpace.y();
-
-    m_clickedSeries = selectedCache->series();
+    m_clickedSeries = m_pickedSeriesCache->series();
     m_clickedType = QAbstract3DGraph::ElementSeries;
-    return QPoint(row, column);
+    return m_pickedPoint;
+}
+
+void Surface3DRenderer::pickSurfacePoint(const QMatrix4x4 &projectionViewMatrix)
+{
+    m_pickedSeriesCache = 0;
+    m_pickedPoint = Surface3DController::invalidSelectionPosition();
+
+    QVector3D rayOrigin;
+    QVector3D rayDirection;
+    if (!inputPositionRay(projectionViewMatrix, rayOrigin, rayDirection))
+        return;
+
+    float nearestDistance = std::numeric_limits<float>::max();
+    foreach (SeriesRenderCache *baseCache, m_renderCacheList) {
+        SurfaceSeriesRenderCache *cache = static_cast<SurfaceSeriesRenderCache *>(baseCache);
+        if (!cache->surfaceObject()->indexCount() || !cache->renderable())
+            continue;
+
+        float distance;
+        QPoint point;
+        if (cache->surfaceObject()->intersectRay(rayOrigin, rayDirection, distance, point)
+                && distance < nearestDistance) {
+            // Surface object covers only the sample space of the data array
+            const QRect &sampleSpace = cache->sampleSpace();
+            nearestDistance = distance;
+            m_pickedSeriesCache = cache;
+            m_pickedPoint = QPoint(point.x() + sampleSpace.y(), point.y() + sampleSpace.x());
+        }
+    }
 }
 
 void Surface3DRenderer::updateShadowQuality(QAbstract3DGraph::ShadowQuality quality)
@@ -2873,8 +2882,20 @@ void Surface3DRenderer::initShaders(const QString &vertexShader, const QString &
     delete m_surfaceTexturedFlatShader;
     delete m_surfaceSliceFlatShader;
     delete m_surfaceSliceSmoothShader;
+    delete m_surfaceHeightMapShader;
+    m_surfaceHeightMapShader = 0;
 
     if (!m_isOpenGLES) {
+        if (m_heightMapSupported) {
+            if (m_cachedShadowQuality > QAbstract3DGraph::ShadowQualityNone) {
+                m_surfaceHeightMapShader = new ShaderHelper(this, QStringLiteral(":/shaders/vertexSurfaceHeightMapShadow"),
+                                                            QStringLiteral(":/shaders/fragmentSurfaceShadowNoTex"));
+            } else {
+                m_surfaceHeightMapShader = new ShaderHelper(this, QStringLiteral(":/shaders/vertexSurfaceHeightMap"),
+                                                            QStringLiteral(":/shaders/fragmentSurface"));
+            }
+            m_surfaceHeightMapShader->initialize();
+        }
         if (m_cachedShadowQuality > QAbstract3DGraph::ShadowQualityNone) {
             m_surfaceSmoothShader = new ShaderHelper(this, QStringLiteral(":/shaders/vertexShadow"),
                                                      QStringLiteral(":/shaders/fragmentSurfaceShadowNoTex"));
@@ -2959,6 +2980,14 @@ void Surface3DRenderer::initSurfaceShaders()
                                            QStringLiteral(":/shaders/fragmentPlainColor"));
     m_surfaceGridShader->initialize();
 
+    if (m_heightMapSupported) {
+        delete m_surfaceHeightMapGridShader;
+        m_surfaceHeightMapGridShader =
+                new ShaderHelper(this, QStringLiteral(":/shaders/vertexSurfaceHeightMap"),
+                                 QStringLiteral(":/shaders/fragmentPlainColor"));
+        m_surfaceHeightMapGridShader->initialize();
+    }
+
     // Triggers surface shader selection by shadow setting
     handleShadowQualityChange();
 }
@@ -2970,6 +2999,14 @@ void Surface3DRenderer::initDepthShader()
         m_depthShader = new ShaderHelper(this, QStringLiteral(":/shaders/vertexDepth"),
                                          QStringLiteral(":/shaders/fragmentDepth"));
         m_depthShader->initialize();
+
+        if (m_heightMapSupported) {
+            delete m_heightMapDepthShader;
+            m_heightMapDepthShader =
+                    new ShaderHelper(this, QStringLiteral(":/shaders/vertexSurfaceHeightMap"),
+                                     QStringLiteral(":/shaders/fragmentDepth"));
+            m_heightMapDepthShader->initialize();
+        }
     }
 }
 
@@ -42,6 +42,9 @@ private:
     ShaderHelper *m_surfaceSliceFlatShader;
     ShaderHelper *m_surfaceSliceSmoothShader;
     ShaderHelper *m_selectionShader;
+    ShaderHelper *m_surfaceHeightMapShader;
+    ShaderHelper *m_surfaceHeightMapGridShader;
+    ShaderHelper *m_heightMapDepthShader;
     float m_heightNormalizer;
     float m_scaleX;
     float m_scaleY;
@@ -52,13 +55,16 @@ private:
     GLuint m_selectionResultTexture;
     GLfloat m_shadowQualityToShader;
     bool m_flatSupported;
+    bool m_heightMapSupported;
     bool m_selectionActive;
     AbstractRenderItem m_dummyRenderItem;
     GLint m_shadowQualityMultiplier;
     QPoint m_selectedPoint;
     QSurface3DSeries *m_selectedSeries;
     QPoint m_clickedPosition;
-    bool m_selectionTexturesDirty;
+    // Series and data array position of the point under cursor, resolved on CPU
+    SurfaceSeriesRenderCache *m_pickedSeriesCache;
+    QPoint m_pickedPoint;
     GLuint m_noShadowTexture;
     bool m_flipHorizontalGrid;
 
@@ -70,10 +76,8 @@ public:
     void updateSeries(const QList<QAbstract3DSeries *> &seriesList) override;
     void updateSurfaceTextures(QList<QSurface3DSeries *> seriesList);
     SeriesRenderCache *createNewCache(QAbstract3DSeries *series) override;
-    void cleanCache(SeriesRenderCache *cache) override;
-    void updateSelectionMode(QAbstract3DGraph::SelectionFlags mode) override;
-    void updateRows(const QList<Surface3DController::ChangeRow> &rows);
-    void updateItems(const QList<Surface3DController::ChangeItem> &points);
+    void updateRows(const Surface3DController::ChangedRows &rows);
+    void updateItems(const Surface3DController::ChangedItems &points);
     void updateScene(Q3DScene *scene) override;
     void updateSlicingActive(bool isSlicing);
     void updateSelectedPoint(const QPoint &position, QSurface3DSeries *series);
@@ -101,6 +105,7 @@ Q_SIGNALS:
 private:
     void checkFlatSupport(SurfaceSeriesRenderCache *cache);
     void updateObjects(SurfaceSeriesRenderCache *cache, bool dimensionChanged);
+    void setHeightMapUniforms(ShaderHelper *shader, SurfaceObject *object);
     void updateSliceDataModel(const QPoint &point);
     QPoint mapCoordsToSampleSpace(SurfaceSeriesRenderCache *cache, const QPointF &coords);
     void findMatchingRow(float z, int &sample, int direction, QSurfaceDataArray &dataArray);
@@ -123,13 +128,10 @@ private:
     void initSurfaceShaders();
     void initSelectionBuffer() override;
     void initDepthShader();
-    void updateSelectionTextures();
-    void createSelectionTexture(SurfaceSeriesRenderCache *cache, uint &lastSelectionId);
-    void idToRGBA(uint id, uchar *r, uchar *g, uchar *b, uchar *a);
-    void fillIdCorner(uchar *p, uchar r, uchar g, uchar b, uchar a);
     void surfacePointSelected(const QPoint &point);
     void updateSelectionPoint(SurfaceSeriesRenderCache *cache, const QPoint &point, bool label);
     QPoint selectionIdToSurfacePoint(uint id);
+    void pickSurfacePoint(const QMatrix4x4 &projectionViewMatrix);
     void updateDepthBuffer() override;
     void emitSelectedPointChanged(QPoint position);
 
@@ -13,12 +13,11 @@ SurfaceSeriesRenderCache::SurfaceSeriesRenderCache(QAbstract3DSeries *series,
       m_surfaceVisible(false),
       m_surfaceGridVisible(false),
       m_surfaceFlatShading(false),
+      m_levelOfDetail(false),
+      m_levelOfDetailThreshold(1.0f),
       m_surfaceObj(new SurfaceObject(renderer)),
       m_sliceSurfaceObj(new SurfaceObject(renderer)),
       m_sampleSpace(QRect(0, 0, 0, 0)),
-      m_selectionTexture(0),
-      m_selectionIdStart(0),
-      m_selectionIdEnd(0),
       m_flatChangeAllowed(true),
       m_flatStatusDirty(true),
       m_sliceSelectionPointer(0),
@@ -48,12 +47,18 @@ void SurfaceSeriesRenderCache::populate(bool newSeries)
         m_surfaceFlatShading = series()->isFlatShadingEnabled();
         m_flatStatusDirty = true;
     }
+
+    // Surface objects are rebuilt the same way as when the shading changes
+    if (m_levelOfDetail != series()->isLevelOfDetail()) {
+        m_levelOfDetail = series()->isLevelOfDetail();
+        m_flatStatusDirty = true;
+    }
+    m_levelOfDetailThreshold = series()->levelOfDetailThreshold();
 }
 
 void SurfaceSeriesRenderCache::cleanup(TextureHelper *texHelper)
 {
     if (QOpenGLContext::currentContext()) {
-        texHelper->deleteTexture(&m_selectionTexture);
         texHelper->deleteTexture(&m_surfaceTexture);
     }
 
@@ -40,6 +40,8 @@ public:
     inline bool isFlatShadingEnabled() const { return m_surfaceFlatShading; }
     inline void setFlatShadingEnabled(bool enabled) { m_surfaceFlatShading = enabled; }
     inline void setFlatChangeAllowed(bool allowed) { m_flatChangeAllowed = allowed; }
+    inline bool levelOfDetail() const { return m_levelOfDetail; }
+    inline float levelOfDetailThreshold() const { return m_levelOfDetailThreshold; }
     inline SurfaceObject *surfaceObject() { return m_surfaceObj; }
     inline SurfaceObject *sliceSurfaceObject() { return m_sliceSurfaceObj; }
     inline const QRect &sampleSpace() const { return m_sampleSpace; }
@@ -49,13 +51,6 @@ public:
     inline QSurfaceDataArray &sliceDataArray() { return m_sliceDataArray; }
     inline bool renderable() const { return m_visible && (m_surfaceVisible ||
                                                           m_surfaceGridVisible); }
-    inline void setSelectionTexture(GLuint texture) { m_selectionTexture = texture; }
-    inline GLuint selectionTexture() const { return m_selectionTexture; }
-    inline void setSelectionIdRange(uint start, uint end) { m_selectionIdStart = start;
-                                                            m_selectionIdEnd = end; }
-    inline uint selectionIdStart() const { return m_selectionIdStart; }
-    inline bool isWithinIdRange(uint selection) const { return selection >= m_selectionIdStart &&
-                                                        selection <= m_selectionIdEnd; }
     inline bool isFlatStatusDirty() const { return m_flatStatusDirty; }
     inline void setFlatStatusDirty(bool status) { m_flatStatusDirty = status; }
     inline void setMVPMatrix(const QMatrix4x4 &matrix) { m_MVPMatrix = matrix; }
@@ -77,14 +72,13 @@ protected:
     bool m_surfaceVisible;
     bool m_surfaceGridVisible;
     bool m_surfaceFlatShading;
+    bool m_levelOfDetail;
+    float m_levelOfDetailThreshold;
     SurfaceObject *m_surfaceObj;
     SurfaceObject *m_sliceSurfaceObj;
     QRect m_sampleSpace;
     QSurfaceDataArray m_dataArray;
     QSurfaceDataArray m_sliceDataArray;
-    GLuint m_selectionTexture;
-    uint m_selectionIdStart;
-    uint m_selectionIdEnd;
     bool m_flatChangeAllowed;
     bool m_flatStatusDirty;
     QMatrix4x4 m_MVPMatrix;
@@ -0,0 +1,123 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include "chunkbounds_p.h"
+
+QT_BEGIN_NAMESPACE
+
+ChunkBounds::ChunkBounds()
+    : m_itemCount(0)
+{
+}
+
+void ChunkBounds::resize(int itemCount)
+{
+    if (itemCount == m_itemCount)
+        return;
+
+    m_itemCount = itemCount;
+    m_chunks.resize((itemCount + chunkSize - 1) / chunkSize);
+    invalidateAll();
+}
+
+void ChunkBounds::resize(int itemCount, int firstMovedIndex)
+{
+    m_itemCount = itemCount;
+    const int chunkCount = (itemCount + chunkSize - 1) / chunkSize;
+    m_chunks.resize(chunkCount);
+    m_dirtyChunks.removeIf([chunkCount](int chunk) { return chunk >= chunkCount; });
+    for (int i = firstMovedIndex / chunkSize; i < chunkCount; i++) {
+        Chunk &chunk = m_chunks[i];
+        if (!chunk.dirty) {
+            chunk.dirty = true;
+            m_dirtyChunks.append(i);
+        }
+    }
+}
+
+void ChunkBounds::invalidate(int index)
+{
+    // Items beyond the current size are handled when resized
+    if (index >= m_itemCount)
+        return;
+
+    Chunk &chunk = m_chunks[index / chunkSize];
+    if (!chunk.dirty) {
+        chunk.dirty = true;
+        m_dirtyChunks.append(index / chunkSize);
+    }
+}
+
+void ChunkBounds::invalidateAll()
+{
+    const int chunkCount = m_chunks.size();
+    m_dirtyChunks.resize(chunkCount);
+    for (int i = 0; i < chunkCount; i++) {
+        m_chunks[i].dirty = true;
+        m_dirtyChunks[i] = i;
+    }
+}
+
+QList<int> ChunkBounds::takeDirtyChunks()
+{
+    QList<int> dirtyChunks;
+    dirtyChunks.swap(m_dirtyChunks);
+    return dirtyChunks;
+}
+
+void ChunkBounds::setChunkBounds(int chunk, const QVector3D &minimum, const QVector3D &maximum,
+                                 int visibleCount)
+{
+    Chunk &target = m_chunks[chunk];
+    target.minimum = minimum;
+    target.maximum = maximum;
+    target.visibleCount = visibleCount;
+    target.dirty = false;
+}
+
+int ChunkBounds::cull(const Frustum &frustum, const QVector3D &margin)
+{
+    int culledCount = 0;
+    for (Chunk &chunk : m_chunks) {
+        chunk.culled = !chunk.visibleCount
+                || !frustum.intersectsBox(chunk.minimum - margin, chunk.maximum + margin);
+        if (chunk.culled)
+            culledCount += chunk.visibleCount;
+    }
+    return culledCount;
+}
+
+void ChunkBounds::resetCulling()
+{
+    for (Chunk &chunk : m_chunks)
+        chunk.culled = false;
+}
+
+bool ChunkBounds::isAllCulled() const
+{
+    for (const Chunk &chunk : m_chunks) {
+        if (!chunk.culled)
+            return false;
+    }
+    return true;
+}
+
+void ChunkBounds::visibleRanges(QList<QPair<int, int>> &ranges) const
+{
+    ranges.clear();
+    const int chunkCount = m_chunks.size();
+    int position = 0;
+    for (int i = 0; i < chunkCount; i++) {
+        const Chunk &chunk = m_chunks.at(i);
+        const int count = qMin(chunkSize, m_itemCount - i * chunkSize);
+        if (!chunk.culled && count) {
+            if (!ranges.isEmpty() && ranges.last().first + ranges.last().second == position)
+                ranges.last().second += count;
+            else
+                ranges.append(qMakePair(position, count));
+        }
+        position += count;
+    }
+}
+
+QT_END_NAMESPACE
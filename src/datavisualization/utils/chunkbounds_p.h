@@ -0,0 +1,70 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QtDataVisualization API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+
+#ifndef CHUNKBOUNDS_P_H
+#define CHUNKBOUNDS_P_H
+
+#include "datavisualizationglobal_p.h"
+#include "frustum_p.h"
+
+QT_BEGIN_NAMESPACE
+
+// Bounding boxes of fixed size runs of consecutive items, used for frustum culling.
+// The owner of the items recomputes the bounds of the chunks returned by takeDirtyChunks().
+class Q_AUTOTEST_EXPORT ChunkBounds
+{
+public:
+    static const int chunkSize = 256;
+
+    ChunkBounds();
+
+    void resize(int itemCount);
+    // Resizes after items were inserted or removed, invalidating only the chunks of the items
+    // from firstMovedIndex onwards
+    void resize(int itemCount, int firstMovedIndex);
+    void invalidate(int index);
+    void invalidateAll();
+    QList<int> takeDirtyChunks();
+    void setChunkBounds(int chunk, const QVector3D &minimum, const QVector3D &maximum,
+                        int visibleCount);
+
+    // Marks the chunks outside the frustum culled. The margin grows the bounds on each axis.
+    // Returns the number of visible items in the culled chunks.
+    int cull(const Frustum &frustum, const QVector3D &margin);
+    void resetCulling();
+    bool isAllCulled() const;
+
+    // Returns the item ranges of consecutive chunks that are not culled, as first item and count
+    void visibleRanges(QList<QPair<int, int>> &ranges) const;
+
+    inline int itemCount() const { return m_itemCount; }
+    inline bool isItemCulled(int index) const { return m_chunks.at(index / chunkSize).culled; }
+
+private:
+    struct Chunk
+    {
+        QVector3D minimum;
+        QVector3D maximum;
+        int visibleCount; // Bounds are only valid if the chunk has visible items
+        bool dirty;
+        bool culled;
+    };
+
+    QList<Chunk> m_chunks;
+    QList<int> m_dirtyChunks;
+    int m_itemCount;
+};
+
+QT_END_NAMESPACE
+
+#endif
@@ -0,0 +1,56 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include "frustum_p.h"
+
+QT_BEGIN_NAMESPACE
+
+Frustum::Frustum(const QMatrix4x4 &projectionViewMatrix)
+{
+    // Points inside the frustum are on the positive side of all planes
+    const QVector4D rowX = projectionViewMatrix.row(0);
+    const QVector4D rowY = projectionViewMatrix.row(1);
+    const QVector4D rowZ = projectionViewMatrix.row(2);
+    const QVector4D rowW = projectionViewMatrix.row(3);
+    m_planes[0] = rowW + rowX; // Left
+    m_planes[1] = rowW - rowX; // Right
+    m_planes[2] = rowW + rowY; // Bottom
+    m_planes[3] = rowW - rowY; // Top
+    m_planes[4] = rowW + rowZ; // Near
+    m_planes[5] = rowW - rowZ; // Far
+
+    // Normalize so that sphere radius can be compared to plane distance
+    for (int i = 0; i < planeCount; i++) {
+        const float length = m_planes[i].toVector3D().length();
+        if (length > 0.0f)
+            m_planes[i] /= length;
+    }
+}
+
+// Returns false only if the box is fully outside one of the planes. Boxes near the frustum
+// corners may be reported intersecting even if they are not.
+bool Frustum::intersectsBox(const QVector3D &minimum, const QVector3D &maximum) const
+{
+    for (int i = 0; i < planeCount; i++) {
+        const QVector4D &plane = m_planes[i];
+        // Corner furthest along the plane normal
+        const QVector3D corner(plane.x() >= 0.0f ? maximum.x() : minimum.x(),
+                               plane.y() >= 0.0f ? maximum.y() : minimum.y(),
+                               plane.z() >= 0.0f ? maximum.z() : minimum.z());
+        if (QVector3D::dotProduct(plane.toVector3D(), corner) + plane.w() < 0.0f)
+            return false;
+    }
+    return true;
+}
+
+bool Frustum::intersectsSphere(const QVector3D &center, float radius) const
+{
+    for (int i = 0; i < planeCount; i++) {
+        const QVector4D &plane = m_planes[i];
+        if (QVector3D::dotProduct(plane.toVector3D(), center) + plane.w() < -radius)
+            return false;
+    }
+    return true;
+}
+
+QT_END_NAMESPACE
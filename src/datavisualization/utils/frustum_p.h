@@ -0,0 +1,41 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QtDataVisualization API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+
+#ifndef FRUSTUM_P_H
+#define FRUSTUM_P_H
+
+#include "datavisualizationglobal_p.h"
+#include <QtGui/QMatrix4x4>
+#include <QtGui/QVector4D>
+
+QT_BEGIN_NAMESPACE
+
+// View frustum planes extracted from a projection view matrix. The planes are in the space the
+// matrix transforms from, so a matrix that includes a model transform gives planes in model space.
+class Q_AUTOTEST_EXPORT Frustum
+{
+public:
+    Frustum(const QMatrix4x4 &projectionViewMatrix);
+
+    bool intersectsBox(const QVector3D &minimum, const QVector3D &maximum) const;
+    bool intersectsSphere(const QVector3D &center, float radius) const;
+
+private:
+    static const int planeCount = 6;
+
+    QVector4D m_planes[planeCount];
+};
+
+QT_END_NAMESPACE
+
+#endif
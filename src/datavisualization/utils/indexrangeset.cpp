@@ -0,0 +1,229 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include "indexrangeset_p.h"
+
+#include <utility>
+
+QT_BEGIN_NAMESPACE
+
+// Range count after which the set switches to a bitmap, if the span is small enough
+static const int maxRangeCount = 1024;
+static const qint64 maxBitmapSize = qint64(1) << 24;
+
+IndexRangeSet::IndexRangeSet()
+    : m_bitmapOffset(0),
+      m_useBitmap(false)
+{
+}
+
+// Returns true if any of the indexes was not already in the set
+bool IndexRangeSet::insert(qint64 start, qint64 count)
+{
+    if (count <= 0)
+        return false;
+
+    if (m_useBitmap)
+        return insertToBitmap(start, count);
+
+    bool added = insertToRanges(start, count);
+    if (m_ranges.size() > maxRangeCount) {
+        const Range &last = m_ranges.last();
+        if (last.start + last.count - m_ranges.first().start <= maxBitmapSize)
+            convertToBitmap();
+    }
+    return added;
+}
+
+bool IndexRangeSet::contains(qint64 index) const
+{
+    if (m_useBitmap) {
+        const qint64 bit = index - m_bitmapOffset;
+        return bit >= 0 && bit < m_bitmap.size() && m_bitmap.testBit(bit);
+    }
+
+    const int position = findRange(index);
+    return position < m_ranges.size() && m_ranges.at(position).start <= index
+            && index < m_ranges.at(position).start + m_ranges.at(position).count;
+}
+
+bool IndexRangeSet::isEmpty() const
+{
+    return !m_useBitmap && m_ranges.isEmpty();
+}
+
+void IndexRangeSet::clear()
+{
+    m_ranges.clear();
+    m_bitmap.clear();
+    m_bitmapOffset = 0;
+    m_useBitmap = false;
+}
+
+QList<IndexRangeSet::Range> IndexRangeSet::ranges() const
+{
+    if (!m_useBitmap)
+        return m_ranges;
+
+    QList<Range> bitmapRanges;
+    const qint64 bitmapSize = m_bitmap.size();
+    qint64 bit = 0;
+    while (bit < bitmapSize) {
+        if (!m_bitmap.testBit(bit)) {
+            bit++;
+            continue;
+        }
+        const qint64 start = bit;
+        while (bit < bitmapSize && m_bitmap.testBit(bit))
+            bit++;
+        Range range = {start + m_bitmapOffset, bit - start};
+        bitmapRanges.append(range);
+    }
+    return bitmapRanges;
+}
+
+void IndexRangeSet::adjustForInsert(qint64 start, qint64 count)
+{
+    if (count <= 0 || isEmpty())
+        return;
+
+    // Ranges spanning the insertion point are split in two
+    const QList<Range> oldRanges = ranges();
+    clear();
+    for (const Range &range : oldRanges) {
+        if (range.start >= start) {
+            insert(range.start + count, range.count);
+        } else if (range.start + range.count <= start) {
+            insert(range.start, range.count);
+        } else {
+            insert(range.start, start - range.start);
+            insert(start + count, range.start + range.count - start);
+        }
+    }
+}
+
+void IndexRangeSet::adjustForRemove(qint64 start, qint64 count)
+{
+    if (count <= 0 || isEmpty())
+        return;
+
+    // Parts of a range before and after the removed items become adjacent.
+    // Ranges that only contain removed items become empty, and are not inserted.
+    const QList<Range> oldRanges = ranges();
+    clear();
+    for (const Range &range : oldRanges) {
+        const qint64 rangeEnd = range.start + range.count;
+        const qint64 newStart = (range.start < start) ? range.start
+                                                      : qMax(range.start - count, start);
+        const qint64 newEnd = (rangeEnd <= start) ? rangeEnd : qMax(rangeEnd - count, start);
+        insert(newStart, newEnd - newStart);
+    }
+}
+
+// Returns the position of the first range that ends at or after the index
+int IndexRangeSet::findRange(qint64 index) const
+{
+    int low = 0;
+    int high = m_ranges.size();
+    while (low < high) {
+        const int middle = (low + high) / 2;
+        const Range &range = m_ranges.at(middle);
+        if (range.start + range.count < index)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return low;
+}
+
+bool IndexRangeSet::insertToRanges(qint64 start, qint64 count)
+{
+    qint64 end = start + count;
+    const int first = findRange(start);
+    if (first < m_ranges.size()) {
+        const Range &range = m_ranges.at(first);
+        if (range.start <= start && end <= range.start + range.count)
+            return false; // Already fully included
+    }
+
+    // Merge all overlapping and adjacent ranges
+    int last = first;
+    while (last < m_ranges.size() && m_ranges.at(last).start <= end) {
+        const Range &range = m_ranges.at(last);
+        start = qMin(start, range.start);
+        end = qMax(end, range.start + range.count);
+        last++;
+    }
+
+    Range newRange = {start, end - start};
+    if (last == first) {
+        m_ranges.insert(first, newRange);
+    } else {
+        m_ranges[first] = newRange;
+        if (last - first > 1)
+            m_ranges.remove(first + 1, last - first - 1);
+    }
+    return true;
+}
+
+bool IndexRangeSet::insertToBitmap(qint64 start, qint64 count)
+{
+    const qint64 end = start + count;
+    const qint64 bitmapEnd = m_bitmapOffset + m_bitmap.size();
+    if (start < m_bitmapOffset || end > bitmapEnd) {
+        // Grow the bitmap, reserving some extra space in the growth direction
+        const qint64 oldSize = m_bitmap.size();
+        qint64 newOffset = qMin(start, m_bitmapOffset);
+        qint64 newEnd = qMax(end, bitmapEnd);
+        if (start < m_bitmapOffset)
+            newOffset = qMin(newOffset, newEnd - 2 * oldSize);
+        else
+            newEnd = qMax(newEnd, newOffset + 2 * oldSize);
+        if (newEnd - newOffset > maxBitmapSize) {
+            newOffset = qMin(start, m_bitmapOffset);
+            newEnd = qMax(end, bitmapEnd);
+        }
+
+        if (newEnd - newOffset > maxBitmapSize) {
+            // Changes are too sparse for a bitmap, revert to ranges
+            m_ranges = ranges();
+            m_bitmap.clear();
+            m_bitmapOffset = 0;
+            m_useBitmap = false;
+            return insertToRanges(start, count);
+        }
+
+        QBitArray newBitmap(newEnd - newOffset);
+        const qint64 shift = m_bitmapOffset - newOffset;
+        for (qint64 bit = 0; bit < oldSize; bit++) {
+            if (m_bitmap.testBit(bit))
+                newBitmap.setBit(bit + shift);
+        }
+        m_bitmap = newBitmap;
+        m_bitmapOffset = newOffset;
+    }
+
+    bool added = false;
+    for (qint64 bit = start - m_bitmapOffset; bit < end - m_bitmapOffset; bit++) {
+        if (!m_bitmap.testBit(bit)) {
+            m_bitmap.setBit(bit);
+            added = true;
+        }
+    }
+    return added;
+}
+
+void IndexRangeSet::convertToBitmap()
+{
+    m_bitmapOffset = m_ranges.first().start;
+    const Range &last = m_ranges.last();
+    m_bitmap = QBitArray(last.start + last.count - m_bitmapOffset);
+    for (const Range &range : std::as_const(m_ranges)) {
+        const qint64 start = range.start - m_bitmapOffset;
+        m_bitmap.fill(true, start, start + range.count);
+    }
+    m_ranges.clear();
+    m_useBitmap = true;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,73 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QtDataVisualization API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+
+#ifndef INDEXRANGESET_P_H
+#define INDEXRANGESET_P_H
+
+#include "datavisualizationglobal_p.h"
+#include <QtCore/QBitArray>
+#include <QtCore/QPoint>
+
+QT_BEGIN_NAMESPACE
+
+// Set of changed indexes, stored as sorted ranges where contiguous indexes are coalesced.
+// When changes become so fragmented that range bookkeeping gets expensive, the set switches
+// to a bitmap covering the changed span.
+// Two dimensional indexes are stored as row * 2^32 + column, so that changes on the
+// same row are still coalesced.
+class Q_AUTOTEST_EXPORT IndexRangeSet
+{
+public:
+    struct Range {
+        qint64 start;
+        qint64 count;
+    };
+
+    IndexRangeSet();
+
+    bool insert(qint64 start, qint64 count = 1);
+    bool contains(qint64 index) const;
+    bool isEmpty() const;
+    inline bool isBitmap() const { return m_useBitmap; }
+    void clear();
+    QList<Range> ranges() const;
+
+    // Move the indexes to follow items inserted or removed at start. Only meaningful for
+    // one dimensional indexes. Indexes of removed items are dropped.
+    void adjustForInsert(qint64 start, qint64 count);
+    void adjustForRemove(qint64 start, qint64 count);
+
+    static inline qint64 pointIndex(const QPoint &point)
+    {
+        return (qint64(point.x()) << 32) | quint32(point.y());
+    }
+    static inline QPoint indexPoint(qint64 index)
+    {
+        return QPoint(int(index >> 32), int(quint32(index)));
+    }
+
+private:
+    int findRange(qint64 index) const;
+    bool insertToRanges(qint64 start, qint64 count);
+    bool insertToBitmap(qint64 start, qint64 count);
+    void convertToBitmap();
+
+    QList<Range> m_ranges;
+    QBitArray m_bitmap;
+    qint64 m_bitmapOffset;
+    bool m_useBitmap;
+};
+
+QT_END_NAMESPACE
+
+#endif
@@ -5,10 +5,13 @@
 #include "vertexindexer_p.h"
 #include "objecthelper_p.h"
 
+#include <utility>
+
 QT_BEGIN_NAMESPACE
 
 ObjectHelper::ObjectHelper(const QString &objectFile)
-    : m_objectFile(objectFile)
+    : m_objectFile(objectFile),
+      m_radius(0.0f)
 {
     load();
 }
@@ -134,6 +137,10 @@ void ObjectHelper::load()
 
         m_indexCount = m_indices.size();
 
+        m_radius = 0.0f;
+        for (const QVector3D &vertex : std::as_const(m_indexedVertices))
+            m_radius = qMax(m_radius, vertex.length());
+
         glGenBuffers(1, &m_vertexbuffer);
         glBindBuffer(GL_ARRAY_BUFFER, m_vertexbuffer);
         glBufferData(GL_ARRAY_BUFFER, m_indexedVertices.size() * sizeof(QVector3D),
@@ -37,6 +37,8 @@ public:
     inline const QList<QVector3D> &indexedvertices() const { return m_indexedVertices; }
     inline const QList<QVector2D> &indexedUVs() const { return m_indexedUVs; }
     inline const QList<QVector3D> &indexedNormals() const { return m_indexedNormals; }
+    // Distance of the furthest vertex from the origin
+    inline float radius() const { return m_radius; }
 
 private:
     static ObjectHelper *getObjectHelper(const Abstract3DRenderer *cacheId,
@@ -48,6 +50,7 @@ private:
     QList<QVector3D> m_indexedVertices;
     QList<QVector2D> m_indexedUVs;
     QList<QVector3D> m_indexedNormals;
+    float m_radius;
 };
 
 QT_END_NAMESPACE
@@ -0,0 +1,164 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include "scatterdensitybufferhelper_p.h"
+#include "utils_p.h"
+#include <QtCore/QThread>
+#include <QtCore/qmath.h>
+
+#include <utility>
+
+QT_BEGIN_NAMESPACE
+
+// Items binned by each thread at a time
+const int minDensityChunkSize = 65536;
+
+ScatterDensityBufferHelper::ScatterDensityBufferHelper()
+    : m_cellSize(0.0f),
+      m_resolution(0),
+      m_cellsDirty(false)
+{
+}
+
+ScatterDensityBufferHelper::~ScatterDensityBufferHelper()
+{
+}
+
+void ScatterDensityBufferHelper::load(ScatterSeriesRenderCache *cache,
+                                      const QVector3D &sceneScale, int resolution)
+{
+    m_sceneScale = sceneScale;
+    m_resolution = resolution;
+    const QVector3D cellExtents = sceneScale * 2.0f / float(resolution);
+    m_cellSize = qMax(cellExtents.x(), qMax(cellExtents.y(), cellExtents.z()));
+
+    const ScatterRenderItemArray &renderArray = cache->renderArray();
+    const int renderArraySize = renderArray.size();
+    m_histogram.fill(QAtomicInt(0), resolution * resolution * resolution);
+    m_itemCells.resize(renderArraySize);
+
+    // All threads count into the same histogram, so its size does not depend on the number of
+    // threads. Most cells are rarely hit by two threads at once.
+    QAtomicInt *histogram = m_histogram.data();
+    int *itemCells = m_itemCells.data();
+    auto binRange = [&](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            const int cell = cellIndex(renderArray.at(i));
+            itemCells[i] = cell;
+            if (cell >= 0)
+                histogram[cell].fetchAndAddRelaxed(1);
+        }
+    };
+    const int chunkSize = qMax(minDensityChunkSize,
+                               renderArraySize / qMax(1, QThread::idealThreadCount()) + 1);
+    Utils::parallelFor(renderArraySize, chunkSize, binRange);
+
+    uploadCells();
+}
+
+void ScatterDensityBufferHelper::update(ScatterSeriesRenderCache *cache)
+{
+    const ScatterRenderItemArray &renderArray = cache->renderArray();
+    if (!m_resolution)
+        return;
+    if (m_itemCells.size() != renderArray.size()) {
+        load(cache, m_sceneScale, m_resolution);
+        return;
+    }
+
+    bool changed = m_cellsDirty;
+    for (int index : std::as_const(cache->updateIndices())) {
+        const int cell = cellIndex(renderArray.at(index));
+        const int oldCell = m_itemCells.at(index);
+        if (cell == oldCell)
+            continue;
+        if (oldCell >= 0)
+            m_histogram[oldCell].fetchAndSubRelaxed(1);
+        if (cell >= 0)
+            m_histogram[cell].fetchAndAddRelaxed(1);
+        m_itemCells[index] = cell;
+        changed = true;
+    }
+    if (changed)
+        uploadCells();
+}
+
+void ScatterDensityBufferHelper::insertItems(int start, int count)
+{
+    m_itemCells.insert(start, count, -1);
+}
+
+void ScatterDensityBufferHelper::removeItems(int start, int count)
+{
+    for (int i = start; i < start + count; i++) {
+        const int cell = m_itemCells.at(i);
+        if (cell >= 0)
+            m_histogram[cell].fetchAndSubRelaxed(1);
+    }
+    m_itemCells.remove(start, count);
+    if (count)
+        m_cellsDirty = true;
+}
+
+int ScatterDensityBufferHelper::itemCount(int x, int y, int z) const
+{
+    return m_histogram.at((z * m_resolution + y) * m_resolution + x).loadRelaxed();
+}
+
+int ScatterDensityBufferHelper::cellIndex(const ScatterRenderItem &item) const
+{
+    if (!item.isVisible())
+        return -1;
+    int cell = 0;
+    for (int axis = 2; axis >= 0; axis--) {
+        const float scale = m_sceneScale[axis];
+        const float position = scale > 0.0f
+                ? (item.translation()[axis] + scale) / (2.0f * scale) : 0.0f;
+        const int index = qBound(0, int(position * m_resolution), m_resolution - 1);
+        cell = cell * m_resolution + index;
+    }
+    return cell;
+}
+
+// Regenerates the vertex buffer from the histogram
+void ScatterDensityBufferHelper::uploadCells()
+{
+    m_cellsDirty = false;
+    m_meshDataLoaded = false;
+    m_indexCount = 0;
+
+    const int cellCount = m_histogram.size();
+    int maxCount = 0;
+    for (const QAtomicInt &count : std::as_const(m_histogram))
+        maxCount = qMax(maxCount, count.loadRelaxed());
+    if (!maxCount)
+        return;
+
+    // Logarithmic scale keeps sparse cells visible next to very dense ones
+    const float densityScale = 1.0f / qLn(1.0 + maxCount);
+    const QVector3D cellExtents = m_sceneScale * 2.0f / float(m_resolution);
+    QList<QVector4D> cells;
+    for (int i = 0; i < cellCount; i++) {
+        const int count = m_histogram.at(i).loadRelaxed();
+        if (!count)
+            continue;
+        const int x = i % m_resolution;
+        const int y = (i / m_resolution) % m_resolution;
+        const int z = i / (m_resolution * m_resolution);
+        const QVector3D center = QVector3D(x + 0.5f, y + 0.5f, z + 0.5f) * cellExtents
+                - m_sceneScale;
+        cells.append(QVector4D(center, float(qLn(1.0 + count)) * densityScale));
+    }
+
+    if (!m_vertexbuffer)
+        glGenBuffers(1, &m_vertexbuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertexbuffer);
+    glBufferData(GL_ARRAY_BUFFER, cells.size() * sizeof(QVector4D), cells.constData(),
+                 GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    m_indexCount = GLuint(cells.size());
+    m_meshDataLoaded = true;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,64 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QtDataVisualization API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+
+#ifndef SCATTERDENSITYBUFFERHELPER_P_H
+#define SCATTERDENSITYBUFFERHELPER_P_H
+
+#include "datavisualizationglobal_p.h"
+#include "abstractobjecthelper_p.h"
+#include "scatterseriesrendercache_p.h"
+#include <QtCore/QAtomicInt>
+
+QT_BEGIN_NAMESPACE
+
+// Holds the density of a scatter series binned into a grid of cells covering the scene.
+// Vertex buffer contains a point for each non-empty cell, with the cell center in xyz and
+// the normalized density in w.
+class Q_AUTOTEST_EXPORT ScatterDensityBufferHelper : public AbstractObjectHelper
+{
+public:
+    ScatterDensityBufferHelper();
+    virtual ~ScatterDensityBufferHelper();
+
+    // Bins the visible items into resolution cells along each axis of the given scene extents
+    void load(ScatterSeriesRenderCache *cache, const QVector3D &sceneScale, int resolution);
+    // Rebins the items in the update indices of the cache, and uploads the cells if they changed
+    void update(ScatterSeriesRenderCache *cache);
+    // Keep the binned items in step with the render array while items are inserted or removed.
+    // Inserted items are binned by a following update().
+    void insertItems(int start, int count);
+    void removeItems(int start, int count);
+
+    // Largest cell extent in scene units
+    float cellSize() const { return m_cellSize; }
+    int resolution() const { return m_resolution; }
+    const QVector3D &sceneScale() const { return m_sceneScale; }
+    int itemCount(int x, int y, int z) const;
+
+private:
+    int cellIndex(const ScatterRenderItem &item) const;
+    void uploadCells();
+
+    QVector3D m_sceneScale;
+    float m_cellSize;
+    int m_resolution;
+    // Item count of each cell, x varying fastest
+    QList<QAtomicInt> m_histogram;
+    // Cell of each render item, -1 for hidden items
+    QList<int> m_itemCells;
+    bool m_cellsDirty; // Histogram has changed since the cells were uploaded
+};
+
+QT_END_NAMESPACE
+
+#endif
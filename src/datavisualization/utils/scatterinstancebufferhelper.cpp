@@ -0,0 +1,354 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include "scatterinstancebufferhelper_p.h"
+#include <QtGui/QVector4D>
+#include <QtGui/QOpenGLContext>
+#include <QtCore/qmath.h>
+
+#include <utility>
+
+QT_BEGIN_NAMESPACE
+
+// Gradient coordinate that marks hidden items, when positions are not raw
+const float hiddenGradientY = -1.0f;
+
+ScatterInstanceBufferHelper::ScatterInstanceBufferHelper()
+    : m_positionbuffer(0),
+      m_rotationbuffer(0),
+      m_stylebuffer(0),
+      m_capacity(0),
+      m_scaleY(0.0f),
+      m_rawPositions(false),
+      m_subsetPositionbuffer(0),
+      m_subsetRotationbuffer(0),
+      m_subsetStylebuffer(0),
+      m_subsetCount(0),
+      m_subsetActive(false),
+      m_drawRangesActive(false)
+{
+}
+
+ScatterInstanceBufferHelper::~ScatterInstanceBufferHelper()
+{
+    if (QOpenGLContext::currentContext()) {
+        glDeleteBuffers(1, &m_positionbuffer);
+        glDeleteBuffers(1, &m_rotationbuffer);
+        glDeleteBuffers(1, &m_stylebuffer);
+        glDeleteBuffers(1, &m_subsetPositionbuffer);
+        glDeleteBuffers(1, &m_subsetRotationbuffer);
+        glDeleteBuffers(1, &m_subsetStylebuffer);
+    }
+}
+
+bool ScatterInstanceBufferHelper::isSupported()
+{
+    // Instanced drawing can be turned off for testing the fallback paths
+    if (qEnvironmentVariableIsSet("QT_DATAVIS_NO_INSTANCING"))
+        return false;
+
+    // Instanced arrays are core functionality in OpenGL 3.3 and OpenGL ES 3.0
+    QOpenGLContext *ctx = QOpenGLContext::currentContext();
+    if (!ctx)
+        return false;
+
+    const QSurfaceFormat format = ctx->format();
+    if (ctx->isOpenGLES())
+        return format.majorVersion() >= 3;
+    return format.version() >= qMakePair(3, 3);
+}
+
+GLuint ScatterInstanceBufferHelper::positionBuf()
+{
+    if (!m_meshDataLoaded)
+        qFatal("No loaded object");
+    return m_subsetActive ? m_subsetPositionbuffer : m_positionbuffer;
+}
+
+GLuint ScatterInstanceBufferHelper::rotationBuf()
+{
+    if (!m_meshDataLoaded)
+        qFatal("No loaded object");
+    return m_subsetActive ? m_subsetRotationbuffer : m_rotationbuffer;
+}
+
+// Returns zero if the items have no individual colors or sizes
+GLuint ScatterInstanceBufferHelper::styleBuf()
+{
+    if (!m_meshDataLoaded)
+        qFatal("No loaded object");
+    return m_subsetActive ? m_subsetStylebuffer : m_stylebuffer;
+}
+
+GLuint ScatterInstanceBufferHelper::instanceCount() const
+{
+    return m_subsetActive ? m_subsetCount : m_indexCount;
+}
+
+// Limits drawing to the given items. The subset is kept up to date on later loads and updates.
+void ScatterInstanceBufferHelper::setSubset(ScatterSeriesRenderCache *cache,
+                                            const QList<int> &indices)
+{
+    m_subsetIndices = indices;
+    m_subsetActive = true;
+    loadSubset(cache);
+}
+
+void ScatterInstanceBufferHelper::clearSubset()
+{
+    if (!m_subsetActive)
+        return;
+
+    glDeleteBuffers(1, &m_subsetPositionbuffer);
+    glDeleteBuffers(1, &m_subsetRotationbuffer);
+    glDeleteBuffers(1, &m_subsetStylebuffer);
+    m_subsetPositionbuffer = 0;
+    m_subsetRotationbuffer = 0;
+    m_subsetStylebuffer = 0;
+    m_subsetCount = 0;
+    m_subsetIndices.clear();
+    m_subsetActive = false;
+}
+
+void ScatterInstanceBufferHelper::setDrawRanges(const QList<QPair<int, int>> &ranges)
+{
+    m_drawRanges = ranges;
+    m_drawRangesActive = true;
+}
+
+void ScatterInstanceBufferHelper::clearDrawRanges()
+{
+    m_drawRanges.clear();
+    m_drawRangesActive = false;
+}
+
+void ScatterInstanceBufferHelper::fullLoad(ScatterSeriesRenderCache *cache)
+{
+    load(cache, cache->renderArray().size());
+}
+
+void ScatterInstanceBufferHelper::update(ScatterSeriesRenderCache *cache)
+{
+    if (!m_meshDataLoaded || cache->updateIndices().isEmpty()) {
+        fullLoad(cache);
+        return;
+    }
+
+    // Consecutive items are uploaded with a single call.
+    // Update indices are expected to be sorted and unique.
+    const QList<int> &updateIndices = cache->updateIndices();
+    const int updateSize = updateIndices.size();
+    int spanStart = 0;
+    for (int i = 1; i <= updateSize; i++) {
+        if (i == updateSize || updateIndices.at(i) != updateIndices.at(i - 1) + 1) {
+            uploadItems(cache, updateIndices.at(spanStart), i - spanStart);
+            spanStart = i;
+        }
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    if (m_subsetActive)
+        loadSubset(cache);
+}
+
+// Updates the buffers after items were inserted or removed. The items before firstMovedIndex
+// are expected to be unchanged.
+void ScatterInstanceBufferHelper::splice(ScatterSeriesRenderCache *cache, int firstMovedIndex)
+{
+    const int renderArraySize = cache->renderArray().size();
+    if (!m_meshDataLoaded || renderArraySize > m_capacity
+            || cache->hasItemStyles() != (m_stylebuffer != 0)) {
+        // Leave room for following insertions
+        load(cache, renderArraySize + renderArraySize / 2);
+        return;
+    }
+
+    m_indexCount = renderArraySize;
+    if (firstMovedIndex < renderArraySize) {
+        uploadItems(cache, firstMovedIndex, renderArraySize - firstMovedIndex);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    if (m_subsetActive)
+        loadSubset(cache);
+}
+
+void ScatterInstanceBufferHelper::load(ScatterSeriesRenderCache *cache, int capacity)
+{
+    m_indexCount = 0;
+    m_capacity = 0;
+
+    const int renderArraySize = cache->renderArray().size();
+
+    if (m_meshDataLoaded) {
+        // Delete old data
+        glDeleteBuffers(1, &m_positionbuffer);
+        glDeleteBuffers(1, &m_rotationbuffer);
+        glDeleteBuffers(1, &m_stylebuffer);
+        m_positionbuffer = 0;
+        m_rotationbuffer = 0;
+        m_stylebuffer = 0;
+        m_meshDataLoaded = false;
+    }
+
+    if (renderArraySize == 0)
+        return;  // No use to go forward
+
+    glGenBuffers(1, &m_positionbuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, m_positionbuffer);
+    glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(QVector4D), 0, GL_DYNAMIC_DRAW);
+
+    glGenBuffers(1, &m_rotationbuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, m_rotationbuffer);
+    glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(QVector4D), 0, GL_DYNAMIC_DRAW);
+
+    if (cache->hasItemStyles()) {
+        glGenBuffers(1, &m_stylebuffer);
+        glBindBuffer(GL_ARRAY_BUFFER, m_stylebuffer);
+        glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(ScatterItemStyle), 0, GL_DYNAMIC_DRAW);
+    }
+
+    // Hidden items keep their instances, so that visibility changes can be updated in place
+    uploadItems(cache, 0, renderArraySize);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    m_indexCount = renderArraySize;
+    m_capacity = capacity;
+    m_meshDataLoaded = true;
+
+    if (m_subsetActive)
+        loadSubset(cache);
+}
+
+// Uploads the attributes of the given consecutive items to their places in the buffers
+void ScatterInstanceBufferHelper::uploadItems(ScatterSeriesRenderCache *cache, int first,
+                                              int count)
+{
+    const ScatterRenderItemArray &renderArray = cache->renderArray();
+    const QQuaternion seriesRotation(cache->meshRotation());
+    const bool rangeGradient = (cache->colorStyle() == Q3DTheme::ColorStyleRangeGradient);
+
+    QList<QVector4D> buffered_positions;
+    QList<QVector4D> buffered_rotations;
+    QList<ScatterItemStyle> buffered_styles;
+    buffered_positions.resize(count);
+    buffered_rotations.resize(count);
+    if (m_stylebuffer)
+        buffered_styles.resize(count);
+
+    for (int i = 0; i < count; i++) {
+        const ScatterRenderItem &item = renderArray.at(first + i);
+        buffered_positions[i] = instancePosition(item, rangeGradient);
+        buffered_rotations[i] = (seriesRotation * item.rotation()).toVector4D();
+        if (m_stylebuffer)
+            buffered_styles[i] = ScatterSeriesRenderCache::itemStyle(item);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_positionbuffer);
+    glBufferSubData(GL_ARRAY_BUFFER, first * sizeof(QVector4D), count * sizeof(QVector4D),
+                    buffered_positions.constData());
+    glBindBuffer(GL_ARRAY_BUFFER, m_rotationbuffer);
+    glBufferSubData(GL_ARRAY_BUFFER, first * sizeof(QVector4D), count * sizeof(QVector4D),
+                    buffered_rotations.constData());
+    if (m_stylebuffer) {
+        glBindBuffer(GL_ARRAY_BUFFER, m_stylebuffer);
+        glBufferSubData(GL_ARRAY_BUFFER, first * sizeof(ScatterItemStyle),
+                        count * sizeof(ScatterItemStyle), buffered_styles.constData());
+    }
+}
+
+void ScatterInstanceBufferHelper::loadSubset(ScatterSeriesRenderCache *cache)
+{
+    const ScatterRenderItemArray &renderArray = cache->renderArray();
+    const int renderArraySize = renderArray.size();
+    const QQuaternion seriesRotation(cache->meshRotation());
+    const bool rangeGradient = (cache->colorStyle() == Q3DTheme::ColorStyleRangeGradient);
+
+    const bool itemStyles = cache->hasItemStyles();
+
+    QList<QVector4D> buffered_positions;
+    QList<QVector4D> buffered_rotations;
+    QList<ScatterItemStyle> buffered_styles;
+    buffered_positions.reserve(m_subsetIndices.size());
+    buffered_rotations.reserve(m_subsetIndices.size());
+    if (itemStyles)
+        buffered_styles.reserve(m_subsetIndices.size());
+    for (int index : std::as_const(m_subsetIndices)) {
+        // Subset may be outdated until it is next set, if items were removed
+        if (index >= renderArraySize
+                || (!renderArray.at(index).isVisible() && !m_rawPositions)) {
+            continue;
+        }
+        const ScatterRenderItem &item = renderArray.at(index);
+        buffered_positions.append(instancePosition(item, rangeGradient));
+        buffered_rotations.append((seriesRotation * item.rotation()).toVector4D());
+        if (itemStyles)
+            buffered_styles.append(ScatterSeriesRenderCache::itemStyle(item));
+    }
+
+    if (!itemStyles && m_subsetStylebuffer) {
+        glDeleteBuffers(1, &m_subsetStylebuffer);
+        m_subsetStylebuffer = 0;
+    }
+
+    m_subsetCount = buffered_positions.size();
+    if (!m_subsetCount)
+        return;
+
+    if (!m_subsetPositionbuffer) {
+        glGenBuffers(1, &m_subsetPositionbuffer);
+        glGenBuffers(1, &m_subsetRotationbuffer);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, m_subsetPositionbuffer);
+    glBufferData(GL_ARRAY_BUFFER, m_subsetCount * sizeof(QVector4D),
+                 buffered_positions.constData(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, m_subsetRotationbuffer);
+    glBufferData(GL_ARRAY_BUFFER, m_subsetCount * sizeof(QVector4D),
+                 buffered_rotations.constData(), GL_DYNAMIC_DRAW);
+    if (itemStyles) {
+        if (!m_subsetStylebuffer)
+            glGenBuffers(1, &m_subsetStylebuffer);
+        glBindBuffer(GL_ARRAY_BUFFER, m_subsetStylebuffer);
+        glBufferData(GL_ARRAY_BUFFER, m_subsetCount * sizeof(ScatterItemStyle),
+                     buffered_styles.constData(), GL_DYNAMIC_DRAW);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+QVector4D ScatterInstanceBufferHelper::instancePosition(const ScatterRenderItem &item,
+                                                       bool rangeGradient) const
+{
+    // Range gradient is calculated in the shader from the mapped position
+    if (m_rawPositions)
+        return QVector4D(item.position(), 0.0f);
+    return itemPosition(item, rangeGradient, m_scaleY);
+}
+
+// Returns the translation of the item and its range gradient texture coordinate
+QVector4D ScatterInstanceBufferHelper::itemPosition(const ScatterRenderItem &item,
+                                                   bool rangeGradient, float scaleY)
+{
+    if (!item.isVisible())
+        return QVector4D(item.translation(), hiddenGradientY);
+
+    float y = 0.0f;
+    if (rangeGradient) {
+        const float yAdjustment = 0.1f;
+        const float flippedYAdjustment = 0.9f;
+
+        y = ((item.translation().y() + scaleY) * 0.5f) / scaleY;
+
+        // Avoid values near gradient texel boundary, as this causes artifacts
+        // with some graphics cards.
+        const float floorY = float(qFloor(y * gradientTextureHeight));
+        const float diff = (y * gradientTextureHeight) - floorY;
+        if (diff < yAdjustment)
+            y += yAdjustment / gradientTextureHeight;
+        else if (diff > flippedYAdjustment)
+            y -= yAdjustment / gradientTextureHeight;
+    }
+
+    return QVector4D(item.translation(), y);
+}
+
+QT_END_NAMESPACE
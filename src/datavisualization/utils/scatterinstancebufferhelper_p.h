@@ -0,0 +1,95 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QtDataVisualization API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+
+#ifndef SCATTERINSTANCEBUFFERHELPER_P_H
+#define SCATTERINSTANCEBUFFERHELPER_P_H
+
+#include "datavisualizationglobal_p.h"
+#include "abstractobjecthelper_p.h"
+#include "scatterseriesrendercache_p.h"
+
+QT_BEGIN_NAMESPACE
+
+// Holds per-instance attributes for drawing a scatter mesh series with a single instanced
+// draw call. The mesh itself is taken from the shared ObjectHelper of the series.
+// The buffers hold all items, visible or not, at their render array indices, so that changes
+// in item visibility only need the changed items to be uploaded.
+// Instance position buffer contains the item translation in xyz and the range gradient
+// texture coordinate in w. Hidden items have a negative w, which makes the shader discard them.
+// Instance rotation buffer contains the combined series and item rotation quaternion as
+// (x, y, z, scalar). If the items have individual colors or sizes, instance style buffer
+// contains them, with zeros standing for the series values.
+// Buffers are allocated with spare capacity when items are inserted, so that following
+// insertions and removals only need the moved items to be uploaded.
+// A subset of the items can be drawn instead of all visible items, in which case the attributes
+// of the subset items are held in separate buffers.
+// With raw positions, the position buffer holds the data positions of the items and the shader
+// maps them to translations, discarding the items outside the axis ranges.
+class Q_AUTOTEST_EXPORT ScatterInstanceBufferHelper : public AbstractObjectHelper
+{
+public:
+    ScatterInstanceBufferHelper();
+    virtual ~ScatterInstanceBufferHelper();
+
+    static bool isSupported();
+    static QVector4D itemPosition(const ScatterRenderItem &item, bool rangeGradient, float scaleY);
+
+    GLuint positionBuf();
+    GLuint rotationBuf();
+    GLuint styleBuf();
+    GLuint instanceCount() const;
+
+    void setSubset(ScatterSeriesRenderCache *cache, const QList<int> &indices);
+    void clearSubset();
+    bool hasSubset() const { return m_subsetActive; }
+
+    // Limits drawing to the given ranges of instances, as first instance and count
+    void setDrawRanges(const QList<QPair<int, int>> &ranges);
+    void clearDrawRanges();
+    bool hasDrawRanges() const { return m_drawRangesActive; }
+    const QList<QPair<int, int>> &drawRanges() const { return m_drawRanges; }
+
+    void fullLoad(ScatterSeriesRenderCache *cache);
+    void update(ScatterSeriesRenderCache *cache);
+    void splice(ScatterSeriesRenderCache *cache, int firstMovedIndex);
+    void setScaleY(float scale) { m_scaleY = scale; }
+    void setRawPositions(bool enable) { m_rawPositions = enable; }
+    bool rawPositions() const { return m_rawPositions; }
+
+public:
+    GLuint m_positionbuffer;
+    GLuint m_rotationbuffer;
+    GLuint m_stylebuffer;
+
+private:
+    QVector4D instancePosition(const ScatterRenderItem &item, bool rangeGradient) const;
+    void load(ScatterSeriesRenderCache *cache, int capacity);
+    void uploadItems(ScatterSeriesRenderCache *cache, int first, int count);
+    void loadSubset(ScatterSeriesRenderCache *cache);
+
+    int m_capacity;
+    float m_scaleY;
+    bool m_rawPositions;
+    GLuint m_subsetPositionbuffer;
+    GLuint m_subsetRotationbuffer;
+    GLuint m_subsetStylebuffer;
+    GLuint m_subsetCount;
+    QList<int> m_subsetIndices;
+    bool m_subsetActive;
+    QList<QPair<int, int>> m_drawRanges;
+    bool m_drawRangesActive;
+};
+
+QT_END_NAMESPACE
+
+#endif
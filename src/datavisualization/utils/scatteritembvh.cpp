@@ -0,0 +1,232 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include "scatteritembvh_p.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+QT_BEGIN_NAMESPACE
+
+static const int maxItemsInLeaf = 8;
+
+ScatterItemBvh::ScatterItemBvh()
+    : m_dirty(true)
+{
+}
+
+void ScatterItemBvh::invalidate()
+{
+    m_dirty = true;
+    m_dirtyItems.clear();
+}
+
+void ScatterItemBvh::invalidateItem(int index)
+{
+    if (!m_dirty)
+        m_dirtyItems.append(index);
+}
+
+void ScatterItemBvh::update(const ScatterRenderItemArray &items)
+{
+    if (m_dirty || items.size() != m_itemLeaves.size())
+        build(items);
+    else if (m_dirtyItems.size())
+        refit(items);
+}
+
+void ScatterItemBvh::intersect(const ScatterRenderItemArray &items, const QVector3D &origin,
+                               const QVector3D &direction, float radius,
+                               QList<int> &candidates) const
+{
+    if (m_nodes.isEmpty())
+        return;
+
+    const float radiusSquared = radius * radius;
+    QList<int> stack;
+    stack.append(0);
+    while (!stack.isEmpty()) {
+        const Node &node = m_nodes.at(stack.takeLast());
+        if (node.minBounds.x() > node.maxBounds.x())
+            continue; // No visible items under this node
+
+        // Slab test against node bounds expanded by the radius
+        float tNear = -std::numeric_limits<float>::max();
+        float tFar = std::numeric_limits<float>::max();
+        bool hit = true;
+        for (int axis = 0; axis < 3 && hit; axis++) {
+            const float minBound = node.minBounds[axis] - radius;
+            const float maxBound = node.maxBounds[axis] + radius;
+            if (qFuzzyIsNull(direction[axis])) {
+                if (origin[axis] < minBound || origin[axis] > maxBound)
+                    hit = false;
+            } else {
+                float t1 = (minBound - origin[axis]) / direction[axis];
+                float t2 = (maxBound - origin[axis]) / direction[axis];
+                if (t1 > t2)
+                    qSwap(t1, t2);
+                tNear = qMax(tNear, t1);
+                tFar = qMin(tFar, t2);
+                if (tNear > tFar || tFar < 0.0f)
+                    hit = false;
+            }
+        }
+        if (!hit)
+            continue;
+
+        if (node.count) {
+            for (int i = node.first; i < node.first + node.count; i++) {
+                const int index = m_itemIndices.at(i);
+                const ScatterRenderItem &item = items.at(index);
+                if (!item.isVisible())
+                    continue;
+                const QVector3D toItem = item.translation() - origin;
+                const float t = QVector3D::dotProduct(toItem, direction);
+                if (t >= 0.0f && toItem.lengthSquared() - t * t <= radiusSquared)
+                    candidates.append(index);
+            }
+        } else {
+            stack.append(node.first);
+            stack.append(node.first + 1);
+        }
+    }
+}
+
+void ScatterItemBvh::build(const ScatterRenderItemArray &items)
+{
+    const int itemCount = items.size();
+
+    m_dirty = false;
+    m_dirtyItems.clear();
+    m_nodes.clear();
+    m_itemIndices.resize(itemCount);
+    m_itemLeaves.resize(itemCount);
+
+    if (!itemCount)
+        return;
+
+    for (int i = 0; i < itemCount; i++)
+        m_itemIndices[i] = i;
+
+    Node root;
+    root.first = 0;
+    root.count = itemCount;
+    root.parent = -1;
+    m_nodes.append(root);
+
+    // Split nodes at the median of their longest axis until leaves are small enough
+    QList<int> stack;
+    stack.append(0);
+    while (!stack.isEmpty()) {
+        const int nodeIndex = stack.takeLast();
+        const int first = m_nodes.at(nodeIndex).first;
+        const int count = m_nodes.at(nodeIndex).count;
+
+        if (count <= maxItemsInLeaf) {
+            for (int i = first; i < first + count; i++)
+                m_itemLeaves[m_itemIndices.at(i)] = nodeIndex;
+            continue;
+        }
+
+        QVector3D minCenter = items.at(m_itemIndices.at(first)).translation();
+        QVector3D maxCenter = minCenter;
+        for (int i = first + 1; i < first + count; i++) {
+            const QVector3D &center = items.at(m_itemIndices.at(i)).translation();
+            for (int axis = 0; axis < 3; axis++) {
+                minCenter[axis] = qMin(minCenter[axis], center[axis]);
+                maxCenter[axis] = qMax(maxCenter[axis], center[axis]);
+            }
+        }
+        const QVector3D extent = maxCenter - minCenter;
+        int axis = 0;
+        if (extent.y() > extent[axis])
+            axis = 1;
+        if (extent.z() > extent[axis])
+            axis = 2;
+
+        const int middle = first + count / 2;
+        std::nth_element(m_itemIndices.begin() + first, m_itemIndices.begin() + middle,
+                         m_itemIndices.begin() + first + count,
+                         [&items, axis](int a, int b) {
+            return items.at(a).translation()[axis] < items.at(b).translation()[axis];
+        });
+
+        const int leftChild = m_nodes.size();
+        Node left;
+        left.first = first;
+        left.count = middle - first;
+        left.parent = nodeIndex;
+        Node right;
+        right.first = middle;
+        right.count = first + count - middle;
+        right.parent = nodeIndex;
+        m_nodes.append(left);
+        m_nodes.append(right);
+
+        m_nodes[nodeIndex].first = leftChild;
+        m_nodes[nodeIndex].count = 0;
+
+        stack.append(leftChild);
+        stack.append(leftChild + 1);
+    }
+
+    // Children are always stored after their parents, so bounds can be resolved bottom-up
+    for (int i = m_nodes.size() - 1; i >= 0; i--) {
+        Node &node = m_nodes[i];
+        if (node.count)
+            calculateLeafBounds(items, node);
+        else
+            calculateInnerBounds(node);
+    }
+}
+
+void ScatterItemBvh::refit(const ScatterRenderItemArray &items)
+{
+    for (int index : std::as_const(m_dirtyItems)) {
+        int nodeIndex = m_itemLeaves.at(index);
+        calculateLeafBounds(items, m_nodes[nodeIndex]);
+
+        // Propagate changes to the root, stopping when the bounds of a parent do not change
+        nodeIndex = m_nodes.at(nodeIndex).parent;
+        while (nodeIndex >= 0) {
+            Node &node = m_nodes[nodeIndex];
+            const QVector3D oldMin = node.minBounds;
+            const QVector3D oldMax = node.maxBounds;
+            calculateInnerBounds(node);
+            if (oldMin == node.minBounds && oldMax == node.maxBounds)
+                break;
+            nodeIndex = node.parent;
+        }
+    }
+    m_dirtyItems.clear();
+}
+
+void ScatterItemBvh::calculateLeafBounds(const ScatterRenderItemArray &items, Node &node) const
+{
+    const float maxFloat = std::numeric_limits<float>::max();
+    node.minBounds = QVector3D(maxFloat, maxFloat, maxFloat);
+    node.maxBounds = QVector3D(-maxFloat, -maxFloat, -maxFloat);
+    for (int i = node.first; i < node.first + node.count; i++) {
+        const ScatterRenderItem &item = items.at(m_itemIndices.at(i));
+        if (!item.isVisible())
+            continue;
+        const QVector3D &center = item.translation();
+        for (int axis = 0; axis < 3; axis++) {
+            node.minBounds[axis] = qMin(node.minBounds[axis], center[axis]);
+            node.maxBounds[axis] = qMax(node.maxBounds[axis], center[axis]);
+        }
+    }
+}
+
+void ScatterItemBvh::calculateInnerBounds(Node &node) const
+{
+    const Node &left = m_nodes.at(node.first);
+    const Node &right = m_nodes.at(node.first + 1);
+    for (int axis = 0; axis < 3; axis++) {
+        node.minBounds[axis] = qMin(left.minBounds[axis], right.minBounds[axis]);
+        node.maxBounds[axis] = qMax(left.maxBounds[axis], right.maxBounds[axis]);
+    }
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,64 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QtDataVisualization API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+
+#ifndef SCATTERITEMBVH_P_H
+#define SCATTERITEMBVH_P_H
+
+#include "datavisualizationglobal_p.h"
+#include "scatterrenderitem_p.h"
+
+QT_BEGIN_NAMESPACE
+
+// Bounding volume hierarchy over the translations of scatter render items, used for resolving
+// picked items on CPU. Invisible items are not included in the node bounds.
+// The hierarchy is built lazily on first query after invalidate(), and changed items are
+// refitted into the existing hierarchy without rebuilding it.
+class Q_AUTOTEST_EXPORT ScatterItemBvh
+{
+public:
+    ScatterItemBvh();
+
+    void invalidate();
+    void invalidateItem(int index);
+    void update(const ScatterRenderItemArray &items);
+
+    // Collects indices of visible items in front of the origin whose translation is closer
+    // than radius to the ray
+    void intersect(const ScatterRenderItemArray &items, const QVector3D &origin,
+                   const QVector3D &direction, float radius, QList<int> &candidates) const;
+
+private:
+    struct Node
+    {
+        QVector3D minBounds;
+        QVector3D maxBounds;
+        int first; // First item for leaf nodes, first child for inner nodes
+        int count; // Item count for leaf nodes, zero for inner nodes
+        int parent;
+    };
+
+    void build(const ScatterRenderItemArray &items);
+    void refit(const ScatterRenderItemArray &items);
+    void calculateLeafBounds(const ScatterRenderItemArray &items, Node &node) const;
+    void calculateInnerBounds(Node &node) const;
+
+    QList<Node> m_nodes;
+    QList<int> m_itemIndices; // Items ordered by leaf
+    QList<int> m_itemLeaves; // Leaf node index for each item
+    QList<int> m_dirtyItems;
+    bool m_dirty;
+};
+
+QT_END_NAMESPACE
+
+#endif
@@ -0,0 +1,209 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include "scatteritemoctree_p.h"
+
+#include <algorithm>
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+static const int maxItemsInLeaf = 8;
+static const int maxDepth = 16;
+static const float sqrtOfThree = 1.7320508f;
+
+static inline int octant(const QVector3D &position, const QVector3D &center)
+{
+    return (position.x() >= center.x() ? 1 : 0)
+            | (position.y() >= center.y() ? 2 : 0)
+            | (position.z() >= center.z() ? 4 : 0);
+}
+
+ScatterItemOctree::ScatterItemOctree()
+    : m_dirty(true),
+      m_selectionValid(false),
+      m_selectionPixelScale(0.0f),
+      m_selectionThreshold(0.0f),
+      m_selectionBudget(0)
+{
+}
+
+void ScatterItemOctree::invalidate()
+{
+    m_dirty = true;
+    m_selectionValid = false;
+}
+
+void ScatterItemOctree::update(const ScatterRenderItemArray &items)
+{
+    if (m_dirty)
+        build(items);
+}
+
+bool ScatterItemOctree::selectItems(const QMatrix4x4 &projectionViewMatrix, float pixelScale,
+                                    float threshold, int budget, QList<int> &indices)
+{
+    if (m_selectionValid && m_selectionMatrix == projectionViewMatrix
+            && m_selectionPixelScale == pixelScale && m_selectionThreshold == threshold
+            && m_selectionBudget == budget) {
+        return false;
+    }
+    m_selectionValid = true;
+    m_selectionMatrix = projectionViewMatrix;
+    m_selectionPixelScale = pixelScale;
+    m_selectionThreshold = threshold;
+    m_selectionBudget = budget;
+
+    indices.clear();
+    if (m_nodes.isEmpty())
+        return true;
+
+    // Nodes at or behind the camera plane are always refined
+    auto projectedSize = [&](const Node &node) {
+        const float w = (projectionViewMatrix * QVector4D(node.center, 1.0f)).w();
+        if (w <= std::numeric_limits<float>::epsilon())
+            return std::numeric_limits<float>::max();
+        return 2.0f * sqrtOfThree * node.halfSize * pixelScale / w;
+    };
+
+    // Max heap of nodes on the current front, ordered by projected size
+    QList<QPair<float, int>> front;
+    front.append(qMakePair(projectedSize(m_nodes.at(0)), 0));
+    int itemCount = 1;
+    while (!front.isEmpty()) {
+        std::pop_heap(front.begin(), front.end());
+        const QPair<float, int> entry = front.takeLast();
+        const Node &node = m_nodes.at(entry.second);
+
+        const int refinedCount = node.childCount ? node.childCount : node.count;
+        if (entry.first <= threshold
+                || (budget > 0 && itemCount - 1 + refinedCount > budget)) {
+            indices.append(node.representative);
+            continue;
+        }
+
+        itemCount += refinedCount - 1;
+        if (node.childCount) {
+            for (int i = node.firstChild; i < node.firstChild + node.childCount; i++) {
+                front.append(qMakePair(projectedSize(m_nodes.at(i)), i));
+                std::push_heap(front.begin(), front.end());
+            }
+        } else {
+            for (int i = node.first; i < node.first + node.count; i++)
+                indices.append(m_itemIndices.at(i));
+        }
+    }
+
+    return true;
+}
+
+void ScatterItemOctree::build(const ScatterRenderItemArray &items)
+{
+    m_dirty = false;
+    m_selectionValid = false;
+    m_nodes.clear();
+    m_itemIndices.clear();
+
+    const int itemCount = items.size();
+    QVector3D minBounds;
+    QVector3D maxBounds;
+    for (int i = 0; i < itemCount; i++) {
+        const ScatterRenderItem &item = items.at(i);
+        if (!item.isVisible())
+            continue;
+        const QVector3D &position = item.translation();
+        if (m_itemIndices.isEmpty()) {
+            minBounds = position;
+            maxBounds = position;
+        } else {
+            for (int axis = 0; axis < 3; axis++) {
+                minBounds[axis] = qMin(minBounds[axis], position[axis]);
+                maxBounds[axis] = qMax(maxBounds[axis], position[axis]);
+            }
+        }
+        m_itemIndices.append(i);
+    }
+
+    if (m_itemIndices.isEmpty())
+        return;
+
+    const QVector3D extent = maxBounds - minBounds;
+    Node root;
+    root.center = (minBounds + maxBounds) / 2.0f;
+    root.halfSize = qMax(extent.x(), qMax(extent.y(), extent.z())) / 2.0f;
+    root.first = 0;
+    root.count = m_itemIndices.size();
+    root.firstChild = 0;
+    root.childCount = 0;
+    root.representative = 0;
+    m_nodes.append(root);
+
+    QList<int> octantItems(m_itemIndices.size());
+    QList<QPair<int, int>> stack; // Node index and depth
+    stack.append(qMakePair(0, 0));
+    while (!stack.isEmpty()) {
+        const QPair<int, int> entry = stack.takeLast();
+        const Node node = m_nodes.at(entry.first);
+
+        // Representative is the item closest to the average position of the node items
+        QVector3D average;
+        for (int i = node.first; i < node.first + node.count; i++)
+            average += items.at(m_itemIndices.at(i)).translation();
+        average /= float(node.count);
+        float closestDistance = std::numeric_limits<float>::max();
+        for (int i = node.first; i < node.first + node.count; i++) {
+            const float distance =
+                    (items.at(m_itemIndices.at(i)).translation() - average).lengthSquared();
+            if (distance < closestDistance) {
+                closestDistance = distance;
+                m_nodes[entry.first].representative = m_itemIndices.at(i);
+            }
+        }
+
+        if (node.count <= maxItemsInLeaf || entry.second >= maxDepth)
+            continue;
+
+        // Sort node items by octant
+        int octantCounts[8] = {};
+        for (int i = node.first; i < node.first + node.count; i++)
+            octantCounts[octant(items.at(m_itemIndices.at(i)).translation(), node.center)]++;
+        int octantStarts[8];
+        int start = node.first;
+        for (int i = 0; i < 8; i++) {
+            octantStarts[i] = start;
+            start += octantCounts[i];
+        }
+        int octantPositions[8];
+        std::copy(octantStarts, octantStarts + 8, octantPositions);
+        for (int i = node.first; i < node.first + node.count; i++) {
+            const int index = m_itemIndices.at(i);
+            octantItems[octantPositions[octant(items.at(index).translation(), node.center)]++]
+                    = index;
+        }
+        std::copy(octantItems.begin() + node.first, octantItems.begin() + node.first + node.count,
+                  m_itemIndices.begin() + node.first);
+
+        m_nodes[entry.first].firstChild = m_nodes.size();
+        const float childHalfSize = node.halfSize / 2.0f;
+        for (int i = 0; i < 8; i++) {
+            if (!octantCounts[i])
+                continue;
+            Node child;
+            child.center = node.center
+                    + QVector3D((i & 1) ? childHalfSize : -childHalfSize,
+                                (i & 2) ? childHalfSize : -childHalfSize,
+                                (i & 4) ? childHalfSize : -childHalfSize);
+            child.halfSize = childHalfSize;
+            child.first = octantStarts[i];
+            child.count = octantCounts[i];
+            child.firstChild = 0;
+            child.childCount = 0;
+            child.representative = 0;
+            m_nodes[entry.first].childCount++;
+            stack.append(qMakePair(m_nodes.size(), entry.second + 1));
+            m_nodes.append(child);
+        }
+    }
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,68 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QtDataVisualization API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+
+#ifndef SCATTERITEMOCTREE_P_H
+#define SCATTERITEMOCTREE_P_H
+
+#include "datavisualizationglobal_p.h"
+#include "scatterrenderitem_p.h"
+#include <QtGui/QMatrix4x4>
+
+QT_BEGIN_NAMESPACE
+
+// Octree over the translations of visible scatter render items, used for level of detail.
+// Each node has a representative item, which is drawn in place of all the items under
+// the node when the node is small enough on screen.
+// The octree is rebuilt lazily on first use after invalidate().
+class ScatterItemOctree
+{
+public:
+    ScatterItemOctree();
+
+    void invalidate();
+    void update(const ScatterRenderItemArray &items);
+
+    // Collects the items to draw, refining the nodes with largest projected size first until
+    // all nodes are smaller than threshold pixels or the budget would be exceeded.
+    // Budget of zero means no limit. Returns false and leaves indices untouched if the
+    // selection would be the same as on the previous call.
+    bool selectItems(const QMatrix4x4 &projectionViewMatrix, float pixelScale, float threshold,
+                     int budget, QList<int> &indices);
+
+private:
+    struct Node
+    {
+        QVector3D center;
+        float halfSize;
+        int first; // First item of the node in m_itemIndices
+        int count;
+        int firstChild; // Children are stored consecutively
+        int childCount; // Zero for leaf nodes
+        int representative;
+    };
+
+    void build(const ScatterRenderItemArray &items);
+
+    QList<Node> m_nodes;
+    QList<int> m_itemIndices; // Items ordered so that each node covers a continuous range
+    bool m_dirty;
+    bool m_selectionValid;
+    QMatrix4x4 m_selectionMatrix;
+    float m_selectionPixelScale;
+    float m_selectionThreshold;
+    int m_selectionBudget;
+};
+
+QT_END_NAMESPACE
+
+#endif
@@ -20,24 +20,35 @@
 
 QT_BEGIN_NAMESPACE
 
-class ScatterObjectBufferHelper : public AbstractObjectHelper
+// Holds the meshes of all items of a static scatter series as a single mesh, for contexts that
+// do not support instanced drawing. Vertex and normal buffers repeat the item mesh for each item.
+// Position and rotation buffers repeat the instance attributes of ScatterInstanceBufferHelper
+// for each vertex of the item, so that the instanced shaders can place and scale the vertices.
+// Item size is a shader uniform, and only the updated items need to be uploaded when the data
+// changes. Buffers are allocated with spare capacity when items are inserted, so that following
+// insertions and removals only need the instance attributes of the moved items to be uploaded.
+class Q_AUTOTEST_EXPORT ScatterObjectBufferHelper : public AbstractObjectHelper
 {
 public:
     ScatterObjectBufferHelper();
     virtual ~ScatterObjectBufferHelper();
 
-    void fullLoad(ScatterSeriesRenderCache *cache, qreal dotScale);
-    void update(ScatterSeriesRenderCache *cache, qreal dotScale);
-    void updateUVs(ScatterSeriesRenderCache *cache);
+    GLuint positionBuf();
+    GLuint rotationBuf();
+
+    void fullLoad(ScatterSeriesRenderCache *cache);
+    void update(ScatterSeriesRenderCache *cache);
+    void splice(ScatterSeriesRenderCache *cache, int firstMovedIndex);
     void setScaleY(float scale) { m_scaleY = scale; }
 
 private:
-    uint createRangeGradientUVs(ScatterSeriesRenderCache *cache, QList<QVector2D> &buffered_uvs);
-    uint createObjectGradientUVs(ScatterSeriesRenderCache *cache, QList<QVector2D> &buffered_uvs,
-                                 const QList<QVector3D> &indexed_vertices);
+    void load(ScatterSeriesRenderCache *cache, int capacity);
+    void uploadItems(ScatterSeriesRenderCache *cache, int first, int count);
 
+    GLuint m_positionbuffer;
+    GLuint m_rotationbuffer;
+    int m_capacity;
     float m_scaleY;
-    static const GLfloat itemScaler;
 };
 
 QT_END_NAMESPACE
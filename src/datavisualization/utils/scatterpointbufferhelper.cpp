@@ -7,17 +7,26 @@
 QT_BEGIN_NAMESPACE
 
 const QVector3D hiddenPos(-1000.0f, -1000.0f, -1000.0f);
+// Unchanged points between changed ones are uploaded too, if the gap is at most this large
+const int maxSpanGap = 8;
 
 ScatterPointBufferHelper::ScatterPointBufferHelper()
     : m_pointbuffer(0),
-      m_oldRemoveIndex(-1)
+      m_stylebuffer(0),
+      m_oldRemoveIndex(-1),
+      m_subsetActive(false),
+      m_drawRangesActive(false)
 {
 }
 
 ScatterPointBufferHelper::~ScatterPointBufferHelper()
 {
-    if (QOpenGLContext::currentContext())
-        glDeleteBuffers(1, &m_pointbuffer);
+    // Streamed point buffers are deleted by the streaming buffer itself
+    if (QOpenGLContext::currentContext()) {
+        if (!m_streamingPoints.isAllocated())
+            glDeleteBuffers(1, &m_pointbuffer);
+        glDeleteBuffers(1, &m_stylebuffer);
+    }
 }
 
 GLuint ScatterPointBufferHelper::pointBuf()
@@ -29,6 +38,15 @@ GLuint ScatterPointBufferHelper::pointBuf()
 
 void ScatterPointBufferHelper::pushPoint(uint pointIndex)
 {
+    if (m_streamingPoints.isAllocated()) {
+        if (m_oldRemoveIndex >= 0)
+            m_streamingPoints.invalidate(m_oldRemoveIndex);
+        m_streamingPoints.invalidate(pointIndex);
+        m_oldRemoveIndex = pointIndex;
+        uploadStreamedPoints();
+        return;
+    }
+
     glBindBuffer(GL_ARRAY_BUFFER, m_pointbuffer);
 
     // Pop the previous point if it is still pushed
@@ -48,6 +66,15 @@ void ScatterPointBufferHelper::pushPoint(uint pointIndex)
 
 void ScatterPointBufferHelper::popPoint()
 {
+    if (m_streamingPoints.isAllocated()) {
+        if (m_oldRemoveIndex >= 0) {
+            m_streamingPoints.invalidate(m_oldRemoveIndex);
+            m_oldRemoveIndex = -1;
+            uploadStreamedPoints();
+        }
+        return;
+    }
+
     if (m_oldRemoveIndex >= 0) {
         glBindBuffer(GL_ARRAY_BUFFER, m_pointbuffer);
         glBufferSubData(GL_ARRAY_BUFFER, m_oldRemoveIndex * sizeof(QVector3D),
@@ -66,16 +93,25 @@ void ScatterPointBufferHelper::load(ScatterSeriesRenderCache *cache)
 
     if (m_meshDataLoaded) {
         // Delete old data
-        glDeleteBuffers(1, &m_pointbuffer);
+        if (m_streamingPoints.isAllocated())
+            m_streamingPoints.release();
+        else
+            glDeleteBuffers(1, &m_pointbuffer);
         glDeleteBuffers(1, &m_uvbuffer);
+        glDeleteBuffers(1, &m_stylebuffer);
         m_bufferedPoints.clear();
+        m_bufferedStyles.clear();
         m_pointbuffer = 0;
         m_uvbuffer = 0;
+        m_stylebuffer = 0;
         m_meshDataLoaded = false;
     }
 
     bool itemsVisible = false;
+    const bool itemStyles = cache->hasItemStyles();
     m_bufferedPoints.resize(renderArraySize);
+    if (itemStyles)
+        m_bufferedStyles.resize(renderArraySize);
     for (int i = 0; i < renderArraySize; i++) {
         const ScatterRenderItem &item = renderArray.at(i);
         if (!item.isVisible()) {
@@ -84,6 +120,8 @@ void ScatterPointBufferHelper::load(ScatterSeriesRenderCache *cache)
             itemsVisible = true;
             m_bufferedPoints[i] = item.translation();
         }
+        if (itemStyles)
+            m_bufferedStyles[i] = ScatterSeriesRenderCache::itemStyle(item);
     }
 
     QList<QVector2D> buffered_uvs;
@@ -94,11 +132,17 @@ void ScatterPointBufferHelper::load(ScatterSeriesRenderCache *cache)
         if (cache->colorStyle() == Q3DTheme::ColorStyleRangeGradient)
             createRangeGradientUVs(cache, buffered_uvs);
 
-        glGenBuffers(1, &m_pointbuffer);
-        glBindBuffer(GL_ARRAY_BUFFER, m_pointbuffer);
-        glBufferData(GL_ARRAY_BUFFER, m_bufferedPoints.size() * sizeof(QVector3D),
-                     &m_bufferedPoints.at(0),
-                     GL_DYNAMIC_DRAW);
+        if (StreamingBuffer::isSupported()) {
+            m_streamingPoints.allocate(sizeof(QVector3D), m_bufferedPoints.size(),
+                                       &m_bufferedPoints.at(0));
+            m_pointbuffer = m_streamingPoints.buffer();
+        } else {
+            glGenBuffers(1, &m_pointbuffer);
+            glBindBuffer(GL_ARRAY_BUFFER, m_pointbuffer);
+            glBufferData(GL_ARRAY_BUFFER, m_bufferedPoints.size() * sizeof(QVector3D),
+                         &m_bufferedPoints.at(0),
+                         GL_DYNAMIC_DRAW);
+        }
 
         if (buffered_uvs.size()) {
             glGenBuffers(1, &m_uvbuffer);
@@ -107,38 +151,140 @@ void ScatterPointBufferHelper::load(ScatterSeriesRenderCache *cache)
                          &buffered_uvs.at(0), GL_STATIC_DRAW);
         }
 
+        if (itemStyles) {
+            glGenBuffers(1, &m_stylebuffer);
+            glBindBuffer(GL_ARRAY_BUFFER, m_stylebuffer);
+            glBufferData(GL_ARRAY_BUFFER, m_bufferedStyles.size() * sizeof(ScatterItemStyle),
+                         &m_bufferedStyles.at(0), GL_DYNAMIC_DRAW);
+        }
+
         glBindBuffer(GL_ARRAY_BUFFER, 0);
 
         m_meshDataLoaded = true;
     }
+
+    if (m_subsetActive) {
+        // Drop points that no longer exist until the subset is next set
+        for (int i = m_subsetIndices.size() - 1; i >= 0; i--) {
+            if (m_subsetIndices.at(i) >= GLuint(renderArraySize))
+                m_subsetIndices.removeAt(i);
+        }
+        uploadSubset();
+    }
+}
+
+void ScatterPointBufferHelper::setSubset(const QList<int> &indices)
+{
+    m_subsetIndices.resize(indices.size());
+    for (int i = 0; i < indices.size(); i++)
+        m_subsetIndices[i] = GLuint(indices.at(i));
+    m_subsetActive = true;
+    uploadSubset();
+}
+
+void ScatterPointBufferHelper::clearSubset()
+{
+    if (!m_subsetActive)
+        return;
+
+    glDeleteBuffers(1, &m_elementbuffer);
+    m_elementbuffer = 0;
+    m_subsetIndices.clear();
+    m_subsetActive = false;
+}
+
+void ScatterPointBufferHelper::setDrawRanges(const QList<QPair<int, int>> &ranges)
+{
+    m_drawRanges = ranges;
+    m_drawRangesActive = true;
 }
 
+void ScatterPointBufferHelper::clearDrawRanges()
+{
+    m_drawRanges.clear();
+    m_drawRangesActive = false;
+}
+
+void ScatterPointBufferHelper::uploadSubset()
+{
+    if (m_subsetIndices.isEmpty())
+        return;
+
+    if (!m_elementbuffer)
+        glGenBuffers(1, &m_elementbuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_elementbuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_subsetIndices.size() * sizeof(GLuint),
+                 m_subsetIndices.constData(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+// Update indices are expected to be sorted and unique
 void ScatterPointBufferHelper::update(ScatterSeriesRenderCache *cache)
 {
     // It may be that the buffer hasn't yet been initialized, in case the entire series was
     // hidden items. No need to update in that case.
     if (m_indexCount > 0) {
         const ScatterRenderItemArray &renderArray = cache->renderArray();
-        const int updateSize = cache->updateIndices().size();
+        const QList<int> &updateIndices = cache->updateIndices();
+        const int updateSize = updateIndices.size();
 
-        glBindBuffer(GL_ARRAY_BUFFER, m_pointbuffer);
         for (int i = 0; i < updateSize; i++) {
-            int index = cache->updateIndices().at(i);
+            int index = updateIndices.at(i);
             const ScatterRenderItem &item = renderArray.at(index);
             if (!item.isVisible())
                 m_bufferedPoints[index] = hiddenPos;
             else
                 m_bufferedPoints[index] = item.translation();
+            if (m_stylebuffer)
+                m_bufferedStyles[index] = ScatterSeriesRenderCache::itemStyle(item);
+        }
 
-            if (index != m_oldRemoveIndex) {
-                glBufferSubData(GL_ARRAY_BUFFER, index * sizeof(QVector3D),
-                                sizeof(QVector3D), &m_bufferedPoints.at(index));
+        // Coalesce changed points into spans. Unchanged points within the spans are uploaded
+        // from the buffered points as well, as they are identical to buffer contents.
+        if (!m_streamingPoints.isAllocated())
+            glBindBuffer(GL_ARRAY_BUFFER, m_pointbuffer);
+        bool removedPointOverwritten = false;
+        int spanStart = 0;
+        while (spanStart < updateSize) {
+            int spanEnd = spanStart + 1;
+            while (spanEnd < updateSize
+                   && updateIndices.at(spanEnd) - updateIndices.at(spanEnd - 1) <= maxSpanGap) {
+                spanEnd++;
+            }
+            const int first = updateIndices.at(spanStart);
+            const int count = updateIndices.at(spanEnd - 1) - first + 1;
+            if (m_oldRemoveIndex >= first && m_oldRemoveIndex < first + count)
+                removedPointOverwritten = true;
+            if (m_streamingPoints.isAllocated()) {
+                m_streamingPoints.invalidate(first, count);
+            } else {
+                glBufferSubData(GL_ARRAY_BUFFER, first * sizeof(QVector3D),
+                                count * sizeof(QVector3D), &m_bufferedPoints.at(first));
             }
+            if (m_stylebuffer) {
+                glBindBuffer(GL_ARRAY_BUFFER, m_stylebuffer);
+                glBufferSubData(GL_ARRAY_BUFFER, first * sizeof(ScatterItemStyle),
+                                count * sizeof(ScatterItemStyle), &m_bufferedStyles.at(first));
+                glBindBuffer(GL_ARRAY_BUFFER,
+                             m_streamingPoints.isAllocated() ? 0 : m_pointbuffer);
+            }
+            spanStart = spanEnd;
+        }
+
+        if (m_streamingPoints.isAllocated()) {
+            uploadStreamedPoints();
+        } else {
+            // Keep the removed point hidden
+            if (removedPointOverwritten) {
+                glBufferSubData(GL_ARRAY_BUFFER, m_oldRemoveIndex * sizeof(QVector3D),
+                                sizeof(QVector3D), &hiddenPos);
+            }
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
         }
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
     }
 }
 
+// Update indices are expected to be sorted and unique
 void ScatterPointBufferHelper::updateUVs(ScatterSeriesRenderCache *cache)
 {
     // It may be that the buffer hasn't yet been initialized, in case the entire series was
@@ -151,14 +297,23 @@ void ScatterPointBufferHelper::updateUVs(ScatterSeriesRenderCache *cache)
             if (!m_uvbuffer)
                 glGenBuffers(1, &m_uvbuffer);
 
-            int updateSize = cache->updateIndices().size();
+            const QList<int> &updateIndices = cache->updateIndices();
+            int updateSize = updateIndices.size();
             glBindBuffer(GL_ARRAY_BUFFER, m_uvbuffer);
             if (updateSize) {
-                for (int i = 0; i < updateSize; i++) {
-                    int index = cache->updateIndices().at(i);
-                    glBufferSubData(GL_ARRAY_BUFFER, index * sizeof(QVector2D),
-                                    sizeof(QVector2D), &buffered_uvs.at(i));
-
+                // Upload contiguous runs of changed items at once
+                int spanStart = 0;
+                while (spanStart < updateSize) {
+                    int spanEnd = spanStart + 1;
+                    while (spanEnd < updateSize
+                           && updateIndices.at(spanEnd) == updateIndices.at(spanEnd - 1) + 1) {
+                        spanEnd++;
+                    }
+                    glBufferSubData(GL_ARRAY_BUFFER,
+                                    updateIndices.at(spanStart) * sizeof(QVector2D),
+                                    (spanEnd - spanStart) * sizeof(QVector2D),
+                                    &buffered_uvs.at(spanStart));
+                    spanStart = spanEnd;
                 }
             } else {
                 glBufferData(GL_ARRAY_BUFFER, buffered_uvs.size() * sizeof(QVector2D),
@@ -170,6 +325,22 @@ void ScatterPointBufferHelper::updateUVs(ScatterSeriesRenderCache *cache)
     }
 }
 
+void ScatterPointBufferHelper::uploadStreamedPoints()
+{
+    // Removed point is only hidden in the buffer, buffered points keep the real position
+    QVector3D removedPoint;
+    if (m_oldRemoveIndex >= 0) {
+        removedPoint = m_bufferedPoints.at(m_oldRemoveIndex);
+        m_bufferedPoints[m_oldRemoveIndex] = hiddenPos;
+    }
+
+    m_streamingPoints.upload(m_bufferedPoints.constData());
+    m_pointbuffer = m_streamingPoints.buffer();
+
+    if (m_oldRemoveIndex >= 0)
+        m_bufferedPoints[m_oldRemoveIndex] = removedPoint;
+}
+
 void ScatterPointBufferHelper::createRangeGradientUVs(ScatterSeriesRenderCache *cache,
                                                       QList<QVector2D> &buffered_uvs)
 {
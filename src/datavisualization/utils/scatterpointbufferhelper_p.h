@@ -17,16 +17,18 @@
 #include "datavisualizationglobal_p.h"
 #include "abstractobjecthelper_p.h"
 #include "scatterseriesrendercache_p.h"
+#include "streamingbuffer_p.h"
 
 QT_BEGIN_NAMESPACE
 
-class ScatterPointBufferHelper : public AbstractObjectHelper
+class Q_AUTOTEST_EXPORT ScatterPointBufferHelper : public AbstractObjectHelper
 {
 public:
     ScatterPointBufferHelper();
     virtual ~ScatterPointBufferHelper();
 
     GLuint pointBuf();
+    GLuint styleBuf() const { return m_stylebuffer; }
 
     void pushPoint(uint pointIndex);
     void popPoint();
@@ -35,15 +37,37 @@ public:
     void setScaleY(float scale) { m_scaleY = scale; }
     void updateUVs(ScatterSeriesRenderCache *cache);
 
+    // Limits drawing to the given points, using the element buffer
+    void setSubset(const QList<int> &indices);
+    void clearSubset();
+    bool hasSubset() const { return m_subsetActive; }
+    GLuint subsetCount() const { return GLuint(m_subsetIndices.size()); }
+    const StreamingBuffer &streamingPoints() const { return m_streamingPoints; }
+
+    // Limits drawing to the given ranges of points, as first point and count
+    void setDrawRanges(const QList<QPair<int, int>> &ranges);
+    void clearDrawRanges();
+    bool hasDrawRanges() const { return m_drawRangesActive; }
+    const QList<QPair<int, int>> &drawRanges() const { return m_drawRanges; }
+
 public:
     GLuint m_pointbuffer;
+    GLuint m_stylebuffer; // Item colors and sizes, only if the items have them
 
 private:
     void createRangeGradientUVs(ScatterSeriesRenderCache *cache, QList<QVector2D> &buffered_uvs);
+    void uploadStreamedPoints();
+    void uploadSubset();
 
 private:
     QList<QVector3D> m_bufferedPoints;
+    QList<ScatterItemStyle> m_bufferedStyles;
+    StreamingBuffer m_streamingPoints; // Used instead of a single point buffer when supported
     int m_oldRemoveIndex;
+    QList<GLuint> m_subsetIndices;
+    bool m_subsetActive;
+    QList<QPair<int, int>> m_drawRanges;
+    bool m_drawRangesActive;
     float m_scaleY;
 };
 
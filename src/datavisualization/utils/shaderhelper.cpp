@@ -29,6 +29,10 @@ ShaderHelper::ShaderHelper(QObject *parent,
       m_positionAttr(0),
       m_uvAttr(0),
       m_normalAttr(0),
+      m_instancePositionAttr(0),
+      m_instanceRotationAttr(0),
+      m_itemColorAttr(0),
+      m_itemSizeAttr(0),
       m_colorUniform(0),
       m_viewMatrixUniform(0),
       m_modelMatrixUniform(0),
@@ -55,6 +59,19 @@ ShaderHelper::ShaderHelper(QObject *parent,
       m_minBoundsUniform(0),
       m_maxBoundsUniform(0),
       m_sliceFrameWidthUniform(0),
+      m_instanceScaleUniform(0),
+      m_pointScaleUniform(0),
+      m_axisMinUniform(0),
+      m_axisMaxUniform(0),
+      m_axisLogUniform(0),
+      m_axisOffsetUniform(0),
+      m_axisNormalizerUniform(0),
+      m_axisScaleUniform(0),
+      m_axisTranslateUniform(0),
+      m_axisMappingUniform(0),
+      m_heightMapUniform(0),
+      m_heightMapGridUniform(0),
+      m_heightMapSizeUniform(0),
       m_initialized(false)
 {
 }
@@ -97,6 +114,10 @@ void ShaderHelper::initialize()
     m_positionAttr = m_program->attributeLocation("vertexPosition_mdl");
     m_normalAttr = m_program->attributeLocation("vertexNormal_mdl");
     m_uvAttr = m_program->attributeLocation("vertexUV");
+    m_instancePositionAttr = m_program->attributeLocation("instancePosition");
+    m_instanceRotationAttr = m_program->attributeLocation("instanceRotation");
+    m_itemColorAttr = m_program->attributeLocation("itemColor");
+    m_itemSizeAttr = m_program->attributeLocation("itemSize");
 
     m_mvpMatrixUniform = m_program->uniformLocation("MVP");
     m_viewMatrixUniform = m_program->uniformLocation("V");
@@ -124,6 +145,19 @@ void ShaderHelper::initialize()
     m_minBoundsUniform = m_program->uniformLocation("minBounds");
     m_maxBoundsUniform = m_program->uniformLocation("maxBounds");
     m_sliceFrameWidthUniform = m_program->uniformLocation("sliceFrameWidth");
+    m_instanceScaleUniform = m_program->uniformLocation("instanceScale");
+    m_pointScaleUniform = m_program->uniformLocation("pointScale");
+    m_axisMinUniform = m_program->uniformLocation("axisMin");
+    m_axisMaxUniform = m_program->uniformLocation("axisMax");
+    m_axisLogUniform = m_program->uniformLocation("axisLog");
+    m_axisOffsetUniform = m_program->uniformLocation("axisOffset");
+    m_axisNormalizerUniform = m_program->uniformLocation("axisNormalizer");
+    m_axisScaleUniform = m_program->uniformLocation("axisScale");
+    m_axisTranslateUniform = m_program->uniformLocation("axisTranslate");
+    m_axisMappingUniform = m_program->uniformLocation("axisMapping");
+    m_heightMapUniform = m_program->uniformLocation("heightSampler");
+    m_heightMapGridUniform = m_program->uniformLocation("heightMapGrid");
+    m_heightMapSizeUniform = m_program->uniformLocation("heightMapSize");
     m_initialized = true;
 }
 
@@ -374,6 +408,97 @@ GLint ShaderHelper::sliceFrameWidth()
     return m_sliceFrameWidthUniform;
 }
 
+GLint ShaderHelper::instanceScale()
+{
+    if (!m_initialized)
+        qFatal("Shader not initialized");
+    return m_instanceScaleUniform;
+}
+
+GLint ShaderHelper::pointScale()
+{
+    if (!m_initialized)
+        qFatal("Shader not initialized");
+    return m_pointScaleUniform;
+}
+
+GLint ShaderHelper::axisMin()
+{
+    if (!m_initialized)
+        qFatal("Shader not initialized");
+    return m_axisMinUniform;
+}
+
+GLint ShaderHelper::axisMax()
+{
+    if (!m_initialized)
+        qFatal("Shader not initialized");
+    return m_axisMaxUniform;
+}
+
+GLint ShaderHelper::axisLog()
+{
+    if (!m_initialized)
+        qFatal("Shader not initialized");
+    return m_axisLogUniform;
+}
+
+GLint ShaderHelper::axisOffset()
+{
+    if (!m_initialized)
+        qFatal("Shader not initialized");
+    return m_axisOffsetUniform;
+}
+
+GLint ShaderHelper::axisNormalizer()
+{
+    if (!m_initialized)
+        qFatal("Shader not initialized");
+    return m_axisNormalizerUniform;
+}
+
+GLint ShaderHelper::axisScale()
+{
+    if (!m_initialized)
+        qFatal("Shader not initialized");
+    return m_axisScaleUniform;
+}
+
+GLint ShaderHelper::axisTranslate()
+{
+    if (!m_initialized)
+        qFatal("Shader not initialized");
+    return m_axisTranslateUniform;
+}
+
+GLint ShaderHelper::axisMapping()
+{
+    if (!m_initialized)
+        qFatal("Shader not initialized");
+    return m_axisMappingUniform;
+}
+
+GLint ShaderHelper::heightMap()
+{
+    if (!m_initialized)
+        qFatal("Shader not initialized");
+    return m_heightMapUniform;
+}
+
+GLint ShaderHelper::heightMapGrid()
+{
+    if (!m_initialized)
+        qFatal("Shader not initialized");
+    return m_heightMapGridUniform;
+}
+
+GLint ShaderHelper::heightMapSize()
+{
+    if (!m_initialized)
+        qFatal("Shader not initialized");
+    return m_heightMapSizeUniform;
+}
+
 GLint ShaderHelper::posAtt()
 {
     if (!m_initialized)
@@ -395,4 +520,32 @@ GLint ShaderHelper::normalAtt()
     return m_normalAttr;
 }
 
+GLint ShaderHelper::instancePosAtt()
+{
+    if (!m_initialized)
+        qFatal("Shader not initialized");
+    return m_instancePositionAttr;
+}
+
+GLint ShaderHelper::instanceRotAtt()
+{
+    if (!m_initialized)
+        qFatal("Shader not initialized");
+    return m_instanceRotationAttr;
+}
+
+GLint ShaderHelper::itemColorAtt()
+{
+    if (!m_initialized)
+        qFatal("Shader not initialized");
+    return m_itemColorAttr;
+}
+
+GLint ShaderHelper::itemSizeAtt()
+{
+    if (!m_initialized)
+        qFatal("Shader not initialized");
+    return m_itemSizeAttr;
+}
+
 QT_END_NAMESPACE
@@ -71,10 +71,27 @@ class ShaderHelper
     GLint maxBounds();
     GLint minBounds();
     GLint sliceFrameWidth();
+    GLint instanceScale();
+    GLint pointScale();
+    GLint axisMin();
+    GLint axisMax();
+    GLint axisLog();
+    GLint axisOffset();
+    GLint axisNormalizer();
+    GLint axisScale();
+    GLint axisTranslate();
+    GLint axisMapping();
+    GLint heightMap();
+    GLint heightMapGrid();
+    GLint heightMapSize();
 
     GLint posAtt();
     GLint uvAtt();
     GLint normalAtt();
+    GLint instancePosAtt();
+    GLint instanceRotAtt();
+    GLint itemColorAtt();
+    GLint itemSizeAtt();
 
     private:
     QObject *m_caller;
@@ -89,6 +106,10 @@ class ShaderHelper
     GLint m_positionAttr;
     GLint m_uvAttr;
     GLint m_normalAttr;
+    GLint m_instancePositionAttr;
+    GLint m_instanceRotationAttr;
+    GLint m_itemColorAttr;
+    GLint m_itemSizeAttr;
 
     GLint m_colorUniform;
     GLint m_viewMatrixUniform;
@@ -116,6 +137,19 @@ class ShaderHelper
     GLint m_minBoundsUniform;
     GLint m_maxBoundsUniform;
     GLint m_sliceFrameWidthUniform;
+    GLint m_instanceScaleUniform;
+    GLint m_pointScaleUniform;
+    GLint m_axisMinUniform;
+    GLint m_axisMaxUniform;
+    GLint m_axisLogUniform;
+    GLint m_axisOffsetUniform;
+    GLint m_axisNormalizerUniform;
+    GLint m_axisScaleUniform;
+    GLint m_axisTranslateUniform;
+    GLint m_axisMappingUniform;
+    GLint m_heightMapUniform;
+    GLint m_heightMapGridUniform;
+    GLint m_heightMapSizeUniform;
 
     GLboolean m_initialized;
 };
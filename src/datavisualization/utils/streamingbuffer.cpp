@@ -0,0 +1,158 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include "streamingbuffer_p.h"
+#include <QtGui/QOpenGLContext>
+#include <cstring>
+
+QT_BEGIN_NAMESPACE
+
+StreamingBuffer::StreamingBuffer()
+    : m_current(0),
+      m_elementSize(0),
+      m_elementCount(0)
+{
+    for (int i = 0; i < bufferCount; i++) {
+        m_buffers[i] = 0;
+        m_fences[i] = 0;
+    }
+    initializeOpenGLFunctions();
+}
+
+StreamingBuffer::~StreamingBuffer()
+{
+    if (QOpenGLContext::currentContext())
+        release();
+}
+
+bool StreamingBuffer::isSupported()
+{
+    // Buffer range mapping is core functionality in OpenGL 3.0 and OpenGL ES 3.0,
+    // fence syncs in OpenGL 3.2 and OpenGL ES 3.0
+    QOpenGLContext *ctx = QOpenGLContext::currentContext();
+    if (!ctx)
+        return false;
+
+    const QSurfaceFormat format = ctx->format();
+    if (ctx->isOpenGLES())
+        return format.majorVersion() >= 3;
+    return format.version() >= qMakePair(3, 2);
+}
+
+void StreamingBuffer::allocate(int elementSize, int elementCount, const void *data)
+{
+    release();
+
+    if (elementCount <= 0)
+        return;
+
+    m_elementSize = elementSize;
+    m_elementCount = elementCount;
+
+    glGenBuffers(bufferCount, m_buffers);
+    for (int i = 0; i < bufferCount; i++) {
+        glBindBuffer(GL_ARRAY_BUFFER, m_buffers[i]);
+        glBufferData(GL_ARRAY_BUFFER, elementSize * elementCount, data, GL_STREAM_DRAW);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void StreamingBuffer::release()
+{
+    if (!m_elementCount)
+        return;
+
+    for (int i = 0; i < bufferCount; i++) {
+        if (m_fences[i]) {
+            glDeleteSync(m_fences[i]);
+            m_fences[i] = 0;
+        }
+        m_pendingRanges[i].clear();
+    }
+    glDeleteBuffers(bufferCount, m_buffers);
+    for (int i = 0; i < bufferCount; i++)
+        m_buffers[i] = 0;
+
+    m_current = 0;
+    m_elementSize = 0;
+    m_elementCount = 0;
+}
+
+// Marks elements changed in all buffers. Changes are written on the next upload() for
+// the buffer taken into use, and on later uploads for the other buffers.
+void StreamingBuffer::invalidate(int first, int count)
+{
+    for (int i = 0; i < bufferCount; i++)
+        m_pendingRanges[i].insert(first, count);
+}
+
+// Switches to the next buffer and writes the elements changed since it was last used.
+// The fence of the buffer is only polled. If the GPU may still read the buffer, the changes
+// are written with glBufferSubData, or the whole buffer is orphaned when most of it changes,
+// so that the driver handles the synchronization without stalling the render thread.
+void StreamingBuffer::upload(const void *data)
+{
+    if (!m_elementCount)
+        return;
+
+    // Draw calls using the current buffer have all been issued by now
+    if (m_fences[m_current])
+        glDeleteSync(m_fences[m_current]);
+    m_fences[m_current] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    m_current = (m_current + 1) % bufferCount;
+
+    bool idle = true;
+    if (m_fences[m_current]) {
+        const GLenum result = glClientWaitSync(m_fences[m_current], 0, 0);
+        idle = (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED);
+        glDeleteSync(m_fences[m_current]);
+        m_fences[m_current] = 0;
+    }
+
+    IndexRangeSet &pending = m_pendingRanges[m_current];
+    if (pending.isEmpty())
+        return;
+
+    const QList<IndexRangeSet::Range> ranges = pending.ranges();
+    const qint64 first = ranges.first().start;
+    const qint64 end = qMin(qint64(m_elementCount), ranges.last().start + ranges.last().count);
+    const char *source = static_cast<const char *>(data);
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_buffers[m_current]);
+    if (first < end && !idle && (end - first) * 2 > m_elementCount) {
+        // Fresh storage for the whole buffer, the old one is freed when the GPU is done with it
+        glBufferData(GL_ARRAY_BUFFER, qint64(m_elementSize) * m_elementCount, data,
+                     GL_STREAM_DRAW);
+    } else if (first < end) {
+        // Idle buffer can be mapped without synchronizing
+        char *mapped = nullptr;
+        if (idle) {
+            mapped = static_cast<char *>(
+                        glMapBufferRange(GL_ARRAY_BUFFER, first * m_elementSize,
+                                         (end - first) * m_elementSize,
+                                         GL_MAP_WRITE_BIT | GL_MAP_FLUSH_EXPLICIT_BIT
+                                         | GL_MAP_UNSYNCHRONIZED_BIT));
+        }
+        for (const IndexRangeSet::Range &range : ranges) {
+            const qint64 rangeEnd = qMin(qint64(m_elementCount), range.start + range.count);
+            if (range.start >= rangeEnd)
+                continue;
+            const qint64 offset = range.start * m_elementSize;
+            const qint64 size = (rangeEnd - range.start) * m_elementSize;
+            if (mapped) {
+                memcpy(mapped + offset - first * m_elementSize, source + offset, size);
+                glFlushMappedBufferRange(GL_ARRAY_BUFFER, offset - first * m_elementSize, size);
+            } else {
+                glBufferSubData(GL_ARRAY_BUFFER, offset, size, source + offset);
+            }
+        }
+        if (mapped)
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    pending.clear();
+}
+
+QT_END_NAMESPACE
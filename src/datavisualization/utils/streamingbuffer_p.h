@@ -0,0 +1,63 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QtDataVisualization API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+
+#ifndef STREAMINGBUFFER_P_H
+#define STREAMINGBUFFER_P_H
+
+#include "datavisualizationglobal_p.h"
+#include "indexrangeset_p.h"
+#include <QtGui/QOpenGLExtraFunctions>
+
+QT_BEGIN_NAMESPACE
+
+// Array buffer that is rotated between several GL buffers, so that frequently changing data
+// can be written without waiting for draw calls that still use the previous contents.
+// Each buffer tracks the elements changed since it was last written, and only those are
+// copied from the caller's CPU side copy of the data when the buffer is taken into use again.
+// Fences of the buffers are polled without waiting. Idle buffers are written via an explicitly
+// flushed mapping, and buffers still in use by the GPU with glBufferSubData, or by orphaning
+// the whole buffer.
+class Q_AUTOTEST_EXPORT StreamingBuffer : protected QOpenGLExtraFunctions
+{
+public:
+    static const int bufferCount = 3;
+
+    StreamingBuffer();
+    ~StreamingBuffer();
+
+    static bool isSupported();
+
+    void allocate(int elementSize, int elementCount, const void *data);
+    void release();
+    void invalidate(int first, int count = 1);
+    void upload(const void *data);
+
+    inline bool isAllocated() const { return m_elementCount > 0; }
+    inline GLuint buffer() const { return m_buffers[m_current]; }
+    inline GLuint buffer(int index) const { return m_buffers[index]; }
+    inline int currentIndex() const { return m_current; }
+    // Elements to write when the buffer at the given index is next taken into use
+    inline const IndexRangeSet &pendingRanges(int index) const { return m_pendingRanges[index]; }
+
+private:
+    GLuint m_buffers[bufferCount];
+    GLsync m_fences[bufferCount];
+    IndexRangeSet m_pendingRanges[bufferCount];
+    int m_current;
+    int m_elementSize;
+    int m_elementCount;
+};
+
+QT_END_NAMESPACE
+
+#endif
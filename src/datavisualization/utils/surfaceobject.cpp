@@ -3,11 +3,18 @@
 
 #include "surfaceobject_p.h"
 #include "surface3drenderer_p.h"
+#include "utils_p.h"
 
+#include <QtCore/QMutex>
 #include <QtGui/QVector2D>
 
+#include <limits>
+
 QT_BEGIN_NAMESPACE
 
+// Minimum number of samples in a band of rows that is set up in parallel
+const int rowBandSampleCount = 16384;
+
 SurfaceObject::SurfaceObject(Surface3DRenderer *renderer)
     : m_axisCacheX(renderer->m_axisCacheX),
       m_axisCacheY(renderer->m_axisCacheY),
@@ -27,12 +34,15 @@ SurfaceObject::~SurfaceObject()
     if (QOpenGLContext::currentContext()) {
         glDeleteBuffers(1, &m_gridElementbuffer);
         glDeleteBuffers(1, &m_uvTextureBuffer);
+        if (m_heightMapTexture)
+            glDeleteTextures(1, &m_heightMapTexture);
     }
 }
 
 void SurfaceObject::setUpSmoothData(const QSurfaceDataArray &dataArray, const QRect &space,
                                     bool changeGeometry, bool polar, bool flipXZ)
 {
+    m_quadTree.invalidate();
     m_columns = space.width();
     m_rows = space.height();
     int totalSize = m_rows * m_columns;
@@ -47,63 +57,109 @@ void SurfaceObject::setUpSmoothData(const QSurfaceDataArray &dataArray, const QR
         indicesDirty = true;
     m_oldDataDimension = m_dataDimension;
 
+    bool heightMapped = m_heightMapAllowed && !m_levelOfDetail
+            && setUpHeightMapGrid(dataArray, polar, flipXZ);
+    if (heightMapped != m_heightMapped) {
+        m_heightMapped = heightMapped;
+        changeGeometry = true;
+    }
+
     // Create/populate vertix table
-    if (changeGeometry)
-        m_vertices.resize(totalSize);
+    if (changeGeometry) {
+        if (m_heightMapped) {
+            m_heights.resize(totalSize);
+            m_vertices.clear();
+            m_vertices.squeeze();
+        } else {
+            m_vertices.resize(totalSize);
+            m_heights.clear();
+            m_heights.squeeze();
+        }
+    }
 
     QList<QVector2D> uvs;
     if (changeGeometry)
         uvs.resize(totalSize);
-    int totalIndex = 0;
 
     // Init min and max to ridiculous values
     m_minY = 10000000.0;
     m_maxY = -10000000.0f;
 
-    for (int i = 0; i < m_rows; i++) {
-        const QSurfaceDataRow &p = *dataArray.at(i);
-        for (int j = 0; j < m_columns; j++) {
-            getNormalizedVertex(p.at(j), m_vertices[totalIndex], polar, flipXZ);
-            if (changeGeometry)
-                uvs[totalIndex] = QVector2D(GLfloat(j) * uvX, GLfloat(i) * uvY);
-            totalIndex++;
-        }
-    }
-
-    if (flipXZ) {
-        for (int i = 0; i < m_vertices.size(); i++) {
-            m_vertices[i].setX(-m_vertices.at(i).x());
-            m_vertices[i].setZ(-m_vertices.at(i).z());
+    QVector3D *vertices = m_vertices.data();
+    float *heights = m_heights.data();
+    QVector2D *uvData = uvs.data();
+    QMutex limitsMutex;
+    forEachRowBand(m_rows, true, [&](int begin, int end) {
+        float minY = 10000000.0f;
+        float maxY = -10000000.0f;
+        QVector3D vertex;
+        int totalIndex = begin * m_columns;
+        for (int i = begin; i < end; i++) {
+            const QSurfaceDataRow &p = *dataArray.at(i);
+            for (int j = 0; j < m_columns; j++) {
+                QVector3D &target = m_heightMapped ? vertex : vertices[totalIndex];
+                normalizeVertex(p.at(j), target, polar, flipXZ);
+                updateLimits(target.y(), minY, maxY);
+                if (flipXZ) {
+                    target.setX(-target.x());
+                    target.setZ(-target.z());
+                }
+                if (m_heightMapped)
+                    heights[totalIndex] = target.y();
+                if (changeGeometry)
+                    uvData[totalIndex] = QVector2D(GLfloat(j) * uvX, GLfloat(i) * uvY);
+                totalIndex++;
+            }
         }
-    }
+        QMutexLocker locker(&limitsMutex);
+        m_minY = qMin(minY, m_minY);
+        m_maxY = qMax(maxY, m_maxY);
+    });
 
-    // Create normals
     int rowLimit = m_rows - 1;
     int colLimit = m_columns - 1;
-    if (changeGeometry)
-        m_normals.resize(totalSize);
-
-    totalIndex = 0;
 
-    if ((m_dataDimension == BothAscending) || (m_dataDimension == XDescending)) {
-        for (int row = 0; row < rowLimit; row++)
-            createSmoothNormalBodyLine(totalIndex, row * m_columns);
-        createSmoothNormalUpperLine(totalIndex);
-    } else { // BothDescending || ZDescending
-        createSmoothNormalUpperLine(totalIndex);
-        for (int row = 1; row < m_rows; row++)
-            createSmoothNormalBodyLine(totalIndex, row * m_columns);
+    // Height mapped normals are derived from the heights in the vertex shader
+    if (m_heightMapped) {
+        m_normals.clear();
+        m_normals.squeeze();
+    } else {
+        // Create normals
+        if (changeGeometry)
+            m_normals.resize(totalSize);
+
+        // Each row has its own normals, the upper line is the last or the first row
+        const bool upwards = (m_dataDimension == BothAscending)
+                || (m_dataDimension == XDescending);
+        const int upperRow = upwards ? rowLimit : 0;
+        forEachRowBand(m_rows, false, [&](int begin, int end) {
+            for (int row = begin; row < end; row++) {
+                int normalIndex = row * m_columns;
+                if (row == upperRow)
+                    createSmoothNormalUpperLine(normalIndex);
+                else
+                    createSmoothNormalBodyLine(normalIndex, row * m_columns);
+            }
+        });
     }
 
-    // Create indices table
-    if (changeGeometry || indicesDirty)
-        createSmoothIndices(0, 0, colLimit, rowLimit);
+    if (m_levelOfDetail) {
+        // Indices are created from the tiles when the level of detail is updated
+        setUpLodTiles();
+    } else {
+        // Create indices table
+        if (changeGeometry || indicesDirty)
+            createSmoothIndices(0, 0, colLimit, rowLimit);
 
-    // Create line element indices
-    if (changeGeometry)
-        createSmoothGridlineIndices(0, 0, colLimit, rowLimit);
+        // Create line element indices
+        if (changeGeometry)
+            createSmoothGridlineIndices(0, 0, colLimit, rowLimit);
+    }
 
-    createBuffers(m_vertices, uvs, m_normals, 0);
+    if (m_heightMapped)
+        createHeightMap(uvs);
+    else
+        createBuffers(m_vertices, uvs, m_normals, 0);
 }
 
 void SurfaceObject::createSmoothNormalBodyLine(int &totalIndex, int column)
@@ -318,12 +374,31 @@ void SurfaceObject::smoothUVs(const QSurfaceDataArray &dataArray,
 
 void SurfaceObject::updateSmoothRow(const QSurfaceDataArray &dataArray, int rowIndex, bool polar)
 {
+    m_quadTree.invalidate();
+
     // Update vertices
     int p = rowIndex * m_columns;
     const QSurfaceDataRow &dataRow = *dataArray.at(rowIndex);
 
+    if (m_heightMapped) {
+        QVector3D vertex;
+        for (int j = 0; j < m_columns; j++) {
+            // Items moved off the grid need the full vertices
+            if (!isOnHeightMapGrid(dataRow.at(j), rowIndex, j)) {
+                setUpSmoothData(dataArray, QRect(0, 0, m_columns, m_rows), true, polar);
+                return;
+            }
+            getNormalizedVertex(dataRow.at(j), vertex, polar, false);
+            m_heights[p++] = vertex.y();
+        }
+        m_dirtyVertices.insert(rowIndex * m_columns, m_columns);
+        return;
+    }
+
     for (int j = 0; j < m_columns; j++)
         getNormalizedVertex(dataRow.at(j), m_vertices[p++], polar, false);
+    m_dirtyVertices.insert(rowIndex * m_columns, m_columns);
+    invalidateLodTiles(rowIndex, -1);
 
     // Create normals
     bool upwards = (m_dataDimension == BothAscending) || (m_dataDimension == XDescending);
@@ -336,6 +411,7 @@ void SurfaceObject::updateSmoothRow(const QSurfaceDataArray &dataArray, int rowI
     if ((endRow == m_rows - 1) && upwards)
         endRow--;
     int totalIndex = startRow * m_columns;
+    const int firstNormal = totalIndex;
 
     if ((startRow == 0) && !upwards) {
         createSmoothNormalUpperLine(totalIndex);
@@ -347,14 +423,33 @@ void SurfaceObject::updateSmoothRow(const QSurfaceDataArray &dataArray, int rowI
 
     if ((rowIndex == m_rows - 1) && upwards)
         createSmoothNormalUpperLine(totalIndex);
+
+    m_dirtyNormals.insert(firstNormal, totalIndex - firstNormal);
 }
 
 void SurfaceObject::updateSmoothItem(const QSurfaceDataArray &dataArray, int row, int column,
                                      bool polar)
 {
+    m_quadTree.invalidate();
+
+    if (m_heightMapped) {
+        const QSurfaceDataItem &data = dataArray.at(row)->at(column);
+        if (!isOnHeightMapGrid(data, row, column)) {
+            setUpSmoothData(dataArray, QRect(0, 0, m_columns, m_rows), true, polar);
+            return;
+        }
+        QVector3D vertex;
+        getNormalizedVertex(data, vertex, polar, false);
+        m_heights[row * m_columns + column] = vertex.y();
+        m_dirtyVertices.insert(row * m_columns + column);
+        return;
+    }
+
     // Update a vertice
     getNormalizedVertex(dataArray.at(row)->at(column),
                         m_vertices[row * m_columns + column], polar, false);
+    m_dirtyVertices.insert(row * m_columns + column);
+    invalidateLodTiles(row, column);
 
     // Create normals
     bool upwards = (m_dataDimension == BothAscending) || (m_dataDimension == XDescending);
@@ -384,6 +479,7 @@ void SurfaceObject::updateSmoothItem(const QSurfaceDataArray &dataArray, int row
             else
                 m_normals[p] = createSmoothNormalBodyLineItem(j, i);
          }
+        m_dirtyNormals.insert(i * m_columns + startCol, endCol - startCol + 1);
     }
 }
 
@@ -401,44 +497,45 @@ void SurfaceObject::createSmoothIndices(int x, int y, int endX, int endY)
 
     m_indexCount = 6 * (endX - x) * (endY - y);
     GLint *indices = new GLint[m_indexCount];
-    int p = 0;
-    int rowEnd = endY * m_columns;
-    for (int row = y * m_columns; row < rowEnd; row += m_columns) {
-        for (int j = x; j < endX; j++) {
-            if ((m_dataDimension == BothAscending) || (m_dataDimension == BothDescending)) {
-                // Left triangle
-                indices[p++] = row + j + 1;
-                indices[p++] = row + m_columns + j;
-                indices[p++] = row + j;
-
-                // Right triangle
-                indices[p++] = row + m_columns + j + 1;
-                indices[p++] = row + m_columns + j;
-                indices[p++] = row + j + 1;
-            } else if (m_dataDimension == XDescending) {
-                // Right triangle
-                indices[p++] = row + m_columns + j;
-                indices[p++] = row + m_columns + j + 1;
-                indices[p++] = row + j;
-
-                // Left triangle
-                indices[p++] = row + j;
-                indices[p++] = row + m_columns + j + 1;
-                indices[p++] = row + j + 1;
-            } else {
-                // Left triangle
-                indices[p++] = row + m_columns + j;
-                indices[p++] = row + m_columns + j + 1;
-                indices[p++] = row + j;
-
-                // Right triangle
-                indices[p++] = row + j;
-                indices[p++] = row + m_columns + j + 1;
-                indices[p++] = row + j + 1;
-
+    forEachRowBand(endY - y, false, [&](int begin, int end) {
+        int p = 6 * (endX - x) * begin;
+        int rowEnd = (y + end) * m_columns;
+        for (int row = (y + begin) * m_columns; row < rowEnd; row += m_columns) {
+            for (int j = x; j < endX; j++) {
+                if ((m_dataDimension == BothAscending) || (m_dataDimension == BothDescending)) {
+                    // Left triangle
+                    indices[p++] = row + j + 1;
+                    indices[p++] = row + m_columns + j;
+                    indices[p++] = row + j;
+
+                    // Right triangle
+                    indices[p++] = row + m_columns + j + 1;
+                    indices[p++] = row + m_columns + j;
+                    indices[p++] = row + j + 1;
+                } else if (m_dataDimension == XDescending) {
+                    // Right triangle
+                    indices[p++] = row + m_columns + j;
+                    indices[p++] = row + m_columns + j + 1;
+                    indices[p++] = row + j;
+
+                    // Left triangle
+                    indices[p++] = row + j;
+                    indices[p++] = row + m_columns + j + 1;
+                    indices[p++] = row + j + 1;
+                } else {
+                    // Left triangle
+                    indices[p++] = row + m_columns + j;
+                    indices[p++] = row + m_columns + j + 1;
+                    indices[p++] = row + j;
+
+                    // Right triangle
+                    indices[p++] = row + j;
+                    indices[p++] = row + m_columns + j + 1;
+                    indices[p++] = row + j + 1;
+                }
             }
         }
-    }
+    });
 
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_elementbuffer);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_indexCount * sizeof(GLint),
@@ -464,19 +561,25 @@ void SurfaceObject::createSmoothGridlineIndices(int x, int y, int endX, int endY
     int nRows = endY - y + 1;
     m_gridIndexCount = 2 * nColumns * (nRows - 1) + 2 * nRows * (nColumns - 1);
     GLint *gridIndices = new GLint[m_gridIndexCount];
-    int p = 0;
-    for (int i = y, row = m_columns * y; i <= endY; i++, row += m_columns) {
-        for (int j = x; j < endX; j++) {
-            gridIndices[p++] = row + j;
-            gridIndices[p++] = row + j + 1;
+    // Horizontal lines of all rows come first, then the vertical lines between the rows
+    const int verticalStart = 2 * (nColumns - 1) * nRows;
+    forEachRowBand(nRows, false, [&](int begin, int end) {
+        int p = 2 * (nColumns - 1) * begin;
+        for (int i = y + begin, row = m_columns * i; i < y + end; i++, row += m_columns) {
+            for (int j = x; j < endX; j++) {
+                gridIndices[p++] = row + j;
+                gridIndices[p++] = row + j + 1;
+            }
         }
-    }
-    for (int i = y, row = m_columns * y; i < endY; i++, row += m_columns) {
-        for (int j = x; j <= endX; j++) {
-            gridIndices[p++] = row + j;
-            gridIndices[p++] = row + j + m_columns;
+        p = verticalStart + 2 * nColumns * begin;
+        for (int i = y + begin, row = m_columns * i; i < qMin(y + end, endY);
+             i++, row += m_columns) {
+            for (int j = x; j <= endX; j++) {
+                gridIndices[p++] = row + j;
+                gridIndices[p++] = row + j + m_columns;
+            }
         }
-    }
+    });
 
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_gridElementbuffer);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_gridIndexCount * sizeof(GLint),
@@ -487,9 +590,379 @@ void SurfaceObject::createSmoothGridlineIndices(int x, int y, int endX, int endY
     delete[] gridIndices;
 }
 
+bool SurfaceObject::isHeightMapSupported()
+{
+    // Vertex texture fetch from single channel float textures is core in OpenGL 3.0
+    QOpenGLContext *ctx = QOpenGLContext::currentContext();
+    if (!ctx || ctx->isOpenGLES())
+        return false;
+    return ctx->format().version() >= qMakePair(3, 0);
+}
+
+// Checks if the data is a regular grid in the normalized coordinates, where all rows share the
+// X values of the first row and all columns the Z values of the first column.
+bool SurfaceObject::setUpHeightMapGrid(const QSurfaceDataArray &dataArray, bool polar,
+                                       bool flipXZ)
+{
+    if (polar || flipXZ || m_columns < 2 || m_rows < 2)
+        return false;
+
+    const QSurfaceDataRow &firstRow = *dataArray.at(0);
+    const float x = m_axisCacheX.positionAt(firstRow.at(0).x());
+    const float z = m_axisCacheZ.positionAt(firstRow.at(0).z());
+    const float xSpan = m_axisCacheX.positionAt(firstRow.at(m_columns - 1).x()) - x;
+    const float zSpan = m_axisCacheZ.positionAt(dataArray.at(m_rows - 1)->at(0).z()) - z;
+    if (xSpan == 0.0f || zSpan == 0.0f)
+        return false;
+    m_heightMapGrid = QVector4D(x, z, xSpan, zSpan);
+
+    for (int j = 0; j < m_columns; j++) {
+        if (!isOnHeightMapGrid(firstRow.at(j), 0, j))
+            return false;
+    }
+    for (int i = 1; i < m_rows; i++) {
+        const QSurfaceDataRow &row = *dataArray.at(i);
+        if (!isOnHeightMapGrid(row.at(0), i, 0))
+            return false;
+        const float rowZ = row.at(0).z();
+        for (int j = 1; j < m_columns; j++) {
+            if (row.at(j).x() != firstRow.at(j).x() || row.at(j).z() != rowZ)
+                return false;
+        }
+    }
+    return true;
+}
+
+bool SurfaceObject::isOnHeightMapGrid(const QSurfaceDataItem &data, int row, int column) const
+{
+    // Allow a small fraction of the sample spacing for rounding errors
+    const float spacingX = m_heightMapGrid.z() / float(m_columns - 1);
+    const float spacingZ = m_heightMapGrid.w() / float(m_rows - 1);
+    const float x = m_axisCacheX.positionAt(data.x());
+    const float z = m_axisCacheZ.positionAt(data.z());
+    return qAbs(x - (m_heightMapGrid.x() + column * spacingX)) <= qAbs(spacingX) * 0.001f
+            && qAbs(z - (m_heightMapGrid.y() + row * spacingZ)) <= qAbs(spacingZ) * 0.001f;
+}
+
+void SurfaceObject::createHeightMap(const QList<QVector2D> &uvs)
+{
+#if !QT_CONFIG(opengles2)
+    if (!m_heightMapTexture)
+        glGenTextures(1, &m_heightMapTexture);
+    glBindTexture(GL_TEXTURE_2D, m_heightMapTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, m_columns, m_rows, 0, GL_RED, GL_FLOAT,
+                 m_heights.constData());
+    glBindTexture(GL_TEXTURE_2D, 0);
+#endif
+    m_heightMapTextureSize = QSize(m_columns, m_rows);
+
+    if (uvs.size()) {
+        glBindBuffer(GL_ARRAY_BUFFER, m_uvbuffer);
+        glBufferData(GL_ARRAY_BUFFER, uvs.size() * sizeof(QVector2D),
+                     &uvs.at(0), GL_STATIC_DRAW);
+    }
+
+    // Release the storage of the vertex and normal buffers, the grid UVs are drawn instead
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertexbuffer);
+    glBufferData(GL_ARRAY_BUFFER, 0, nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, m_normalbuffer);
+    glBufferData(GL_ARRAY_BUFFER, 0, nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    m_bufferVertexCount = 0;
+    m_bufferNormalCount = 0;
+    m_dirtyVertices.clear();
+    m_dirtyNormals.clear();
+    m_meshDataLoaded = true;
+}
+
+// Uploads the heights changed by the update functions, one sub-image per changed range
+void SurfaceObject::uploadHeightMap()
+{
+    if (m_heightMapTextureSize != QSize(m_columns, m_rows)) {
+        createHeightMap(QList<QVector2D>());
+        return;
+    }
+    if (m_dirtyVertices.isEmpty())
+        return;
+
+#if !QT_CONFIG(opengles2)
+    glBindTexture(GL_TEXTURE_2D, m_heightMapTexture);
+    const QList<IndexRangeSet::Range> dirtyRanges = m_dirtyVertices.ranges();
+    for (const IndexRangeSet::Range &range : dirtyRanges) {
+        const int firstRow = range.start / m_columns;
+        const int lastRow = (range.start + range.count - 1) / m_columns;
+        if (firstRow == lastRow) {
+            glTexSubImage2D(GL_TEXTURE_2D, 0, range.start % m_columns, firstRow, range.count, 1,
+                            GL_RED, GL_FLOAT, &m_heights.at(range.start));
+        } else {
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, firstRow, m_columns, lastRow - firstRow + 1,
+                            GL_RED, GL_FLOAT, &m_heights.at(firstRow * m_columns));
+        }
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+#endif
+    m_dirtyVertices.clear();
+}
+
+void SurfaceObject::setUpLodTiles()
+{
+    m_lodTileColumns = qMax(1, (m_columns - 2) / lodTileSize + 1);
+    m_lodTileRows = qMax(1, (m_rows - 2) / lodTileSize + 1);
+    m_lodTiles.resize(m_lodTileColumns * m_lodTileRows);
+    for (LodTile &tile : m_lodTiles) {
+        tile.level = 0;
+        tile.dirty = true;
+    }
+    m_lodIndicesDirty = true;
+}
+
+// Invalidates the tiles containing the vertex. Vertices on tile borders belong to two tiles.
+// Negative column invalidates the whole row.
+void SurfaceObject::invalidateLodTiles(int row, int column)
+{
+    if (!m_levelOfDetail || m_surfaceType != SurfaceSmooth || m_lodTiles.isEmpty())
+        return;
+
+    const int firstTileRow = row > 0 ? (row - 1) / lodTileSize : 0;
+    const int lastTileRow = qMin(row / lodTileSize, m_lodTileRows - 1);
+    int firstTileColumn = 0;
+    int lastTileColumn = m_lodTileColumns - 1;
+    if (column >= 0) {
+        firstTileColumn = column > 0 ? (column - 1) / lodTileSize : 0;
+        lastTileColumn = qMin(column / lodTileSize, m_lodTileColumns - 1);
+    }
+    for (int i = firstTileRow; i <= lastTileRow; i++) {
+        for (int j = firstTileColumn; j <= lastTileColumn; j++)
+            m_lodTiles[i * m_lodTileColumns + j].dirty = true;
+    }
+}
+
+// Calculates the bounds of the tile and the error of each level. The error of a level is the
+// largest height difference between the vertices of the previous level and the bilinear
+// interpolation of the coarser grid, accumulated over the levels.
+void SurfaceObject::updateLodTile(LodTile &tile, int tileIndex)
+{
+    const int c0 = (tileIndex % m_lodTileColumns) * lodTileSize;
+    const int r0 = (tileIndex / m_lodTileColumns) * lodTileSize;
+    const int c1 = qMin(c0 + lodTileSize, m_columns - 1);
+    const int r1 = qMin(r0 + lodTileSize, m_rows - 1);
+
+    const float maxFloat = std::numeric_limits<float>::max();
+    tile.minimum = QVector3D(maxFloat, maxFloat, maxFloat);
+    tile.maximum = QVector3D(-maxFloat, -maxFloat, -maxFloat);
+    for (int r = r0; r <= r1; r++) {
+        for (int c = c0; c <= c1; c++) {
+            const QVector3D &vertex = m_vertices.at(r * m_columns + c);
+            if (qIsNaN(vertex.y()) || qIsInf(vertex.y()))
+                continue;
+            tile.minimum = QVector3D(qMin(tile.minimum.x(), vertex.x()),
+                                     qMin(tile.minimum.y(), vertex.y()),
+                                     qMin(tile.minimum.z(), vertex.z()));
+            tile.maximum = QVector3D(qMax(tile.maximum.x(), vertex.x()),
+                                     qMax(tile.maximum.y(), vertex.y()),
+                                     qMax(tile.maximum.z(), vertex.z()));
+        }
+    }
+
+    auto heightAt = [this](int r, int c) { return m_vertices.at(r * m_columns + c).y(); };
+
+    tile.errors[0] = 0.0f;
+    for (int level = 1; level < lodLevelCount; level++) {
+        const int step = 1 << level;
+        const int fineStep = step / 2;
+        float error = tile.errors[level - 1];
+        for (int r = r0; r <= r1; r = (r == r1) ? r1 + 1 : qMin(r + fineStep, r1)) {
+            const int cellR0 = r0 + ((r - r0) / step) * step;
+            const int cellR1 = qMin(cellR0 + step, r1);
+            const float fr = cellR1 > cellR0 ? float(r - cellR0) / float(cellR1 - cellR0) : 0.0f;
+            for (int c = c0; c <= c1; c = (c == c1) ? c1 + 1 : qMin(c + fineStep, c1)) {
+                const int cellC0 = c0 + ((c - c0) / step) * step;
+                const int cellC1 = qMin(cellC0 + step, c1);
+                const float fc = cellC1 > cellC0
+                        ? float(c - cellC0) / float(cellC1 - cellC0) : 0.0f;
+                const float interpolated =
+                        (1.0f - fr) * ((1.0f - fc) * heightAt(cellR0, cellC0)
+                                       + fc * heightAt(cellR0, cellC1))
+                        + fr * ((1.0f - fc) * heightAt(cellR1, cellC0)
+                                + fc * heightAt(cellR1, cellC1));
+                const float difference = qAbs(heightAt(r, c) - interpolated);
+                // Invalid heights propagate to the difference and are skipped
+                if (!qIsNaN(difference) && !qIsInf(difference))
+                    error = qMax(error, difference);
+            }
+        }
+        tile.errors[level] = error;
+    }
+    tile.dirty = false;
+}
+
+// Selects the coarsest level for each tile whose error projects to at most threshold pixels,
+// and recreates the indices if any level changed.
+void SurfaceObject::updateLevelOfDetail(const QMatrix4x4 &projectionViewMatrix, float pixelScale,
+                                        float threshold)
+{
+    if (!m_levelOfDetail || m_surfaceType != SurfaceSmooth || m_lodTiles.isEmpty())
+        return;
+
+    QList<int> dirtyTiles;
+    for (int i = 0; i < m_lodTiles.size(); i++) {
+        if (m_lodTiles.at(i).dirty)
+            dirtyTiles.append(i);
+    }
+    if (!dirtyTiles.isEmpty()) {
+        LodTile *tiles = m_lodTiles.data();
+        Utils::parallelFor(dirtyTiles.size(), 4, [this, tiles, &dirtyTiles](int begin, int end) {
+            for (int i = begin; i < end; i++)
+                updateLodTile(tiles[dirtyTiles.at(i)], dirtyTiles.at(i));
+        });
+        m_lodIndicesDirty = true;
+    }
+
+    const QVector4D rowW = projectionViewMatrix.row(3);
+    for (LodTile &tile : m_lodTiles) {
+        int level = 0;
+        if (tile.minimum.x() <= tile.maximum.x()) {
+            // Closest corner of the bounding box gives the largest projected error
+            float minW = std::numeric_limits<float>::max();
+            for (int corner = 0; corner < 8; corner++) {
+                const QVector4D position((corner & 1) ? tile.maximum.x() : tile.minimum.x(),
+                                         (corner & 2) ? tile.maximum.y() : tile.minimum.y(),
+                                         (corner & 4) ? tile.maximum.z() : tile.minimum.z(),
+                                         1.0f);
+                minW = qMin(minW, QVector4D::dotProduct(rowW, position));
+            }
+            if (minW > std::numeric_limits<float>::epsilon()) {
+                while (level + 1 < lodLevelCount
+                       && tile.errors[level + 1] * pixelScale / minW <= threshold) {
+                    level++;
+                }
+            }
+        }
+        if (tile.level != level) {
+            tile.level = level;
+            m_lodIndicesDirty = true;
+        }
+    }
+
+    if (m_lodIndicesDirty)
+        createLodIndices();
+}
+
+int SurfaceObject::lodStep(int tileRow, int tileColumn) const
+{
+    return 1 << m_lodTiles.at(tileRow * m_lodTileColumns + tileColumn).level;
+}
+
+// Creates the triangle and grid line indices of all tiles. Vertices on tile edges are snapped
+// to the coarser grid of the two tiles sharing the edge, so that the tiles meet without cracks.
+void SurfaceObject::createLodIndices()
+{
+    QList<GLint> indices;
+    QList<GLint> gridIndices;
+    const bool ascending =
+            (m_dataDimension == BothAscending) || (m_dataDimension == BothDescending);
+
+    for (int tileRow = 0; tileRow < m_lodTileRows; tileRow++) {
+        for (int tileColumn = 0; tileColumn < m_lodTileColumns; tileColumn++) {
+            const int step = lodStep(tileRow, tileColumn);
+            const int c0 = tileColumn * lodTileSize;
+            const int r0 = tileRow * lodTileSize;
+            const int c1 = qMin(c0 + lodTileSize, m_columns - 1);
+            const int r1 = qMin(r0 + lodTileSize, m_rows - 1);
+            const int leftStep = tileColumn > 0
+                    ? qMax(step, lodStep(tileRow, tileColumn - 1)) : step;
+            const int rightStep = tileColumn < m_lodTileColumns - 1
+                    ? qMax(step, lodStep(tileRow, tileColumn + 1)) : step;
+            const int bottomStep = tileRow > 0
+                    ? qMax(step, lodStep(tileRow - 1, tileColumn)) : step;
+            const int topStep = tileRow < m_lodTileRows - 1
+                    ? qMax(step, lodStep(tileRow + 1, tileColumn)) : step;
+
+            auto snap = [](int value, int start, int end, int snapStep) {
+                return value == end ? end : start + ((value - start) / snapStep) * snapStep;
+            };
+            auto vertexIndex = [&](int r, int c) {
+                int snappedR = r;
+                int snappedC = c;
+                if (c == c0)
+                    snappedR = snap(r, r0, r1, leftStep);
+                else if (c == c1)
+                    snappedR = snap(r, r0, r1, rightStep);
+                if (r == r0)
+                    snappedC = snap(c, c0, c1, bottomStep);
+                else if (r == r1)
+                    snappedC = snap(c, c0, c1, topStep);
+                return GLint(snappedR * m_columns + snappedC);
+            };
+            auto addTriangle = [&indices](GLint a, GLint b, GLint c) {
+                if (a != b && b != c && a != c) {
+                    indices.append(a);
+                    indices.append(b);
+                    indices.append(c);
+                }
+            };
+            auto addLine = [&gridIndices](GLint a, GLint b) {
+                if (a != b) {
+                    gridIndices.append(a);
+                    gridIndices.append(b);
+                }
+            };
+
+            for (int r = r0; r < r1; r += step) {
+                const int nextR = qMin(r + step, r1);
+                for (int c = c0; c < c1; c += step) {
+                    const int nextC = qMin(c + step, c1);
+                    const GLint a = vertexIndex(r, c);
+                    const GLint b = vertexIndex(r, nextC);
+                    const GLint c2 = vertexIndex(nextR, c);
+                    const GLint d = vertexIndex(nextR, nextC);
+                    if (ascending) {
+                        addTriangle(b, c2, a);
+                        addTriangle(d, c2, b);
+                    } else {
+                        addTriangle(c2, d, a);
+                        addTriangle(a, d, b);
+                    }
+                }
+            }
+
+            // Tiles draw their left and bottom edges, the last tiles also the right and top
+            const int lastR = tileRow == m_lodTileRows - 1 ? r1 : r1 - 1;
+            const int lastC = tileColumn == m_lodTileColumns - 1 ? c1 : c1 - 1;
+            for (int r = r0; r <= lastR; r = (r == r1) ? r1 + 1 : qMin(r + step, r1)) {
+                for (int c = c0; c < c1; c += step)
+                    addLine(vertexIndex(r, c), vertexIndex(r, qMin(c + step, c1)));
+            }
+            for (int c = c0; c <= lastC; c = (c == c1) ? c1 + 1 : qMin(c + step, c1)) {
+                for (int r = r0; r < r1; r += step)
+                    addLine(vertexIndex(r, c), vertexIndex(qMin(r + step, r1), c));
+            }
+        }
+    }
+
+    m_indexCount = indices.size();
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_elementbuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLint),
+                 indices.constData(), GL_DYNAMIC_DRAW);
+
+    m_gridIndexCount = gridIndices.size();
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_gridElementbuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, gridIndices.size() * sizeof(GLint),
+                 gridIndices.constData(), GL_DYNAMIC_DRAW);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    m_lodIndicesDirty = false;
+}
+
 void SurfaceObject::setUpData(const QSurfaceDataArray &dataArray, const QRect &space,
                               bool changeGeometry, bool polar, bool flipXZ)
 {
+    m_quadTree.invalidate();
     m_columns = space.width();
     m_rows = space.height();
     int totalSize = m_rows * m_columns * 2;
@@ -512,63 +985,74 @@ void SurfaceObject::setUpData(const QSurfaceDataArray &dataArray, const QRect &s
     if (changeGeometry)
         uvs.resize(totalSize);
 
-    int totalIndex = 0;
     int rowLimit = m_rows - 1;
     int colLimit = m_columns - 1;
     int doubleColumns = m_columns * 2 - 2;
-    int rowColLimit = rowLimit * doubleColumns;
 
     // Init min and max to ridiculous values
     m_minY = 10000000.0;
     m_maxY = -10000000.0f;
 
-    for (int i = 0; i < m_rows; i++) {
-        const QSurfaceDataRow &row = *dataArray.at(i);
-        for (int j = 0; j < m_columns; j++) {
-            getNormalizedVertex(row.at(j), m_vertices[totalIndex], polar, flipXZ);
-            if (changeGeometry)
-                uvs[totalIndex] = QVector2D(GLfloat(j) * uvX, GLfloat(i) * uvY);
-
-            totalIndex++;
-
-            if (j > 0 && j < colLimit) {
-                m_vertices[totalIndex] = m_vertices[totalIndex - 1];
+    QVector3D *vertices = m_vertices.data();
+    QVector2D *uvData = uvs.data();
+    QMutex limitsMutex;
+    forEachRowBand(m_rows, true, [&](int begin, int end) {
+        float minY = 10000000.0f;
+        float maxY = -10000000.0f;
+        int totalIndex = begin * doubleColumns;
+        for (int i = begin; i < end; i++) {
+            const QSurfaceDataRow &row = *dataArray.at(i);
+            for (int j = 0; j < m_columns; j++) {
+                QVector3D &vertex = vertices[totalIndex];
+                normalizeVertex(row.at(j), vertex, polar, flipXZ);
+                updateLimits(vertex.y(), minY, maxY);
+                if (flipXZ) {
+                    vertex.setX(-vertex.x());
+                    vertex.setZ(-vertex.z());
+                }
                 if (changeGeometry)
-                    uvs[totalIndex] = uvs[totalIndex - 1];
+                    uvData[totalIndex] = QVector2D(GLfloat(j) * uvX, GLfloat(i) * uvY);
+
                 totalIndex++;
-            }
-        }
-    }
 
-    if (flipXZ) {
-        for (int i = 0; i < m_vertices.size(); i++) {
-            m_vertices[i].setX(-m_vertices.at(i).x());
-            m_vertices[i].setZ(-m_vertices.at(i).z());
+                if (j > 0 && j < colLimit) {
+                    vertices[totalIndex] = vertices[totalIndex - 1];
+                    if (changeGeometry)
+                        uvData[totalIndex] = uvData[totalIndex - 1];
+                    totalIndex++;
+                }
+            }
         }
-    }
+        QMutexLocker locker(&limitsMutex);
+        m_minY = qMin(minY, m_minY);
+        m_maxY = qMax(maxY, m_maxY);
+    });
 
     // Create normals & indices table
+    const bool createIndices = changeGeometry || indicesDirty;
     GLint *indices = 0;
-    if (changeGeometry || indicesDirty) {
+    if (createIndices) {
         int normalCount = 2 * colLimit * rowLimit;
         m_indexCount = 3 * normalCount;
         indices = new GLint[m_indexCount];
         m_normals.resize(normalCount);
     }
 
-    int p = 0;
-    totalIndex = 0;
-    for (int row = 0, upperRow = doubleColumns;
-         row < rowColLimit;
-         row += doubleColumns, upperRow += doubleColumns) {
-        for (int j = 0; j < doubleColumns; j += 2) {
-            createNormals(totalIndex, row, upperRow, j);
-
-            if (changeGeometry || indicesDirty) {
-                createCoarseIndices(indices, p, row, upperRow, j);
+    // Each row of cells has doubleColumns normals and three times as many indices
+    forEachRowBand(rowLimit, false, [&](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            int row = i * doubleColumns;
+            int upperRow = row + doubleColumns;
+            int normalIndex = row;
+            int p = 3 * row;
+            for (int j = 0; j < doubleColumns; j += 2) {
+                createNormals(normalIndex, row, upperRow, j);
+
+                if (createIndices)
+                    createCoarseIndices(indices, p, row, upperRow, j);
             }
         }
-    }
+    });
 
     // Create grid line element indices
     if (changeGeometry)
@@ -628,6 +1112,8 @@ void SurfaceObject::coarseUVs(const QSurfaceDataArray &dataArray,
 
 void SurfaceObject::updateCoarseRow(const QSurfaceDataArray &dataArray, int rowIndex, bool polar)
 {
+    m_quadTree.invalidate();
+
     int colLimit = m_columns - 1;
     int doubleColumns = m_columns * 2 - 2;
 
@@ -641,11 +1127,13 @@ void SurfaceObject::updateCoarseRow(const QSurfaceDataArray &dataArray, int rowI
             p++;
         }
     }
+    m_dirtyVertices.insert(rowIndex * doubleColumns, p - rowIndex * doubleColumns);
 
     // Create normals
     p = rowIndex * doubleColumns;
     if (p > 0)
         p -= doubleColumns;
+    const int firstNormal = p;
     int rowLimit = (rowIndex + 1) * doubleColumns;
     if (rowIndex == m_rows - 1)
         rowLimit = rowIndex * doubleColumns; //Topmost row, no normals
@@ -655,11 +1143,15 @@ void SurfaceObject::updateCoarseRow(const QSurfaceDataArray &dataArray, int rowI
         for (int j = 0; j < doubleColumns; j += 2)
             createNormals(p, row, upperRow, j);
     }
+    if (p > firstNormal)
+        m_dirtyNormals.insert(firstNormal, p - firstNormal);
 }
 
 void SurfaceObject::updateCoarseItem(const QSurfaceDataArray &dataArray, int row, int column,
                                      bool polar)
 {
+    m_quadTree.invalidate();
+
     int colLimit = m_columns - 1;
     int doubleColumns = m_columns * 2 - 2;
 
@@ -667,8 +1159,12 @@ void SurfaceObject::updateCoarseItem(const QSurfaceDataArray &dataArray, int row
     int p = row * doubleColumns + column * 2 - (column > 0);
     getNormalizedVertex(dataArray.at(row)->at(column), m_vertices[p++], polar, false);
 
-    if (column > 0 && column < colLimit)
+    if (column > 0 && column < colLimit) {
         m_vertices[p] = m_vertices[p - 1];
+        m_dirtyVertices.insert(p - 1, 2);
+    } else {
+        m_dirtyVertices.insert(p - 1);
+    }
 
     // Create normals
     int startRow = row;
@@ -687,6 +1183,7 @@ void SurfaceObject::updateCoarseItem(const QSurfaceDataArray &dataArray, int row
             p = i * doubleColumns + j * 2;
             createNormals(p, i * doubleColumns, (i + 1) * doubleColumns, j * 2);
         }
+        m_dirtyNormals.insert(i * doubleColumns + startCol * 2, (column - startCol + 1) * 2);
     }
 }
 
@@ -774,10 +1271,39 @@ void SurfaceObject::createCoarseGridlineIndices(int x, int y, int endX, int endY
     delete[] gridIndices;
 }
 
+// Uploads the vertices and normals changed by the update functions. Buffers are only
+// re-specified if their size has changed since the data was set up.
 void SurfaceObject::uploadBuffers()
 {
-    QList<QVector2D> uvs; // Empty dummy
-    createBuffers(m_vertices, uvs, m_normals, 0);
+    if (m_heightMapped) {
+        uploadHeightMap();
+        return;
+    }
+
+    if (m_vertices.size() != m_bufferVertexCount || m_normals.size() != m_bufferNormalCount) {
+        QList<QVector2D> uvs; // Empty dummy
+        createBuffers(m_vertices, uvs, m_normals, 0);
+        return;
+    }
+
+    uploadDirtyRanges(m_vertexbuffer, m_vertices, m_dirtyVertices);
+    uploadDirtyRanges(m_normalbuffer, m_normals, m_dirtyNormals);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void SurfaceObject::uploadDirtyRanges(GLuint buffer, const QList<QVector3D> &data,
+                                      IndexRangeSet &ranges)
+{
+    if (ranges.isEmpty())
+        return;
+
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    const QList<IndexRangeSet::Range> dirtyRanges = ranges.ranges();
+    for (const IndexRangeSet::Range &range : dirtyRanges) {
+        glBufferSubData(GL_ARRAY_BUFFER, range.start * sizeof(QVector3D),
+                        range.count * sizeof(QVector3D), &data.at(range.start));
+    }
+    ranges.clear();
 }
 
 void SurfaceObject::createBuffers(const QList<QVector3D> &vertices, const QList<QVector2D> &uvs,
@@ -807,6 +1333,10 @@ void SurfaceObject::createBuffers(const QList<QVector3D> &vertices, const QList<
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 
+    m_bufferVertexCount = vertices.size();
+    m_bufferNormalCount = normals.size();
+    m_dirtyVertices.clear();
+    m_dirtyNormals.clear();
     m_meshDataLoaded = true;
 }
 
@@ -827,6 +1357,13 @@ void SurfaceObject::checkDirections(const QSurfaceDataArray &array)
 
 void SurfaceObject::getNormalizedVertex(const QSurfaceDataItem &data, QVector3D &vertex,
                                         bool polar, bool flipXZ)
+{
+    normalizeVertex(data, vertex, polar, flipXZ);
+    updateLimits(vertex.y(), m_minY, m_maxY);
+}
+
+void SurfaceObject::normalizeVertex(const QSurfaceDataItem &data, QVector3D &vertex,
+                                    bool polar, bool flipXZ) const
 {
     float normalizedX;
     float normalizedZ;
@@ -842,15 +1379,31 @@ void SurfaceObject::getNormalizedVertex(const QSurfaceDataItem &data, QVector3D
             normalizedZ = m_axisCacheZ.positionAt(data.z());
         }
     }
-    float normalizedY = m_axisCacheY.positionAt(data.y());
-    m_minY = qMin(normalizedY, m_minY);
-    if (!qIsNaN(normalizedY) && !qIsInf(normalizedY))
-        m_maxY = qMax(normalizedY, m_maxY);
     vertex.setX(normalizedX);
-    vertex.setY(normalizedY);
+    vertex.setY(m_axisCacheY.positionAt(data.y()));
     vertex.setZ(normalizedZ);
 }
 
+void SurfaceObject::updateLimits(float y, float &minY, float &maxY)
+{
+    minY = qMin(y, minY);
+    if (!qIsNaN(y) && !qIsInf(y))
+        maxY = qMax(y, maxY);
+}
+
+void SurfaceObject::forEachRowBand(int rowCount, bool usesFormatters,
+                                   const std::function<void(int begin, int end)> &function)
+{
+    // Custom formatters may call into script engines and user code that are not thread safe
+    if (usesFormatters && (!m_axisCacheX.hasBuiltInFormatter()
+                           || !m_axisCacheY.hasBuiltInFormatter()
+                           || !m_axisCacheZ.hasBuiltInFormatter())) {
+        function(0, rowCount);
+        return;
+    }
+    Utils::parallelFor(rowCount, qMax(1, rowBandSampleCount / qMax(1, m_columns)), function);
+}
+
 GLuint SurfaceObject::gridElementBuf()
 {
     if (!m_meshDataLoaded)
@@ -877,9 +1430,15 @@ GLuint SurfaceObject::gridIndexCount()
 QVector3D SurfaceObject::vertexAt(int column, int row)
 {
     int pos = 0;
-    if (m_surfaceType == Undefined || !m_vertices.size())
+    if (m_surfaceType == Undefined || (!m_vertices.size() && !m_heights.size()))
         return zeroVector;
 
+    if (m_heightMapped) {
+        return QVector3D(m_heightMapGrid.x() + m_heightMapGrid.z() * column / (m_columns - 1),
+                         m_heights.at(row * m_columns + column),
+                         m_heightMapGrid.y() + m_heightMapGrid.w() * row / (m_rows - 1));
+    }
+
     if (m_surfaceType == SurfaceFlat)
         pos = row * (m_columns * 2 - 2) + column * 2 - (column > 0);
     else
@@ -887,6 +1446,24 @@ QVector3D SurfaceObject::vertexAt(int column, int row)
     return m_vertices.at(pos);
 }
 
+bool SurfaceObject::intersectRay(const QVector3D &origin, const QVector3D &direction,
+                                 float &distance, QPoint &point)
+{
+    if (m_surfaceType == Undefined)
+        return false;
+
+    // Cells are split along the same diagonal as when drawing
+    const bool mainDiagonal = (m_dataDimension == XDescending)
+            || (m_dataDimension == ZDescending);
+    int row;
+    int column;
+    if (!m_quadTree.intersect(*this, mainDiagonal, origin, direction, distance, row, column))
+        return false;
+
+    point = QPoint(row, column);
+    return true;
+}
+
 void SurfaceObject::clear()
 {
     m_gridIndexCount = 0;
@@ -894,6 +1471,12 @@ void SurfaceObject::clear()
     m_surfaceType = Undefined;
     m_vertices.clear();
     m_normals.clear();
+    m_dirtyVertices.clear();
+    m_dirtyNormals.clear();
+    m_lodTiles.clear();
+    m_heightMapped = false;
+    m_heights.clear();
+    m_quadTree.invalidate();
 }
 
 void SurfaceObject::createCoarseIndices(GLint *indices, int &p, int row, int upperRow, int j)
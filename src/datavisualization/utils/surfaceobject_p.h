@@ -15,17 +15,23 @@
 #define SURFACEOBJECT_P_H
 
 #include "abstractobjecthelper_p.h"
+#include "indexrangeset_p.h"
 #include "qsurfacedataproxy.h"
+#include "surfacequadtree_p.h"
 
 #include <QtCore/QRect>
 #include <QtGui/QColor>
+#include <QtGui/QMatrix4x4>
+#include <QtGui/QVector2D>
+
+#include <functional>
 
 QT_BEGIN_NAMESPACE
 
 class Surface3DRenderer;
 class AxisRenderCache;
 
-class SurfaceObject : public AbstractObjectHelper
+class Q_AUTOTEST_EXPORT SurfaceObject : public AbstractObjectHelper
 {
 public:
     enum SurfaceType {
@@ -65,14 +71,63 @@ public:
     GLuint uvBuf() override;
     GLuint gridIndexCount();
     QVector3D vertexAt(int column, int row);
+    // Vertices and normals in the order they are uploaded to the buffers
+    inline const QList<QVector3D> &vertices() const { return m_vertices; }
+    inline const QList<QVector3D> &normals() const { return m_normals; }
+    // Indexes of the vertices and normals changed since the buffers were uploaded
+    inline const IndexRangeSet &dirtyVertices() const { return m_dirtyVertices; }
+    inline const IndexRangeSet &dirtyNormals() const { return m_dirtyNormals; }
+    // Finds the nearest point where the ray hits the surface. The point is returned as the
+    // (row, column) of the closest vertex.
+    bool intersectRay(const QVector3D &origin, const QVector3D &direction, float &distance,
+                      QPoint &point);
     void clear();
+    inline int columns() const { return m_columns; }
+    inline int rows() const { return m_rows; }
     float minYValue() const { return m_minY; }
     float maxYValue() const { return m_maxY; }
     inline void activateSurfaceTexture(bool value) { m_returnTextureBuffer = value; }
     inline void setLineColor(const QColor &color) { m_wireframeColor = color; }
     inline const QColor &wireframeColor() const { return m_wireframeColor; }
+    inline void setLevelOfDetail(bool enable) { m_levelOfDetail = enable; }
+    inline bool levelOfDetail() const { return m_levelOfDetail; }
+    void updateLevelOfDetail(const QMatrix4x4 &projectionViewMatrix, float pixelScale,
+                             float threshold);
+    // Vertex step of the tile at its current level of detail
+    int lodStep(int tileRow, int tileColumn) const;
+    inline void setHeightMapAllowed(bool allowed) { m_heightMapAllowed = allowed; }
+    inline bool isHeightMapped() const { return m_heightMapped; }
+    inline GLuint heightMapTexture() const { return m_heightMapTexture; }
+    // Position of the first vertex and the distance to the last vertex as (x, z, xSpan, zSpan)
+    inline const QVector4D &heightMapGrid() const { return m_heightMapGrid; }
+    inline QVector2D heightMapSize() const { return QVector2D(m_columns, m_rows); }
+
+    static bool isHeightMapSupported();
 
 private:
+    // Smooth surfaces with level of detail are split into square tiles of lodTileSize cells.
+    // Each tile is drawn using every 2^level:th vertex.
+    static const int lodTileSize = 64;
+    static const int lodLevelCount = 7;
+
+    struct LodTile
+    {
+        QVector3D minimum;
+        QVector3D maximum;
+        // Largest height deviation from the full resolution surface for each level
+        float errors[lodLevelCount];
+        int level = 0;
+        bool dirty = true;
+    };
+
+    bool setUpHeightMapGrid(const QSurfaceDataArray &dataArray, bool polar, bool flipXZ);
+    bool isOnHeightMapGrid(const QSurfaceDataItem &data, int row, int column) const;
+    void createHeightMap(const QList<QVector2D> &uvs);
+    void uploadHeightMap();
+    void setUpLodTiles();
+    void invalidateLodTiles(int row, int column);
+    void updateLodTile(LodTile &tile, int tileIndex);
+    void createLodIndices();
     void createCoarseIndices(GLint *indices, int &p, int row, int upperRow, int j);
     void createNormals(int &p, int row, int upperRow, int j);
     void createSmoothNormalBodyLine(int &totalIndex, int column);
@@ -82,9 +137,19 @@ private:
     QVector3D normal(const QVector3D &a, const QVector3D &b, const QVector3D &c);
     void createBuffers(const QList<QVector3D> &vertices, const QList<QVector2D> &uvs,
                        const QList<QVector3D> &normals, const GLint *indices);
+    void uploadDirtyRanges(GLuint buffer, const QList<QVector3D> &data, IndexRangeSet &ranges);
     void checkDirections(const QSurfaceDataArray &array);
     inline void getNormalizedVertex(const QSurfaceDataItem &data, QVector3D &vertex, bool polar,
                                     bool flipXZ);
+    // Like getNormalizedVertex(), but leaves the Y limits alone so that it can be called
+    // from several threads
+    void normalizeVertex(const QSurfaceDataItem &data, QVector3D &vertex, bool polar,
+                         bool flipXZ) const;
+    static inline void updateLimits(float y, float &minY, float &maxY);
+    // Calls the function for bands of rows in parallel. Normalizing with custom axis formatters
+    // is not thread safe, so usesFormatters makes the call serial for those.
+    void forEachRowBand(int rowCount, bool usesFormatters,
+                        const std::function<void(int begin, int end)> &function);
 
 private:
     SurfaceType m_surfaceType = Undefined;
@@ -94,6 +159,12 @@ private:
     GLuint m_gridIndexCount = 0;
     QList<QVector3D> m_vertices;
     QList<QVector3D> m_normals;
+    // Vertices and normals changed since the buffers were uploaded
+    IndexRangeSet m_dirtyVertices;
+    IndexRangeSet m_dirtyNormals;
+    // Used to detect if the buffers need to be re-specified
+    int m_bufferVertexCount = 0;
+    int m_bufferNormalCount = 0;
     // Caches are not owned
     AxisRenderCache &m_axisCacheX;
     AxisRenderCache &m_axisCacheY;
@@ -106,6 +177,20 @@ private:
     SurfaceObject::DataDimensions m_dataDimension;
     SurfaceObject::DataDimensions m_oldDataDimension = DataDimensions(-1);
     QColor m_wireframeColor;
+    bool m_levelOfDetail = false;
+    QList<LodTile> m_lodTiles;
+    int m_lodTileColumns = 0;
+    int m_lodTileRows = 0;
+    bool m_lodIndicesDirty = false;
+    // Regular grids are drawn by displacing the grid with a height texture in the vertex shader.
+    // Only the heights are stored then, and vertices and normals are empty.
+    bool m_heightMapAllowed = false;
+    bool m_heightMapped = false;
+    QList<float> m_heights;
+    QVector4D m_heightMapGrid;
+    GLuint m_heightMapTexture = 0;
+    QSize m_heightMapTextureSize;
+    SurfaceQuadTree m_quadTree;
 };
 
 QT_END_NAMESPACE
@@ -0,0 +1,216 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include "surfacequadtree_p.h"
+#include "surfaceobject_p.h"
+
+#include <QtGui/QVector2D>
+
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+// Leaves cover at most this many cells in both directions
+static const int leafCellCount = 4;
+
+static inline bool isFinite(const QVector3D &vertex)
+{
+    return qIsFinite(vertex.x()) && qIsFinite(vertex.y()) && qIsFinite(vertex.z());
+}
+
+// Slab test, returns the distance along the ray where it enters the box
+static bool intersectBox(const QVector3D &minBounds, const QVector3D &maxBounds,
+                         const QVector3D &origin, const QVector3D &direction, float &tNear)
+{
+    tNear = 0.0f;
+    float tFar = std::numeric_limits<float>::max();
+    for (int axis = 0; axis < 3; axis++) {
+        if (qFuzzyIsNull(direction[axis])) {
+            if (origin[axis] < minBounds[axis] || origin[axis] > maxBounds[axis])
+                return false;
+        } else {
+            float t1 = (minBounds[axis] - origin[axis]) / direction[axis];
+            float t2 = (maxBounds[axis] - origin[axis]) / direction[axis];
+            if (t1 > t2)
+                qSwap(t1, t2);
+            tNear = qMax(tNear, t1);
+            tFar = qMin(tFar, t2);
+            if (tNear > tFar)
+                return false;
+        }
+    }
+    return true;
+}
+
+// Moeller-Trumbore intersection, for both sides of the triangle. Returns the distance along the
+// ray and the barycentric coordinates of the intersection relative to b and c.
+static bool intersectTriangle(const QVector3D &origin, const QVector3D &direction,
+                              const QVector3D &a, const QVector3D &b, const QVector3D &c,
+                              float &t, float &u, float &v)
+{
+    const QVector3D edge1 = b - a;
+    const QVector3D edge2 = c - a;
+    const QVector3D p = QVector3D::crossProduct(direction, edge2);
+    const float determinant = QVector3D::dotProduct(edge1, p);
+    // Comparisons are written so that non-finite values are rejected
+    if (!(qAbs(determinant) > 0.0f))
+        return false;
+
+    const float inverse = 1.0f / determinant;
+    const QVector3D s = origin - a;
+    u = QVector3D::dotProduct(s, p) * inverse;
+    if (!(u >= 0.0f && u <= 1.0f))
+        return false;
+    const QVector3D q = QVector3D::crossProduct(s, edge1);
+    v = QVector3D::dotProduct(direction, q) * inverse;
+    if (!(v >= 0.0f && u + v <= 1.0f))
+        return false;
+    t = QVector3D::dotProduct(edge2, q) * inverse;
+    return t >= 0.0f;
+}
+
+SurfaceQuadTree::SurfaceQuadTree()
+    : m_dirty(true)
+{
+}
+
+void SurfaceQuadTree::invalidate()
+{
+    m_dirty = true;
+}
+
+bool SurfaceQuadTree::intersect(SurfaceObject &object, bool mainDiagonal,
+                                const QVector3D &origin, const QVector3D &direction,
+                                float &distance, int &row, int &column)
+{
+    if (m_dirty)
+        build(object);
+    if (m_nodes.isEmpty())
+        return false;
+
+    distance = std::numeric_limits<float>::max();
+    QVector2D hitPosition;
+    bool found = false;
+    QList<int> stack;
+    stack.append(0);
+    while (!stack.isEmpty()) {
+        const Node &node = m_nodes.at(stack.takeLast());
+        float tNear;
+        if (node.minBounds.x() > node.maxBounds.x()
+                || !intersectBox(node.minBounds, node.maxBounds, origin, direction, tNear)
+                || tNear > distance) {
+            continue;
+        }
+
+        if (node.children[0] != -1) {
+            for (int child : node.children) {
+                if (child != -1)
+                    stack.append(child);
+            }
+            continue;
+        }
+
+        for (int y = node.y; y < node.y + node.height; y++) {
+            for (int x = node.x; x < node.x + node.width; x++) {
+                // Corners of the cell in grid and in world coordinates
+                const QVector2D grid[4] = {QVector2D(x, y), QVector2D(x + 1, y),
+                                           QVector2D(x, y + 1), QVector2D(x + 1, y + 1)};
+                const QVector3D corners[4] = {object.vertexAt(x, y), object.vertexAt(x + 1, y),
+                                              object.vertexAt(x, y + 1),
+                                              object.vertexAt(x + 1, y + 1)};
+                static const int mainTriangles[2][3] = {{0, 2, 3}, {0, 3, 1}};
+                static const int otherTriangles[2][3] = {{1, 2, 0}, {3, 2, 1}};
+                const int (*triangles)[3] = mainDiagonal ? mainTriangles : otherTriangles;
+                for (int i = 0; i < 2; i++) {
+                    const int *triangle = triangles[i];
+                    float t;
+                    float u;
+                    float v;
+                    if (intersectTriangle(origin, direction, corners[triangle[0]],
+                                          corners[triangle[1]], corners[triangle[2]], t, u, v)
+                            && t < distance) {
+                        distance = t;
+                        hitPosition = grid[triangle[0]] * (1.0f - u - v)
+                                + grid[triangle[1]] * u + grid[triangle[2]] * v;
+                        found = true;
+                    }
+                }
+            }
+        }
+    }
+
+    if (found) {
+        // Each vertex owns the quarters of the adjacent cells closest to it
+        column = qBound(0, int(hitPosition.x() + 0.5f), object.columns() - 1);
+        row = qBound(0, int(hitPosition.y() + 0.5f), object.rows() - 1);
+    }
+    return found;
+}
+
+void SurfaceQuadTree::build(SurfaceObject &object)
+{
+    m_nodes.clear();
+    m_dirty = false;
+    if (object.columns() < 2 || object.rows() < 2)
+        return;
+
+    buildNode(object, 0, 0, object.columns() - 1, object.rows() - 1);
+}
+
+int SurfaceQuadTree::buildNode(SurfaceObject &object, int x, int y, int width, int height)
+{
+    const int index = m_nodes.size();
+    m_nodes.append(Node());
+
+    Node node;
+    node.x = x;
+    node.y = y;
+    node.width = width;
+    node.height = height;
+    node.minBounds = QVector3D(std::numeric_limits<float>::max(),
+                               std::numeric_limits<float>::max(),
+                               std::numeric_limits<float>::max());
+    node.maxBounds = -node.minBounds;
+    for (int &child : node.children)
+        child = -1;
+
+    if (width <= leafCellCount && height <= leafCellCount) {
+        for (int row = y; row <= y + height; row++) {
+            for (int column = x; column <= x + width; column++) {
+                const QVector3D vertex = object.vertexAt(column, row);
+                if (!isFinite(vertex))
+                    continue;
+                for (int axis = 0; axis < 3; axis++) {
+                    node.minBounds[axis] = qMin(node.minBounds[axis], vertex[axis]);
+                    node.maxBounds[axis] = qMax(node.maxBounds[axis], vertex[axis]);
+                }
+            }
+        }
+    } else {
+        // Split the sides that are longer than a leaf in half
+        const int leftWidth = (width > leafCellCount) ? width / 2 : width;
+        const int bottomHeight = (height > leafCellCount) ? height / 2 : height;
+        const int widths[2] = {leftWidth, width - leftWidth};
+        const int heights[2] = {bottomHeight, height - bottomHeight};
+        int childCount = 0;
+        for (int i = 0; i < 2; i++) {
+            for (int j = 0; j < 2; j++) {
+                if (!widths[j] || !heights[i])
+                    continue;
+                const int child = buildNode(object, x + j * leftWidth, y + i * bottomHeight,
+                                            widths[j], heights[i]);
+                const Node &childNode = m_nodes.at(child);
+                for (int axis = 0; axis < 3; axis++) {
+                    node.minBounds[axis] = qMin(node.minBounds[axis], childNode.minBounds[axis]);
+                    node.maxBounds[axis] = qMax(node.maxBounds[axis], childNode.maxBounds[axis]);
+                }
+                node.children[childCount++] = child;
+            }
+        }
+    }
+
+    m_nodes[index] = node;
+    return index;
+}
+
+QT_END_NAMESPACE
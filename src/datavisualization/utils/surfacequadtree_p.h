@@ -0,0 +1,62 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the QtDataVisualization API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+
+#ifndef SURFACEQUADTREE_P_H
+#define SURFACEQUADTREE_P_H
+
+#include "datavisualizationglobal_p.h"
+
+QT_BEGIN_NAMESPACE
+
+class SurfaceObject;
+
+// Quadtree of bounding boxes over the cells of a surface grid, used for resolving picked surface
+// points on CPU. Vertices that are not finite are left out of the bounds.
+// The tree is built lazily on first query after invalidate().
+class SurfaceQuadTree
+{
+public:
+    SurfaceQuadTree();
+
+    void invalidate();
+
+    // Finds the nearest intersection of the ray with the triangles of the surface. Cells are split
+    // along the diagonal from the first vertex to the last one if mainDiagonal is true, and along
+    // the other diagonal otherwise. Returns the distance along the ray and the grid position of the
+    // cell corner closest to the intersection.
+    bool intersect(SurfaceObject &object, bool mainDiagonal, const QVector3D &origin,
+                   const QVector3D &direction, float &distance, int &row, int &column);
+
+private:
+    struct Node
+    {
+        QVector3D minBounds;
+        QVector3D maxBounds;
+        // Covered cells
+        int x;
+        int y;
+        int width;
+        int height;
+        int children[4]; // -1 for missing children, all are missing for leaf nodes
+    };
+
+    void build(SurfaceObject &object);
+    int buildNode(SurfaceObject &object, int x, int y, int width, int height);
+
+    QList<Node> m_nodes;
+    bool m_dirty;
+};
+
+QT_END_NAMESPACE
+
+#endif
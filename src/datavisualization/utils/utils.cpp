@@ -8,6 +8,8 @@
 #include <QtGui/QOffscreenSurface>
 #include <QtCore/QCoreApplication>
 #include <QtCore/QRegularExpression>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThreadPool>
 #include <QLocale>
 
 QT_BEGIN_NAMESPACE
@@ -308,6 +310,42 @@ QQuaternion Utils::calculateRotation(const QVector3D &xyzRotations)
     return totalRotation;
 }
 
+// Calls the function for consecutive item ranges of at most chunkSize items, using idle threads
+// of the global thread pool in addition to the calling thread. Returns when all items are done.
+void Utils::parallelFor(int count, int chunkSize,
+                        const std::function<void(int begin, int end)> &function)
+{
+    if (count <= 0)
+        return;
+
+    const int chunkCount = (count + chunkSize - 1) / chunkSize;
+    QThreadPool *pool = QThreadPool::globalInstance();
+    const int workerCount = qMin(chunkCount, pool->maxThreadCount()) - 1;
+    if (workerCount <= 0) {
+        function(0, count);
+        return;
+    }
+
+    QAtomicInt nextChunk(0);
+    auto processChunks = [&]() {
+        for (int chunk = nextChunk.fetchAndAddRelaxed(1); chunk < chunkCount;
+             chunk = nextChunk.fetchAndAddRelaxed(1)) {
+            function(chunk * chunkSize, qMin(count, (chunk + 1) * chunkSize));
+        }
+    };
+
+    // Busy pool threads are not waited for, the calling thread handles the remaining chunks
+    QSemaphore finished;
+    int startedCount = 0;
+    for (int i = 0; i < workerCount; i++) {
+        if (!pool->tryStart([&]() { processChunks(); finished.release(); }))
+            break;
+        startedCount++;
+    }
+    processChunks();
+    finished.acquire(startedCount);
+}
+
 bool Utils::isOpenGLES()
 {
     if (!staticsResolved)
@@ -15,6 +15,7 @@
 #define UTILS_P_H
 
 #include "datavisualizationglobal_p.h"
+#include <functional>
 
 QT_FORWARD_DECLARE_CLASS(QLinearGradient)
 
@@ -54,6 +55,8 @@ public:
 
     static float wrapValue(float value, float min, float max);
     static QQuaternion calculateRotation(const QVector3D &xyzRotations);
+    static void parallelFor(int count, int chunkSize,
+                            const std::function<void(int begin, int end)> &function);
     static bool isOpenGLES();
     static void resolveStatics();
 
@@ -103,7 +103,9 @@ public:
 
     enum OptimizationHint {
         OptimizationDefault = 0,
-        OptimizationStatic  = 1
+        OptimizationStatic  = 1,
+        OptimizationAxisMapping = 2,
+        OptimizationSphereImpostors = 4
     };
     Q_DECLARE_FLAGS(OptimizationHints, OptimizationHint)
 
@@ -20,6 +20,10 @@ private slots:
     void initialProperties();
     void initializeProperties();
 
+    void externalArray();
+    void ringBuffer();
+    void itemColorsAndSizes();
+
 private:
     QScatterDataProxy *m_proxy;
 };
@@ -55,6 +59,8 @@ void tst_proxy::initialProperties()
 
     QCOMPARE(m_proxy->itemCount(), 0);
     QVERIFY(!m_proxy->series());
+    QCOMPARE(m_proxy->ringCapacity(), 0);
+    QCOMPARE(m_proxy->ringHead(), 0);
 
     QCOMPARE(m_proxy->type(), QAbstractDataProxy::DataTypeScatter);
 }
@@ -70,5 +76,164 @@ void tst_proxy::initializeProperties()
     QCOMPARE(m_proxy->itemCount(), 2);
 }
 
+void tst_proxy::externalArray()
+{
+    QVERIFY(m_proxy);
+
+    const float xValues[] = { 0.5f, -0.3f, 1.0f };
+    const float yValues[] = { 0.5f, -0.5f, 2.0f };
+    const float zValues[] = { 0.5f, -0.4f, 3.0f };
+    const QQuaternion rotations[] = { QQuaternion(), QQuaternion(0.0f, 1.0f, 0.0f, 0.0f),
+                                      QQuaternion() };
+
+    QSignalSpy resetSpy(m_proxy, &QScatterDataProxy::arrayReset);
+    m_proxy->resetArray(3, xValues, yValues, zValues, rotations);
+
+    QCOMPARE(resetSpy.size(), 1);
+    QVERIFY(m_proxy->hasExternalArray());
+    QCOMPARE(m_proxy->itemCount(), 3);
+    QCOMPARE(m_proxy->item(1).position(), QVector3D(-0.3f, -0.5f, -0.4f));
+    QCOMPARE(m_proxy->item(1).rotation(), QQuaternion(0.0f, 1.0f, 0.0f, 0.0f));
+
+    // There are no items to point to
+    QTest::ignoreMessage(QtWarningMsg,
+                         "Data array is not available while the proxy uses external arrays.");
+    QVERIFY(!m_proxy->array());
+    QTest::ignoreMessage(QtWarningMsg,
+                         "Item pointers are not available while the proxy uses external arrays.");
+    QVERIFY(!m_proxy->itemAt(1));
+
+    // Modifying items copies the external values
+    m_proxy->setItem(0, QScatterDataItem(QVector3D(1.0f, 1.0f, 1.0f)));
+    QVERIFY(!m_proxy->hasExternalArray());
+    QCOMPARE(m_proxy->array()->size(), 3);
+    QCOMPARE(m_proxy->itemAt(0)->position(), QVector3D(1.0f, 1.0f, 1.0f));
+    QCOMPARE(m_proxy->itemAt(2)->position(), QVector3D(1.0f, 2.0f, 3.0f));
+    QCOMPARE(m_proxy->itemAt(1)->rotation(), QQuaternion(0.0f, 1.0f, 0.0f, 0.0f));
+    QCOMPARE(m_proxy->item(1).rotation(), QQuaternion(0.0f, 1.0f, 0.0f, 0.0f));
+
+    m_proxy->resetArray(0, nullptr, nullptr, nullptr);
+    QVERIFY(!m_proxy->hasExternalArray());
+    QCOMPARE(m_proxy->itemCount(), 0);
+}
+
+void tst_proxy::ringBuffer()
+{
+    QVERIFY(m_proxy);
+
+    m_proxy->setRingCapacity(3);
+    QCOMPARE(m_proxy->ringCapacity(), 3);
+
+    QScatterDataArray data;
+    data << QVector3D(0.0f, 0.0f, 0.0f) << QVector3D(1.0f, 1.0f, 1.0f);
+    QCOMPARE(m_proxy->addItems(data), 0);
+    QCOMPARE(m_proxy->itemCount(), 2);
+    QCOMPARE(m_proxy->ringHead(), 0);
+
+    // Items beyond the capacity overwrite the oldest items
+    QSignalSpy addedSpy(m_proxy, &QScatterDataProxy::itemsAdded);
+    QSignalSpy changedSpy(m_proxy, &QScatterDataProxy::itemsChanged);
+    data.clear();
+    data << QVector3D(2.0f, 2.0f, 2.0f) << QVector3D(3.0f, 3.0f, 3.0f)
+         << QVector3D(4.0f, 4.0f, 4.0f);
+    QCOMPARE(m_proxy->addItems(data), 2);
+    QCOMPARE(m_proxy->itemCount(), 3);
+    QCOMPARE(m_proxy->ringHead(), 2);
+    QCOMPARE(addedSpy.size(), 1);
+    QCOMPARE(addedSpy.at(0).at(0).toInt(), 2);
+    QCOMPARE(addedSpy.at(0).at(1).toInt(), 1);
+    QCOMPARE(changedSpy.size(), 1);
+    QCOMPARE(changedSpy.at(0).at(0).toInt(), 0);
+    QCOMPARE(changedSpy.at(0).at(1).toInt(), 2);
+    QCOMPARE(m_proxy->itemAt(0)->x(), 3.0f);
+    QCOMPARE(m_proxy->itemAt(1)->x(), 4.0f);
+    QCOMPARE(m_proxy->itemAt(2)->x(), 2.0f);
+
+    // Writes wrap around at the end of the array
+    changedSpy.clear();
+    data.clear();
+    data << QVector3D(5.0f, 5.0f, 5.0f) << QVector3D(6.0f, 6.0f, 6.0f);
+    QCOMPARE(m_proxy->addItems(data), 2);
+    QCOMPARE(m_proxy->ringHead(), 1);
+    QCOMPARE(changedSpy.size(), 2);
+    QCOMPARE(changedSpy.at(0).at(0).toInt(), 2);
+    QCOMPARE(changedSpy.at(1).at(0).toInt(), 0);
+    QCOMPARE(m_proxy->itemAt(0)->x(), 6.0f);
+    QCOMPARE(m_proxy->itemAt(2)->x(), 5.0f);
+
+    QCOMPARE(m_proxy->addItem(QScatterDataItem(QVector3D(7.0f, 7.0f, 7.0f))), 1);
+    QCOMPARE(m_proxy->ringHead(), 2);
+
+    // Shrinking the capacity keeps the newest items in order
+    m_proxy->setRingCapacity(2);
+    QCOMPARE(m_proxy->itemCount(), 2);
+    QCOMPARE(m_proxy->ringHead(), 0);
+    QCOMPARE(m_proxy->itemAt(0)->x(), 6.0f);
+    QCOMPARE(m_proxy->itemAt(1)->x(), 7.0f);
+
+    m_proxy->setRingCapacity(0);
+    m_proxy->addItems(data);
+    QCOMPARE(m_proxy->itemCount(), 4);
+}
+
+void tst_proxy::itemColorsAndSizes()
+{
+    QVERIFY(m_proxy);
+
+    QScatterDataArray data;
+    data << QVector3D(0.0f, 0.0f, 0.0f) << QVector3D(1.0f, 1.0f, 1.0f)
+         << QVector3D(2.0f, 2.0f, 2.0f);
+    m_proxy->resetArray(new QScatterDataArray(data));
+
+    QSignalSpy resetSpy(m_proxy, &QScatterDataProxy::arrayReset);
+    QSignalSpy changedSpy(m_proxy, &QScatterDataProxy::itemsChanged);
+
+    // Only the items covered by the styles change
+    m_proxy->setItemColors({ qRgb(255, 0, 0), qRgb(0, 255, 0), qRgb(0, 0, 255) });
+    m_proxy->setItemSizes({ 0.5f, 1.0f });
+    QCOMPARE(resetSpy.size(), 0);
+    QCOMPARE(changedSpy.size(), 2);
+    QCOMPARE(changedSpy.at(0).at(0).toInt(), 0);
+    QCOMPARE(changedSpy.at(0).at(1).toInt(), 3);
+    QCOMPARE(changedSpy.at(1).at(0).toInt(), 0);
+    QCOMPARE(changedSpy.at(1).at(1).toInt(), 2);
+    QCOMPARE(m_proxy->itemColors().size(), 3);
+    QCOMPARE(m_proxy->itemColors().at(1), qRgb(0, 255, 0));
+    QCOMPARE(m_proxy->itemSizes(), QList<float>({ 0.5f, 1.0f }));
+
+    m_proxy->setItemSize(2, 0.25f);
+    QCOMPARE(changedSpy.size(), 3);
+    QCOMPARE(changedSpy.at(2).at(0).toInt(), 2);
+    QCOMPARE(m_proxy->itemSizes(), QList<float>({ 0.5f, 1.0f, 0.25f }));
+
+    // Invalid values are ignored
+    QTest::ignoreMessage(QtWarningMsg, "Invalid index. Item color index is out of range.");
+    m_proxy->setItemColor(3, qRgb(0, 0, 0));
+    QTest::ignoreMessage(QtWarningMsg, "Invalid size. Valid range for item size is 0.0f...1.0f");
+    m_proxy->setItemSize(0, -1.0f);
+    QTest::ignoreMessage(QtWarningMsg, "Invalid size. Valid range for item size is 0.0f...1.0f");
+    m_proxy->setItemSizes({ 0.5f, 2.0f });
+    QCOMPARE(changedSpy.size(), 3);
+    QCOMPARE(m_proxy->itemSizes(), QList<float>({ 0.5f, 1.0f, 0.25f }));
+
+    // Styles follow inserted and removed items
+    m_proxy->insertItem(1, QScatterDataItem(QVector3D(3.0f, 3.0f, 3.0f)));
+    QCOMPARE(m_proxy->itemColors(),
+             QList<QRgb>({ qRgb(255, 0, 0), 0, qRgb(0, 255, 0), qRgb(0, 0, 255) }));
+    QCOMPARE(m_proxy->itemSizes(), QList<float>({ 0.5f, 0.0f, 1.0f, 0.25f }));
+    m_proxy->removeItems(0, 2);
+    QCOMPARE(m_proxy->itemColors(), QList<QRgb>({ qRgb(0, 255, 0), qRgb(0, 0, 255) }));
+    QCOMPARE(m_proxy->itemSizes(), QList<float>({ 1.0f, 0.25f }));
+
+    // Overwritten ring buffer items lose their styles
+    m_proxy->setRingCapacity(2);
+    m_proxy->addItem(QScatterDataItem(QVector3D(4.0f, 4.0f, 4.0f)));
+    QCOMPARE(m_proxy->itemColors(), QList<QRgb>({ 0, qRgb(0, 0, 255) }));
+    QCOMPARE(m_proxy->itemSizes(), QList<float>({ 0.0f, 0.25f }));
+
+    m_proxy->setItemColors(QList<QRgb>());
+    QVERIFY(m_proxy->itemColors().isEmpty());
+}
+
 QTEST_MAIN(tst_proxy)
 #include "tst_proxy.moc"
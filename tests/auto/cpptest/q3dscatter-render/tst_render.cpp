@@ -0,0 +1,1163 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtTest/QtTest>
+
+#include <QtCore/QLineF>
+#include <QtCore/QRandomGenerator>
+#include <QtDataVisualization/Q3DCamera>
+#include <QtDataVisualization/QLogValue3DAxisFormatter>
+#include <QtDataVisualization/QScatter3DSeries>
+#include <QtDataVisualization/QValue3DAxis>
+#include <QtGui/QOffscreenSurface>
+#include <QtGui/QOpenGLContext>
+#include <QtGui/QOpenGLExtraFunctions>
+#include <QtOpenGL/QOpenGLFramebufferObject>
+
+#include <private/chunkbounds_p.h>
+#include <private/scatter3dcontroller_p.h>
+#include <private/scatter3drenderer_p.h>
+#include <private/scatterdensitybufferhelper_p.h>
+#include <private/scatterinstancebufferhelper_p.h>
+#include <private/scatteritembvh_p.h>
+#include <private/scatterobjectbufferhelper_p.h>
+#include <private/scatterpointbufferhelper_p.h>
+#include <private/scatterseriesrendercache_p.h>
+#include <private/streamingbuffer_p.h>
+
+#include "cpptestutil.h"
+
+// Gives access to the renderer the controller creates
+class TestController : public Scatter3DController
+{
+public:
+    TestController() : Scatter3DController(QRect(0, 0, 400, 400)) {}
+
+    Scatter3DRenderer *renderer() const { return static_cast<Scatter3DRenderer *>(m_renderer); }
+};
+
+class tst_render: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void cleanup();
+
+    void instancedDrawing();
+    void parallelRenderItems_data();
+    void parallelRenderItems();
+    void axisMapping();
+    void sphereImpostors();
+    void visibilityInPlace_data();
+    void visibilityInPlace();
+    void staticItemSize();
+    void spliceItems_data();
+    void spliceItems();
+    void pickItems();
+    void frustumCulling_data();
+    void frustumCulling();
+    void streamedPointSpans();
+
+    void densityBinning();
+    void densityParallelBinning();
+    void densitySplice();
+
+private:
+    void createController();
+    void deleteController();
+    void disableInstancing();
+    static QScatterDataArray *createArray(int count);
+    QScatter3DSeries *addSeries(QScatterDataArray *array);
+    ScatterSeriesRenderCache *renderCache(QScatter3DSeries *series) const;
+    QList<QVector3D> translations(QScatter3DSeries *series) const;
+    QVector3D shaderMappedPosition(const QVector3D &value, bool &outsideRanges) const;
+    bool canReadBuffers() const;
+    template <typename T>
+    QList<T> bufferContents(GLuint buffer, int first, int count) const;
+    void compareInstances(ScatterSeriesRenderCache *cache) const;
+    QImage renderImage();
+    static int dominantPixels(const QImage &image, int channel,
+                              QList<QPoint> *positions = nullptr);
+    static int darkerPixels(const QImage &image, const QImage &other);
+    static void compareDensity(const ScatterDensityBufferHelper &actual,
+                               const ScatterDensityBufferHelper &expected);
+
+    QOffscreenSurface *m_surface;
+    QOpenGLContext *m_context;
+    TestController *m_controller;
+};
+
+void tst_render::initTestCase()
+{
+    if (!CpptestUtil::isOpenGLSupported())
+        QSKIP("OpenGL not supported on this platform");
+}
+
+void tst_render::cleanupTestCase()
+{
+}
+
+void tst_render::init()
+{
+    m_surface = new QOffscreenSurface();
+    m_surface->create();
+    m_context = new QOpenGLContext();
+    QVERIFY(m_context->create());
+    QVERIFY(m_context->makeCurrent(m_surface));
+
+    createController();
+}
+
+void tst_render::cleanup()
+{
+    deleteController();
+    m_context->doneCurrent();
+    delete m_context;
+    delete m_surface;
+}
+
+void tst_render::createController()
+{
+    m_controller = new TestController();
+    m_controller->initializeOpenGL();
+    m_controller->setShadowQuality(QAbstract3DGraph::ShadowQualityNone);
+    m_controller->activeTheme()->setSingleHighlightColor(Qt::blue);
+    static_cast<QValue3DAxis *>(m_controller->axisX())->setRange(-10.0f, 10.0f);
+    static_cast<QValue3DAxis *>(m_controller->axisY())->setRange(-10.0f, 10.0f);
+    static_cast<QValue3DAxis *>(m_controller->axisZ())->setRange(-10.0f, 10.0f);
+}
+
+void tst_render::deleteController()
+{
+    const QList<QScatter3DSeries *> seriesList = m_controller->scatterSeriesList();
+    for (QScatter3DSeries *series : seriesList) {
+        m_controller->removeSeries(series);
+        delete series;
+    }
+    delete m_controller;
+    m_controller = nullptr;
+}
+
+// Recreates the controller with a renderer that draws each item separately, the same way
+// as on contexts without instanced arrays
+void tst_render::disableInstancing()
+{
+    deleteController();
+    qputenv("QT_DATAVIS_NO_INSTANCING", "1");
+    createController();
+    qunsetenv("QT_DATAVIS_NO_INSTANCING");
+}
+
+// Items at fixed pseudo random positions within the axis ranges
+QScatterDataArray *tst_render::createArray(int count)
+{
+    QRandomGenerator generator(count);
+    QScatterDataArray *array = new QScatterDataArray(count);
+    for (QScatterDataItem &item : *array) {
+        item.setPosition(QVector3D(float(generator.bounded(20.0) - 10.0),
+                                   float(generator.bounded(20.0) - 10.0),
+                                   float(generator.bounded(20.0) - 10.0)));
+    }
+    return array;
+}
+
+// Adds a red series and synchronizes it to the renderer
+QScatter3DSeries *tst_render::addSeries(QScatterDataArray *array)
+{
+    QScatter3DSeries *series = new QScatter3DSeries();
+    series->setBaseColor(Qt::red);
+    series->dataProxy()->resetArray(array);
+    m_controller->addSeries(series);
+    m_controller->synchDataToRenderer();
+    return series;
+}
+
+ScatterSeriesRenderCache *tst_render::renderCache(QScatter3DSeries *series) const
+{
+    return static_cast<ScatterSeriesRenderCache *>(
+            m_controller->renderer()->renderCache(series));
+}
+
+// Translations of the render items, null for hidden items
+QList<QVector3D> tst_render::translations(QScatter3DSeries *series) const
+{
+    QList<QVector3D> result;
+    const ScatterRenderItemArray &renderArray = renderCache(series)->renderArray();
+    result.reserve(renderArray.size());
+    for (const ScatterRenderItem &item : renderArray)
+        result.append(item.isVisible() ? item.translation() : QVector3D());
+    return result;
+}
+
+// Maps a data value the same way as mapPosition() in the instanced vertex shaders of
+// Cartesian graphs, from the same parameters as the uniforms
+QVector3D tst_render::shaderMappedPosition(const QVector3D &value, bool &outsideRanges) const
+{
+    const Scatter3DRenderer *renderer = m_controller->renderer();
+    const AxisRenderCache *axisCaches[3] = {&renderer->axisCacheX(), &renderer->axisCacheY(),
+                                            &renderer->axisCacheZ()};
+    QVector3D position;
+    outsideRanges = false;
+    for (int axis = 0; axis < 3; axis++) {
+        bool logarithmic = false;
+        float offset = 0.0f;
+        float normalizer = 1.0f;
+        float scale = 1.0f;
+        float translate = 0.0f;
+        if (!axisCaches[axis]->shaderMapping(logarithmic, offset, normalizer, scale, translate))
+            return QVector3D();
+        const float mapped = logarithmic ? qLn(qMax(value[axis], 1.0e-30f)) : value[axis];
+        position[axis] = (mapped - offset) / normalizer * scale + translate;
+        if (value[axis] < axisCaches[axis]->min() || value[axis] > axisCaches[axis]->max())
+            outsideRanges = true;
+    }
+    return position;
+}
+
+// Mapping buffers for reading needs OpenGL 3.0 or OpenGL ES 3.0
+bool tst_render::canReadBuffers() const
+{
+    return m_context->format().majorVersion() >= 3;
+}
+
+// Reads back count elements of a buffer, starting from element first
+template <typename T>
+QList<T> tst_render::bufferContents(GLuint buffer, int first, int count) const
+{
+    QOpenGLExtraFunctions *functions = m_context->extraFunctions();
+    QList<T> contents(count);
+    functions->glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+    const void *data = functions->glMapBufferRange(GL_COPY_READ_BUFFER, first * sizeof(T),
+                                                   count * sizeof(T), GL_MAP_READ_BIT);
+    if (data) {
+        memcpy(contents.data(), data, count * sizeof(T));
+        functions->glUnmapBuffer(GL_COPY_READ_BUFFER);
+    } else {
+        contents.clear();
+    }
+    functions->glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    return contents;
+}
+
+// Instance buffers hold the translation and combined rotation of each item at its render array
+// index, hidden items with a negative gradient coordinate
+void tst_render::compareInstances(ScatterSeriesRenderCache *cache) const
+{
+    ScatterInstanceBufferHelper *instances = cache->bufferInstances();
+    QVERIFY(instances);
+    const ScatterRenderItemArray &renderArray = cache->renderArray();
+    const int count = renderArray.size();
+    QCOMPARE(int(instances->indexCount()), count);
+
+    const QList<QVector4D> positions =
+            bufferContents<QVector4D>(instances->positionBuf(), 0, count);
+    const QList<QVector4D> rotations =
+            bufferContents<QVector4D>(instances->rotationBuf(), 0, count);
+    QCOMPARE(positions.size(), count);
+    QCOMPARE(rotations.size(), count);
+    for (int i = 0; i < count; i++) {
+        const ScatterRenderItem &item = renderArray.at(i);
+        if (item.isVisible()) {
+            QCOMPARE(positions.at(i).toVector3D(), item.translation());
+            QCOMPARE(positions.at(i).w(), 0.0f);
+        } else {
+            QVERIFY(positions.at(i).w() < 0.0f);
+        }
+        QCOMPARE(rotations.at(i), (cache->meshRotation() * item.rotation()).toVector4D());
+    }
+}
+
+// Renders the graph the same way as QAbstract3DGraph::renderToImage()
+QImage tst_render::renderImage()
+{
+    QOpenGLFramebufferObjectFormat format;
+    format.setAttachment(QOpenGLFramebufferObject::CombinedDepthStencil);
+    QOpenGLFramebufferObject fbo(m_controller->scene()->viewport().size(), format);
+    if (!fbo.isValid())
+        return QImage();
+    m_controller->synchDataToRenderer();
+    fbo.bind();
+    m_controller->requestRender(&fbo);
+    const QImage image = fbo.toImage();
+    fbo.release();
+    return image;
+}
+
+// Number of pixels where the given color channel clearly dominates the other two, optionally
+// collecting their positions
+int tst_render::dominantPixels(const QImage &image, int channel, QList<QPoint> *positions)
+{
+    int count = 0;
+    for (int y = 0; y < image.height(); y++) {
+        for (int x = 0; x < image.width(); x++) {
+            const QRgb color = image.pixel(x, y);
+            const int channels[3] = {qRed(color), qGreen(color), qBlue(color)};
+            bool dominant = true;
+            for (int other = 0; other < 3; other++) {
+                if (other != channel && channels[channel] <= 2 * channels[other] + 32)
+                    dominant = false;
+            }
+            if (dominant) {
+                count++;
+                if (positions)
+                    positions->append(QPoint(x, y));
+            }
+        }
+    }
+    return count;
+}
+
+// Number of grayish pixels that are clearly darker than in the other image, such as shadows
+// cast on the background
+int tst_render::darkerPixels(const QImage &image, const QImage &other)
+{
+    int count = 0;
+    for (int y = 0; y < image.height(); y++) {
+        for (int x = 0; x < image.width(); x++) {
+            const QRgb color = image.pixel(x, y);
+            const int saturation = qMax(qRed(color), qMax(qGreen(color), qBlue(color)))
+                    - qMin(qRed(color), qMin(qGreen(color), qBlue(color)));
+            if (saturation < 32 && qGray(color) < qGray(other.pixel(x, y)) - 32)
+                count++;
+        }
+    }
+    return count;
+}
+
+void tst_render::compareDensity(const ScatterDensityBufferHelper &actual,
+                                const ScatterDensityBufferHelper &expected)
+{
+    const int resolution = expected.resolution();
+    QCOMPARE(actual.resolution(), resolution);
+    for (int z = 0; z < resolution; z++) {
+        for (int y = 0; y < resolution; y++) {
+            for (int x = 0; x < resolution; x++)
+                QCOMPARE(actual.itemCount(x, y, z), expected.itemCount(x, y, z));
+        }
+    }
+    QCOMPARE(actual.indexCount(), expected.indexCount());
+}
+
+void tst_render::instancedDrawing()
+{
+    if (!ScatterInstanceBufferHelper::isSupported())
+        QSKIP("Instanced drawing not supported by the context");
+
+    auto addRotatedSeries = [this]() {
+        QScatterDataArray *array = createArray(200);
+        // Outside the axis ranges
+        (*array)[10].setPosition(QVector3D(0.0f, 20.0f, 0.0f));
+        (*array)[20].setRotation(QQuaternion::fromAxisAndAngle(0.0f, 1.0f, 0.0f, 45.0f));
+        QScatter3DSeries *series = addSeries(array);
+        series->setMesh(QAbstract3DSeries::MeshCube);
+        series->setItemSize(0.1f);
+        series->setMeshRotation(QQuaternion::fromAxisAndAngle(1.0f, 0.0f, 0.0f, 30.0f));
+        m_controller->synchDataToRenderer();
+        return series;
+    };
+
+    QScatter3DSeries *series = addRotatedSeries();
+    ScatterSeriesRenderCache *cache = renderCache(series);
+    QVERIFY(cache);
+    QVERIFY(!cache->renderArray().at(10).isVisible());
+
+    // One instance per item, hidden or not
+    compareInstances(cache);
+    QCOMPARE(cache->bufferInstances()->indexCount(), GLuint(200));
+
+    // Changed items are updated in place
+    const GLuint positionBuffer = cache->bufferInstances()->positionBuf();
+    const QScatterDataItem original = *series->dataProxy()->itemAt(30);
+    series->dataProxy()->setItem(30, QScatterDataItem(QVector3D(1.0f, 2.0f, 3.0f)));
+    m_controller->synchDataToRenderer();
+    QCOMPARE(cache->bufferInstances()->positionBuf(), positionBuffer);
+    compareInstances(cache);
+    series->dataProxy()->setItem(30, original);
+
+    const QImage image = renderImage();
+    QVERIFY(!image.isNull());
+    const int itemPixels = dominantPixels(image, 0);
+    QVERIFY(itemPixels > 500);
+
+    // Instanced depth pass casts the shadows of the items
+    m_controller->setShadowQuality(QAbstract3DGraph::ShadowQualityMedium);
+    series->setVisible(false);
+    const QImage background = renderImage();
+    series->setVisible(true);
+    const QImage shadowed = renderImage();
+    const bool shadowsSupported =
+            (m_controller->shadowQuality() == QAbstract3DGraph::ShadowQualityMedium);
+    const int shadowPixels = shadowsSupported ? darkerPixels(shadowed, background) : 0;
+    if (shadowsSupported)
+        QVERIFY(shadowPixels > 100);
+
+    // Items drawn one at a time cover the same pixels and cast the same shadows
+    disableInstancing();
+    series = addRotatedSeries();
+    cache = renderCache(series);
+    QVERIFY(!cache->bufferInstances());
+    const QImage separate = renderImage();
+    QVERIFY(qAbs(dominantPixels(separate, 0) - itemPixels) < itemPixels / 20);
+    if (shadowsSupported) {
+        m_controller->setShadowQuality(QAbstract3DGraph::ShadowQualityMedium);
+        series->setVisible(false);
+        const QImage separateBackground = renderImage();
+        series->setVisible(true);
+        const int separateShadowPixels = darkerPixels(renderImage(), separateBackground);
+        QVERIFY(qAbs(separateShadowPixels - shadowPixels) < shadowPixels / 10);
+    }
+}
+
+void tst_render::parallelRenderItems_data()
+{
+    QTest::addColumn<bool>("logarithmic");
+    QTest::addColumn<bool>("polar");
+    QTest::addColumn<bool>("reversed");
+
+    QTest::newRow("linear") << false << false << false;
+    QTest::newRow("reversed") << false << false << true;
+    QTest::newRow("logarithmic") << true << false << false;
+    QTest::newRow("polar") << false << true << false;
+}
+
+void tst_render::parallelRenderItems()
+{
+    QFETCH(bool, logarithmic);
+    QFETCH(bool, polar);
+    QFETCH(bool, reversed);
+
+    QValue3DAxis *axisX = static_cast<QValue3DAxis *>(m_controller->axisX());
+    QValue3DAxis *axisY = static_cast<QValue3DAxis *>(m_controller->axisY());
+    axisX->setRange(-3.5f, 12.0f);
+    axisX->setReversed(reversed);
+    if (logarithmic) {
+        axisY->setFormatter(new QLogValue3DAxisFormatter());
+        axisY->setRange(0.1f, 10.0f);
+    }
+    m_controller->setPolar(polar);
+
+    // Enough items for several chunks
+    const int itemCount = 100000;
+    QThreadPool *pool = QThreadPool::globalInstance();
+    const int maxThreadCount = pool->maxThreadCount();
+    pool->setMaxThreadCount(1);
+    QScatter3DSeries *series = addSeries(createArray(itemCount));
+    const QList<QVector3D> serial = translations(series);
+    pool->setMaxThreadCount(4);
+    series->dataProxy()->resetArray(createArray(itemCount));
+    m_controller->synchDataToRenderer();
+    const QList<QVector3D> parallel = translations(series);
+    pool->setMaxThreadCount(maxThreadCount);
+
+    QCOMPARE(parallel.size(), itemCount);
+    QCOMPARE(parallel, serial);
+
+    // Translations are the same as the formatters give
+    if (polar)
+        return;
+    const Scatter3DRenderer *renderer = m_controller->renderer();
+    const ScatterRenderItemArray &renderArray = renderCache(series)->renderArray();
+    int visibleCount = 0;
+    for (const ScatterRenderItem &item : renderArray) {
+        if (!item.isVisible())
+            continue;
+        visibleCount++;
+        const QVector3D &position = item.position();
+        QCOMPARE(item.translation().x(), renderer->axisCacheX().positionAt(position.x()));
+        QCOMPARE(item.translation().y(), renderer->axisCacheY().positionAt(position.y()));
+        QCOMPARE(item.translation().z(), renderer->axisCacheZ().positionAt(position.z()));
+    }
+    QVERIFY(visibleCount > 0);
+}
+
+void tst_render::axisMapping()
+{
+    if (!ScatterInstanceBufferHelper::isSupported())
+        QSKIP("Instanced drawing not supported by the context");
+
+    const Scatter3DRenderer *renderer = m_controller->renderer();
+    m_controller->setOptimizationHints(QAbstract3DGraph::OptimizationDefault
+                                       | QAbstract3DGraph::OptimizationAxisMapping);
+    QValue3DAxis *axisX = static_cast<QValue3DAxis *>(m_controller->axisX());
+    QValue3DAxis *axisY = static_cast<QValue3DAxis *>(m_controller->axisY());
+    QValue3DAxis *axisZ = static_cast<QValue3DAxis *>(m_controller->axisZ());
+    axisX->setRange(-3.5f, 12.0f);
+    axisY->setRange(-8.0f, 7.0f);
+    axisY->setReversed(true);
+    axisZ->setFormatter(new QLogValue3DAxisFormatter());
+    axisZ->setRange(0.5f, 10.0f);
+    QScatter3DSeries *series = addSeries(createArray(1000));
+    ScatterSeriesRenderCache *cache = renderCache(series);
+    QVERIFY(cache);
+    ScatterInstanceBufferHelper *instances = cache->bufferInstances();
+    QVERIFY(instances);
+    QVERIFY(instances->rawPositions());
+
+    // Instance positions are the data values of all items, including the ones outside the
+    // axis ranges
+    QCOMPARE(instances->instanceCount(), GLuint(1000));
+    const QList<QVector4D> positions = bufferContents<QVector4D>(instances->positionBuf(), 0,
+                                                                 1000);
+    QCOMPARE(positions.size(), 1000);
+    for (int i = 0; i < 1000; i++)
+        QCOMPARE(positions.at(i), QVector4D(series->dataProxy()->itemAt(i)->position(), 0.0f));
+
+    // Range changes only mark the translations on CPU outdated, and leave the buffers as they are
+    axisX->setRange(-2.0f, 9.5f);
+    m_controller->synchDataToRenderer();
+    QVERIFY(cache->translationsDirty());
+    QVERIFY(!cache->dataDirty());
+    QCOMPARE(bufferContents<QVector4D>(instances->positionBuf(), 0, 1000), positions);
+
+    // Picking needs the translations
+    m_controller->scene()->setSelectionQueryPosition(QPoint(200, 200));
+    QVERIFY(!renderImage().isNull());
+    QVERIFY(!cache->translationsDirty());
+
+    // Data values uploaded as instance positions are mapped in the shaders to the same
+    // translations as on CPU
+    LinearAxisMapping mappingX;
+    LinearAxisMapping mappingY;
+    LinearAxisMapping mappingZ;
+    QVERIFY(renderer->axisCacheX().linearMapping(mappingX));
+    QVERIFY(renderer->axisCacheY().linearMapping(mappingY));
+    // Logarithmic axes are mapped through the formatter on CPU
+    QVERIFY(!renderer->axisCacheZ().linearMapping(mappingZ));
+    int visibleCount = 0;
+    for (const ScatterRenderItem &item : cache->renderArray()) {
+        const QVector3D &value = item.position();
+        bool outsideRanges = false;
+        const QVector3D mapped = shaderMappedPosition(value, outsideRanges);
+        QCOMPARE(outsideRanges, !item.isVisible());
+        if (outsideRanges)
+            continue;
+        visibleCount++;
+        QVERIFY(qAbs(mapped.x() - mappingX.positionAt(value.x())) < 1.0e-5f);
+        QVERIFY(qAbs(mapped.y() - mappingY.positionAt(value.y())) < 1.0e-5f);
+        QVERIFY((mapped - item.translation()).length() < 1.0e-5f);
+    }
+    QVERIFY(visibleCount > 0);
+void tst_render::sphereImpostors()
+{
+    if (!ScatterInstanceBufferHelper::isSupported() || m_context->isOpenGLES())
+        QSKIP("Sphere impostors not supported by the context");
+
+    const Scatter3DRenderer *renderer = m_controller->renderer();
+    QScatter3DSeries *series = addSeries(new QScatterDataArray(
+            1, QScatterDataItem(QVector3D(0.0f, 0.0f, 0.0f))));
+    series->setMesh(QAbstract3DSeries::MeshSphere);
+    series->setItemSize(0.3f);
+    // Cube that intersects the sphere, so that the depth of both decides which one is seen
+    QScatter3DSeries *occluder = addSeries(new QScatterDataArray(
+            1, QScatterDataItem(QVector3D(1.5f, 0.5f, 1.5f))));
+    occluder->setBaseColor(Qt::green);
+    occluder->setMesh(QAbstract3DSeries::MeshCube);
+    occluder->setItemSize(0.3f);
+    ScatterSeriesRenderCache *cache = renderCache(series);
+    QVERIFY(cache);
+
+    auto renderBoth = [this, occluder](QImage &alone, QImage &occluded) {
+        occluder->setVisible(false);
+        alone = renderImage();
+        occluder->setVisible(true);
+        occluded = renderImage();
+    };
+
+    QImage meshAlone;
+    QImage meshOccluded;
+    renderBoth(meshAlone, meshOccluded);
+    QVERIFY(!meshAlone.isNull());
+    QVERIFY(!renderer->isDrawnAsImpostors(cache));
+
+    m_controller->setOptimizationHints(QAbstract3DGraph::OptimizationDefault
+                                       | QAbstract3DGraph::OptimizationSphereImpostors);
+    QImage impostorAlone;
+    QImage impostorOccluded;
+    renderBoth(impostorAlone, impostorOccluded);
+    QVERIFY(renderer->isDrawnAsImpostors(cache));
+
+    // Impostors cover the same pixels as the sphere mesh, which is slightly smaller than the
+    // sphere it approximates
+    const int meshPixels = dominantPixels(meshAlone, 0);
+    const int impostorPixels = dominantPixels(impostorAlone, 0);
+    QVERIFY(meshPixels > 1000);
+    QVERIFY2(qAbs(impostorPixels - meshPixels) < meshPixels / 10,
+             qPrintable(QStringLiteral("%1 impostor and %2 mesh pixels")
+                        .arg(impostorPixels).arg(meshPixels)));
+
+    // Written fragment depth hides the same parts of the impostor and the mesh occluder as
+    // with the sphere mesh
+    const int meshVisible = dominantPixels(meshOccluded, 0);
+    const int impostorVisible = dominantPixels(impostorOccluded, 0);
+    const int meshOccluderVisible = dominantPixels(meshOccluded, 1);
+    const int impostorOccluderVisible = dominantPixels(impostorOccluded, 1);
+    QVERIFY(meshVisible < meshPixels - meshPixels / 10);
+    QVERIFY(impostorVisible < impostorPixels - impostorPixels / 10);
+    QVERIFY(meshOccluderVisible > 500);
+    QVERIFY2(qAbs(impostorVisible - meshVisible) < meshVisible / 10,
+             qPrintable(QStringLiteral("%1 impostor and %2 mesh pixels visible")
+                        .arg(impostorVisible).arg(meshVisible)));
+    QVERIFY2(qAbs(impostorOccluderVisible - meshOccluderVisible) < meshOccluderVisible / 10,
+             qPrintable(QStringLiteral("%1 and %2 occluder pixels visible")
+                        .arg(impostorOccluderVisible).arg(meshOccluderVisible)));
+
+    // Selected item is highlighted with an impostor that covers the instance
+    series->setSelectedItem(0);
+    const QImage impostorSelected = renderImage();
+    m_controller->setOptimizationHints(QAbstract3DGraph::OptimizationDefault);
+    const QImage meshSelected = renderImage();
+    const int meshHighlight = dominantPixels(meshSelected, 2);
+    const int impostorHighlight = dominantPixels(impostorSelected, 2);
+    QVERIFY(meshHighlight > meshVisible / 2);
+    QVERIFY2(qAbs(impostorHighlight - meshHighlight) < meshHighlight / 10,
+             qPrintable(QStringLiteral("%1 impostor and %2 mesh pixels highlighted")
+                        .arg(impostorHighlight).arg(meshHighlight)));
+    QVERIFY(dominantPixels(impostorSelected, 0) < impostorVisible / 20);
+    series->setSelectedItem(QScatter3DSeries::invalidSelectionIndex());
+
+    // Impostors cast the same shadows as the mesh in the depth pass and are shadowed the same
+    // way in the shadow shaders
+    m_controller->setShadowQuality(QAbstract3DGraph::ShadowQualityMedium);
+    occluder->setVisible(false);
+    series->setVisible(false);
+    const QImage background = renderImage();
+    series->setVisible(true);
+    const QImage meshShadowed = renderImage();
+    if (m_controller->shadowQuality() == QAbstract3DGraph::ShadowQualityMedium) {
+        m_controller->setOptimizationHints(QAbstract3DGraph::OptimizationDefault
+                                           | QAbstract3DGraph::OptimizationSphereImpostors);
+        const QImage impostorShadowed = renderImage();
+        const int meshShadow = darkerPixels(meshShadowed, background);
+        const int impostorShadow = darkerPixels(impostorShadowed, background);
+        QVERIFY(meshShadow > 100);
+        QVERIFY2(qAbs(impostorShadow - meshShadow) < meshShadow / 10,
+                 qPrintable(QStringLiteral("%1 impostor and %2 mesh shadow pixels")
+                            .arg(impostorShadow).arg(meshShadow)));
+        const int meshShadowedPixels = dominantPixels(meshShadowed, 0);
+        QVERIFY(qAbs(dominantPixels(impostorShadowed, 0) - meshShadowedPixels)
+                < meshShadowedPixels / 10);
+    }
+
+    // Only instanced spheres are replaced
+    m_controller->setOptimizationHints(QAbstract3DGraph::OptimizationDefault
+                                       | QAbstract3DGraph::OptimizationSphereImpostors);
+    series->setMesh(QAbstract3DSeries::MeshCube);
+    m_controller->synchDataToRenderer();
+    QVERIFY(!renderer->isDrawnAsImpostors(cache));
+    series->setMesh(QAbstract3DSeries::MeshSphere);
+    m_controller->synchDataToRenderer();
+    QVERIFY(renderer->isDrawnAsImpostors(cache));
+
+    disableInstancing();
+    m_controller->setOptimizationHints(QAbstract3DGraph::OptimizationDefault
+                                       | QAbstract3DGraph::OptimizationSphereImpostors);
+    series = addSeries(new QScatterDataArray(1, QScatterDataItem(QVector3D(0.0f, 0.0f, 0.0f))));
+    series->setMesh(QAbstract3DSeries::MeshSphere);
+    series->setItemSize(0.3f);
+    const QImage separate = renderImage();
+    QVERIFY(!m_controller->renderer()->isDrawnAsImpostors(renderCache(series)));
+    QVERIFY(qAbs(dominantPixels(separate, 0) - meshPixels) < meshPixels / 20);
+}
+
+void tst_render::visibilityInPlace_data()
+{
+    QTest::addColumn<bool>("instanced");
+
+    QTest::newRow("instanced") << true;
+    QTest::newRow("static") << false;
+}
+
+void tst_render::visibilityInPlace()
+{
+    QFETCH(bool, instanced);
+
+    if (instanced && !ScatterInstanceBufferHelper::isSupported())
+        QSKIP("Instanced drawing not supported by the context");
+    if (!canReadBuffers())
+        QSKIP("Buffers cannot be read back on the context");
+    // Static meshes are drawn as a single object when instancing is not available
+    if (!instanced)
+        disableInstancing();
+
+    m_controller->setOptimizationHints(QAbstract3DGraph::OptimizationStatic);
+    QScatterDataArray *array = new QScatterDataArray;
+    array->append(QScatterDataItem(QVector3D(0.0f, 0.0f, 0.0f)));
+    array->append(QScatterDataItem(QVector3D(5.0f, 5.0f, 5.0f)));
+    array->append(QScatterDataItem(QVector3D(-5.0f, -3.0f, 4.0f)));
+    QScatter3DSeries *series = addSeries(array);
+    series->setItemSize(0.3f);
+    ScatterSeriesRenderCache *cache = renderCache(series);
+    QVERIFY(cache);
+    const QImage shown = renderImage();
+    QVERIFY(!shown.isNull());
+    const int shownPixels = dominantPixels(shown, 0);
+    QVERIFY(shownPixels > 500);
+
+    // Static meshes repeat the instance position for each vertex of the item
+    ScatterInstanceBufferHelper *instances = cache->bufferInstances();
+    ScatterObjectBufferHelper *object = cache->bufferObject();
+    GLuint buffer = 0;
+    int itemVertexCount = 1;
+    if (instanced) {
+        QVERIFY(instances);
+        QCOMPARE(instances->instanceCount(), GLuint(3));
+        buffer = instances->positionBuf();
+    } else {
+        QVERIFY(!instances);
+        QVERIFY(object);
+        buffer = object->positionBuf();
+        itemVertexCount = cache->object()->indexedvertices().size();
+    }
+    const QList<QVector4D> positions = bufferContents<QVector4D>(buffer, 0, 3 * itemVertexCount);
+    QCOMPARE(positions.size(), 3 * itemVertexCount);
+
+    // Moving an item outside the axis ranges hides only that item, and the buffers keep a
+    // place for it
+    series->dataProxy()->setItem(1, QScatterDataItem(QVector3D(5.0f, 20.0f, 5.0f)));
+    const QImage hidden = renderImage();
+    QVERIFY(!cache->renderArray().at(1).isVisible());
+    const int hiddenPixels = dominantPixels(hidden, 0);
+    QVERIFY(hiddenPixels > 100);
+    QVERIFY(hiddenPixels < shownPixels - 100);
+    if (instanced) {
+        QCOMPARE(instances->instanceCount(), GLuint(3));
+        QCOMPARE(instances->positionBuf(), buffer);
+    } else {
+        QCOMPARE(cache->oldArraySize(), 3);
+        QCOMPARE(object->positionBuf(), buffer);
+    }
+    const QList<QVector4D> hiddenPositions =
+            bufferContents<QVector4D>(buffer, 0, 3 * itemVertexCount);
+    QCOMPARE(hiddenPositions.mid(0, itemVertexCount), positions.mid(0, itemVertexCount));
+    QCOMPARE(hiddenPositions.mid(2 * itemVertexCount), positions.mid(2 * itemVertexCount));
+    for (int i = itemVertexCount; i < 2 * itemVertexCount; i++)
+        QVERIFY(hiddenPositions.at(i).w() < 0.0f);
+
+    // Moving it back shows it again where it was
+    series->dataProxy()->setItem(1, QScatterDataItem(QVector3D(5.0f, 5.0f, 5.0f)));
+    const QImage restored = renderImage();
+    QVERIFY(cache->renderArray().at(1).isVisible());
+    QCOMPARE(bufferContents<QVector4D>(buffer, 0, 3 * itemVertexCount), positions);
+    QCOMPARE(dominantPixels(restored, 0), shownPixels);
+}
+
+void tst_render::staticItemSize()
+{
+    if (!canReadBuffers())
+        QSKIP("Buffers cannot be read back on the context");
+    disableInstancing();
+
+    m_controller->setOptimizationHints(QAbstract3DGraph::OptimizationStatic);
+    QScatter3DSeries *series = addSeries(createArray(50));
+    series->setItemSize(0.1f);
+    ScatterSeriesRenderCache *cache = renderCache(series);
+    QVERIFY(cache);
+    const QImage small = renderImage();
+    ScatterObjectBufferHelper *object = cache->bufferObject();
+    QVERIFY(object);
+
+    // Vertex buffer holds the unscaled item mesh for each item
+    const QList<QVector3D> &itemVertices = cache->object()->indexedvertices();
+    const int itemVertexCount = itemVertices.size();
+    const GLuint vertexBuffer = object->vertexBuf();
+    const QList<QVector3D> vertices =
+            bufferContents<QVector3D>(vertexBuffer, 0, 50 * itemVertexCount);
+    QCOMPARE(vertices.size(), 50 * itemVertexCount);
+    QCOMPARE(vertices.mid(0, itemVertexCount), itemVertices);
+    QCOMPARE(vertices.mid(49 * itemVertexCount), itemVertices);
+
+    // Item size changes apply in the shader without reloading the mesh
+    series->setItemSize(0.3f);
+    const QImage large = renderImage();
+    QCOMPARE(cache->oldArraySize(), 50);
+    QCOMPARE(object->vertexBuf(), vertexBuffer);
+    QCOMPARE(bufferContents<QVector3D>(vertexBuffer, 0, 50 * itemVertexCount), vertices);
+    const int smallPixels = dominantPixels(small, 0);
+    QVERIFY(smallPixels > 500);
+    QVERIFY(dominantPixels(large, 0) > 4 * smallPixels);
+}
+
+void tst_render::spliceItems_data()
+{
+    QTest::addColumn<bool>("instanced");
+
+    QTest::newRow("instanced") << true;
+    QTest::newRow("static") << false;
+}
+
+void tst_render::spliceItems()
+{
+    QFETCH(bool, instanced);
+
+    if (instanced && !ScatterInstanceBufferHelper::isSupported())
+        QSKIP("Instanced drawing not supported by the context");
+    if (!canReadBuffers())
+        QSKIP("Buffers cannot be read back on the context");
+    if (!instanced)
+        disableInstancing();
+
+    m_controller->setOptimizationHints(QAbstract3DGraph::OptimizationStatic);
+    QScatter3DSeries *series = addSeries(createArray(100));
+    ScatterSeriesRenderCache *cache = renderCache(series);
+    QVERIFY(cache);
+    QVERIFY(!renderImage().isNull());
+    series->setSelectedItem(60);
+    m_controller->synchDataToRenderer();
+
+    // Splices keep the existing render items as they are, so a changed translation survives
+    const QVector3D sentinel(0.125f, 0.25f, 0.5f);
+    cache->renderArray()[50].setTranslation(sentinel);
+    QScatterDataProxy *proxy = series->dataProxy();
+    QScatterDataArray inserted(5, QScatterDataItem(QVector3D(1.0f, 2.0f, 3.0f)));
+    inserted[2].setPosition(QVector3D(-4.0f, 15.0f, -4.0f));
+    proxy->insertItems(10, inserted);
+    proxy->removeItems(30, 3);
+    m_controller->synchDataToRenderer();
+
+    const ScatterRenderItemArray &renderArray = cache->renderArray();
+    QCOMPARE(renderArray.size(), 102);
+    QCOMPARE(series->selectedItem(), 62);
+    QCOMPARE(renderArray.at(52).translation(), sentinel);
+    QVERIFY(!cache->dataDirty());
+    for (int i = 10; i < 15; i++)
+        QCOMPARE(renderArray.at(i).position(), proxy->itemAt(i)->position());
+    QVERIFY(!renderArray.at(12).isVisible());
+
+    // Buffers follow the spliced render array
+    if (instanced) {
+        QCOMPARE(cache->bufferInstances()->instanceCount(), GLuint(102));
+        compareInstances(cache);
+    } else {
+        ScatterObjectBufferHelper *object = cache->bufferObject();
+        QVERIFY(object);
+        QCOMPARE(cache->oldArraySize(), 102);
+        const int itemVertexCount = cache->object()->indexedvertices().size();
+        QCOMPARE(object->indexCount(), GLuint(102 * cache->object()->indices().size()));
+        const QList<QVector4D> positions =
+                bufferContents<QVector4D>(object->positionBuf(), 0, 102 * itemVertexCount);
+        QCOMPARE(positions.size(), 102 * itemVertexCount);
+        for (int i = 0; i < 102; i++) {
+            const QVector4D &position = positions.at(i * itemVertexCount);
+            QCOMPARE(positions.at((i + 1) * itemVertexCount - 1), position);
+            if (renderArray.at(i).isVisible())
+                QCOMPARE(position.toVector3D(), renderArray.at(i).translation());
+            else
+                QVERIFY(position.w() < 0.0f);
+        }
+    }
+
+    // Spliced items are the same as when all items are read from the data
+    QList<QVector3D> spliced = translations(series);
+    proxy->resetArray(new QScatterDataArray(*proxy->array()));
+    m_controller->synchDataToRenderer();
+    const QList<QVector3D> reloaded = translations(series);
+    QVERIFY(reloaded.at(52) != sentinel);
+    spliced[52] = reloaded.at(52);
+    QCOMPARE(reloaded, spliced);
+}
+
+void tst_render::pickItems()
+{
+    QScatter3DSeries *series = addSeries(new QScatterDataArray(3));
+    ScatterSeriesRenderCache *cache = renderCache(series);
+    QVERIFY(cache);
+
+    // Only items in front of the ray origin are candidates
+    ScatterRenderItemArray &renderArray = cache->renderArray();
+    QCOMPARE(renderArray.size(), 3);
+    renderArray[0].setTranslation(QVector3D(0.0f, 0.0f, -5.0f));
+    renderArray[1].setTranslation(QVector3D(0.0f, 0.0f, 5.0f));
+    renderArray[2].setTranslation(QVector3D(0.8f, 0.0f, -5.0f));
+    for (ScatterRenderItem &item : renderArray)
+        item.setVisible(true);
+    ScatterItemBvh bvh;
+    bvh.update(renderArray);
+    QList<int> candidates;
+    bvh.intersect(renderArray, QVector3D(), QVector3D(0.0f, 0.0f, -1.0f), 0.5f, candidates);
+    QCOMPARE(candidates, QList<int>({0}));
+    candidates.clear();
+    bvh.intersect(renderArray, QVector3D(), QVector3D(0.0f, 0.0f, 1.0f), 0.5f, candidates);
+    QCOMPARE(candidates, QList<int>({1}));
+    candidates.clear();
+    bvh.intersect(renderArray, QVector3D(), QVector3D(0.0f, 0.0f, -1.0f), 1.0f, candidates);
+    QCOMPARE(candidates, QList<int>({0, 2}));
+
+    // The corners of a cube are farther from its center than the item size, and still pick it
+    series->dataProxy()->resetArray(new QScatterDataArray(
+            1, QScatterDataItem(QVector3D(0.0f, 0.0f, 0.0f))));
+    series->setMesh(QAbstract3DSeries::MeshCube);
+    series->setItemSize(0.3f);
+    const QImage image = renderImage();
+    QVERIFY(!image.isNull());
+    QList<QPoint> itemPixels;
+    QVERIFY(dominantPixels(image, 0, &itemPixels) > 0);
+    QPointF center;
+    for (const QPoint &pixel : std::as_const(itemPixels))
+        center += QPointF(pixel);
+    center /= qreal(itemPixels.size());
+    QPointF corner = center;
+    for (const QPoint &pixel : std::as_const(itemPixels)) {
+        if (QLineF(center, pixel).length() > QLineF(center, corner).length())
+            corner = pixel;
+    }
+    QCOMPARE(series->selectedItem(), QScatter3DSeries::invalidSelectionIndex());
+    // Slightly inside the silhouette, which is convex
+    m_controller->scene()->setSelectionQueryPosition((center + (corner - center) * 0.9)
+                                                     .toPoint());
+    QVERIFY(!renderImage().isNull());
+    m_controller->synchDataToRenderer();
+    QCOMPARE(series->selectedItem(), 0);
+}
+
+void tst_render::frustumCulling_data()
+{
+    QTest::addColumn<bool>("instanced");
+
+    QTest::newRow("instanced") << true;
+    QTest::newRow("separate") << false;
+}
+
+void tst_render::frustumCulling()
+{
+    QFETCH(bool, instanced);
+
+    if (instanced && !ScatterInstanceBufferHelper::isSupported())
+        QSKIP("Instanced drawing not supported by the context");
+    if (!instanced)
+        disableInstancing();
+
+    // First two chunks at the right side of the graph, the rest at the left
+    QRandomGenerator generator(1000);
+    QScatterDataArray *array = new QScatterDataArray(1000);
+    for (int i = 0; i < 1000; i++) {
+        const float x = (i < 2 * ChunkBounds::chunkSize) ? 9.0f : -9.0f;
+        (*array)[i].setPosition(QVector3D(x + float(generator.bounded(0.4) - 0.2),
+                                          float(generator.bounded(0.4) - 0.2),
+                                          float(generator.bounded(0.4) - 0.2)));
+    }
+    QScatter3DSeries *series = addSeries(array);
+    ScatterSeriesRenderCache *cache = renderCache(series);
+    QVERIFY(cache);
+    const Scatter3DRenderer *renderer = m_controller->renderer();
+    typedef QList<QPair<int, int>> RangeList;
+
+    QVERIFY(dominantPixels(renderImage(), 0) > 0);
+    QCOMPARE(renderer->culledItemCount(Abstract3DRenderer::RenderingNormal), 0);
+    if (instanced)
+        QCOMPARE(cache->bufferInstances()->drawRanges(), RangeList({{0, 1000}}));
+
+    // Zoomed in on the left side, only the items there are drawn
+    Q3DCamera *camera = m_controller->scene()->activeCamera();
+    camera->setTarget(QVector3D(-0.9f, 0.0f, 0.0f));
+    camera->setZoomLevel(500.0f);
+    const QImage zoomed = renderImage();
+    QVERIFY(!zoomed.isNull());
+    QCOMPARE(renderer->culledItemCount(Abstract3DRenderer::RenderingNormal), 512);
+    QCOMPARE(renderer->culledItemCount(Abstract3DRenderer::RenderingDepth), 0);
+    // Instances of the drawn range are read from its offset in the buffers
+    if (instanced)
+        QCOMPARE(cache->bufferInstances()->drawRanges(), RangeList({{512, 488}}));
+    QVERIFY(dominantPixels(zoomed, 0) > 100);
+
+    // Moving an item invalidates the bounds of its chunk
+    series->dataProxy()->setItem(0, QScatterDataItem(QVector3D(-9.0f, 0.0f, 0.0f)));
+    QVERIFY(!renderImage().isNull());
+    QCOMPARE(renderer->culledItemCount(Abstract3DRenderer::RenderingNormal), 256);
+    if (instanced) {
+        QCOMPARE(cache->bufferInstances()->drawRanges(),
+                 RangeList({{0, 256}, {512, 488}}));
+    }
+
+    // Counts are per frame
+    camera->setTarget(QVector3D());
+    camera->setZoomLevel(100.0f);
+    QVERIFY(!renderImage().isNull());
+    QCOMPARE(renderer->culledItemCount(Abstract3DRenderer::RenderingNormal), 0);
+}
+
+void tst_render::streamedPointSpans()
+{
+    m_controller->setOptimizationHints(QAbstract3DGraph::OptimizationStatic);
+    QScatter3DSeries *series = addSeries(createArray(100));
+    series->setMesh(QAbstract3DSeries::MeshPoint);
+    m_controller->synchDataToRenderer();
+    ScatterSeriesRenderCache *cache = renderCache(series);
+    QVERIFY(cache);
+    ScatterPointBufferHelper *points = cache->bufferPoints();
+    QVERIFY(points);
+    const StreamingBuffer &streaming = points->streamingPoints();
+    if (!streaming.isAllocated())
+        QSKIP("Streaming buffers not supported by the context");
+    for (int i = 0; i < StreamingBuffer::bufferCount; i++)
+        QVERIFY(streaming.pendingRanges(i).isEmpty());
+
+    // Changed points less than maxSpanGap apart are merged into one span
+    auto moveItems = [series](const QList<int> &indices) {
+        for (int index : indices) {
+            QScatterDataItem item = *series->dataProxy()->itemAt(index);
+            item.setPosition(-item.position());
+            series->dataProxy()->setItem(index, item);
+        }
+    };
+    moveItems({2, 5, 20, 40, 41});
+    m_controller->synchDataToRenderer();
+    const int firstBuffer = streaming.currentIndex();
+    QCOMPARE(points->pointBuf(), streaming.buffer(firstBuffer));
+    QVERIFY(streaming.pendingRanges(firstBuffer).isEmpty());
+    for (int i = 0; i < StreamingBuffer::bufferCount; i++) {
+        if (i == firstBuffer)
+            continue;
+        const QList<IndexRangeSet::Range> ranges = streaming.pendingRanges(i).ranges();
+        QCOMPARE(ranges.size(), 3);
+        QCOMPARE(ranges.at(0).start, qint64(2));
+        QCOMPARE(ranges.at(0).count, qint64(4));
+        QCOMPARE(ranges.at(1).start, qint64(20));
+        QCOMPARE(ranges.at(1).count, qint64(1));
+        QCOMPARE(ranges.at(2).start, qint64(40));
+        QCOMPARE(ranges.at(2).count, qint64(2));
+    }
+
+    // Each buffer gets the changes it missed when it is taken into use
+    moveItems({60});
+    m_controller->synchDataToRenderer();
+    const int secondBuffer = streaming.currentIndex();
+    QVERIFY(secondBuffer != firstBuffer);
+    QVERIFY(streaming.pendingRanges(secondBuffer).isEmpty());
+    QCOMPARE(streaming.pendingRanges(firstBuffer).ranges().size(), 1);
+    QCOMPARE(streaming.pendingRanges(firstBuffer).ranges().at(0).start, qint64(60));
+    const int thirdBuffer = 3 - firstBuffer - secondBuffer;
+    QCOMPARE(streaming.pendingRanges(thirdBuffer).ranges().size(), 4);
+
+    if (!canReadBuffers())
+        return;
+    const QList<QVector3D> expected = translations(series);
+    QCOMPARE(bufferContents<QVector3D>(streaming.buffer(secondBuffer), 0, 100), expected);
+    const QList<QVector3D> firstContents =
+            bufferContents<QVector3D>(streaming.buffer(firstBuffer), 0, 100);
+    QCOMPARE(firstContents.mid(0, 60), expected.mid(0, 60));
+    QVERIFY(firstContents.at(60) != expected.at(60));
+    for (int i = 0; i < StreamingBuffer::bufferCount; i++) {
+        series->dataProxy()->setItem(99, *series->dataProxy()->itemAt(99));
+        m_controller->synchDataToRenderer();
+    }
+    for (int i = 0; i < StreamingBuffer::bufferCount; i++) {
+        QVERIFY(streaming.pendingRanges(i).isEmpty());
+        QCOMPARE(bufferContents<QVector3D>(streaming.buffer(i), 0, 100), expected);
+    }
+}
+
+void tst_render::densityBinning()
+{
+    QScatter3DSeries *series = addSeries(createArray(6));
+    ScatterSeriesRenderCache *cache = renderCache(series);
+    QVERIFY(cache);
+    ScatterRenderItemArray &renderArray = cache->renderArray();
+    QCOMPARE(renderArray.size(), 6);
+
+    // Cells are 1 x 0.5 x 0.5 scene units
+    const QVector3D sceneScale(2.0f, 1.0f, 1.0f);
+    const int resolution = 4;
+    renderArray[0].setTranslation(QVector3D(-1.9f, -0.9f, -0.9f));
+    renderArray[1].setTranslation(QVector3D(-1.5f, -0.6f, -0.6f));
+    renderArray[2].setTranslation(QVector3D(1.5f, 0.9f, -0.1f));
+    renderArray[3].setTranslation(QVector3D(0.5f, 0.1f, 0.3f));
+    // Items outside the scene are counted in the nearest cell, hidden items are not counted
+    renderArray[4].setTranslation(QVector3D(5.0f, 5.0f, 5.0f));
+    renderArray[5].setTranslation(QVector3D(-1.9f, -0.9f, -0.9f));
+    renderArray[5].setVisible(false);
+
+    ScatterDensityBufferHelper density;
+    density.load(cache, sceneScale, resolution);
+    QCOMPARE(density.itemCount(0, 0, 0), 2);
+    QCOMPARE(density.itemCount(3, 3, 1), 1);
+    QCOMPARE(density.itemCount(2, 2, 2), 1);
+    QCOMPARE(density.itemCount(3, 3, 3), 1);
+    QCOMPARE(density.indexCount(), GLuint(4));
+    QCOMPARE(density.cellSize(), 1.0f);
+
+    // Only the changed items are rebinned
+    renderArray[0].setTranslation(QVector3D(0.5f, 0.1f, 0.3f));
+    renderArray[2].setVisible(false);
+    cache->updateIndices() = {0, 2};
+    density.update(cache);
+    QCOMPARE(density.itemCount(0, 0, 0), 1);
+    QCOMPARE(density.itemCount(3, 3, 1), 0);
+    QCOMPARE(density.itemCount(2, 2, 2), 2);
+    QCOMPARE(density.indexCount(), GLuint(3));
+
+    ScatterDensityBufferHelper reloaded;
+    reloaded.load(cache, sceneScale, resolution);
+    compareDensity(density, reloaded);
+    cache->updateIndices().clear();
+}
+
+void tst_render::densityParallelBinning()
+{
+    // Enough items for several chunks
+    QScatter3DSeries *series = addSeries(createArray(300000));
+    ScatterSeriesRenderCache *cache = renderCache(series);
+    QVERIFY(cache);
+    const QVector3D sceneScale(1.0f, 1.0f, 1.0f);
+
+    QThreadPool *pool = QThreadPool::globalInstance();
+    const int maxThreadCount = pool->maxThreadCount();
+    pool->setMaxThreadCount(1);
+    ScatterDensityBufferHelper serial;
+    serial.load(cache, sceneScale, 32);
+    pool->setMaxThreadCount(4);
+    ScatterDensityBufferHelper parallel;
+    parallel.load(cache, sceneScale, 32);
+    pool->setMaxThreadCount(maxThreadCount);
+
+    QVERIFY(serial.indexCount() > 0);
+    compareDensity(parallel, serial);
+}
+
+void tst_render::densitySplice()
+{
+    QScatter3DSeries *series = addSeries(createArray(1000));
+    series->setDensityRendering(true);
+    m_controller->synchDataToRenderer();
+    ScatterSeriesRenderCache *cache = renderCache(series);
+    QVERIFY(cache);
+    QVERIFY(cache->densityRendering());
+    const QVector3D sceneScale(1.0f, 1.0f, 1.0f);
+
+    // Binned the way drawing the series does
+    ScatterDensityBufferHelper *density = new ScatterDensityBufferHelper();
+    cache->setBufferDensity(density);
+    density->load(cache, sceneScale, 8);
+    cache->setDensityDirty(false);
+    cache->updateIndices().clear();
+
+    QScatterDataProxy *proxy = series->dataProxy();
+    proxy->removeItems(100, 50);
+    QScatterDataArray inserted(20, QScatterDataItem(QVector3D(9.0f, -9.0f, 9.0f)));
+    proxy->insertItems(500, inserted);
+    proxy->setItem(10, QScatterDataItem(QVector3D(-9.0f, 9.0f, -9.0f)));
+    m_controller->synchDataToRenderer();
+
+    // Splices keep the binned items, only the inserted and changed items are rebinned
+    QVERIFY(!cache->densityDirty());
+    QCOMPARE(cache->renderArray().size(), 970);
+    density->update(cache);
+    cache->updateIndices().clear();
+
+    ScatterDensityBufferHelper reloaded;
+    reloaded.load(cache, sceneScale, 8);
+    compareDensity(*density, reloaded);
+    int itemCount = 0;
+    for (int z = 0; z < 8; z++) {
+        for (int y = 0; y < 8; y++) {
+            for (int x = 0; x < 8; x++)
+                itemCount += density->itemCount(x, y, z);
+        }
+    }
+    QCOMPARE(itemCount, 970);
+}
+
+QTEST_MAIN(tst_render)
+#include "tst_render.moc"
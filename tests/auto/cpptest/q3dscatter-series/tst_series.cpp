@@ -63,6 +63,11 @@ void tst_series::initialProperties()
     QVERIFY(m_series->dataProxy());
     QCOMPARE(m_series->itemSize(), 0.0f);
     QCOMPARE(m_series->selectedItem(), m_series->invalidSelectionIndex());
+    QCOMPARE(m_series->isLevelOfDetail(), false);
+    QCOMPARE(m_series->levelOfDetailThreshold(), 1.0f);
+    QCOMPARE(m_series->levelOfDetailBudget(), 0);
+    QCOMPARE(m_series->isDensityRendering(), false);
+    QCOMPARE(m_series->densityResolution(), 64);
 
     // Common properties. The ones identical between different series are tested in QBar3DSeries tests
     QCOMPARE(m_series->itemLabelFormat(), QString("@xLabel, @yLabel, @zLabel"));
@@ -77,9 +82,19 @@ void tst_series::initializeProperties()
     m_series->setDataProxy(new QScatterDataProxy());
     m_series->setItemSize(0.5f);
     m_series->setSelectedItem(0);
+    m_series->setLevelOfDetail(true);
+    m_series->setLevelOfDetailThreshold(2.0f);
+    m_series->setLevelOfDetailBudget(1000);
+    m_series->setDensityRendering(true);
+    m_series->setDensityResolution(32);
 
     QCOMPARE(m_series->itemSize(), 0.5f);
     QCOMPARE(m_series->selectedItem(), 0);
+    QCOMPARE(m_series->isLevelOfDetail(), true);
+    QCOMPARE(m_series->levelOfDetailThreshold(), 2.0f);
+    QCOMPARE(m_series->levelOfDetailBudget(), 1000);
+    QCOMPARE(m_series->isDensityRendering(), true);
+    QCOMPARE(m_series->densityResolution(), 32);
 
     // Common properties. The ones identical between different series are tested in QBar3DSeries tests
     m_series->setMesh(QAbstract3DSeries::MeshPoint);
@@ -30,6 +30,10 @@ private slots:
     void removeMultipleSeries();
     void hasSeries();
 
+    void adjustAxisRanges();
+    void axisMappingHint();
+    void sphereImpostorHint();
+
 private:
     Q3DScatter *m_graph;
 };
@@ -237,5 +241,56 @@ void tst_scatter::hasSeries()
     QCOMPARE(m_graph->hasSeries(series2), false);
 }
 
+void tst_scatter::adjustAxisRanges()
+{
+    QScatter3DSeries *series = newSeries();
+    QScatterDataProxy *proxy = series->dataProxy();
+    m_graph->addSeries(series);
+
+    proxy->setItem(1, QScatterDataItem(QVector3D(10.0f, -0.5f, -0.4f)));
+    QVERIFY(m_graph->axisX()->max() >= 10.0f);
+
+    proxy->setItem(1, QScatterDataItem(QVector3D(-0.3f, -0.5f, -0.4f)));
+    QVERIFY(m_graph->axisX()->max() < 10.0f);
+
+    proxy->insertItem(1, QScatterDataItem(QVector3D(-5.0f, 0.0f, 0.0f)));
+    QVERIFY(m_graph->axisX()->min() <= -5.0f);
+
+    proxy->removeItems(1, 1);
+    QVERIFY(m_graph->axisX()->min() > -5.0f);
+
+    proxy->addItem(QScatterDataItem(QVector3D(0.0f, qQNaN(), qInf())));
+    QVERIFY(!qIsNaN(m_graph->axisY()->min()) && !qIsNaN(m_graph->axisY()->max()));
+    QVERIFY(!qIsInf(m_graph->axisZ()->min()) && !qIsInf(m_graph->axisZ()->max()));
+}
+
+void tst_scatter::axisMappingHint()
+{
+    const QAbstract3DGraph::OptimizationHints hints =
+            QAbstract3DGraph::OptimizationStatic | QAbstract3DGraph::OptimizationAxisMapping;
+    m_graph->setOptimizationHints(hints);
+    QCOMPARE(m_graph->optimizationHints(), hints);
+
+    QScatter3DSeries *series = newSeries();
+    m_graph->addSeries(series);
+    m_graph->axisX()->setRange(-2.0f, 2.0f);
+    QCOMPARE(m_graph->axisX()->min(), -2.0f);
+    QCOMPARE(m_graph->axisX()->max(), 2.0f);
+}
+
+void tst_scatter::sphereImpostorHint()
+{
+    const QAbstract3DGraph::OptimizationHints hints =
+            QAbstract3DGraph::OptimizationDefault | QAbstract3DGraph::OptimizationSphereImpostors;
+    m_graph->setOptimizationHints(hints);
+    QCOMPARE(m_graph->optimizationHints(), hints);
+
+    QScatter3DSeries *series = newSeries();
+    series->setMesh(QAbstract3DSeries::MeshSphere);
+    m_graph->addSeries(series);
+    QCOMPARE(m_graph->seriesList().size(), 1);
+    QCOMPARE(series->mesh(), QAbstract3DSeries::MeshSphere);
+}
+
 QTEST_MAIN(tst_scatter)
 #include "tst_scatter.moc"
@@ -0,0 +1,263 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtTest/QtTest>
+
+#include <QtDataVisualization/QHeightFieldSurfaceDataProxy>
+
+class tst_proxy: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void cleanup();
+
+    void construct();
+
+    void initialProperties();
+    void initializeProperties();
+    void invalidProperties();
+
+    void float32Field();
+    void uint16Field();
+    void sampleRegion();
+    void defaultSampleCount();
+
+private:
+    QString writeField(const QByteArray &data);
+
+    QHeightFieldSurfaceDataProxy *m_proxy;
+    QTemporaryDir m_dir;
+    int m_fileCount = 0;
+};
+
+void tst_proxy::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+}
+
+void tst_proxy::cleanupTestCase()
+{
+}
+
+void tst_proxy::init()
+{
+    m_proxy = new QHeightFieldSurfaceDataProxy();
+}
+
+void tst_proxy::cleanup()
+{
+    delete m_proxy;
+}
+
+QString tst_proxy::writeField(const QByteArray &data)
+{
+    const QString filename = m_dir.filePath(QString::number(m_fileCount++) + ".raw");
+    QFile file(filename);
+    if (!file.open(QIODevice::WriteOnly))
+        return QString();
+    file.write(data);
+    return filename;
+}
+
+// Field of 5 columns and 4 rows where the height of each sample is 10 * row + column
+static QByteArray float32Data()
+{
+    QByteArray data;
+    for (int row = 0; row < 4; row++) {
+        for (int column = 0; column < 5; column++) {
+            const float height = qToLittleEndian(float(10 * row + column));
+            data.append(reinterpret_cast<const char *>(&height), sizeof(height));
+        }
+    }
+    return data;
+}
+
+void tst_proxy::construct()
+{
+    QHeightFieldSurfaceDataProxy *proxy = new QHeightFieldSurfaceDataProxy();
+    QVERIFY(proxy);
+    delete proxy;
+}
+
+void tst_proxy::initialProperties()
+{
+    QVERIFY(m_proxy);
+
+    QCOMPARE(m_proxy->heightFieldFile(), QString());
+    QCOMPARE(m_proxy->fieldWidth(), 0);
+    QCOMPARE(m_proxy->fieldHeight(), 0);
+    QCOMPARE(m_proxy->sampleType(), QHeightFieldSurfaceDataProxy::SampleTypeUInt16);
+    QCOMPARE(m_proxy->dataOffset(), 0);
+    QCOMPARE(m_proxy->rowStride(), 0);
+    QCOMPARE(m_proxy->sampleRegion(), QRect());
+    QCOMPARE(m_proxy->sampleStep(), 1);
+    QCOMPARE(m_proxy->maxXValue(), 10.0f);
+    QCOMPARE(m_proxy->maxZValue(), 10.0f);
+    QCOMPARE(m_proxy->minXValue(), 0.0f);
+    QCOMPARE(m_proxy->minZValue(), 0.0f);
+
+    QCOMPARE(m_proxy->columnCount(), 0);
+    QCOMPARE(m_proxy->rowCount(), 0);
+    QVERIFY(!m_proxy->series());
+
+    QCOMPARE(m_proxy->type(), QAbstractDataProxy::DataTypeSurface);
+}
+
+void tst_proxy::initializeProperties()
+{
+    QVERIFY(m_proxy);
+
+    const QString filename = writeField(float32Data());
+    QSignalSpy spy(m_proxy, &QHeightFieldSurfaceDataProxy::heightFieldChanged);
+    QVERIFY(m_proxy->setHeightFieldFile(filename, 5, 4,
+                                        QHeightFieldSurfaceDataProxy::SampleTypeFloat32));
+    QCOMPARE(spy.size(), 1);
+    m_proxy->setSampleRegion(QRect(1, 1, 3, 2));
+    m_proxy->setSampleStep(2);
+    m_proxy->setValueRanges(-10.0f, 11.0f, -10.0f, 11.0f);
+
+    QCOMPARE(m_proxy->heightFieldFile(), filename);
+    QCOMPARE(m_proxy->fieldWidth(), 5);
+    QCOMPARE(m_proxy->fieldHeight(), 4);
+    QCOMPARE(m_proxy->sampleType(), QHeightFieldSurfaceDataProxy::SampleTypeFloat32);
+    QCOMPARE(m_proxy->rowStride(), 20);
+    QCOMPARE(m_proxy->sampleRegion(), QRect(1, 1, 3, 2));
+    QCOMPARE(m_proxy->sampleStep(), 2);
+    QCOMPARE(m_proxy->maxXValue(), 11.0f);
+    QCOMPARE(m_proxy->maxZValue(), 11.0f);
+    QCOMPARE(m_proxy->minXValue(), -10.0f);
+    QCOMPARE(m_proxy->minZValue(), -10.0f);
+
+    m_proxy->clearHeightField();
+    QCOMPARE(spy.size(), 2);
+    QCOMPARE(m_proxy->heightFieldFile(), QString());
+    QCoreApplication::processEvents();
+    QCOMPARE(m_proxy->rowCount(), 0);
+}
+
+void tst_proxy::invalidProperties()
+{
+    m_proxy->setSampleStep(0);
+    QCOMPARE(m_proxy->sampleStep(), 1);
+
+    m_proxy->setMaxXValue(-10.0f);
+    m_proxy->setMinZValue(10.0f);
+    QCOMPARE(m_proxy->maxXValue(), 10.0f);
+    QCOMPARE(m_proxy->minZValue(), 0.0f);
+
+    // File too small for the given dimensions
+    const QString filename = writeField(float32Data());
+    QVERIFY(!m_proxy->setHeightFieldFile(filename, 5, 5,
+                                         QHeightFieldSurfaceDataProxy::SampleTypeFloat32));
+    QVERIFY(!m_proxy->setHeightFieldFile(filename, 5, 4,
+                                         QHeightFieldSurfaceDataProxy::SampleTypeFloat32, 0, 8));
+    QVERIFY(!m_proxy->setHeightFieldFile(m_dir.filePath("missing.raw"), 5, 4,
+                                         QHeightFieldSurfaceDataProxy::SampleTypeUInt16));
+    QCOMPARE(m_proxy->heightFieldFile(), QString());
+    QCOMPARE(m_proxy->fieldWidth(), 0);
+}
+
+void tst_proxy::float32Field()
+{
+    QVERIFY(m_proxy->setHeightFieldFile(writeField(float32Data()), 5, 4,
+                                        QHeightFieldSurfaceDataProxy::SampleTypeFloat32));
+    QCOMPARE(m_proxy->heightAt(2, 3), 23.0f);
+    QCOMPARE(m_proxy->heightAt(4, 0), 0.0f);
+
+    QSignalSpy spy(m_proxy, &QSurfaceDataProxy::arrayReset);
+    QCoreApplication::processEvents();
+    QCOMPARE(spy.size(), 1);
+    QCOMPARE(m_proxy->columnCount(), 5);
+    QCOMPARE(m_proxy->rowCount(), 4);
+    QCOMPARE(m_proxy->itemAt(0, 0)->position(), QVector3D(0.0f, 0.0f, 0.0f));
+    QCOMPARE(m_proxy->itemAt(2, 3)->y(), 23.0f);
+    QCOMPARE(m_proxy->itemAt(2, 2)->x(), 5.0f);
+    QCOMPARE(m_proxy->itemAt(3, 4)->position(), QVector3D(10.0f, 34.0f, 10.0f));
+}
+
+void tst_proxy::uint16Field()
+{
+    // Two header bytes and two padding bytes after each row of three samples
+    QByteArray data(2, '\0');
+    for (int row = 0; row < 2; row++) {
+        for (int column = 0; column < 3; column++) {
+            const quint16 height = qToLittleEndian(quint16(1000 * row + column));
+            data.append(reinterpret_cast<const char *>(&height), sizeof(height));
+        }
+        data.append(2, '\0');
+    }
+
+    QVERIFY(m_proxy->setHeightFieldFile(writeField(data), 3, 2,
+                                        QHeightFieldSurfaceDataProxy::SampleTypeUInt16, 2, 8));
+    QCoreApplication::processEvents();
+    QCOMPARE(m_proxy->columnCount(), 3);
+    QCOMPARE(m_proxy->rowCount(), 2);
+    QCOMPARE(m_proxy->itemAt(0, 2)->y(), 2.0f);
+    QCOMPARE(m_proxy->itemAt(1, 1)->y(), 1001.0f);
+}
+
+void tst_proxy::sampleRegion()
+{
+    QVERIFY(m_proxy->setHeightFieldFile(writeField(float32Data()), 5, 4,
+                                        QHeightFieldSurfaceDataProxy::SampleTypeFloat32));
+    m_proxy->setValueRanges(0.0f, 4.0f, 0.0f, 3.0f);
+
+    // Region is clipped to the field
+    m_proxy->setSampleRegion(QRect(2, 1, 10, 10));
+    QCoreApplication::processEvents();
+    QCOMPARE(m_proxy->columnCount(), 3);
+    QCOMPARE(m_proxy->rowCount(), 3);
+    QCOMPARE(m_proxy->itemAt(0, 0)->position(), QVector3D(2.0f, 12.0f, 1.0f));
+
+    // Last row and column of the region are included even if not on the step
+    m_proxy->setSampleRegion(QRect());
+    m_proxy->setSampleStep(3);
+    QCoreApplication::processEvents();
+    QCOMPARE(m_proxy->columnCount(), 3);
+    QCOMPARE(m_proxy->rowCount(), 2);
+    QCOMPARE(m_proxy->itemAt(0, 1)->x(), 3.0f);
+    QCOMPARE(m_proxy->itemAt(0, 2)->x(), 4.0f);
+    QCOMPARE(m_proxy->itemAt(1, 2)->y(), 34.0f);
+
+    m_proxy->setSampleRegion(QRect(10, 10, 2, 2));
+    QCoreApplication::processEvents();
+    QCOMPARE(m_proxy->rowCount(), 0);
+}
+
+void tst_proxy::defaultSampleCount()
+{
+    // Too large to be resolved at full resolution without a region
+    const int width = 2000;
+    const int height = 1000;
+    QVERIFY(m_proxy->setHeightFieldFile(writeField(QByteArray(width * height * 2, '\0')),
+                                        width, height,
+                                        QHeightFieldSurfaceDataProxy::SampleTypeUInt16));
+    m_proxy->setValueRanges(0.0f, width - 1, 0.0f, height - 1);
+    QCoreApplication::processEvents();
+    QCOMPARE(m_proxy->sampleStep(), 1);
+    QCOMPARE(m_proxy->columnCount(), 1001);
+    QCOMPARE(m_proxy->rowCount(), 501);
+    QCOMPARE(m_proxy->itemAt(0, 1)->x(), 2.0f);
+    QCOMPARE(m_proxy->itemAt(1, 0)->z(), 2.0f);
+    QCOMPARE(m_proxy->itemAt(500, 1000)->position(), QVector3D(width - 1, 0.0f, height - 1));
+
+    // Larger steps are used as is
+    m_proxy->setSampleStep(4);
+    QCoreApplication::processEvents();
+    QCOMPARE(m_proxy->columnCount(), 501);
+    QCOMPARE(m_proxy->rowCount(), 251);
+
+    // Explicit region is resolved with the given step
+    m_proxy->setSampleStep(1);
+    m_proxy->setSampleRegion(QRect(0, 0, width, height));
+    QCoreApplication::processEvents();
+    QCOMPARE(m_proxy->columnCount(), width);
+    QCOMPARE(m_proxy->rowCount(), height);
+}
+
+QTEST_MAIN(tst_proxy)
+#include "tst_proxy.moc"
@@ -21,6 +21,10 @@ private slots:
     void initializeProperties();
     void invalidProperties();
 
+    void backgroundResolve();
+    void rescaleRanges();
+    void resolveRaces();
+
 private:
     QHeightMapSurfaceDataProxy *m_proxy;
 };
@@ -139,5 +143,93 @@ void tst_proxy::invalidProperties()
     QCOMPARE(m_proxy->minZValue(), 10.0f);
 }
 
+void tst_proxy::backgroundResolve()
+{
+    QImage image(QSize(1000, 600), QImage::Format_Grayscale8);
+    image.fill(0);
+    image.setPixel(0, 599, qRgb(255, 255, 255));
+
+    QSignalSpy spy(m_proxy, &QSurfaceDataProxy::arrayReset);
+    m_proxy->setHeightMap(image);
+
+    // A newer height map cancels the resolve in progress
+    QCoreApplication::processEvents();
+    QImage newerImage(QSize(1200, 800), QImage::Format_RGBX64);
+    newerImage.fill(QColor(Qt::white));
+    m_proxy->setHeightMap(newerImage);
+    m_proxy->setAutoScaleY(true);
+
+    QTRY_COMPARE(m_proxy->rowCount(), 800);
+    QCOMPARE(m_proxy->columnCount(), 1200);
+    QCOMPARE(spy.size(), 1);
+    QCOMPARE(m_proxy->itemAt(0, 0)->y(), 10.0f);
+    QCOMPARE(m_proxy->itemAt(799, 1199)->x(), 10.0f);
+    QCOMPARE(m_proxy->itemAt(799, 1199)->y(), 10.0f);
+    QCOMPARE(m_proxy->itemAt(799, 1199)->z(), 10.0f);
+
+    // Bottom left pixel is the first item
+    m_proxy->setHeightMap(image);
+    QTRY_COMPARE(m_proxy->rowCount(), 600);
+    QCOMPARE(m_proxy->itemAt(0, 0)->y(), 10.0f);
+    QCOMPARE(m_proxy->itemAt(599, 0)->y(), 0.0f);
+}
+
+void tst_proxy::rescaleRanges()
+{
+    QImage image(QSize(4, 3), QImage::Format_Grayscale8);
+    image.fill(51);
+    m_proxy->setHeightMap(image);
+    QCoreApplication::processEvents();
+    QCOMPARE(m_proxy->itemAt(0, 0)->y(), 51.0f);
+
+    QSignalSpy spy(m_proxy, &QSurfaceDataProxy::arrayReset);
+    m_proxy->setAutoScaleY(true);
+    m_proxy->setMinYValue(-10.0f);
+    m_proxy->setMaxXValue(20.0f);
+    QCoreApplication::processEvents();
+
+    QCOMPARE(spy.size(), 1);
+    QCOMPARE(m_proxy->rowCount(), 3);
+    QCOMPARE(m_proxy->columnCount(), 4);
+    QCOMPARE(m_proxy->itemAt(0, 0)->y(), -6.0f);
+    QCOMPARE(m_proxy->itemAt(2, 3)->y(), -6.0f);
+    QCOMPARE(m_proxy->itemAt(2, 3)->x(), 20.0f);
+    QCOMPARE(m_proxy->itemAt(0, 1)->x(), 20.0f / 3.0f);
+
+    m_proxy->setAutoScaleY(false);
+    QCoreApplication::processEvents();
+    QCOMPARE(m_proxy->itemAt(1, 1)->y(), 51.0f);
+}
+
+void tst_proxy::resolveRaces()
+{
+    QImage image(QSize(1000, 600), QImage::Format_Grayscale8);
+    image.fill(255);
+
+    // Ranges changed while a resolve is in progress are applied to its result
+    m_proxy->setHeightMap(image);
+    QCoreApplication::processEvents();
+    m_proxy->setMaxXValue(20.0f);
+    m_proxy->setMinYValue(-10.0f);
+    m_proxy->setAutoScaleY(true);
+    QTRY_COMPARE(m_proxy->rowCount(), 600);
+    QCOMPARE(m_proxy->itemAt(599, 999)->x(), 20.0f);
+    QCOMPARE(m_proxy->itemAt(0, 0)->y(), 10.0f);
+    QCOMPARE(m_proxy->itemAt(0, 0)->z(), 0.0f);
+
+    // A smaller height map set while a larger one is resolved stays, the stale result is dropped
+    QImage newerImage(QSize(4, 3), QImage::Format_Grayscale8);
+    newerImage.fill(0);
+    image.fill(128);
+    m_proxy->setHeightMap(image);
+    QCoreApplication::processEvents();
+    m_proxy->setHeightMap(newerImage);
+    QTRY_COMPARE(m_proxy->rowCount(), 3);
+    QTest::qWait(500);
+    QCOMPARE(m_proxy->rowCount(), 3);
+    QCOMPARE(m_proxy->columnCount(), 4);
+    QCOMPARE(m_proxy->itemAt(0, 0)->y(), -10.0f);
+}
+
 QTEST_MAIN(tst_proxy)
 #include "tst_proxy.moc"
@@ -0,0 +1,415 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtTest/QtTest>
+
+#include <QtDataVisualization/QValue3DAxis>
+#include <QtGui/QOffscreenSurface>
+#include <QtGui/QOpenGLContext>
+#include <QtGui/QOpenGLExtraFunctions>
+
+#include <private/surface3dcontroller_p.h>
+#include <private/surface3drenderer_p.h>
+#include <private/surfaceobject_p.h>
+
+#include "cpptestutil.h"
+
+// Gives access to the renderer the controller creates
+class TestController : public Surface3DController
+{
+public:
+    TestController() : Surface3DController(QRect(0, 0, 400, 400)) {}
+
+    Surface3DRenderer *renderer() const { return static_cast<Surface3DRenderer *>(m_renderer); }
+};
+
+class tst_object: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void cleanup();
+
+    void levelOfDetail();
+    void heightMapVertices();
+    void heightMapSupport();
+    void parallelSetUp_data();
+    void parallelSetUp();
+    void intersectRay();
+    void dirtyRanges_data();
+    void dirtyRanges();
+
+private:
+    void setRanges(float maxX, float minY, float maxY, float maxZ);
+    QList<QVector3D> bufferContents(GLuint buffer, int count) const;
+
+    QOffscreenSurface *m_surface;
+    QOpenGLContext *m_context;
+    TestController *m_controller;
+};
+
+typedef QList<QPair<qint64, qint64>> RangeList;
+
+// Ranges of the set as start and count pairs
+static RangeList ranges(const IndexRangeSet &set)
+{
+    RangeList result;
+    const QList<IndexRangeSet::Range> setRanges = set.ranges();
+    for (const IndexRangeSet::Range &range : setRanges)
+        result.append(qMakePair(range.start, range.count));
+    return result;
+}
+
+// Grid of columns x rows items at integer X and Z values
+static QSurfaceDataArray createArray(int columns, int rows,
+                                     const std::function<float(int, int)> &height)
+{
+    QSurfaceDataArray array;
+    array.reserve(rows);
+    for (int row = 0; row < rows; row++) {
+        QSurfaceDataRow *dataRow = new QSurfaceDataRow(columns);
+        for (int column = 0; column < columns; column++)
+            (*dataRow)[column].setPosition(QVector3D(column, height(column, row), row));
+        array.append(dataRow);
+    }
+    return array;
+}
+
+void tst_object::initTestCase()
+{
+    if (!CpptestUtil::isOpenGLSupported())
+        QSKIP("OpenGL not supported on this platform");
+}
+
+void tst_object::cleanupTestCase()
+{
+}
+
+void tst_object::init()
+{
+    m_surface = new QOffscreenSurface();
+    m_surface->create();
+    m_context = new QOpenGLContext();
+    QVERIFY(m_context->create());
+    QVERIFY(m_context->makeCurrent(m_surface));
+
+    m_controller = new TestController();
+    m_controller->initializeOpenGL();
+}
+
+void tst_object::cleanup()
+{
+    // Tests may leave another context current
+    m_context->makeCurrent(m_surface);
+    delete m_controller;
+    m_context->doneCurrent();
+    delete m_context;
+    delete m_surface;
+}
+
+// Sets fixed axis ranges and synchronizes them to the renderer, so that the data is normalized
+// the same way in every test
+void tst_object::setRanges(float maxX, float minY, float maxY, float maxZ)
+{
+    static_cast<QValue3DAxis *>(m_controller->axisX())->setRange(0.0f, maxX);
+    static_cast<QValue3DAxis *>(m_controller->axisY())->setRange(minY, maxY);
+    static_cast<QValue3DAxis *>(m_controller->axisZ())->setRange(0.0f, maxZ);
+    m_controller->synchDataToRenderer();
+}
+
+// Reads back count vectors from the start of a buffer. Mapping buffers for reading needs
+// OpenGL 3.0 or OpenGL ES 3.0, so the result is empty on older contexts.
+QList<QVector3D> tst_object::bufferContents(GLuint buffer, int count) const
+{
+    QList<QVector3D> contents;
+    if (m_context->format().majorVersion() < 3)
+        return contents;
+
+    QOpenGLExtraFunctions *functions = m_context->extraFunctions();
+    functions->glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+    const void *data = functions->glMapBufferRange(GL_COPY_READ_BUFFER, 0,
+                                                   count * sizeof(QVector3D), GL_MAP_READ_BIT);
+    if (data) {
+        contents.resize(count);
+        memcpy(contents.data(), data, count * sizeof(QVector3D));
+        functions->glUnmapBuffer(GL_COPY_READ_BUFFER);
+    }
+    functions->glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    return contents;
+}
+
+void tst_object::levelOfDetail()
+{
+    // Four tiles deep surface of slow waves along Z, seen from just before the first row
+    const int columns = 65;
+    const int rows = 257;
+    setRanges(columns - 1, -1.0f, 1.0f, rows - 1);
+    QSurfaceDataArray array = createArray(columns, rows, [](int, int row) {
+        return qSin(0.05f * row);
+    });
+
+    SurfaceObject object(m_controller->renderer());
+    object.setLevelOfDetail(true);
+    object.setUpSmoothData(array, QRect(0, 0, columns, rows), true, false);
+
+    const QVector3D first = object.vertexAt(columns / 2, 0);
+    const QVector3D last = object.vertexAt(columns / 2, rows - 1);
+    const QVector3D direction = (last - first).normalized();
+    QMatrix4x4 projectionViewMatrix;
+    projectionViewMatrix.perspective(45.0f, 1.0f, 0.01f, 100.0f);
+    projectionViewMatrix.lookAt(first - 0.05f * direction + QVector3D(0.0f, 0.1f, 0.0f), last,
+                                QVector3D(0.0f, 1.0f, 0.0f));
+    object.updateLevelOfDetail(projectionViewMatrix, 100.0f, 1.0f);
+
+    // Tiles further away are drawn with fewer vertices
+    const int tileRows = 4;
+    QCOMPARE(object.lodStep(0, 0), 1);
+    for (int tileRow = 1; tileRow < tileRows; tileRow++)
+        QVERIFY(object.lodStep(tileRow, 0) >= object.lodStep(tileRow - 1, 0));
+    QVERIFY(object.lodStep(tileRows - 1, 0) > object.lodStep(0, 0));
+
+    // Moving far away makes the whole surface coarser
+    QMatrix4x4 farMatrix;
+    farMatrix.perspective(45.0f, 1.0f, 0.01f, 1000.0f);
+    farMatrix.lookAt(first - 200.0f * direction, last, QVector3D(0.0f, 1.0f, 0.0f));
+    object.updateLevelOfDetail(farMatrix, 100.0f, 1.0f);
+    QVERIFY(object.lodStep(0, 0) > 1);
+
+    qDeleteAll(array);
+}
+
+void tst_object::heightMapVertices()
+{
+    if (!SurfaceObject::isHeightMapSupported())
+        QSKIP("Height map surfaces not supported by the context");
+
+    const int columns = 30;
+    const int rows = 20;
+    setRanges(columns - 1, -2.0f, 2.0f, rows - 1);
+    QSurfaceDataArray array = createArray(columns, rows, [](int column, int row) {
+        return qSin(0.3f * column) + qCos(0.2f * row);
+    });
+
+    SurfaceObject buffered(m_controller->renderer());
+    buffered.setUpSmoothData(array, QRect(0, 0, columns, rows), true, false);
+    SurfaceObject heightMapped(m_controller->renderer());
+    heightMapped.setHeightMapAllowed(true);
+    heightMapped.setUpSmoothData(array, QRect(0, 0, columns, rows), true, false);
+    QVERIFY(!buffered.isHeightMapped());
+    QVERIFY(heightMapped.isHeightMapped());
+
+    // Vertices derived from the height map grid match the vertices uploaded in buffers
+    for (int row = 0; row < rows; row++) {
+        for (int column = 0; column < columns; column++) {
+            const QVector3D difference =
+                    heightMapped.vertexAt(column, row) - buffered.vertexAt(column, row);
+            QVERIFY2(difference.length() < 1e-5f,
+                     qPrintable(QStringLiteral("Vertex %1, %2").arg(column).arg(row)));
+        }
+    }
+    QCOMPARE(heightMapped.minYValue(), buffered.minYValue());
+    QCOMPARE(heightMapped.maxYValue(), buffered.maxYValue());
+
+    qDeleteAll(array);
+}
+
+void tst_object::heightMapSupport()
+{
+    m_context->doneCurrent();
+    QVERIFY(!SurfaceObject::isHeightMapSupported());
+
+    QSurfaceFormat format;
+    format.setVersion(2, 1);
+    QOpenGLContext context;
+    context.setFormat(format);
+    QVERIFY(context.create());
+    QVERIFY(context.makeCurrent(m_surface));
+    if (!context.isOpenGLES() && context.format().version() >= qMakePair(3, 0))
+        QSKIP("Platform does not provide OpenGL ES 2 or OpenGL 2 contexts");
+
+    // Vertex texture fetch from float textures is not available
+    QVERIFY(!SurfaceObject::isHeightMapSupported());
+}
+
+void tst_object::parallelSetUp_data()
+{
+    QTest::addColumn<bool>("flat");
+
+    QTest::newRow("smooth") << false;
+    QTest::newRow("flat") << true;
+}
+
+void tst_object::parallelSetUp()
+{
+    QFETCH(bool, flat);
+
+    // Tall enough for several row bands
+    const int columns = 256;
+    const int rows = 512;
+    setRanges(columns - 1, -2.0f, 2.0f, rows - 1);
+    QSurfaceDataArray array = createArray(columns, rows, [](int column, int row) {
+        return qSin(0.1f * column) * qCos(0.07f * row) + 0.001f * row;
+    });
+
+    QThreadPool *pool = QThreadPool::globalInstance();
+    const int maxThreadCount = pool->maxThreadCount();
+
+    pool->setMaxThreadCount(1);
+    SurfaceObject serial(m_controller->renderer());
+    if (flat)
+        serial.setUpData(array, QRect(0, 0, columns, rows), true, false);
+    else
+        serial.setUpSmoothData(array, QRect(0, 0, columns, rows), true, false);
+
+    pool->setMaxThreadCount(4);
+    SurfaceObject parallel(m_controller->renderer());
+    if (flat)
+        parallel.setUpData(array, QRect(0, 0, columns, rows), true, false);
+    else
+        parallel.setUpSmoothData(array, QRect(0, 0, columns, rows), true, false);
+    pool->setMaxThreadCount(maxThreadCount);
+
+    QVERIFY(!serial.vertices().isEmpty());
+    QCOMPARE(parallel.vertices(), serial.vertices());
+    QCOMPARE(parallel.normals(), serial.normals());
+    QCOMPARE(parallel.minYValue(), serial.minYValue());
+    QCOMPARE(parallel.maxYValue(), serial.maxYValue());
+
+    qDeleteAll(array);
+}
+
+void tst_object::intersectRay()
+{
+    const int columns = 40;
+    const int rows = 30;
+    setRanges(columns - 1, -2.0f, 2.0f, rows - 1);
+    QSurfaceDataArray array = createArray(columns, rows, [](int column, int row) {
+        return qSin(0.2f * column) + 0.5f * qCos(0.3f * row);
+    });
+
+    SurfaceObject object(m_controller->renderer());
+    object.setUpSmoothData(array, QRect(0, 0, columns, rows), true, false);
+
+    // Straight down, slightly off the vertex towards the next cell
+    const QVector3D vertex = object.vertexAt(12, 7);
+    const QVector3D offset = 0.2f * (object.vertexAt(13, 8) - vertex);
+    float distance = 0.0f;
+    QPoint point;
+    QVERIFY(object.intersectRay(vertex + QVector3D(offset.x(), 5.0f, offset.z()),
+                                QVector3D(0.0f, -1.0f, 0.0f), distance, point));
+    QCOMPARE(point, QPoint(7, 12));
+    QVERIFY(distance > 0.0f);
+
+    // Through the vertex as seen by a perspective camera, mapped back from the screen the same
+    // way as the input position
+    const QVector3D target = object.vertexAt(25, 18);
+    QMatrix4x4 projectionViewMatrix;
+    projectionViewMatrix.perspective(45.0f, 1.0f, 0.1f, 100.0f);
+    projectionViewMatrix.lookAt(QVector3D(0.5f, 8.0f, 3.0f), QVector3D(0.0f, 0.0f, 0.0f),
+                                QVector3D(0.0f, 1.0f, 0.0f));
+    const QVector3D ndc = projectionViewMatrix.map(target);
+    const QMatrix4x4 inverseMatrix = projectionViewMatrix.inverted();
+    const QVector3D origin = inverseMatrix.map(QVector3D(ndc.x(), ndc.y(), -1.0f));
+    const QVector3D direction =
+            (inverseMatrix.map(QVector3D(ndc.x(), ndc.y(), 1.0f)) - origin).normalized();
+    QVERIFY(object.intersectRay(origin, direction, distance, point));
+    QCOMPARE(point, QPoint(18, 25));
+    QVERIFY(qAbs(distance - (target - origin).length()) < 1e-3f);
+
+    // Rays that miss the surface
+    QVERIFY(!object.intersectRay(vertex + QVector3D(0.0f, 5.0f, 0.0f),
+                                 QVector3D(0.0f, 1.0f, 0.0f), distance, point));
+    QVERIFY(!object.intersectRay(QVector3D(10.0f, 5.0f, 10.0f),
+                                 QVector3D(0.0f, -1.0f, 0.0f), distance, point));
+
+    qDeleteAll(array);
+}
+
+void tst_object::dirtyRanges_data()
+{
+    QTest::addColumn<bool>("flat");
+
+    QTest::newRow("smooth") << false;
+    QTest::newRow("flat") << true;
+}
+
+void tst_object::dirtyRanges()
+{
+    QFETCH(bool, flat);
+
+    const int columns = 10;
+    const int rows = 8;
+    setRanges(columns - 1, -2.0f, 2.0f, rows - 1);
+    QSurfaceDataArray array = createArray(columns, rows, [](int column, int row) {
+        return qSin(0.3f * column) + qCos(0.2f * row);
+    });
+
+    SurfaceObject object(m_controller->renderer());
+    if (flat)
+        object.setUpData(array, QRect(0, 0, columns, rows), true, false);
+    else
+        object.setUpSmoothData(array, QRect(0, 0, columns, rows), true, false);
+    QVERIFY(!object.isHeightMapped());
+    QVERIFY(object.dirtyVertices().isEmpty());
+    QVERIFY(object.dirtyNormals().isEmpty());
+
+    // A changed row marks its vertices and the normals of the cells next to it
+    for (int column = 0; column < columns; column++)
+        (*array[3])[column].setY(1.5f);
+    if (flat) {
+        object.updateCoarseRow(array, 3, false);
+        // Flat surfaces have two vertices for inner columns and two normals for each cell
+        QCOMPARE(ranges(object.dirtyVertices()), RangeList({{54, 18}}));
+        QCOMPARE(ranges(object.dirtyNormals()), RangeList({{36, 36}}));
+    } else {
+        object.updateSmoothRow(array, 3, false);
+        QCOMPARE(ranges(object.dirtyVertices()), RangeList({{30, 10}}));
+        QCOMPARE(ranges(object.dirtyNormals()), RangeList({{20, 20}}));
+    }
+
+    // A changed item marks its vertices and the normals of the four cells around it
+    (*array[5])[4].setY(-1.5f);
+    if (flat) {
+        object.updateCoarseItem(array, 5, 4, false);
+        QCOMPARE(ranges(object.dirtyVertices()), RangeList({{54, 18}, {97, 2}}));
+        QCOMPARE(ranges(object.dirtyNormals()), RangeList({{36, 36}, {78, 4}, {96, 4}}));
+    } else {
+        object.updateSmoothItem(array, 5, 4, false);
+        QCOMPARE(ranges(object.dirtyVertices()), RangeList({{30, 10}, {54, 1}}));
+        QCOMPARE(ranges(object.dirtyNormals()), RangeList({{20, 20}, {43, 2}, {53, 2}}));
+    }
+
+    // Updated vertices and normals are the same as when set up from the changed data
+    SurfaceObject expected(m_controller->renderer());
+    if (flat)
+        expected.setUpData(array, QRect(0, 0, columns, rows), true, false);
+    else
+        expected.setUpSmoothData(array, QRect(0, 0, columns, rows), true, false);
+    const int vertexCount = expected.vertices().size();
+    const int normalCount = expected.normals().size();
+    QCOMPARE(object.vertices().size(), vertexCount);
+    QCOMPARE(object.normals().size(), normalCount);
+    for (int i = 0; i < vertexCount; i++)
+        QVERIFY((object.vertices().at(i) - expected.vertices().at(i)).length() < 1e-5f);
+    for (int i = 0; i < normalCount; i++)
+        QVERIFY((object.normals().at(i) - expected.normals().at(i)).length() < 1e-5f);
+
+    // Uploading writes the changed ranges to the buffers and clears them
+    object.uploadBuffers();
+    QVERIFY(object.dirtyVertices().isEmpty());
+    QVERIFY(object.dirtyNormals().isEmpty());
+    const QList<QVector3D> vertices = bufferContents(object.vertexBuf(), vertexCount);
+    const QList<QVector3D> normals = bufferContents(object.normalBuf(), normalCount);
+    if (!vertices.isEmpty()) {
+        QCOMPARE(vertices, object.vertices());
+        QCOMPARE(normals, object.normals());
+    }
+
+    qDeleteAll(array);
+}
+
+QTEST_MAIN(tst_object)
+#include "tst_object.moc"
@@ -67,6 +67,8 @@ void tst_series::initialProperties()
     QCOMPARE(m_series->isFlatShadingSupported(), true);
     QCOMPARE(m_series->selectedPoint(), m_series->invalidSelectionPosition());
     QCOMPARE(m_series->wireframeColor(), QColor(Qt::black));
+    QCOMPARE(m_series->isLevelOfDetail(), false);
+    QCOMPARE(m_series->levelOfDetailThreshold(), 1.0f);
     // Common properties. The ones identical between different series are tested in QBar3DSeries tests
     QCOMPARE(m_series->itemLabelFormat(), QString("@xLabel, @yLabel, @zLabel"));
     QCOMPARE(m_series->mesh(), QAbstract3DSeries::MeshSphere);
@@ -82,11 +84,15 @@ void tst_series::initializeProperties()
     m_series->setFlatShadingEnabled(false);
     m_series->setSelectedPoint(QPoint(0, 0));
     m_series->setWireframeColor(QColor(Qt::red));
+    m_series->setLevelOfDetail(true);
+    m_series->setLevelOfDetailThreshold(2.5f);
 
     QCOMPARE(m_series->drawMode(), QSurface3DSeries::DrawWireframe);
     QCOMPARE(m_series->isFlatShadingEnabled(), false);
     QCOMPARE(m_series->selectedPoint(), QPoint(0, 0));
     QCOMPARE(m_series->wireframeColor(), QColor(Qt::red));
+    QCOMPARE(m_series->isLevelOfDetail(), true);
+    QCOMPARE(m_series->levelOfDetailThreshold(), 2.5f);
 
     // Common properties. The ones identical between different series are tested in QBar3DSeries tests
     m_series->setMesh(QAbstract3DSeries::MeshPyramid);
@@ -97,8 +103,10 @@ void tst_series::initializeProperties()
 void tst_series::invalidProperties()
 {
     m_series->setMesh(QAbstract3DSeries::MeshPoint);
+    m_series->setLevelOfDetailThreshold(0.0f);
 
     QCOMPARE(m_series->mesh(), QAbstract3DSeries::MeshSphere);
+    QCOMPARE(m_series->levelOfDetailThreshold(), 1.0f);
 }
 
 QTEST_MAIN(tst_series)
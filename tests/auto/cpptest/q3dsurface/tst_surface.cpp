@@ -30,6 +30,8 @@ private slots:
     void removeMultipleSeries();
     void hasSeries();
 
+    void adjustAxisRanges();
+
 private:
     Q3DSurface *m_graph;
 };
@@ -247,5 +249,27 @@ void tst_surface::hasSeries()
     QCOMPARE(m_graph->hasSeries(series2), false);
 }
 
+void tst_surface::adjustAxisRanges()
+{
+    QSurface3DSeries *series = newSeries();
+    QSurfaceDataProxy *proxy = series->dataProxy();
+    m_graph->addSeries(series);
+
+    proxy->setItem(1, 1, QSurfaceDataItem(QVector3D(1.0f, 10.0f, 1.0f)));
+    QVERIFY(m_graph->axisY()->max() >= 10.0f);
+
+    proxy->setItem(1, 1, QSurfaceDataItem(QVector3D(1.0f, 1.2f, 1.0f)));
+    QVERIFY(m_graph->axisY()->max() < 10.0f);
+
+    QSurfaceDataRow *row = new QSurfaceDataRow;
+    *row << QVector3D(0.0f, -5.0f, 0.0f) << QVector3D(1.0f, qQNaN(), 0.0f);
+    proxy->insertRow(0, row);
+    QVERIFY(m_graph->axisY()->min() <= -5.0f);
+    QVERIFY(!qIsNaN(m_graph->axisY()->max()));
+
+    proxy->removeRows(0, 1);
+    QVERIFY(m_graph->axisY()->min() > -5.0f);
+}
+
 QTEST_MAIN(tst_surface)
 #include "tst_surface.moc"
@@ -0,0 +1,180 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtTest/QtTest>
+
+#include <private/chunkbounds_p.h>
+#include <private/frustum_p.h>
+
+typedef QList<QPair<int, int>> RangeList;
+
+class tst_culling: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void orthographicPlanes();
+    void perspectivePlanes();
+    void modelSpacePlanes();
+    void chunkInvalidation();
+    void chunkCulling();
+
+private:
+    static void setAllBounds(ChunkBounds &bounds);
+};
+
+// Chunks of 600 items, with the second chunk at X from 10 to 11 and the others from 0 to 1
+void tst_culling::setAllBounds(ChunkBounds &bounds)
+{
+    bounds.resize(600);
+    bounds.takeDirtyChunks();
+    bounds.setChunkBounds(0, QVector3D(0.0f, 0.0f, 0.0f), QVector3D(1.0f, 1.0f, 1.0f), 256);
+    bounds.setChunkBounds(1, QVector3D(10.0f, 0.0f, 0.0f), QVector3D(11.0f, 1.0f, 1.0f), 256);
+    bounds.setChunkBounds(2, QVector3D(0.0f, 0.0f, 0.0f), QVector3D(1.0f, 1.0f, 1.0f), 88);
+}
+
+void tst_culling::orthographicPlanes()
+{
+    // Identity covers the unit cube of normalized device coordinates
+    const Frustum unit((QMatrix4x4()));
+    QVERIFY(unit.intersectsSphere(QVector3D(0.0f, 0.0f, 0.0f), 0.0f));
+    QVERIFY(unit.intersectsSphere(QVector3D(0.0f, -1.0f, 1.0f), 0.0f));
+    QVERIFY(!unit.intersectsSphere(QVector3D(2.0f, 0.0f, 0.0f), 0.5f));
+    QVERIFY(unit.intersectsSphere(QVector3D(2.0f, 0.0f, 0.0f), 1.5f));
+    QVERIFY(!unit.intersectsSphere(QVector3D(0.0f, 0.0f, -1.5f), 0.4f));
+    QVERIFY(unit.intersectsBox(QVector3D(0.5f, 0.5f, 0.5f), QVector3D(3.0f, 3.0f, 3.0f)));
+    QVERIFY(!unit.intersectsBox(QVector3D(1.5f, -0.5f, -0.5f), QVector3D(3.0f, 0.5f, 0.5f)));
+    QVERIFY(!unit.intersectsBox(QVector3D(-0.5f, 1.1f, -0.5f), QVector3D(0.5f, 2.0f, 0.5f)));
+
+    // Planes are normalized, so that radii are compared to distances in the original space
+    QMatrix4x4 scale;
+    scale.scale(0.5f);
+    const Frustum scaled(scale);
+    QVERIFY(scaled.intersectsSphere(QVector3D(1.9f, 0.0f, 0.0f), 0.0f));
+    QVERIFY(!scaled.intersectsSphere(QVector3D(2.2f, 0.0f, 0.0f), 0.15f));
+    QVERIFY(scaled.intersectsSphere(QVector3D(2.2f, 0.0f, 0.0f), 0.25f));
+    QVERIFY(!scaled.intersectsSphere(QVector3D(0.0f, -2.2f, 0.0f), 0.15f));
+    QVERIFY(scaled.intersectsSphere(QVector3D(0.0f, 0.0f, 2.2f), 0.25f));
+}
+
+void tst_culling::perspectivePlanes()
+{
+    // Camera at origin looking towards negative Z, with 90 degree field of view
+    QMatrix4x4 projection;
+    projection.perspective(90.0f, 1.0f, 1.0f, 10.0f);
+    const Frustum frustum(projection);
+    QVERIFY(frustum.intersectsSphere(QVector3D(0.0f, 0.0f, -5.0f), 0.0f));
+    QVERIFY(frustum.intersectsSphere(QVector3D(4.9f, 0.0f, -5.0f), 0.0f));
+    QVERIFY(!frustum.intersectsSphere(QVector3D(5.5f, 0.0f, -5.0f), 0.0f));
+    QVERIFY(!frustum.intersectsSphere(QVector3D(0.0f, -5.5f, -5.0f), 0.0f));
+    // Behind the camera, closer than the near plane and farther than the far plane
+    QVERIFY(!frustum.intersectsSphere(QVector3D(0.0f, 0.0f, 5.0f), 1.0f));
+    QVERIFY(!frustum.intersectsSphere(QVector3D(0.0f, 0.0f, -0.5f), 0.25f));
+    QVERIFY(frustum.intersectsSphere(QVector3D(0.0f, 0.0f, -0.5f), 0.75f));
+    QVERIFY(!frustum.intersectsSphere(QVector3D(0.0f, 0.0f, -11.0f), 0.5f));
+
+    QVERIFY(frustum.intersectsBox(QVector3D(4.0f, -1.0f, -6.0f), QVector3D(6.0f, 1.0f, -4.0f)));
+    QVERIFY(!frustum.intersectsBox(QVector3D(7.0f, -1.0f, -6.0f), QVector3D(9.0f, 1.0f, -4.0f)));
+    QVERIFY(!frustum.intersectsBox(QVector3D(-1.0f, -1.0f, 1.0f), QVector3D(1.0f, 1.0f, 2.0f)));
+    // Box enclosing the whole frustum
+    QVERIFY(frustum.intersectsBox(QVector3D(-20.0f, -20.0f, -20.0f),
+                                  QVector3D(20.0f, 20.0f, 20.0f)));
+}
+
+void tst_culling::modelSpacePlanes()
+{
+    // Planes are in the space the matrix transforms from
+    QMatrix4x4 projection;
+    projection.perspective(90.0f, 1.0f, 1.0f, 10.0f);
+    QMatrix4x4 model;
+    model.translate(10.0f, 0.0f, 0.0f);
+    const Frustum frustum(projection * model);
+    QVERIFY(frustum.intersectsSphere(QVector3D(-10.0f, 0.0f, -5.0f), 0.0f));
+    QVERIFY(!frustum.intersectsSphere(QVector3D(0.0f, 0.0f, -5.0f), 0.0f));
+    QVERIFY(frustum.intersectsBox(QVector3D(-11.0f, -1.0f, -6.0f),
+                                  QVector3D(-9.0f, 1.0f, -4.0f)));
+    QVERIFY(!frustum.intersectsBox(QVector3D(-1.0f, -1.0f, -6.0f),
+                                   QVector3D(1.0f, 1.0f, -4.0f)));
+}
+
+void tst_culling::chunkInvalidation()
+{
+    ChunkBounds bounds;
+    bounds.resize(600);
+    QCOMPARE(bounds.itemCount(), 600);
+    QCOMPARE(bounds.takeDirtyChunks(), QList<int>({0, 1, 2}));
+    QVERIFY(bounds.takeDirtyChunks().isEmpty());
+
+    // Resizing to the same size keeps the bounds
+    setAllBounds(bounds);
+    bounds.resize(600);
+    QVERIFY(bounds.takeDirtyChunks().isEmpty());
+
+    // Each changed chunk is reported once, items beyond the size are ignored
+    bounds.invalidate(300);
+    bounds.invalidate(310);
+    bounds.invalidate(700);
+    bounds.invalidate(0);
+    QCOMPARE(bounds.takeDirtyChunks(), QList<int>({1, 0}));
+    bounds.setChunkBounds(0, QVector3D(), QVector3D(1.0f, 1.0f, 1.0f), 256);
+    bounds.setChunkBounds(1, QVector3D(), QVector3D(1.0f, 1.0f, 1.0f), 256);
+
+    // Inserts and removes invalidate the chunks from the first moved item onwards
+    bounds.resize(700, 400);
+    QCOMPARE(bounds.itemCount(), 700);
+    QCOMPARE(bounds.takeDirtyChunks(), QList<int>({1, 2}));
+    bounds.setChunkBounds(1, QVector3D(), QVector3D(1.0f, 1.0f, 1.0f), 256);
+    bounds.setChunkBounds(2, QVector3D(), QVector3D(1.0f, 1.0f, 1.0f), 188);
+    bounds.invalidate(650);
+    bounds.resize(300, 280);
+    QCOMPARE(bounds.takeDirtyChunks(), QList<int>({1}));
+
+    bounds.invalidateAll();
+    QCOMPARE(bounds.takeDirtyChunks(), QList<int>({0, 1}));
+}
+
+void tst_culling::chunkCulling()
+{
+    ChunkBounds bounds;
+    setAllBounds(bounds);
+    QMatrix4x4 scale;
+    scale.scale(0.5f);
+    const Frustum frustum(scale);
+
+    // Visible items in culled chunks are counted, and ranges of consecutive visible chunks
+    // are merged
+    QCOMPARE(bounds.cull(frustum, QVector3D()), 256);
+    QVERIFY(!bounds.isAllCulled());
+    QVERIFY(!bounds.isItemCulled(255));
+    QVERIFY(bounds.isItemCulled(256));
+    QVERIFY(bounds.isItemCulled(511));
+    QVERIFY(!bounds.isItemCulled(512));
+    RangeList ranges;
+    bounds.visibleRanges(ranges);
+    QCOMPARE(ranges, RangeList({{0, 256}, {512, 88}}));
+
+    // Margin grows the bounds
+    QCOMPARE(bounds.cull(frustum, QVector3D(8.5f, 0.0f, 0.0f)), 0);
+    bounds.visibleRanges(ranges);
+    QCOMPARE(ranges, RangeList({{0, 600}}));
+
+    // Chunks without visible items are always culled, but have no items to count
+    bounds.setChunkBounds(0, QVector3D(), QVector3D(), 0);
+    QCOMPARE(bounds.cull(frustum, QVector3D()), 256);
+    bounds.visibleRanges(ranges);
+    QCOMPARE(ranges, RangeList({{512, 88}}));
+
+    bounds.setChunkBounds(2, QVector3D(5.0f, 5.0f, 5.0f), QVector3D(6.0f, 6.0f, 6.0f), 88);
+    QCOMPARE(bounds.cull(frustum, QVector3D()), 344);
+    QVERIFY(bounds.isAllCulled());
+    bounds.visibleRanges(ranges);
+    QVERIFY(ranges.isEmpty());
+
+    bounds.resetCulling();
+    QVERIFY(!bounds.isAllCulled());
+    bounds.visibleRanges(ranges);
+    QCOMPARE(ranges, RangeList({{0, 600}}));
+}
+
+QTEST_MAIN(tst_culling)
+#include "tst_culling.moc"
@@ -0,0 +1,187 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtTest/QtTest>
+
+#include <private/indexrangeset_p.h>
+
+typedef QList<QPair<qint64, qint64>> RangeList;
+
+class tst_indexrangeset: public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void coalescing();
+    void bitmap();
+    void adjustForInsert();
+    void adjustForRemove();
+    void pointIndexes();
+
+private:
+    static RangeList ranges(const IndexRangeSet &set);
+};
+
+// Ranges of the set as start and count pairs
+RangeList tst_indexrangeset::ranges(const IndexRangeSet &set)
+{
+    RangeList result;
+    const QList<IndexRangeSet::Range> setRanges = set.ranges();
+    for (const IndexRangeSet::Range &range : setRanges)
+        result.append(qMakePair(range.start, range.count));
+    return result;
+}
+
+void tst_indexrangeset::coalescing()
+{
+    IndexRangeSet set;
+    QVERIFY(set.isEmpty());
+    QVERIFY(!set.insert(3, 0));
+    QVERIFY(set.isEmpty());
+
+    QVERIFY(set.insert(5, 3));
+    QVERIFY(set.insert(10, 2));
+    QCOMPARE(ranges(set), RangeList({{5, 3}, {10, 2}}));
+
+    // Adjacent and overlapping ranges are merged
+    QVERIFY(set.insert(8, 2));
+    QCOMPARE(ranges(set), RangeList({{5, 7}}));
+    QVERIFY(set.insert(4));
+    QVERIFY(set.insert(11, 4));
+    QCOMPARE(ranges(set), RangeList({{4, 11}}));
+
+    // Indexes already in the set are not reported as added
+    QVERIFY(!set.insert(6, 2));
+    QVERIFY(!set.insert(14));
+
+    // A range covering several ranges replaces them
+    QVERIFY(set.insert(20));
+    QVERIFY(set.insert(22));
+    QVERIFY(set.insert(0, 2));
+    QVERIFY(set.insert(1, 21));
+    QCOMPARE(ranges(set), RangeList({{0, 23}}));
+
+    QVERIFY(set.contains(0));
+    QVERIFY(set.contains(22));
+    QVERIFY(!set.contains(-1));
+    QVERIFY(!set.contains(23));
+    QVERIFY(!set.isBitmap());
+
+    set.clear();
+    QVERIFY(set.isEmpty());
+    QVERIFY(!set.contains(0));
+}
+
+void tst_indexrangeset::bitmap()
+{
+    // Every other index, so that no ranges are merged
+    IndexRangeSet set;
+    RangeList expected;
+    for (int i = 0; i < 1024; i++) {
+        QVERIFY(set.insert(2 * i));
+        expected.append(qMakePair(qint64(2 * i), qint64(1)));
+    }
+    QVERIFY(!set.isBitmap());
+    QVERIFY(set.insert(2048));
+    expected.append(qMakePair(qint64(2048), qint64(1)));
+    QVERIFY(set.isBitmap());
+    QVERIFY(!set.isEmpty());
+    QCOMPARE(ranges(set), expected);
+    QVERIFY(set.contains(2));
+    QVERIFY(!set.contains(3));
+    QVERIFY(!set.insert(4));
+
+    // Bitmap grows in both directions
+    QVERIFY(set.insert(-100, 2));
+    QVERIFY(set.insert(3000));
+    QVERIFY(set.isBitmap());
+    expected.prepend(qMakePair(qint64(-100), qint64(2)));
+    expected.append(qMakePair(qint64(3000), qint64(1)));
+    QCOMPARE(ranges(set), expected);
+
+    // Changes too far apart for a bitmap revert to ranges
+    QVERIFY(set.insert(qint64(1) << 40));
+    QVERIFY(!set.isBitmap());
+    expected.append(qMakePair(qint64(1) << 40, qint64(1)));
+    QCOMPARE(ranges(set), expected);
+
+    set.clear();
+    QVERIFY(!set.isBitmap());
+    QVERIFY(set.isEmpty());
+}
+
+void tst_indexrangeset::adjustForInsert()
+{
+    IndexRangeSet set;
+    set.insert(2, 3);
+    set.insert(10, 2);
+
+    // The range spanning the insertion point is split, later ones are moved
+    set.adjustForInsert(3, 4);
+    QCOMPARE(ranges(set), RangeList({{2, 1}, {7, 2}, {14, 2}}));
+
+    // Insertion at the start of a range moves the whole range
+    set.adjustForInsert(14, 1);
+    QCOMPARE(ranges(set), RangeList({{2, 1}, {7, 2}, {15, 2}}));
+
+    set.adjustForInsert(0, 0);
+    QCOMPARE(ranges(set), RangeList({{2, 1}, {7, 2}, {15, 2}}));
+
+    // Bitmap sets are adjusted the same way
+    IndexRangeSet bitmap;
+    for (int i = 0; i <= 1024; i++)
+        bitmap.insert(2 * i);
+    QVERIFY(bitmap.isBitmap());
+    bitmap.adjustForInsert(1, 1);
+    QVERIFY(bitmap.contains(0));
+    QVERIFY(!bitmap.contains(2));
+    QVERIFY(bitmap.contains(3));
+    QVERIFY(bitmap.contains(2049));
+    QCOMPARE(bitmap.ranges().size(), 1025);
+}
+
+void tst_indexrangeset::adjustForRemove()
+{
+    IndexRangeSet set;
+    set.insert(2, 3);
+    set.insert(10, 2);
+    set.insert(20);
+
+    // Parts before and after the removed items are merged
+    set.adjustForRemove(3, 8);
+    QCOMPARE(ranges(set), RangeList({{2, 2}, {12, 1}}));
+
+    // Ranges with only removed items are dropped
+    set.adjustForRemove(10, 5);
+    QCOMPARE(ranges(set), RangeList({{2, 2}}));
+
+    set.adjustForRemove(0, 2);
+    QCOMPARE(ranges(set), RangeList({{0, 2}}));
+
+    set.adjustForRemove(0, 2);
+    QVERIFY(set.isEmpty());
+}
+
+void tst_indexrangeset::pointIndexes()
+{
+    const QList<QPoint> points = {QPoint(0, 0), QPoint(3, 7), QPoint(0, -1),
+                                  QPoint(INT_MAX, INT_MIN)};
+    for (const QPoint &point : points)
+        QCOMPARE(IndexRangeSet::indexPoint(IndexRangeSet::pointIndex(point)), point);
+
+    // Changes on the same row are coalesced, and rows are kept in order
+    IndexRangeSet set;
+    set.insert(IndexRangeSet::pointIndex(QPoint(2, 0)));
+    set.insert(IndexRangeSet::pointIndex(QPoint(1, 5)), 2);
+    set.insert(IndexRangeSet::pointIndex(QPoint(1, 7)));
+    const QList<IndexRangeSet::Range> setRanges = set.ranges();
+    QCOMPARE(setRanges.size(), 2);
+    QCOMPARE(IndexRangeSet::indexPoint(setRanges.at(0).start), QPoint(1, 5));
+    QCOMPARE(setRanges.at(0).count, qint64(3));
+    QCOMPARE(IndexRangeSet::indexPoint(setRanges.at(1).start), QPoint(2, 0));
+    QVERIFY(set.contains(IndexRangeSet::pointIndex(QPoint(1, 6))));
+    QVERIFY(!set.contains(IndexRangeSet::pointIndex(QPoint(1, 8))));
+}
+
+QTEST_MAIN(tst_indexrangeset)
+#include "tst_indexrangeset.moc"
@@ -0,0 +1,83 @@
+// Copyright (C) 2016 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+import QtQuick
+import QtDataVisualization
+import QtTest
+
+Item {
+    id: top
+    height: 150
+    width: 150
+
+    HeightFieldSurfaceDataProxy {
+        id: initial
+    }
+
+    HeightFieldSurfaceDataProxy {
+        id: initialized
+        sampleRegion: Qt.rect(1, 2, 3, 4)
+        sampleStep: 2
+        maxXValue: 10.0
+        maxZValue: 10.0
+        minXValue: -10.0
+        minZValue: -10.0
+    }
+
+    HeightFieldSurfaceDataProxy {
+        id: invalid
+    }
+
+    TestCase {
+        name: "HeightFieldSurfaceDataProxy Initial"
+
+        function test_initial() {
+            compare(initial.heightFieldFile, "")
+            compare(initial.fieldWidth, 0)
+            compare(initial.fieldHeight, 0)
+            compare(initial.sampleType, HeightFieldSurfaceDataProxy.SampleTypeUInt16)
+            compare(initial.dataOffset, 0)
+            compare(initial.rowStride, 0)
+            compare(initial.sampleStep, 1)
+            compare(initial.maxXValue, 10.0)
+            compare(initial.maxZValue, 10.0)
+            compare(initial.minXValue, 0)
+            compare(initial.minZValue, 0)
+
+            compare(initial.columnCount, 0)
+            compare(initial.rowCount, 0)
+            verify(!initial.series)
+
+            compare(initial.type, AbstractDataProxy.DataTypeSurface)
+        }
+    }
+
+    TestCase {
+        name: "HeightFieldSurfaceDataProxy Initialized"
+
+        function test_initialized() {
+            compare(initialized.sampleRegion, Qt.rect(1, 2, 3, 4))
+            compare(initialized.sampleStep, 2)
+            compare(initialized.maxXValue, 10.0)
+            compare(initialized.maxZValue, 10.0)
+            compare(initialized.minXValue, -10.0)
+            compare(initialized.minZValue, -10.0)
+        }
+    }
+
+    TestCase {
+        name: "HeightFieldSurfaceDataProxy Invalid"
+
+        function test_invalid() {
+            ignoreWarning("Failed to open height field file :/nonexistent.raw")
+            verify(!invalid.setHeightFieldFile(":/nonexistent.raw", 4, 4,
+                                               HeightFieldSurfaceDataProxy.SampleTypeFloat32, 0, 0))
+            compare(invalid.heightFieldFile, "")
+            compare(invalid.heightAt(0, 0), 0)
+
+            ignoreWarning("Invalid sample step. The step must be positive.")
+            invalid.sampleStep = 0
+            compare(invalid.sampleStep, 1)
+        }
+    }
+}